@@ -0,0 +1,119 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "RetargetEditor/IKRetargetBatchCommandlet.h"
+#include "Animation/AnimSequence.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/SkeletalMesh.h"
+#include "FileHelpers.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+#include "Retargeter/IKRetargeter.h"
+#include "RetargetEditor/IKRetargetBatchOperation.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(IKRetargetBatchCommandlet)
+
+DEFINE_LOG_CATEGORY_STATIC(LogIKRetargetBatch, Log, All);
+
+UIKRetargetBatchCommandlet::UIKRetargetBatchCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UIKRetargetBatchCommandlet::Main(const FString& Params)
+{
+	FString RetargeterPath;
+	FString SourceMeshPath;
+	FString TargetMeshPath;
+	FParse::Value(*Params, TEXT("Retargeter="), RetargeterPath);
+	FParse::Value(*Params, TEXT("SourceMesh="), SourceMeshPath);
+	FParse::Value(*Params, TEXT("TargetMesh="), TargetMeshPath);
+
+	UIKRetargeter* IKRetargetAsset = LoadObject<UIKRetargeter>(nullptr, *RetargeterPath);
+	USkeletalMesh* SourceMesh = LoadObject<USkeletalMesh>(nullptr, *SourceMeshPath);
+	USkeletalMesh* TargetMesh = LoadObject<USkeletalMesh>(nullptr, *TargetMeshPath);
+	if (!IKRetargetAsset || !SourceMesh || !TargetMesh)
+	{
+		UE_LOG(LogIKRetargetBatch, Error, TEXT("-Retargeter=, -SourceMesh= and -TargetMesh= must name an IK retargeter and two skeletal meshes"));
+		return 1;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+	TArray<FAssetData> AssetsToRetarget;
+	FString AssetsParam;
+	FString PathParam;
+	if (FParse::Value(*Params, TEXT("Assets="), AssetsParam, false))
+	{
+		TArray<FString> Paths;
+		AssetsParam.ParseIntoArray(Paths, TEXT(","));
+		for (const FString& Path : Paths)
+		{
+			if (UObject* Asset = FSoftObjectPath(Path).TryLoad())
+			{
+				AssetsToRetarget.Emplace(Asset);
+			}
+			else
+			{
+				UE_LOG(LogIKRetargetBatch, Warning, TEXT("Could not load asset %s"), *Path);
+			}
+		}
+	}
+	else if (FParse::Value(*Params, TEXT("Path="), PathParam))
+	{
+		AssetRegistry.SearchAllAssets(true);
+		FARFilter Filter;
+		Filter.PackagePaths.Add(FName(*PathParam));
+		Filter.ClassPaths.Add(UAnimSequence::StaticClass()->GetClassPathName());
+		Filter.bRecursivePaths = true;
+		Filter.bRecursiveClasses = true;
+		AssetRegistry.GetAssets(Filter, AssetsToRetarget);
+	}
+
+	if (AssetsToRetarget.IsEmpty())
+	{
+		UE_LOG(LogIKRetargetBatch, Error, TEXT("No asset to retarget, give them with -Assets= or -Path="));
+		return 1;
+	}
+
+	FString Search;
+	FString Replace;
+	FString Prefix;
+	FString Suffix;
+	FParse::Value(*Params, TEXT("Search="), Search);
+	FParse::Value(*Params, TEXT("Replace="), Replace);
+	FParse::Value(*Params, TEXT("Prefix="), Prefix);
+	FParse::Value(*Params, TEXT("Suffix="), Suffix);
+	const bool bIncludeReferencedAssets = FParse::Param(*Params, TEXT("IncludeReferenced"));
+
+	if (IConsoleVariable* ParallelVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("IKRetarget.Batch.Parallel")))
+	{
+		ParallelVariable->Set(!FParse::Param(*Params, TEXT("Serial")), ECVF_SetByCommandline);
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	const TArray<FAssetData> Results = UIKRetargetBatchOperation::DuplicateAndRetarget(
+		AssetsToRetarget, SourceMesh, TargetMesh, IKRetargetAsset, Search, Replace, Prefix, Suffix, bIncludeReferencedAssets);
+	const double RetargetSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TArray<UPackage*> PackagesToSave;
+	for (const FAssetData& Result : Results)
+	{
+		if (UObject* Asset = Result.GetAsset())
+		{
+			PackagesToSave.AddUnique(Asset->GetPackage());
+		}
+	}
+
+	constexpr bool bOnlyDirty = false;
+	if (!UEditorLoadingAndSavingUtils::SavePackages(PackagesToSave, bOnlyDirty))
+	{
+		UE_LOG(LogIKRetargetBatch, Error, TEXT("Failed to save the retargeted assets"));
+		return 1;
+	}
+
+	UE_LOG(LogIKRetargetBatch, Display, TEXT("Retargeted %d assets in %.3f s, saved %d packages"), Results.Num(), RetargetSeconds, PackagesToSave.Num());
+	return 0;
+}
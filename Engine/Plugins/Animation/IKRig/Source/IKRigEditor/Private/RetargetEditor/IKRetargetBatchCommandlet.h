@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "IKRetargetBatchCommandlet.generated.h"
+
+/**
+ * Duplicates and retargets animation assets headlessly, for retargeting large animation libraries on build machines.
+ *
+ * Usage: UnrealEditor-Cmd.exe <Project> -run=IKRetargetBatch -Retargeter=/Game/RTG -SourceMesh=/Game/Src -TargetMesh=/Game/Dst
+ *     (-Assets=/Game/A,/Game/B | -Path=/Game/Anims) [-Search=X -Replace=Y] [-Prefix=P] [-Suffix=S] [-IncludeReferenced] [-Serial]
+ * -Path retargets every animation sequence under the folder. Sequences are retargeted in parallel (IKRetarget.Batch.Parallel) unless
+ * -Serial is given. The retargeted assets are saved.
+ */
+UCLASS()
+class UIKRetargetBatchCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UIKRetargetBatchCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
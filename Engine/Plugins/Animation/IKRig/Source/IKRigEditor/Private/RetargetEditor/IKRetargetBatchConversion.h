@@ -0,0 +1,23 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "RetargetEditor/IKRetargetBatchOperation.h"
+
+class UAnimSequence;
+struct FScopedSlowTask;
+
+namespace UE::IKRetarget::Private
+{
+	/** Replaces the bone tracks of each target sequence with its source sequence retargeted by Context.IKRetargetAsset, one sequence at a time. */
+	void ConvertAnimationSerial(
+		const FIKRetargetBatchOperationContext& Context,
+		const TArray<TPair<UAnimSequence*, UAnimSequence*>>& Sequences,
+		FScopedSlowTask& Progress);
+
+	/** Same as ConvertAnimationSerial, retargeting the sequences and, without speed based IK planting, chunks of their frames in parallel (IKRetarget.Batch.ChunkFrames). */
+	void ConvertAnimationParallel(
+		const FIKRetargetBatchOperationContext& Context,
+		const TArray<TPair<UAnimSequence*, UAnimSequence*>>& Sequences,
+		FScopedSlowTask& Progress);
+}
@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "RetargetEditor/IKRetargetBatchOperation.h"
+#include "RetargetEditor/IKRetargetBatchConversion.h"
 
 #include "Engine/SkeletalMesh.h"
 #include "Animation/AnimSequence.h"
@@ -25,9 +26,379 @@
 #include "Retargeter/RetargetOps/CurveRemapOp.h"
 #include "ObjectTools.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/StrongObjectPtr.h"
 
 #define LOCTEXT_NAMESPACE "RetargetBatchOperation"
 
+namespace UE::IKRetarget::Private
+{
+	static bool bParallelBatchRetarget = false;
+	static FAutoConsoleVariableRef CVarParallelBatchRetarget(
+		TEXT("IKRetarget.Batch.Parallel"),
+		bParallelBatchRetarget,
+		TEXT("When true, batch retargeting retargets several animation sequences at once, with one retarget processor per worker thread."));
+
+	static int32 BatchChunkFrames = 600;
+	static FAutoConsoleVariableRef CVarBatchChunkFrames(
+		TEXT("IKRetarget.Batch.ChunkFrames"),
+		BatchChunkFrames,
+		TEXT("With IKRetarget.Batch.Parallel, sequences longer than this are split in chunks of this many frames retargeted in parallel. 0 never splits sequences.\n")
+		TEXT("Sequences are never split for retargeters with speed based IK planting, which carries state from one frame to the next."));
+
+	static int32 BatchSequencesPerCommit = 32;
+	static FAutoConsoleVariableRef CVarBatchSequencesPerCommit(
+		TEXT("IKRetarget.Batch.SequencesPerCommit"),
+		BatchSequencesPerCommit,
+		TEXT("With IKRetarget.Batch.Parallel, number of sequences retargeted before their keys are written to the sequences on the game thread. Bounds the memory used by retargeted keys."));
+
+	static FAnimPoseEvaluationOptions MakeSourceEvaluationOptions(const FRetargetSkeleton& SourceSkeleton)
+	{
+		// ensure we evaluate the source animation using the skeletal mesh proportions that were evaluated in the viewport
+		FAnimPoseEvaluationOptions EvaluationOptions = FAnimPoseEvaluationOptions();
+		EvaluationOptions.OptionalSkeletalMesh = SourceSkeleton.SkeletalMesh;
+		// ensure WYSIWYG with editor by ensuring the same root motion is applied to the pose, not to the component
+		EvaluationOptions.bExtractRootMotion = false;
+		EvaluationOptions.bIncorporateRootMotionIntoPose = true;
+		return EvaluationOptions;
+	}
+
+	/**
+	 * Retargets the pose of SourceSequence at FrameIndex. SourceComponentPose is scratch space sized to the source bones.
+	 * The processor must have had its IK rig settings copied from the asset, and SettingsProfile is filled from the asset once per batch,
+	 * neither changes while a batch runs.
+	 *
+	 * Runs on task workers in ConvertAnimationParallel. Evaluating the source pose and curves only reads the source sequence, the same way
+	 * parallel animation evaluation does at runtime: GetAnimPoseAtFrame evaluates into stack memory of the calling thread, and
+	 * EvaluateCurveData reads the curves of the data model. Nothing writes to source sequences during the batch, target sequences are
+	 * duplicates that are only written on the game thread once the ParallelFor has completed.
+	 */
+	static void RetargetFrame(
+		UIKRetargetProcessor* Processor,
+		const FRetargetProfile& SettingsProfile,
+		const UAnimSequence* SourceSequence,
+		const int32 FrameIndex,
+		const FAnimPoseEvaluationOptions& EvaluationOptions,
+		const TArray<FName>& SpeedCurveNames,
+		TArray<FTransform>& SourceComponentPose,
+		TArray<FTransform>& OutTargetLocalPose)
+	{
+		const TArray<FName>& SourceBoneNames = Processor->GetSkeleton(ERetargetSourceOrTarget::Source).BoneNames;
+		const int32 NumSourceBones = SourceBoneNames.Num();
+
+		// get the source global pose
+		FAnimPose SourcePoseAtFrame;
+		UAnimPoseExtensions::GetAnimPoseAtFrame(SourceSequence, FrameIndex, EvaluationOptions, SourcePoseAtFrame);
+
+		// we don't use UAnimPoseExtensions::GetBoneNames as the sequence can store bones that only exist on the
+		// skeleton, but not on the current mesh. This results in indices discrepancy
+		for (int32 BoneIndex = 0; BoneIndex < NumSourceBones; BoneIndex++)
+		{
+			const FName& BoneName = SourceBoneNames[BoneIndex];
+			SourceComponentPose[BoneIndex] = UAnimPoseExtensions::GetBonePose(SourcePoseAtFrame, BoneName, EAnimPoseSpaces::World);
+		}
+
+		// strip all scale out of the pose values, the translation of a component-space pose has incorporated scale values
+		for (FTransform& Transform : SourceComponentPose)
+		{
+			Transform.SetScale3D(FVector::OneVector);
+		}
+
+		// calculate the delta time
+		const float TimeAtCurrentFrame = SourceSequence->GetTimeAtFrame(FrameIndex);
+		float DeltaTime = TimeAtCurrentFrame;
+		if (FrameIndex > 0)
+		{
+			const float TimeAtPrevFrame = SourceSequence->GetTimeAtFrame(FrameIndex-1);
+			DeltaTime = TimeAtCurrentFrame - TimeAtPrevFrame;
+		}
+
+		// get the curve values from the source sequence (for speed-based IK planting)
+		TMap<FName, float> SpeedCurveValues;
+		for (const FName& SpeedCurveName : SpeedCurveNames)
+		{
+			SpeedCurveValues.Add(SpeedCurveName, SourceSequence->EvaluateCurveData(SpeedCurveName, TimeAtCurrentFrame));
+		}
+
+		// run the retargeter
+		const TArray<FTransform>& TargetComponentPose = Processor->RunRetargeter(SourceComponentPose, SpeedCurveValues, DeltaTime, SettingsProfile);
+
+		// convert to a local-space pose
+		OutTargetLocalPose = TargetComponentPose;
+		Processor->GetSkeleton(ERetargetSourceOrTarget::Target).UpdateLocalTransformsBelowBone(0, OutTargetLocalPose, TargetComponentPose);
+	}
+
+	static void StoreFrameKeys(TArray<FRawAnimSequenceTrack>& BoneTracks, const int32 FrameIndex, const TArray<FTransform>& TargetLocalPose)
+	{
+		// store key data for each bone
+		for (int32 TargetBoneIndex=0; TargetBoneIndex<BoneTracks.Num(); ++TargetBoneIndex)
+		{
+			const FTransform& LocalPose = TargetLocalPose[TargetBoneIndex];
+
+			FRawAnimSequenceTrack& BoneTrack = BoneTracks[TargetBoneIndex];
+
+			BoneTrack.PosKeys[FrameIndex] = FVector3f(LocalPose.GetLocation());
+			BoneTrack.RotKeys[FrameIndex] = FQuat4f(LocalPose.GetRotation().GetNormalized());
+			BoneTrack.ScaleKeys[FrameIndex] = FVector3f(LocalPose.GetScale3D());
+		}
+	}
+
+	void ConvertAnimationSerial(
+		const FIKRetargetBatchOperationContext& Context,
+		const TArray<TPair<UAnimSequence*, UAnimSequence*>>& Sequences,
+		FScopedSlowTask& Progress)
+	{
+		// initialize the retargeter
+		UObject* TransientOuter = Cast<UObject>(GetTransientPackage());
+		UIKRetargetProcessor* Processor = NewObject<UIKRetargetProcessor>(TransientOuter);
+		FRetargetProfile RetargetProfile;
+		Context.IKRetargetAsset->FillProfileWithAssetSettings(RetargetProfile);
+		Processor->Initialize(Context.SourceMesh, Context.TargetMesh, Context.IKRetargetAsset, RetargetProfile);
+		if (!Processor->IsInitialized())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unable to initialize the IK Retargeter. Newly created animations were not retargeted!"));
+			return;
+		}
+
+		// update goals, the asset doesn't change during the batch
+		Processor->CopyIKRigSettingsFromAsset();
+
+		// target skeleton data
+		const FRetargetSkeleton& TargetSkeleton = Processor->GetSkeleton(ERetargetSourceOrTarget::Target);
+		const TArray<FName>& TargetBoneNames = TargetSkeleton.BoneNames;
+		const int32 NumTargetBones = TargetBoneNames.Num();
+
+		// allocate target keyframe data
+		TArray<FRawAnimSequenceTrack> BoneTracks;
+		BoneTracks.SetNumZeroed(NumTargetBones);
+
+		// source skeleton data
+		const FRetargetSkeleton& SourceSkeleton = Processor->GetSkeleton(ERetargetSourceOrTarget::Source);
+		const int32 NumSourceBones = SourceSkeleton.BoneNames.Num();
+
+		TArray<FTransform> SourceComponentPose;
+		SourceComponentPose.SetNum(NumSourceBones);
+		TArray<FTransform> TargetLocalPose;
+
+		// get names of the curves the retargeter is looking for
+		TArray<FName> SpeedCurveNames;
+		Context.IKRetargetAsset->GetSpeedCurveNames(SpeedCurveNames);
+		
+		// for each pair of source / target animation sequences
+		for (const TPair<UAnimSequence*, UAnimSequence*>& Pair : Sequences)
+		{
+			if (Progress.ShouldCancel())
+			{
+				return;
+			}
+			
+			UAnimSequence* SourceSequence = Pair.Key;
+			UAnimSequence* TargetSequence = Pair.Value;
+
+			// increment progress bar
+			FString AssetName = TargetSequence->GetName();
+			Progress.EnterProgressFrame(1.f, FText::Format(LOCTEXT("RunningBatchRetarget", "Retargeting animation asset: {0}"), FText::FromString(AssetName)));
+
+			// remove all keys from the destination animation sequence
+			IAnimationDataController& TargetSeqController = TargetSequence->GetController();
+			constexpr bool bShouldTransact = false;
+			TargetSeqController.OpenBracket(FText::FromString("Generating Retargeted Animation Data"), bShouldTransact);
+			TargetSeqController.RemoveAllBoneTracks(bShouldTransact);
+
+			// number of frames in this animation
+			const int32 NumFrames = SourceSequence->GetNumberOfSampledKeys();
+
+			// BoneTracks arrays allocation
+			for (int32 TargetBoneIndex=0; TargetBoneIndex<NumTargetBones; ++TargetBoneIndex)
+			{
+				BoneTracks[TargetBoneIndex].PosKeys.SetNum(NumFrames);
+				BoneTracks[TargetBoneIndex].RotKeys.SetNum(NumFrames);
+				BoneTracks[TargetBoneIndex].ScaleKeys.SetNum(NumFrames);
+			}
+
+			const FAnimPoseEvaluationOptions EvaluationOptions = MakeSourceEvaluationOptions(SourceSkeleton);
+
+			// reset the planting state
+			Processor->ResetPlanting();
+			
+			// retarget each frame's pose from source to target
+			for (int32 FrameIndex=0; FrameIndex<NumFrames; ++FrameIndex)
+			{
+				if (Progress.ShouldCancel())
+				{
+					TargetSeqController.CloseBracket(bShouldTransact);
+					return;
+				}
+				
+				// retarget the frame and store key data for each bone
+				RetargetFrame(Processor, RetargetProfile, SourceSequence, FrameIndex, EvaluationOptions, SpeedCurveNames, SourceComponentPose, TargetLocalPose);
+				StoreFrameKeys(BoneTracks, FrameIndex, TargetLocalPose);
+			} // END for each frame
+
+			// add keys to bone tracks
+			for (int32 TargetBoneIndex=0; TargetBoneIndex<NumTargetBones; ++TargetBoneIndex)
+			{
+				const FName& TargetBoneName = TargetBoneNames[TargetBoneIndex];
+
+				const FRawAnimSequenceTrack& RawTrack = BoneTracks[TargetBoneIndex];
+				TargetSeqController.AddBoneCurve(TargetBoneName, bShouldTransact);
+				TargetSeqController.SetBoneTrackKeys(TargetBoneName, RawTrack.PosKeys, RawTrack.RotKeys, RawTrack.ScaleKeys, bShouldTransact);
+			}
+
+			TargetSeqController.CloseBracket(bShouldTransact);
+		}
+	}
+
+	/**
+	 * Parallel version of ConvertAnimationSerial, with one task context per worker of the ParallelFor, each with its own processor.
+	 *
+	 * The contexts and their processors are created and initialized on the game thread before the ParallelFor, as is the settings profile
+	 * they share. Sequences longer than BatchChunkFrames are split into chunks, which are retargeted in parallel. Keys are written to the
+	 * target sequences on the game thread, BatchSequencesPerCommit sequences at a time, with the same controller calls as the serial conversion.
+	 *
+	 * Speed based IK planting carries state from one frame to the next, which a chunk can't get from the previous one. Retargeters with
+	 * speed curves only retarget whole sequences in parallel, so that every conversion gives the same keys as the serial one.
+	 */
+	void ConvertAnimationParallel(
+		const FIKRetargetBatchOperationContext& Context,
+		const TArray<TPair<UAnimSequence*, UAnimSequence*>>& Sequences,
+		FScopedSlowTask& Progress)
+	{
+		FRetargetProfile RetargetProfile;
+		Context.IKRetargetAsset->FillProfileWithAssetSettings(RetargetProfile);
+
+		struct FTaskContext
+		{
+			UIKRetargetProcessor* Processor = nullptr;
+			TArray<FTransform> SourceComponentPose;
+			TArray<FTransform> TargetLocalPose;
+		};
+
+		// the task graph workers and this thread can run the ParallelFor body at the same time, processors can't be initialized off the game thread
+		UObject* TransientOuter = Cast<UObject>(GetTransientPackage());
+		const int32 NumContexts = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+		TArray<TStrongObjectPtr<UIKRetargetProcessor>> Processors;
+		TArray<FTaskContext> TaskContexts;
+		TaskContexts.SetNum(NumContexts);
+		for (FTaskContext& TaskContext : TaskContexts)
+		{
+			UIKRetargetProcessor* Processor = NewObject<UIKRetargetProcessor>(TransientOuter);
+			Processor->Initialize(Context.SourceMesh, Context.TargetMesh, Context.IKRetargetAsset, RetargetProfile);
+			if (!Processor->IsInitialized())
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Unable to initialize the IK Retargeter. Newly created animations were not retargeted!"));
+				return;
+			}
+			Processor->CopyIKRigSettingsFromAsset();
+			Processors.Emplace(Processor);
+			TaskContext.Processor = Processor;
+			TaskContext.SourceComponentPose.SetNum(Processor->GetSkeleton(ERetargetSourceOrTarget::Source).BoneNames.Num());
+		}
+
+		const FRetargetSkeleton& SourceSkeleton = Processors[0]->GetSkeleton(ERetargetSourceOrTarget::Source);
+		const TArray<FName>& TargetBoneNames = Processors[0]->GetSkeleton(ERetargetSourceOrTarget::Target).BoneNames;
+		const int32 NumTargetBones = TargetBoneNames.Num();
+		const FAnimPoseEvaluationOptions EvaluationOptions = MakeSourceEvaluationOptions(SourceSkeleton);
+
+		// get names of the curves the retargeter is looking for
+		TArray<FName> SpeedCurveNames;
+		Context.IKRetargetAsset->GetSpeedCurveNames(SpeedCurveNames);
+		const bool bUsesPlanting = SpeedCurveNames.Num() > 0;
+
+		struct FSequenceResult
+		{
+			UAnimSequence* SourceSequence = nullptr;
+			UAnimSequence* TargetSequence = nullptr;
+			TArray<FRawAnimSequenceTrack> BoneTracks;
+		};
+
+		struct FFrameChunk
+		{
+			int32 ResultIndex = 0;
+			int32 FirstFrame = 0;
+			int32 EndFrame = 0;
+		};
+
+		TArray<FSequenceResult> Results;
+		TArray<FFrameChunk> Chunks;
+		const int32 SequencesPerCommit = FMath::Max(BatchSequencesPerCommit, 1);
+		for (int32 BatchStart = 0; BatchStart < Sequences.Num(); BatchStart += SequencesPerCommit)
+		{
+			if (Progress.ShouldCancel())
+			{
+				return;
+			}
+
+			const int32 BatchEnd = FMath::Min(BatchStart + SequencesPerCommit, Sequences.Num());
+			Results.Reset();
+			Chunks.Reset();
+			for (int32 SequenceIndex = BatchStart; SequenceIndex < BatchEnd; ++SequenceIndex)
+			{
+				FSequenceResult& Result = Results.AddDefaulted_GetRef();
+				Result.SourceSequence = Sequences[SequenceIndex].Key;
+				Result.TargetSequence = Sequences[SequenceIndex].Value;
+
+				// number of frames in this animation
+				const int32 NumFrames = Result.SourceSequence->GetNumberOfSampledKeys();
+
+				// BoneTracks arrays allocation
+				Result.BoneTracks.SetNum(NumTargetBones);
+				for (FRawAnimSequenceTrack& BoneTrack : Result.BoneTracks)
+				{
+					BoneTrack.PosKeys.SetNum(NumFrames);
+					BoneTrack.RotKeys.SetNum(NumFrames);
+					BoneTrack.ScaleKeys.SetNum(NumFrames);
+				}
+
+				const int32 ChunkFrames = BatchChunkFrames > 0 && !bUsesPlanting ? BatchChunkFrames : FMath::Max(NumFrames, 1);
+				for (int32 FirstFrame = 0; FirstFrame < NumFrames; FirstFrame += ChunkFrames)
+				{
+					Chunks.Add({ Results.Num() - 1, FirstFrame, FMath::Min(FirstFrame + ChunkFrames, NumFrames) });
+				}
+			}
+
+			ParallelForWithExistingTaskContext(TEXT("IKRetargetBatch"), MakeArrayView(TaskContexts), Chunks.Num(), 1, [&](FTaskContext& TaskContext, int32 ChunkIndex)
+			{
+				const FFrameChunk& Chunk = Chunks[ChunkIndex];
+				FSequenceResult& Result = Results[Chunk.ResultIndex];
+				UIKRetargetProcessor* Processor = TaskContext.Processor;
+
+				// reset the planting state, with planting each sequence is a single chunk
+				Processor->ResetPlanting();
+				for (int32 FrameIndex = Chunk.FirstFrame; FrameIndex < Chunk.EndFrame; ++FrameIndex)
+				{
+					RetargetFrame(Processor, RetargetProfile, Result.SourceSequence, FrameIndex, EvaluationOptions, SpeedCurveNames, TaskContext.SourceComponentPose, TaskContext.TargetLocalPose);
+					StoreFrameKeys(Result.BoneTracks, FrameIndex, TaskContext.TargetLocalPose);
+				}
+			});
+
+			// the anim data controllers are only used from the game thread
+			for (const FSequenceResult& Result : Results)
+			{
+				// increment progress bar
+				FString AssetName = Result.TargetSequence->GetName();
+				Progress.EnterProgressFrame(1.f, FText::Format(LOCTEXT("RunningBatchRetarget", "Retargeting animation asset: {0}"), FText::FromString(AssetName)));
+
+				// replace all keys of the destination animation sequence
+				IAnimationDataController& TargetSeqController = Result.TargetSequence->GetController();
+				constexpr bool bShouldTransact = false;
+				TargetSeqController.OpenBracket(FText::FromString("Generating Retargeted Animation Data"), bShouldTransact);
+				TargetSeqController.RemoveAllBoneTracks(bShouldTransact);
+				for (int32 TargetBoneIndex=0; TargetBoneIndex<NumTargetBones; ++TargetBoneIndex)
+				{
+					const FName& TargetBoneName = TargetBoneNames[TargetBoneIndex];
+
+					const FRawAnimSequenceTrack& RawTrack = Result.BoneTracks[TargetBoneIndex];
+					TargetSeqController.AddBoneCurve(TargetBoneName, bShouldTransact);
+					TargetSeqController.SetBoneTrackKeys(TargetBoneName, RawTrack.PosKeys, RawTrack.RotKeys, RawTrack.ScaleKeys, bShouldTransact);
+				}
+				TargetSeqController.CloseBracket(bShouldTransact);
+			}
+		}
+	}
+}
+
 int32 UIKRetargetBatchOperation::GenerateAssetLists(const FIKRetargetBatchOperationContext& Context)
 {
 	// re-generate lists of selected and referenced assets
@@ -330,167 +701,26 @@ void UIKRetargetBatchOperation::ConvertAnimation(
 	const FIKRetargetBatchOperationContext& Context,
 	FScopedSlowTask& Progress)
 {
-	// initialize the retargeter
-	UObject* TransientOuter = Cast<UObject>(GetTransientPackage());
-	UIKRetargetProcessor* Processor = NewObject<UIKRetargetProcessor>(TransientOuter);
-	FRetargetProfile RetargetProfile;
-	Context.IKRetargetAsset->FillProfileWithAssetSettings(RetargetProfile);
-	Processor->Initialize(Context.SourceMesh, Context.TargetMesh, Context.IKRetargetAsset, RetargetProfile);
-	if (!Processor->IsInitialized())
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Unable to initialize the IK Retargeter. Newly created animations were not retargeted!"));
-		return;
-	}
-
-	// target skeleton data
-	const FRetargetSkeleton& TargetSkeleton = Processor->GetSkeleton(ERetargetSourceOrTarget::Target);
-	const TArray<FName>& TargetBoneNames = TargetSkeleton.BoneNames;
-	const int32 NumTargetBones = TargetBoneNames.Num();
-
-	// allocate target keyframe data
-	TArray<FRawAnimSequenceTrack> BoneTracks;
-	BoneTracks.SetNumZeroed(NumTargetBones);
+	using namespace UE::IKRetarget::Private;
 
-	// source skeleton data
-	const FRetargetSkeleton& SourceSkeleton = Processor->GetSkeleton(ERetargetSourceOrTarget::Source);
-	const TArray<FName>& SourceBoneNames = SourceSkeleton.BoneNames;
-	const int32 NumSourceBones = SourceBoneNames.Num();
-
-	TArray<FTransform> SourceComponentPose;
-	SourceComponentPose.SetNum(NumSourceBones);
-
-	// get names of the curves the retargeter is looking for
-	TArray<FName> SpeedCurveNames;
-	Context.IKRetargetAsset->GetSpeedCurveNames(SpeedCurveNames);
-	
-	// for each pair of source / target animation sequences
+	TArray<TPair<UAnimSequence*, UAnimSequence*>> Sequences;
 	for (TPair<UAnimationAsset*, UAnimationAsset*>& Pair : DuplicatedAnimAssets)
 	{
-		if (Progress.ShouldCancel())
-		{
-			return;
-		}
-		
 		UAnimSequence* SourceSequence = Cast<UAnimSequence>(Pair.Key);
 		UAnimSequence* TargetSequence = Cast<UAnimSequence>(Pair.Value);
-		if (!(SourceSequence && TargetSequence))
+		if (SourceSequence && TargetSequence)
 		{
-			continue;
-		}
-
-		// increment progress bar
-		FString AssetName = TargetSequence->GetName();
-		Progress.EnterProgressFrame(1.f, FText::Format(LOCTEXT("RunningBatchRetarget", "Retargeting animation asset: {0}"), FText::FromString(AssetName)));
-
-		// remove all keys from the destination animation sequence
-		IAnimationDataController& TargetSeqController = TargetSequence->GetController();
-		constexpr bool bShouldTransact = false;
-		TargetSeqController.OpenBracket(FText::FromString("Generating Retargeted Animation Data"), bShouldTransact);
-		TargetSeqController.RemoveAllBoneTracks(bShouldTransact);
-
-		// number of frames in this animation
-		const int32 NumFrames = SourceSequence->GetNumberOfSampledKeys();
-
-		// BoneTracks arrays allocation
-		for (int32 TargetBoneIndex=0; TargetBoneIndex<NumTargetBones; ++TargetBoneIndex)
-		{
-			BoneTracks[TargetBoneIndex].PosKeys.SetNum(NumFrames);
-			BoneTracks[TargetBoneIndex].RotKeys.SetNum(NumFrames);
-			BoneTracks[TargetBoneIndex].ScaleKeys.SetNum(NumFrames);
-		}
-
-		// ensure we evaluate the source animation using the skeletal mesh proportions that were evaluated in the viewport
-		FAnimPoseEvaluationOptions EvaluationOptions = FAnimPoseEvaluationOptions();
-		EvaluationOptions.OptionalSkeletalMesh = SourceSkeleton.SkeletalMesh;
-		// ensure WYSIWYG with editor by ensuring the same root motion is applied to the pose, not to the component
-		EvaluationOptions.bExtractRootMotion = false;
-		EvaluationOptions.bIncorporateRootMotionIntoPose = true;
-
-		// reset the planting state
-		Processor->ResetPlanting();
-		
-		// retarget each frame's pose from source to target
-		for (int32 FrameIndex=0; FrameIndex<NumFrames; ++FrameIndex)
-		{
-			if (Progress.ShouldCancel())
-			{
-				TargetSeqController.CloseBracket(bShouldTransact);
-				return;
-			}
-			
-			// get the source global pose
-			FAnimPose SourcePoseAtFrame;
-			UAnimPoseExtensions::GetAnimPoseAtFrame(SourceSequence, FrameIndex, EvaluationOptions, SourcePoseAtFrame);
-
-			// we don't use UAnimPoseExtensions::GetBoneNames as the sequence can store bones that only exist on the
-			// skeleton, but not on the current mesh. This results in indices discrepancy
-			for (int32 BoneIndex = 0; BoneIndex < NumSourceBones; BoneIndex++)
-			{
-				const FName& BoneName = SourceBoneNames[BoneIndex];
-				SourceComponentPose[BoneIndex] = UAnimPoseExtensions::GetBonePose(SourcePoseAtFrame, BoneName, EAnimPoseSpaces::World);
-			}
-			
-			// strip all scale out of the pose values, the translation of a component-space pose has incorporated scale values
-			for (FTransform& Transform : SourceComponentPose)
-			{
-				Transform.SetScale3D(FVector::OneVector);
-			}
-
-			// update goals 
-			Processor->CopyIKRigSettingsFromAsset();
-			
-			// calculate the delta time
-			const float TimeAtCurrentFrame = SourceSequence->GetTimeAtFrame(FrameIndex);
-			float DeltaTime = TimeAtCurrentFrame;
-			if (FrameIndex > 0)
-			{
-				const float TimeAtPrevFrame = SourceSequence->GetTimeAtFrame(FrameIndex-1);
-				DeltaTime = TimeAtCurrentFrame - TimeAtPrevFrame;
-			}
-			
-			// get the curve values from the source sequence (for speed-based IK planting)
-			TMap<FName, float> SpeedCurveValues;
-			for (const FName& SpeedCurveName : SpeedCurveNames)
-			{
-				SpeedCurveValues.Add(SpeedCurveName, SourceSequence->EvaluateCurveData(SpeedCurveName, TimeAtCurrentFrame));
-			}
-
-			// get the settings profile
-			FRetargetProfile SettingsProfile;
-			Context.IKRetargetAsset->FillProfileWithAssetSettings(SettingsProfile);
-
-			// run the retargeter
-			const TArray<FTransform>& TargetComponentPose = Processor->RunRetargeter(SourceComponentPose, SpeedCurveValues, DeltaTime, SettingsProfile);
-
-			// convert to a local-space pose
-			TArray<FTransform> TargetLocalPose = TargetComponentPose;
-			TargetSkeleton.UpdateLocalTransformsBelowBone(0,TargetLocalPose, TargetComponentPose);
-
-			// store key data for each bone
-			for (int32 TargetBoneIndex=0; TargetBoneIndex<NumTargetBones; ++TargetBoneIndex)
-			{
-				const FTransform& LocalPose = TargetLocalPose[TargetBoneIndex];
-				
-				FRawAnimSequenceTrack& BoneTrack = BoneTracks[TargetBoneIndex];
-				
-				BoneTrack.PosKeys[FrameIndex] = FVector3f(LocalPose.GetLocation());
-				BoneTrack.RotKeys[FrameIndex] = FQuat4f(LocalPose.GetRotation().GetNormalized());
-				BoneTrack.ScaleKeys[FrameIndex] = FVector3f(LocalPose.GetScale3D());
-			}
-			
-		} // END for each frame
-
-		// add keys to bone tracks
-		for (int32 TargetBoneIndex=0; TargetBoneIndex<NumTargetBones; ++TargetBoneIndex)
-		{
-			const FName& TargetBoneName = TargetBoneNames[TargetBoneIndex];
-
-			const FRawAnimSequenceTrack& RawTrack = BoneTracks[TargetBoneIndex];
-			TargetSeqController.AddBoneCurve(TargetBoneName, bShouldTransact);
-			TargetSeqController.SetBoneTrackKeys(TargetBoneName, RawTrack.PosKeys, RawTrack.RotKeys, RawTrack.ScaleKeys, bShouldTransact);
+			Sequences.Emplace(SourceSequence, TargetSequence);
 		}
+	}
 
-		TargetSeqController.CloseBracket(bShouldTransact);
+	if (bParallelBatchRetarget)
+	{
+		ConvertAnimationParallel(Context, Sequences, Progress);
+	}
+	else
+	{
+		ConvertAnimationSerial(Context, Sequences, Progress);
 	}
 }
 
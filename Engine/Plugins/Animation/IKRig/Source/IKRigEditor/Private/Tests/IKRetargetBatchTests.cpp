@@ -0,0 +1,264 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Animation/AnimSequence.h"
+#include "Engine/SkeletalMesh.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Retargeter/IKRetargeter.h"
+#include "Retargeter/RetargetOps/SpeedPlantingOp.h"
+#include "RetargetEditor/IKRetargetBatchConversion.h"
+#include "RetargetEditor/IKRetargeterController.h"
+#include "Rig/IKRigDefinition.h"
+#include "RigEditor/IKRigController.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace IKRetargetBatchTest
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_EditorContext | EAutomationTestFlags::EngineFilter;
+
+// Engine content mannequin, the retarget definition is generated for it
+static const TCHAR* MeshPath = TEXT("/Engine/Tutorial/SubEditors/TutorialAssets/Character/TutorialTPP.TutorialTPP");
+
+/** Sets a console variable for the scope of the test. */
+class FScopedConsoleVariable
+{
+public:
+	FScopedConsoleVariable(const TCHAR* Name, int32 Value)
+		: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+	{
+		check(Variable);
+		PreviousValue = Variable->GetInt();
+		Variable->Set(Value, ECVF_SetByCode);
+	}
+
+	~FScopedConsoleVariable()
+	{
+		Variable->Set(PreviousValue, ECVF_SetByCode);
+	}
+
+private:
+	IConsoleVariable* Variable;
+	int32 PreviousValue;
+};
+
+/**
+ * Every bone of the mesh swings around its reference pose, with a different phase per bone.
+ * With a SpeedCurveName, the curve goes above and below the planting threshold a few times.
+ */
+static UAnimSequence* CreateSourceSequence(USkeletalMesh* Mesh, int32 NumKeys, FName SpeedCurveName)
+{
+	UAnimSequence* Sequence = NewObject<UAnimSequence>(GetTransientPackage(), NAME_None, RF_Transient);
+	Sequence->SetSkeleton(Mesh->GetSkeleton());
+	Sequence->SetPreviewMesh(Mesh);
+
+	constexpr bool bShouldTransact = false;
+	IAnimationDataController& Controller = Sequence->GetController();
+	Controller.InitializeModel();
+	Controller.OpenBracket(FText::FromString(TEXT("Generating test animation")), bShouldTransact);
+	Controller.SetFrameRate(FFrameRate(30, 1), bShouldTransact);
+	Controller.SetNumberOfFrames(FFrameNumber(NumKeys - 1), bShouldTransact);
+
+	const FReferenceSkeleton& RefSkeleton = Mesh->GetRefSkeleton();
+	const TArray<FTransform>& RefPose = RefSkeleton.GetRefBonePose();
+	for (int32 BoneIndex = 0; BoneIndex < RefSkeleton.GetNum(); ++BoneIndex)
+	{
+		TArray<FVector3f> PosKeys;
+		TArray<FQuat4f> RotKeys;
+		TArray<FVector3f> ScaleKeys;
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			const double Angle = 0.4 * FMath::Sin(Key * 0.15 + BoneIndex * 0.7);
+			const FQuat Swing(FVector(1.0, 0.5, 0.25).GetSafeNormal(), Angle);
+			PosKeys.Add(FVector3f(RefPose[BoneIndex].GetLocation() + (BoneIndex == 0 ? FVector(Key * 2.0, 0.0, 0.0) : FVector::ZeroVector)));
+			RotKeys.Add(FQuat4f((RefPose[BoneIndex].GetRotation() * Swing).GetNormalized()));
+			ScaleKeys.Add(FVector3f::OneVector);
+		}
+
+		const FName BoneName = RefSkeleton.GetBoneName(BoneIndex);
+		Controller.AddBoneCurve(BoneName, bShouldTransact);
+		Controller.SetBoneTrackKeys(BoneName, PosKeys, RotKeys, ScaleKeys, bShouldTransact);
+	}
+
+	if (SpeedCurveName != NAME_None)
+	{
+		const FAnimationCurveIdentifier CurveId(SpeedCurveName, ERawCurveTrackTypes::RCT_Float);
+		TArray<FRichCurveKey> CurveKeys;
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			CurveKeys.Emplace(Key / 30.0f, 40.0f + 40.0f * FMath::Sin(Key * 0.3f));
+		}
+		Controller.AddCurve(CurveId, AACF_DefaultCurve, bShouldTransact);
+		Controller.SetCurveKeys(CurveId, CurveKeys, bShouldTransact);
+	}
+
+	Controller.NotifyPopulated();
+	Controller.CloseBracket(bShouldTransact);
+	return Sequence;
+}
+
+static UAnimSequence* CreateTargetSequence(UAnimSequence* SourceSequence)
+{
+	UAnimSequence* TargetSequence = DuplicateObject<UAnimSequence>(SourceSequence, GetTransientPackage());
+	TargetSequence->GetController().RemoveAllBoneTracks(false);
+	return TargetSequence;
+}
+
+/** Generates a retargeter from the mannequin to itself, with speed based IK planting on every IK chain when SpeedCurveName is set. */
+static UIKRetargeter* CreateRetargeter(FAutomationTestBase& Test, USkeletalMesh* Mesh, FName SpeedCurveName)
+{
+	UIKRigDefinition* IKRig = NewObject<UIKRigDefinition>(GetTransientPackage(), NAME_None, RF_Transient);
+	UIKRigController* IKRigController = UIKRigController::GetController(IKRig);
+	IKRigController->SetSkeletalMesh(Mesh);
+	IKRigController->ApplyAutoGeneratedRetargetDefinition();
+	if (!Test.TestTrue(TEXT("Retarget chains generated for the mannequin"), IKRig->GetRetargetChains().Num() > 0))
+	{
+		return nullptr;
+	}
+
+	UIKRetargeter* Retargeter = NewObject<UIKRetargeter>(GetTransientPackage(), NAME_None, RF_Transient);
+	UIKRetargeterController* RetargeterController = UIKRetargeterController::GetController(Retargeter);
+	RetargeterController->SetIKRig(ERetargetSourceOrTarget::Source, IKRig);
+	RetargeterController->SetIKRig(ERetargetSourceOrTarget::Target, IKRig);
+	RetargeterController->AutoMapChains(EAutoMapChainType::Exact, true);
+
+	if (SpeedCurveName != NAME_None)
+	{
+		// planting needs IK goals on the chains
+		IKRigController->ApplyAutoFBIK();
+
+		const int32 OpIndex = RetargeterController->AddRetargetOp(FIKRetargetSpeedPlantingOp::StaticStruct());
+		FIKRetargetSpeedPlantingOp* SpeedPlantingOp = static_cast<FIKRetargetSpeedPlantingOp*>(RetargeterController->GetRetargetOpByIndex(OpIndex));
+		if (!Test.TestNotNull(TEXT("Speed planting op added"), SpeedPlantingOp))
+		{
+			return nullptr;
+		}
+		for (const FBoneChain& Chain : IKRig->GetRetargetChains())
+		{
+			if (Chain.IKGoalName != NAME_None)
+			{
+				FRetargetSpeedPlantingSettings& ChainSettings = SpeedPlantingOp->Settings.ChainsToSpeedPlant.AddDefaulted_GetRef();
+				ChainSettings.TargetChainName = Chain.ChainName;
+				ChainSettings.SpeedCurveName = SpeedCurveName;
+			}
+		}
+	}
+
+	return Retargeter;
+}
+
+/** Retargets sequences longer than a chunk with the serial and the parallel conversion, and checks they give the same bone keys. */
+static void TestParallelMatchesSerial(FAutomationTestBase& Test, USkeletalMesh* Mesh, UIKRetargeter* Retargeter, FName SpeedCurveName)
+{
+	using namespace UE::IKRetarget::Private;
+
+	FIKRetargetBatchOperationContext Context;
+	Context.SourceMesh = Mesh;
+	Context.TargetMesh = Mesh;
+	Context.IKRetargetAsset = Retargeter;
+
+	// several chunks per sequence, the last one partial, and several commits
+	constexpr int32 ChunkFrames = 16;
+	const int32 NumKeysPerSequence[] = { 3 * ChunkFrames + 5, ChunkFrames, 2 };
+	FScopedConsoleVariable ChunkFramesVariable(TEXT("IKRetarget.Batch.ChunkFrames"), ChunkFrames);
+	FScopedConsoleVariable SequencesPerCommitVariable(TEXT("IKRetarget.Batch.SequencesPerCommit"), 2);
+
+	TArray<TPair<UAnimSequence*, UAnimSequence*>> SerialSequences;
+	TArray<TPair<UAnimSequence*, UAnimSequence*>> ParallelSequences;
+	for (const int32 NumKeys : NumKeysPerSequence)
+	{
+		UAnimSequence* SourceSequence = CreateSourceSequence(Mesh, NumKeys, SpeedCurveName);
+		SerialSequences.Emplace(SourceSequence, CreateTargetSequence(SourceSequence));
+		ParallelSequences.Emplace(SourceSequence, CreateTargetSequence(SourceSequence));
+	}
+
+	{
+		FScopedSlowTask Progress(2 * SerialSequences.Num());
+		ConvertAnimationSerial(Context, SerialSequences, Progress);
+		ConvertAnimationParallel(Context, ParallelSequences, Progress);
+	}
+
+	const FReferenceSkeleton& RefSkeleton = Mesh->GetRefSkeleton();
+	for (int32 SequenceIndex = 0; SequenceIndex < SerialSequences.Num(); ++SequenceIndex)
+	{
+		const IAnimationDataModel* SerialModel = SerialSequences[SequenceIndex].Value->GetDataModel();
+		const IAnimationDataModel* ParallelModel = ParallelSequences[SequenceIndex].Value->GetDataModel();
+		if (!Test.TestEqual(TEXT("Every bone is retargeted"), SerialModel->GetNumBoneTracks(), RefSkeleton.GetNum())
+			|| !Test.TestEqual(TEXT("Same bone tracks"), ParallelModel->GetNumBoneTracks(), SerialModel->GetNumBoneTracks()))
+		{
+			continue;
+		}
+
+		int32 NumMismatches = 0;
+		TArray<FTransform> SerialKeys;
+		TArray<FTransform> ParallelKeys;
+		for (int32 BoneIndex = 0; BoneIndex < RefSkeleton.GetNum(); ++BoneIndex)
+		{
+			const FName BoneName = RefSkeleton.GetBoneName(BoneIndex);
+			SerialModel->GetBoneTrackTransforms(BoneName, SerialKeys);
+			ParallelModel->GetBoneTrackTransforms(BoneName, ParallelKeys);
+			if (!Test.TestEqual(TEXT("Key count"), ParallelKeys.Num(), NumKeysPerSequence[SequenceIndex]) || !Test.TestEqual(TEXT("Same key count"), ParallelKeys.Num(), SerialKeys.Num()))
+			{
+				break;
+			}
+			for (int32 Key = 0; Key < SerialKeys.Num(); ++Key)
+			{
+				NumMismatches += ParallelKeys[Key].Equals(SerialKeys[Key], UE_KINDA_SMALL_NUMBER) ? 0 : 1;
+			}
+		}
+		Test.TestEqual(FString::Printf(TEXT("Keys differing between serial and parallel, sequence of %d keys"), NumKeysPerSequence[SequenceIndex]), NumMismatches, 0);
+	}
+}
+
+/** Without speed curves nothing is planted, so the parallel conversion splits sequences into chunks. */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FIKRetargetBatchParallelTest, "Editor.IKRetarget.Batch.ParallelMatchesSerial", TestFlags)
+bool FIKRetargetBatchParallelTest::RunTest(const FString& Parameters)
+{
+	USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, MeshPath);
+	if (!Mesh)
+	{
+		AddWarning(FString::Printf(TEXT("Skipped, %s could not be loaded"), MeshPath));
+		return true;
+	}
+
+	if (UIKRetargeter* Retargeter = CreateRetargeter(*this, Mesh, NAME_None))
+	{
+		TestParallelMatchesSerial(*this, Mesh, Retargeter, NAME_None);
+	}
+	return true;
+}
+
+/** Speed based IK planting carries state across frames, the parallel conversion must still give the keys of the serial one. */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FIKRetargetBatchParallelPlantingTest, "Editor.IKRetarget.Batch.ParallelMatchesSerialWithPlanting", TestFlags)
+bool FIKRetargetBatchParallelPlantingTest::RunTest(const FString& Parameters)
+{
+	USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, MeshPath);
+	if (!Mesh)
+	{
+		AddWarning(FString::Printf(TEXT("Skipped, %s could not be loaded"), MeshPath));
+		return true;
+	}
+
+	const FName SpeedCurveName(TEXT("IKRetargetBatchTestSpeed"));
+	UIKRetargeter* Retargeter = CreateRetargeter(*this, Mesh, SpeedCurveName);
+	if (!Retargeter)
+	{
+		return true;
+	}
+
+	TArray<FName> SpeedCurveNames;
+	Retargeter->GetSpeedCurveNames(SpeedCurveNames);
+	if (!TestTrue(TEXT("Retargeter plants on the speed curve"), SpeedCurveNames.Contains(SpeedCurveName)))
+	{
+		return true;
+	}
+
+	TestParallelMatchesSerial(*this, Mesh, Retargeter, SpeedCurveName);
+	return true;
+}
+
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
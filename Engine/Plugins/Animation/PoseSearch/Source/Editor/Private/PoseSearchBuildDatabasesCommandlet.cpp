@@ -0,0 +1,104 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "PoseSearchBuildDatabasesCommandlet.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+#include "PoseSearch/PoseSearchDatabase.h"
+#include "PoseSearch/PoseSearchDerivedData.h"
+#include "PoseSearch/PoseSearchIndexingStats.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(PoseSearchBuildDatabasesCommandlet)
+
+DEFINE_LOG_CATEGORY_STATIC(LogPoseSearchBuildDatabases, Log, All);
+
+UPoseSearchBuildDatabasesCommandlet::UPoseSearchBuildDatabasesCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UPoseSearchBuildDatabasesCommandlet::Main(const FString& Params)
+{
+	using namespace UE::PoseSearch;
+
+	TArray<FSoftObjectPath> DatabasePaths;
+	FString DatabasesParam;
+	if (FParse::Value(*Params, TEXT("Databases="), DatabasesParam, false))
+	{
+		TArray<FString> Paths;
+		DatabasesParam.ParseIntoArray(Paths, TEXT(","));
+		for (const FString& Path : Paths)
+		{
+			DatabasePaths.Emplace(Path);
+		}
+	}
+	else
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.SearchAllAssets(true);
+
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssetsByClass(UPoseSearchDatabase::StaticClass()->GetClassPathName(), Assets, true);
+		for (const FAssetData& Asset : Assets)
+		{
+			DatabasePaths.Add(Asset.GetSoftObjectPath());
+		}
+	}
+
+	int32 NumIterations = 1;
+	FParse::Value(*Params, TEXT("Iterations="), NumIterations);
+	NumIterations = FMath::Max(NumIterations, 1);
+
+	TArray<UPoseSearchDatabase*> Databases;
+	for (const FSoftObjectPath& Path : DatabasePaths)
+	{
+		if (UPoseSearchDatabase* Database = Cast<UPoseSearchDatabase>(Path.TryLoad()))
+		{
+			Databases.Add(Database);
+		}
+		else
+		{
+			UE_LOG(LogPoseSearchBuildDatabases, Warning, TEXT("Could not load database %s"), *Path.ToString());
+		}
+	}
+
+	if (Databases.IsEmpty())
+	{
+		UE_LOG(LogPoseSearchBuildDatabases, Error, TEXT("No database to build"));
+		return 1;
+	}
+
+	int32 NumFailures = 0;
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		ResetChannelIndexingStats();
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (UPoseSearchDatabase* Database : Databases)
+		{
+			const double DatabaseStartTime = FPlatformTime::Seconds();
+			const EAsyncBuildIndexResult Result = FAsyncPoseSearchDatabasesManagement::RequestAsyncBuildIndex(Database, ERequestAsyncBuildFlag::NewRequest | ERequestAsyncBuildFlag::WaitForCompletion);
+			if (Result != EAsyncBuildIndexResult::Success)
+			{
+				UE_LOG(LogPoseSearchBuildDatabases, Error, TEXT("Failed to build %s"), *Database->GetPathName());
+				++NumFailures;
+				continue;
+			}
+			UE_LOG(LogPoseSearchBuildDatabases, Display, TEXT("Built %s in %.3f s"), *Database->GetPathName(), FPlatformTime::Seconds() - DatabaseStartTime);
+		}
+		const double TotalSeconds = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogPoseSearchBuildDatabases, Display, TEXT("Iteration %d: built %d databases in %.3f s"), Iteration, Databases.Num(), TotalSeconds);
+		for (const FChannelIndexingStats& Stats : GetChannelIndexingStats())
+		{
+			UE_LOG(LogPoseSearchBuildDatabases, Display, TEXT("    %-48s %10.3f s  %6d assets  %10lld samples  %8.3f us/sample"),
+				*Stats.ChannelType.ToString(), Stats.Seconds, Stats.NumAssets, Stats.NumSamples,
+				Stats.NumSamples > 0 ? 1000000.0 * Stats.Seconds / double(Stats.NumSamples) : 0.0);
+		}
+	}
+
+	return NumFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,24 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "PoseSearchBuildDatabasesCommandlet.generated.h"
+
+/**
+ * Builds pose search databases headlessly and reports the time spent, in total and per feature channel type.
+ *
+ * Usage: UnrealEditor-Cmd.exe <Project> -run=PoseSearchBuildDatabases [-Databases=/Game/A,/Game/B] [-Iterations=N]
+ * Without -Databases every database of the project is built. Builds served from the DDC report no channel time,
+ * run it against an empty DDC to measure indexing.
+ */
+UCLASS()
+class UPoseSearchBuildDatabasesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPoseSearchBuildDatabasesCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
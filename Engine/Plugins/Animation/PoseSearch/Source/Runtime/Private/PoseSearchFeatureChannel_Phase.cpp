@@ -5,8 +5,10 @@
 #include "PoseSearch/PoseSearchAssetSampler.h"
 #include "PoseSearch/PoseSearchContext.h"
 #include "PoseSearch/PoseSearchDatabase.h"
+#include "PoseSearch/PoseSearchIndexingStats.h"
 #include "PoseSearch/PoseSearchSchema.h"
 #include "PoseSearchFeatureChannel_Position.h"
+#include "PoseSearchPhaseSignal.h"
 
 #if WITH_EDITOR
 namespace UE::PoseSearch
@@ -23,7 +25,7 @@ namespace UE::PoseSearch
 	};
 
 	template <typename T>
-	T GetValueAtIndex(int32 Sample, const TArray<T>& Values)
+	T GetValueAtIndex(int32 Sample, TConstArrayView<T> Values)
 	{
 		const int32 Num = Values.Num();
 		check(Num > 1);
@@ -58,35 +60,72 @@ namespace UE::PoseSearch
 		return true;
 	}
 
-	static void CalculateSignal(const TArray<FVector>& BonePositions, TArray<float>& Signal, int32 offset = 1)
+	void CalculatePhaseSignal(TConstArrayView<FVector> BonePositions, TArray<float>& Signal, int32 offset)
 	{
-		Signal.Reset();
-		Signal.AddDefaulted(BonePositions.Num());
+		const int32 Num = BonePositions.Num();
+		Signal.SetNumUninitialized(Num, EAllowShrinking::No);
 
-		for (int32 SampleIdx = 0; SampleIdx != BonePositions.Num(); ++SampleIdx)
+		// only the first and last offset samples need extrapolated bone positions
+		const int32 InteriorBegin = FMath::Min(offset, Num);
+		const int32 InteriorEnd = FMath::Max(Num - offset, InteriorBegin);
+
+		for (int32 SampleIdx = 0; SampleIdx != InteriorBegin; ++SampleIdx)
+		{
+			Signal[SampleIdx] = (GetValueAtIndex(SampleIdx + offset, BonePositions) - GetValueAtIndex(SampleIdx - offset, BonePositions)).Length();
+		}
+
+		const FVector* RESTRICT Positions = BonePositions.GetData();
+		float* RESTRICT SignalData = Signal.GetData();
+		for (int32 SampleIdx = InteriorBegin; SampleIdx < InteriorEnd; ++SampleIdx)
+		{
+			const VectorRegister4Double Delta = VectorSubtract(VectorLoadFloat3_W0(&Positions[SampleIdx + offset].X), VectorLoadFloat3_W0(&Positions[SampleIdx - offset].X));
+			SignalData[SampleIdx] = static_cast<float>(FMath::Sqrt(VectorDot3Scalar(Delta, Delta)));
+		}
+
+		for (int32 SampleIdx = InteriorEnd; SampleIdx < Num; ++SampleIdx)
 		{
 			Signal[SampleIdx] = (GetValueAtIndex(SampleIdx + offset, BonePositions) - GetValueAtIndex(SampleIdx - offset, BonePositions)).Length();
 		}
 	}
 
-	static void SmoothSignal(const TArray<float>& Signal, TArray<float>& SmoothedSignal, int32 offset = 1)
+	void SmoothPhaseSignal(TConstArrayView<float> Signal, TArray<float>& SmoothedSignal, int32 offset)
 	{
+		const int32 Num = Signal.Num();
 		SmoothedSignal.Reset();
-		SmoothedSignal.AddDefaulted(Signal.Num());
+		SmoothedSignal.AddZeroed(Num);
 
 		for (int32 SampleIdx = -offset; SampleIdx != offset; ++SampleIdx)
 		{
 			SmoothedSignal[0] += GetValueAtIndex(SampleIdx, Signal);
 		}
 
-		for (int32 SampleIdx = 1; SampleIdx != Signal.Num(); ++SampleIdx)
+		// the running sum only reads extrapolated values for the first and last offset samples.
+		// the additions happen in the same order as a single loop over all the samples, so the result doesn't change
+		const int32 InteriorBegin = FMath::Min(offset + 1, Num);
+		const int32 InteriorEnd = FMath::Max(Num - offset, InteriorBegin);
+
+		for (int32 SampleIdx = 1; SampleIdx < InteriorBegin; ++SampleIdx)
+		{
+			SmoothedSignal[SampleIdx] = SmoothedSignal[SampleIdx - 1] - GetValueAtIndex(SampleIdx - offset - 1, Signal) + GetValueAtIndex(SampleIdx + offset, Signal);
+		}
+
+		const float* RESTRICT SignalData = Signal.GetData();
+		float* RESTRICT SmoothedData = SmoothedSignal.GetData();
+		for (int32 SampleIdx = InteriorBegin; SampleIdx < InteriorEnd; ++SampleIdx)
+		{
+			SmoothedData[SampleIdx] = SmoothedData[SampleIdx - 1] - SignalData[SampleIdx - offset - 1] + SignalData[SampleIdx + offset];
+		}
+
+		for (int32 SampleIdx = FMath::Max(InteriorEnd, 1); SampleIdx < Num; ++SampleIdx)
 		{
 			SmoothedSignal[SampleIdx] = SmoothedSignal[SampleIdx - 1] - GetValueAtIndex(SampleIdx - offset - 1, Signal) + GetValueAtIndex(SampleIdx + offset, Signal);
 		}
 
-		for (int32 SampleIdx = 0; SampleIdx != Signal.Num(); ++SampleIdx)
+		// no dependency between samples, vectorized by the compiler
+		const float WindowSize = static_cast<float>(2 * offset + 1);
+		for (int32 SampleIdx = 0; SampleIdx < Num; ++SampleIdx)
 		{
-			SmoothedSignal[SampleIdx] /= 2 * offset + 1;
+			SmoothedData[SampleIdx] /= WindowSize;
 		}
 	}
 
@@ -237,18 +276,21 @@ namespace UE::PoseSearch
 		}
 	}
 
-	static void CalculatePhaseAndCertainty(int32 Index, const TArray<LocalMinMax>& MinMax, int32 SignalSize, float& Phase, float& Certainty)
+	// SearchStart is the MinMax index the search starts from, samples are processed in increasing Index order so it only moves forward
+	static void CalculatePhaseAndCertainty(int32 Index, const TArray<LocalMinMax>& MinMax, int32 SignalSize, float& Phase, float& Certainty, int32& SearchStart)
 	{
 		// @todo: expose them via UI
 		static float CertaintyMin = 1.f;
 		static float CertaintyMult = 0.1f;
 
 		const int32 LastIndex = MinMax.Num() - 1;
-		for (int32 i = 1; i < MinMax.Num(); ++i)
+		for (int32 i = FMath::Max(SearchStart, 1); i < MinMax.Num(); ++i)
 		{
 			const int32 MinMaxIndex = MinMax[i].Index;
 			if (Index < MinMaxIndex)
 			{
+				SearchStart = i;
+
 				const int32 PrevMinMaxIndex = MinMax[i - 1].Index;
 				check(MinMaxIndex > PrevMinMaxIndex);
 				const float Ratio = static_cast<float>((Index - PrevMinMaxIndex)) / static_cast<float>((MinMaxIndex - PrevMinMaxIndex));
@@ -273,14 +315,32 @@ namespace UE::PoseSearch
 
 		float Certainty = 1.f;
 		float Phase = 0.f;
+		int32 SearchStart = 1;
 		for (int32 i = 0; i < SignalSize; ++i)
 		{
-			CalculatePhaseAndCertainty(i, MinMax, SignalSize, Phase, Certainty);
+			CalculatePhaseAndCertainty(i, MinMax, SignalSize, Phase, Certainty, SearchStart);
 			FMath::SinCos(&Phases[i].X, &Phases[i].Y, Phase * TWO_PI);
 			Phases[i] *= Certainty;
 		}
 	}
 
+	// buffers reused by every asset indexed on the same thread, so indexing a database in parallel doesn't allocate per asset
+	struct FPhaseIndexingScratch
+	{
+		TArray<FVector2D> Phases;
+		TArray<float> Signal;
+		TArray<float> SmoothedSignal;
+		TArray<LocalMinMax> LocalMinMax;
+		TArray<FVector> BonePositions;
+		bool bInUse = false;
+	};
+
+	static FPhaseIndexingScratch& GetPhaseIndexingScratch()
+	{
+		static thread_local FPhaseIndexingScratch Scratch;
+		return Scratch;
+	}
+
 } // namespace UE::PoseSearch
 #endif // WITH_EDITOR
 
@@ -406,11 +466,19 @@ bool UPoseSearchFeatureChannel_Phase::IndexAsset(UE::PoseSearch::FAssetIndexer&
 
 	const UPoseSearchSchema* Schema = Indexer.GetSchema();
 
-	TArray<FVector2D> Phases;
-	TArray<float> Signal;
-	TArray<float> SmoothedSignal;
-	TArray<LocalMinMax> LocalMinMax;
-	TArray<FVector> BonePositions;
+	FScopedChannelIndexingTimer IndexingTimer(this, Indexer.GetEndSampleIdx() - Indexer.GetBeginSampleIdx());
+
+	// falling back to local buffers if a task waiting inside the indexer picked up another asset on this thread
+	FPhaseIndexingScratch LocalScratch;
+	FPhaseIndexingScratch& ThreadScratch = GetPhaseIndexingScratch();
+	FPhaseIndexingScratch& Scratch = ThreadScratch.bInUse ? LocalScratch : ThreadScratch;
+	TGuardValue<bool> ScratchInUse(Scratch.bInUse, true);
+
+	TArray<FVector2D>& Phases = Scratch.Phases;
+	TArray<float>& Signal = Scratch.Signal;
+	TArray<float>& SmoothedSignal = Scratch.SmoothedSignal;
+	TArray<LocalMinMax>& LocalMinMax = Scratch.LocalMinMax;
+	TArray<FVector>& BonePositions = Scratch.BonePositions;
 
 	if (!CollectBonePositions(BonePositions, Indexer, SchemaBoneIdx, SampleRole))
 	{
@@ -419,10 +487,10 @@ bool UPoseSearchFeatureChannel_Phase::IndexAsset(UE::PoseSearch::FAssetIndexer&
 
 	// @todo: have different way of calculating signals, for example: height of the bone transform, acceleration, etc?
 	const int32 BoneSamplingCentralDifferencesOffset = FMath::Max(FMath::CeilToInt(BoneSamplingCentralDifferencesTime * Schema->SampleRate), 1);
-	CalculateSignal(BonePositions, Signal, BoneSamplingCentralDifferencesOffset);
+	CalculatePhaseSignal(BonePositions, Signal, BoneSamplingCentralDifferencesOffset);
 
 	const int32 SmoothingWindowOffset = FMath::Max(FMath::CeilToInt(SmoothingWindowTime * Schema->SampleRate), 1);
-	SmoothSignal(Signal, SmoothedSignal, SmoothingWindowOffset);
+	SmoothPhaseSignal(Signal, SmoothedSignal, SmoothingWindowOffset);
 
 	FindLocalMinMax(SmoothedSignal, LocalMinMax);
 	ValidateLocalMinMax(LocalMinMax);
@@ -0,0 +1,50 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "PoseSearch/PoseSearchIndexingStats.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/Class.h"
+
+#if WITH_EDITOR
+namespace UE::PoseSearch
+{
+
+static FCriticalSection ChannelIndexingStatsLock;
+static TMap<FName, FChannelIndexingStats> ChannelIndexingStats;
+
+void AddChannelIndexingTime(const UObject* Channel, double Seconds, int32 NumSamples)
+{
+	check(Channel);
+	const FName ChannelType = Channel->GetClass()->GetFName();
+
+	// one call per asset and channel, the lock is negligible next to the indexing itself
+	FScopeLock Lock(&ChannelIndexingStatsLock);
+	FChannelIndexingStats& Stats = ChannelIndexingStats.FindOrAdd(ChannelType);
+	Stats.ChannelType = ChannelType;
+	Stats.Seconds += Seconds;
+	Stats.NumAssets += 1;
+	Stats.NumSamples += NumSamples;
+}
+
+void ResetChannelIndexingStats()
+{
+	FScopeLock Lock(&ChannelIndexingStatsLock);
+	ChannelIndexingStats.Reset();
+}
+
+TArray<FChannelIndexingStats> GetChannelIndexingStats()
+{
+	TArray<FChannelIndexingStats> Result;
+	{
+		FScopeLock Lock(&ChannelIndexingStatsLock);
+		ChannelIndexingStats.GenerateValueArray(Result);
+	}
+
+	Result.Sort([](const FChannelIndexingStats& A, const FChannelIndexingStats& B)
+	{
+		return A.Seconds > B.Seconds;
+	});
+	return Result;
+}
+
+} // namespace UE::PoseSearch
+#endif // WITH_EDITOR
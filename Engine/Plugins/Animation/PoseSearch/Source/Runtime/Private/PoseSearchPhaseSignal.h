@@ -0,0 +1,20 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_EDITOR
+
+namespace UE::PoseSearch
+{
+
+// Distance the bone travels between the samples offset before and after each sample, extrapolating the positions past the ends
+void CalculatePhaseSignal(TConstArrayView<FVector> BonePositions, TArray<float>& Signal, int32 offset = 1);
+
+// Average of the signal over a window of 2 * offset + 1 samples centered on each sample, extrapolating the signal past the ends
+void SmoothPhaseSignal(TConstArrayView<float> Signal, TArray<float>& SmoothedSignal, int32 offset = 1);
+
+} // namespace UE::PoseSearch
+
+#endif // WITH_EDITOR
@@ -0,0 +1,132 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "PoseSearchPhaseSignal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+namespace UE::PoseSearch::PhaseSignalTest
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+// The scalar implementation the phase channel used before the interior loops were split out, kept as the reference
+template <typename T>
+T GetValueAtIndex(int32 Sample, TConstArrayView<T> Values)
+{
+	const int32 Num = Values.Num();
+	check(Num > 1);
+
+	if (Sample < 0)
+	{
+		return (Values[1] - Values[0]) * Sample + Values[0];
+	}
+
+	if (Sample < Num)
+	{
+		return Values[Sample];
+	}
+
+	return (Values[Num - 1] - Values[Num - 2]) * (Sample - (Num - 1)) + Values[Num - 1];
+}
+
+static void ReferenceCalculateSignal(TConstArrayView<FVector> BonePositions, TArray<float>& Signal, int32 offset)
+{
+	const int32 NumSamples = BonePositions.Num();
+	Signal.Reset();
+	Signal.AddDefaulted(NumSamples);
+	for (int32 SampleIdx = 0; SampleIdx != NumSamples; ++SampleIdx)
+	{
+		Signal[SampleIdx] = (GetValueAtIndex(SampleIdx + offset, BonePositions) - GetValueAtIndex(SampleIdx - offset, BonePositions)).Length();
+	}
+}
+
+static void ReferenceSmoothSignal(TConstArrayView<float> Signal, TArray<float>& SmoothedSignal, int32 offset)
+{
+	const int32 NumSamples = Signal.Num();
+	SmoothedSignal.Reset();
+	SmoothedSignal.AddDefaulted(NumSamples);
+
+	for (int32 SampleIdx = -offset; SampleIdx != offset; ++SampleIdx)
+	{
+		SmoothedSignal[0] += GetValueAtIndex(SampleIdx, Signal);
+	}
+
+	for (int32 SampleIdx = 1; SampleIdx != NumSamples; ++SampleIdx)
+	{
+		SmoothedSignal[SampleIdx] = SmoothedSignal[SampleIdx - 1] - GetValueAtIndex(SampleIdx - offset - 1, Signal) + GetValueAtIndex(SampleIdx + offset, Signal);
+	}
+
+	for (int32 SampleIdx = 0; SampleIdx != NumSamples; ++SampleIdx)
+	{
+		SmoothedSignal[SampleIdx] /= float(2 * offset + 1);
+	}
+}
+
+// A foot-like path: swinging forward and back while drifting, with a vertical bounce
+static TArray<FVector> MakeBonePositions(int32 NumSamples)
+{
+	TArray<FVector> BonePositions;
+	BonePositions.Reserve(NumSamples);
+	for (int32 SampleIdx = 0; SampleIdx != NumSamples; ++SampleIdx)
+	{
+		const double Time = SampleIdx / 30.0;
+		BonePositions.Emplace(40.0 * FMath::Sin(Time * 7.0) + 150.0 * Time, 10.0 * FMath::Cos(Time * 3.0), 12.0 * FMath::Abs(FMath::Sin(Time * 7.0)));
+	}
+	return BonePositions;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPoseSearchPhaseSignalTest, "System.Animation.PoseSearch.PhaseSignal.MatchesScalar", TestFlags)
+bool FPoseSearchPhaseSignalTest::RunTest(const FString& Parameters)
+{
+	// short clips where the extrapolated edges overlap or cover every sample, and a long one with a vectorized interior
+	const int32 NumSamplesToTest[] = { 2, 3, 4, 5, 7, 8, 16, 97, 300 };
+	const int32 OffsetsToTest[] = { 1, 2, 3, 6, 9 };
+
+	TArray<float> ExpectedSignal;
+	TArray<float> Signal;
+	TArray<float> ExpectedSmoothedSignal;
+	TArray<float> SmoothedSignal;
+	for (const int32 NumSamples : NumSamplesToTest)
+	{
+		const TArray<FVector> BonePositions = MakeBonePositions(NumSamples);
+		for (const int32 Offset : OffsetsToTest)
+		{
+			ReferenceCalculateSignal(BonePositions, ExpectedSignal, Offset);
+			CalculatePhaseSignal(BonePositions, Signal, Offset);
+			if (!TestEqual(FString::Printf(TEXT("Signal size, %d samples, offset %d"), NumSamples, Offset), Signal.Num(), ExpectedSignal.Num()))
+			{
+				return false;
+			}
+			for (int32 SampleIdx = 0; SampleIdx != NumSamples; ++SampleIdx)
+			{
+				// the interior samples come from a SIMD dot product, which may round the last bit differently than FVector::Length
+				const float Tolerance = 1e-6f * FMath::Max(1.f, FMath::Abs(ExpectedSignal[SampleIdx]));
+				if (!TestEqual(FString::Printf(TEXT("Signal, %d samples, offset %d, sample %d"), NumSamples, Offset, SampleIdx), Signal[SampleIdx], ExpectedSignal[SampleIdx], Tolerance))
+				{
+					break;
+				}
+			}
+
+			// smoothing the same input, the running sum adds in the same order, so the results must be identical
+			ReferenceSmoothSignal(ExpectedSignal, ExpectedSmoothedSignal, Offset);
+			SmoothPhaseSignal(ExpectedSignal, SmoothedSignal, Offset);
+			if (!TestEqual(FString::Printf(TEXT("Smoothed signal size, %d samples, offset %d"), NumSamples, Offset), SmoothedSignal.Num(), ExpectedSmoothedSignal.Num()))
+			{
+				return false;
+			}
+			for (int32 SampleIdx = 0; SampleIdx != NumSamples; ++SampleIdx)
+			{
+				if (!TestEqual(FString::Printf(TEXT("Smoothed signal, %d samples, offset %d, sample %d"), NumSamples, Offset, SampleIdx), SmoothedSignal[SampleIdx], ExpectedSmoothedSignal[SampleIdx], 0.f))
+				{
+					break;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+} // namespace UE::PoseSearch::PhaseSignalTest
+
+#endif // WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
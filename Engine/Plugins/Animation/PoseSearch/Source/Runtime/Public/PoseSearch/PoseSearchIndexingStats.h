@@ -0,0 +1,53 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+
+#if WITH_EDITOR
+
+class UObject;
+
+namespace UE::PoseSearch
+{
+
+// Time spent indexing assets by every channel of one type, summed over the threads indexing in parallel
+struct FChannelIndexingStats
+{
+	FName ChannelType;
+	double Seconds = 0.0;
+	int32 NumAssets = 0;
+	int64 NumSamples = 0;
+};
+
+POSESEARCH_API void AddChannelIndexingTime(const UObject* Channel, double Seconds, int32 NumSamples);
+POSESEARCH_API void ResetChannelIndexingStats();
+
+// Returns the stats accumulated since the last ResetChannelIndexingStats, slowest channel type first
+POSESEARCH_API TArray<FChannelIndexingStats> GetChannelIndexingStats();
+
+// Adds the time spent in the scope to the stats of the type of Channel, for channels to wrap their IndexAsset with
+struct FScopedChannelIndexingTimer
+{
+	FScopedChannelIndexingTimer(const UObject* InChannel, int32 InNumSamples)
+		: Channel(InChannel)
+		, NumSamples(InNumSamples)
+		, StartTime(FPlatformTime::Seconds())
+	{
+	}
+
+	~FScopedChannelIndexingTimer()
+	{
+		AddChannelIndexingTime(Channel, FPlatformTime::Seconds() - StartTime, NumSamples);
+	}
+
+private:
+	const UObject* Channel;
+	int32 NumSamples;
+	double StartTime;
+};
+
+} // namespace UE::PoseSearch
+
+#endif // WITH_EDITOR
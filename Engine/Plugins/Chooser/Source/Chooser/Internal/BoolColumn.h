@@ -3,6 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "IChooserColumn.h"
+#include "ChooserRowBitset.h"
 #include "IChooserParameterBool.h"
 #include "ChooserPropertyAccess.h"
 #include "StructUtils/InstancedStruct.h"
@@ -66,9 +67,36 @@ struct CHOOSER_API FBoolColumn : public FChooserColumnBase
 	
 	UPROPERTY(EditAnywhere, Category= "Data", DisplayName="RowValues");
 	TArray<EBoolColumnCellValue> RowValuesWithAny; 
+
+	// Rows that pass when the input is true (MatchTrue or MatchAny) and when it is false (MatchFalse or MatchAny), one bit per row.
+	// Compiled on load in the editor and again whenever the column is saved, so cooked tables are saved with masks matching their rows.
+	UPROPERTY()
+	TArray<uint64> MatchTrueMask;
+
+	UPROPERTY()
+	TArray<uint64> MatchFalseMask;
+
+	// Builds MatchTrueMask and MatchFalseMask from RowValuesWithAny
+	void Compile();
+
+	// Recompiles the masks before they are saved, rows can be inserted, deleted or pasted in the editor without going through Compile.
+	// Returns false so the properties are still serialized as tagged properties.
+	bool Serialize(FArchive& Ar)
+	{
+		if (Ar.IsSaving())
+		{
+			Compile();
+		}
+		return false;
+	}
 	
 	virtual void Filter(FChooserEvaluationContext& Context, const FChooserIndexArray& IndexListIn, FChooserIndexArray& IndexListOut) const override;
 
+	// Same rows as Filter with every row as input: clears the rows of InOutRows this column rejects with one AND per 64 rows.
+	// Only pays off when the table ANDs every column into one bitset before materializing indices, Filter keeps testing cells until it does.
+	void FilterBitset(FChooserEvaluationContext& Context, FChooserRowBitset& InOutRows) const;
+	void FilterBitset(bool bValue, FChooserRowBitset& InOutRows) const;
+
 #if WITH_EDITOR
 	mutable bool TestValue = false;
 	virtual bool EditorTestFilter(int32 RowIndex) const override
@@ -105,11 +133,30 @@ struct CHOOSER_API FBoolColumn : public FChooserColumnBase
 		{
 			InputValue.GetMutable<FChooserParameterBase>().PostLoad();
 		}
+
+#if WITH_EDITOR
+		Compile();
+#else
+		if (MatchTrueMask.Num() != FChooserRowBitset::GetNumWords(RowValuesWithAny.Num()))
+		{
+			// Cooked before the masks existed
+			Compile();
+		}
+#endif
 	}
 
 	CHOOSER_COLUMN_BOILERPLATE2(FChooserParameterBoolBase, RowValuesWithAny);
 };
 
+template<>
+struct TStructOpsTypeTraits<FBoolColumn> : public TStructOpsTypeTraitsBase2<FBoolColumn>
+{
+	enum
+	{
+		WithSerializer = true,
+	};
+};
+
 // deprecated class versions for converting old data
 
 UCLASS(ClassGroup = "LiveLink", deprecated)
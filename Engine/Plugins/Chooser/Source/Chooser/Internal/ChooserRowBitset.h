@@ -0,0 +1,119 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * One bit per chooser row, for filtering all the rows of a table with word wide ANDs of the masks compiled by each column
+ * instead of testing and copying surviving row indices column after column. Indices are materialized once, after the last column.
+ *
+ * Storage for 2048 rows is inline, evaluating a table doesn't allocate.
+ */
+class FChooserRowBitset
+{
+public:
+	static constexpr int32 BitsPerWord = 64;
+
+	FChooserRowBitset() = default;
+
+	/** Sets the bits of the first NumRows rows. */
+	explicit FChooserRowBitset(int32 InNumRows)
+	{
+		Init(InNumRows);
+	}
+
+	void Init(int32 InNumRows)
+	{
+		NumRows = InNumRows;
+		const int32 NumWords = GetNumWords(NumRows);
+		Words.SetNumUninitialized(NumWords);
+		for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+		{
+			Words[WordIndex] = ~uint64(0);
+		}
+		if (NumRows % BitsPerWord)
+		{
+			Words.Last() = (uint64(1) << (NumRows % BitsPerWord)) - 1;
+		}
+	}
+
+	int32 Num() const { return NumRows; }
+
+	bool IsSet(int32 RowIndex) const
+	{
+		return (Words[RowIndex / BitsPerWord] >> (RowIndex % BitsPerWord)) & 1;
+	}
+
+	/** Clears the rows that are not set in Mask, rows past the end of Mask are cleared too. */
+	void And(TConstArrayView<uint64> Mask)
+	{
+		const int32 NumWords = Words.Num();
+		const int32 NumMaskWords = FMath::Min(NumWords, Mask.Num());
+		uint64* RESTRICT Data = Words.GetData();
+		const uint64* RESTRICT MaskData = Mask.GetData();
+		for (int32 WordIndex = 0; WordIndex < NumMaskWords; ++WordIndex)
+		{
+			Data[WordIndex] &= MaskData[WordIndex];
+		}
+		for (int32 WordIndex = NumMaskWords; WordIndex < NumWords; ++WordIndex)
+		{
+			Data[WordIndex] = 0;
+		}
+	}
+
+	bool IsEmpty() const
+	{
+		for (uint64 Word : Words)
+		{
+			if (Word)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	int32 CountSetBits() const
+	{
+		int32 Count = 0;
+		for (uint64 Word : Words)
+		{
+			Count += FMath::CountBits(Word);
+		}
+		return Count;
+	}
+
+	/** Calls Func(RowIndex) for every set row, in increasing row order. */
+	template<typename FuncType>
+	void ForEachSetRow(FuncType&& Func) const
+	{
+		for (int32 WordIndex = 0; WordIndex < Words.Num(); ++WordIndex)
+		{
+			for (uint64 Word = Words[WordIndex]; Word; Word &= Word - 1)
+			{
+				Func(WordIndex * BitsPerWord + (int32)FMath::CountTrailingZeros64(Word));
+			}
+		}
+	}
+
+	static int32 GetNumWords(int32 InNumRows)
+	{
+		return (InNumRows + BitsPerWord - 1) / BitsPerWord;
+	}
+
+	/** Sets bit RowIndex of a compiled column mask. */
+	static void SetMaskBit(TArray<uint64>& Mask, int32 RowIndex)
+	{
+		Mask[RowIndex / BitsPerWord] |= uint64(1) << (RowIndex % BitsPerWord);
+	}
+
+	static bool IsMaskBitSet(TConstArrayView<uint64> Mask, int32 RowIndex)
+	{
+		const int32 WordIndex = RowIndex / BitsPerWord;
+		return Mask.IsValidIndex(WordIndex) && ((Mask[WordIndex] >> (RowIndex % BitsPerWord)) & 1);
+	}
+
+private:
+	TArray<uint64, TInlineAllocator<2048 / BitsPerWord>> Words;
+	int32 NumRows = 0;
+};
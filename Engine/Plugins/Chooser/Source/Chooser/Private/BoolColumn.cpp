@@ -59,6 +59,68 @@ void FBoolColumn::Filter(FChooserEvaluationContext& Context, const FChooserIndex
 	}
 }
 
+void FBoolColumn::FilterBitset(FChooserEvaluationContext& Context, FChooserRowBitset& InOutRows) const
+{
+	if (InputValue.IsValid())
+	{
+		bool Result = false;
+		InputValue.Get<FChooserParameterBoolBase>().GetValue(Context,Result);
+
+		TRACE_CHOOSER_VALUE(Context, ToCStr(InputValue.Get<FChooserParameterBase>().GetDebugName()), Result);
+
+	#if WITH_EDITOR
+		if (Context.DebuggingInfo.bCurrentDebugTarget)
+		{
+			TestValue = Result;
+		}
+	#endif
+
+		FilterBitset(Result, InOutRows);
+	}
+	// else passthrough fallback (behaves better during live editing)
+}
+
+void FBoolColumn::FilterBitset(bool bValue, FChooserRowBitset& InOutRows) const
+{
+#if WITH_EDITOR
+	// rows can be edited after the masks were compiled, build the mask from the current values
+	TArray<uint64, TInlineAllocator<2048 / FChooserRowBitset::BitsPerWord>> Mask;
+	Mask.SetNumZeroed(FChooserRowBitset::GetNumWords(RowValuesWithAny.Num()));
+	for (int32 RowIndex = 0; RowIndex < RowValuesWithAny.Num(); ++RowIndex)
+	{
+		if (RowValuesWithAny[RowIndex] == EBoolColumnCellValue::MatchAny || bValue == static_cast<bool>(RowValuesWithAny[RowIndex]))
+		{
+			Mask[RowIndex / FChooserRowBitset::BitsPerWord] |= uint64(1) << (RowIndex % FChooserRowBitset::BitsPerWord);
+		}
+	}
+	InOutRows.And(Mask);
+#else
+	InOutRows.And(bValue ? MatchTrueMask : MatchFalseMask);
+#endif
+}
+
+void FBoolColumn::Compile()
+{
+	const int32 NumWords = FChooserRowBitset::GetNumWords(RowValuesWithAny.Num());
+	MatchTrueMask.Reset(NumWords);
+	MatchTrueMask.SetNumZeroed(NumWords);
+	MatchFalseMask.Reset(NumWords);
+	MatchFalseMask.SetNumZeroed(NumWords);
+
+	for (int32 RowIndex = 0; RowIndex < RowValuesWithAny.Num(); ++RowIndex)
+	{
+		const EBoolColumnCellValue CellValue = RowValuesWithAny[RowIndex];
+		if (CellValue != EBoolColumnCellValue::MatchFalse)
+		{
+			FChooserRowBitset::SetMaskBit(MatchTrueMask, RowIndex);
+		}
+		if (CellValue != EBoolColumnCellValue::MatchTrue)
+		{
+			FChooserRowBitset::SetMaskBit(MatchFalseMask, RowIndex);
+		}
+	}
+}
+
 #if WITH_EDITOR
 	void FBoolColumn::AddToDetails(FInstancedPropertyBag& PropertyBag, int32 ColumnIndex, int32 RowIndex)
 	{
@@ -79,6 +141,7 @@ void FBoolColumn::Filter(FChooserEvaluationContext& Context, const FChooserIndex
 		if (uint8* Value = Result.TryGetValue())
 		{
 			RowValuesWithAny[RowIndex] = static_cast<EBoolColumnCellValue>(*Value);
+			Compile();
 		}
 	}
 #endif
\ No newline at end of file
@@ -0,0 +1,191 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "BoolColumn.h"
+#include "ChooserIndexArray.h"
+#include "ChooserRowBitset.h"
+#include "ChooserTestParameters.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Serialization/MemoryWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ChooserRowBitsetTest
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+// Random table: mostly MatchAny cells, like the sparse conditions of a locomotion table
+static void MakeColumns(int32 NumColumns, int32 NumRows, TArray<FBoolColumn>& OutColumns)
+{
+	FRandomStream Stream(0xc4005e);
+	OutColumns.SetNum(NumColumns);
+	for (FBoolColumn& Column : OutColumns)
+	{
+		Column.RowValuesWithAny.SetNum(NumRows);
+		for (EBoolColumnCellValue& CellValue : Column.RowValuesWithAny)
+		{
+			const float Roll = Stream.GetFraction();
+			CellValue = Roll < 0.6f ? EBoolColumnCellValue::MatchAny : (Roll < 0.8f ? EBoolColumnCellValue::MatchTrue : EBoolColumnCellValue::MatchFalse);
+		}
+		Column.Compile();
+	}
+}
+
+static bool RowPasses(const FBoolColumn& Column, int32 RowIndex, bool bValue)
+{
+	const EBoolColumnCellValue CellValue = Column.RowValuesWithAny[RowIndex];
+	return CellValue == EBoolColumnCellValue::MatchAny || bValue == static_cast<bool>(CellValue);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChooserRowBitsetTest, "System.Chooser.RowBitset", TestFlags)
+bool FChooserRowBitsetTest::RunTest(const FString& Parameters)
+{
+	FChooserRowBitset Rows(130);
+	TestEqual(TEXT("Init sets every row"), Rows.CountSetBits(), 130);
+	TestTrue(TEXT("Last row is set"), Rows.IsSet(129));
+
+	TArray<FBoolColumn> Columns;
+	MakeColumns(3, 130, Columns);
+	for (int32 RowIndex = 0; RowIndex < 130; ++RowIndex)
+	{
+		TestEqual(TEXT("MatchTrueMask"), FChooserRowBitset::IsMaskBitSet(Columns[0].MatchTrueMask, RowIndex), RowPasses(Columns[0], RowIndex, true));
+		TestEqual(TEXT("MatchFalseMask"), FChooserRowBitset::IsMaskBitSet(Columns[0].MatchFalseMask, RowIndex), RowPasses(Columns[0], RowIndex, false));
+	}
+
+	Columns[0].FilterBitset(true, Rows);
+	Columns[1].FilterBitset(false, Rows);
+	Columns[2].FilterBitset(true, Rows);
+
+	TArray<int32> Expected;
+	for (int32 RowIndex = 0; RowIndex < 130; ++RowIndex)
+	{
+		if (RowPasses(Columns[0], RowIndex, true) && RowPasses(Columns[1], RowIndex, false) && RowPasses(Columns[2], RowIndex, true))
+		{
+			Expected.Add(RowIndex);
+		}
+	}
+	TArray<int32> Actual;
+	Rows.ForEachSetRow([&Actual](int32 RowIndex) { Actual.Add(RowIndex); });
+	TestEqual(TEXT("Bitset rows match the per row filter"), Actual, Expected);
+
+	// A mask shorter than the table rejects the rows it doesn't cover
+	FChooserRowBitset ShortRows(130);
+	const uint64 ShortMask[] = { ~uint64(0) };
+	ShortRows.And(ShortMask);
+	TestEqual(TEXT("Rows past the end of the mask are cleared"), ShortRows.CountSetBits(), 64);
+
+	FChooserRowBitset NoRows(0);
+	TestTrue(TEXT("Empty table"), NoRows.IsEmpty());
+
+	// Rows inserted without going through Compile, like rows inserted or pasted in the editor, are compiled when the column is saved
+	FBoolColumn& EditedColumn = Columns[1];
+	EditedColumn.RowValuesWithAny.Insert(EBoolColumnCellValue::MatchFalse, 0);
+	EditedColumn.RowValuesWithAny.Add(EBoolColumnCellValue::MatchTrue);
+	TArray<uint8> SavedBytes;
+	FMemoryWriter Writer(SavedBytes);
+	FBoolColumn::StaticStruct()->SerializeItem(Writer, &EditedColumn, nullptr);
+	TestEqual(TEXT("Saved masks cover the inserted rows"), EditedColumn.MatchTrueMask.Num(), FChooserRowBitset::GetNumWords(EditedColumn.RowValuesWithAny.Num()));
+	bool bSavedMasksMatch = true;
+	for (int32 RowIndex = 0; RowIndex < EditedColumn.RowValuesWithAny.Num(); ++RowIndex)
+	{
+		bSavedMasksMatch &= FChooserRowBitset::IsMaskBitSet(EditedColumn.MatchTrueMask, RowIndex) == RowPasses(EditedColumn, RowIndex, true)
+			&& FChooserRowBitset::IsMaskBitSet(EditedColumn.MatchFalseMask, RowIndex) == RowPasses(EditedColumn, RowIndex, false);
+	}
+	TestTrue(TEXT("Saved masks match the edited rows"), bSavedMasksMatch);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChooserRowBitsetBenchmarkTest, "System.Chooser.RowBitset.Benchmark", TestFlags | EAutomationTestFlags::PerfFilter)
+bool FChooserRowBitsetBenchmarkTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumCharacters = 500;
+	constexpr int32 NumRows = 2048;
+	constexpr int32 NumColumns = 6;
+
+	TArray<FBoolColumn> Columns;
+	MakeColumns(NumColumns, NumRows, Columns);
+
+	// Input values of every character
+	FRandomStream Stream(0xb175e7);
+	TArray<uint8> Inputs;
+	Inputs.SetNum(NumCharacters * NumColumns);
+	for (uint8& Input : Inputs)
+	{
+		Input = Stream.RandHelper(2);
+	}
+
+	// What the table does: FBoolColumn::Filter tests the surviving indices of each column and copies the ones that pass to the next list
+	for (FBoolColumn& Column : Columns)
+	{
+		Column.InputValue.InitializeAs(FChooserTestBoolParameter::StaticStruct());
+	}
+	FChooserEvaluationContext Context;
+	TArray<FChooserIndexArray::FIndexData> IndexDataA;
+	TArray<FChooserIndexArray::FIndexData> IndexDataB;
+	IndexDataA.SetNumZeroed(NumRows);
+	IndexDataB.SetNumZeroed(NumRows);
+
+	uint64 IndexListChecksum = 0;
+	double StartTime = FPlatformTime::Seconds();
+	{
+		FChooserIndexArray IndexListA(IndexDataA.GetData(), NumRows);
+		FChooserIndexArray IndexListB(IndexDataB.GetData(), NumRows);
+		for (int32 Character = 0; Character < NumCharacters; ++Character)
+		{
+			FChooserIndexArray* IndexListIn = &IndexListA;
+			FChooserIndexArray* IndexListOut = &IndexListB;
+			IndexListIn->SetNum(0);
+			for (int32 RowIndex = 0; RowIndex < NumRows; ++RowIndex)
+			{
+				FChooserIndexArray::FIndexData IndexData;
+				IndexData.Index = RowIndex;
+				IndexListIn->Push(IndexData);
+			}
+			for (int32 ColumnIndex = 0; ColumnIndex < NumColumns; ++ColumnIndex)
+			{
+				FBoolColumn& Column = Columns[ColumnIndex];
+				Column.InputValue.GetMutable<FChooserTestBoolParameter>().bValue = Inputs[Character * NumColumns + ColumnIndex] != 0;
+				IndexListOut->SetNum(0);
+				Column.Filter(Context, *IndexListIn, *IndexListOut);
+				Swap(IndexListIn, IndexListOut);
+			}
+			for (const FChooserIndexArray::FIndexData& IndexData : *IndexListIn)
+			{
+				IndexListChecksum += IndexData.Index + 1;
+			}
+		}
+	}
+	const double IndexListSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// Compiled masks ANDed into one bitset, indices materialized once at the end
+	uint64 BitsetChecksum = 0;
+	StartTime = FPlatformTime::Seconds();
+	{
+		FChooserRowBitset Rows;
+		for (int32 Character = 0; Character < NumCharacters; ++Character)
+		{
+			Rows.Init(NumRows);
+			for (int32 ColumnIndex = 0; ColumnIndex < NumColumns; ++ColumnIndex)
+			{
+				const FBoolColumn& Column = Columns[ColumnIndex];
+				Rows.And(Inputs[Character * NumColumns + ColumnIndex] ? Column.MatchTrueMask : Column.MatchFalseMask);
+			}
+			Rows.ForEachSetRow([&BitsetChecksum](int32 RowIndex) { BitsetChecksum += RowIndex + 1; });
+		}
+	}
+	const double BitsetSeconds = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("Both evaluations select the same rows"), BitsetChecksum, IndexListChecksum);
+
+	AddInfo(FString::Printf(TEXT("%d characters, %d rows, %d bool columns: %.3f ms with FBoolColumn::Filter, %.3f ms with row bitsets"),
+		NumCharacters, NumRows, NumColumns, 1000.0 * IndexListSeconds, 1000.0 * BitsetSeconds));
+
+	return true;
+}
+
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
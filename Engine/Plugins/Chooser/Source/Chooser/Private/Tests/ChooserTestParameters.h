@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IChooserParameterBool.h"
+#include "ChooserTestParameters.generated.h"
+
+// Bool parameter with a value set directly by the tests, so columns can be evaluated without binding to a context object
+USTRUCT(Meta = (Hidden))
+struct FChooserTestBoolParameter : public FChooserParameterBoolBase
+{
+	GENERATED_BODY()
+public:
+
+	bool bValue = false;
+
+	virtual bool GetValue(FChooserEvaluationContext& Context, bool& OutResult) const override
+	{
+		OutResult = bValue;
+		return true;
+	}
+};
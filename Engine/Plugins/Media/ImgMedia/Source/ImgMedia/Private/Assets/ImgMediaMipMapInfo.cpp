@@ -2,12 +2,14 @@
 
 #include "Assets/ImgMediaMipMapInfo.h"
 
+#include "Assets/ImgMediaVisibleTiles.h"
 #include "ConvexVolume.h"
 #include "IImgMediaModule.h"
 #include "ImgMediaPrivate.h"
 #include "ImgMediaSceneViewExtension.h"
 
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Components/StaticMeshComponent.h"
 #include "Containers/Set.h"
 #include "Engine/Engine.h"
@@ -37,6 +39,18 @@ static TAutoConsoleVariable<float> CVarImgMediaMipLevelPadding(
 	TEXT("Value padded onto the estimated (minimum and maximum) mipmap levels used by the loader.\n"),
 	ECVF_Default);
 
+static TAutoConsoleVariable<bool> CVarImgMediaMipMapParallel(
+	TEXT("ImgMedia.MipMapParallel"),
+	true,
+	TEXT("Calculate the visible tiles of the objects using a sequence in parallel.\n"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarImgMediaMipMapTileCache(
+	TEXT("ImgMedia.MipMapTileCache"),
+	true,
+	TEXT("Reuse the visible tiles of an object from previous frames while its mesh, the views and the sequence are unchanged.\n"),
+	ECVF_Default);
+
 FImgMediaTileSelection::FImgMediaTileSelection(int32 NumTilesX, int32 NumTilesY, bool bDefaultVisibility)
 	: Tiles(bDefaultVisibility, NumTilesX * NumTilesY)
 	, Dimensions(NumTilesX, NumTilesY)
@@ -106,6 +120,7 @@ void FImgMediaTileSelection::Include(const FImgMediaTileSelection& Other)
 	ensure(Tiles.Num() == Other.Tiles.Num());
 
 	Tiles = TBitArray<>::BitwiseOR(Tiles, Other.Tiles, EBitwiseOperatorFlags::MaxSize);
+	bCachedVisibleRegionDirty = true;
 }
 
 void FImgMediaTileSelection::SetVisible(int32 TileCoordX, int32 TileCoordY)
@@ -384,270 +399,617 @@ namespace {
 		return bValid;
 	}
 
-	class FPlaneObjectInfo : public FImgMediaMipMapObjectInfo
+	FVector TransformSphericalUVsToLocationWS(const FVector2f& MeshRange, const FTransform& MeshTransform, float SphereRadius, FVector2f UV)
 	{
-	public:
-		FPlaneObjectInfo(UMeshComponent* InMeshComponent, TWeakPtr<FMediaTextureTrackerObject, ESPMode::ThreadSafe> InTracker)
-			: FImgMediaMipMapObjectInfo(InMeshComponent, MoveTemp(InTracker))
-			, PlaneSize(FVector::ZeroVector)
+		// Scale UVs by spherical mesh range
+		UV.X *= MeshRange.X / 360.0f;
+		UV.Y = (UV.Y - 0.5f) * (MeshRange.Y / 180.0f) + 0.5f;
+		// Convert from latlong UV to spherical coordinates
+		FVector2d TileCornerSpherical = FVector2d(UE_PI * UV.Y, UE_TWO_PI * UV.X);
+		FVector CornersWS = TileCornerSpherical.SphericalToUnitCartesian() * SphereRadius;
+		return MeshTransform.TransformPosition(CornersWS);
+	}
+
+	FVector2f TransformDirectionWSToSphericalUVs(const FVector2f& MeshRange, const FTransform& MeshTransform, const FVector& InDirection)
+	{
+		//Convert direction to spherical angular coordinates.
+		FVector SphereViewPoint = MeshTransform.InverseTransformVectorNoScale(InDirection);
+		SphereViewPoint.Normalize();
+		FVector2d Spherical = SphereViewPoint.UnitCartesianToSpherical();
+		Spherical.Y = FMath::Fmod(Spherical.Y + UE_TWO_PI, UE_TWO_PI);
+		//Convert spherical to 0-1 UV range.
+		FVector2f UV = FVector2f(Spherical.Y / UE_TWO_PI, Spherical.X / UE_PI);
+		// Scale UVs by spherical mesh range
+		UV.X /= MeshRange.X / 360.0f;
+		UV.Y = (UV.Y - 0.5f) / (MeshRange.Y / 180.0f) + 0.5f;
+		return UV;
+	}
+
+	// Number of tiles of the selections created by plane objects, from the fractional mip resolution.
+	FIntPoint GetPlaneNumTiles(const FSequenceInfo& SequenceInfo, int32 MipLevel)
+	{
+		if (!SequenceInfo.IsTiled())
 		{
-			// Get size of object.
-			if (MeshComponent != nullptr)
-			{
-				PlaneSize = 2.0f * MeshComponent->CalcLocalBounds().BoxExtent;
-			}
-			else
-			{
-				UE_LOG(LogImgMedia, Error, TEXT("FPlaneImgMediaMipMapObjectInfo is missing its plane mesh component."));
-			}
+			return FIntPoint(1, 1);
 		}
 
-		void CalculateVisibleTiles(const TArray<FImgMediaViewInfo>& InViewInfos, const FSequenceInfo& InSequenceInfo, TMap<int32, FImgMediaTileSelection>& VisibleTiles) const override
+		const int32 MipLevelDiv = 1 << MipLevel;
+		return FIntPoint(
+			FMath::Max(1, FMath::CeilToInt((float(SequenceInfo.Dim.X) / MipLevelDiv) / SequenceInfo.TilingDescription.TileSize.X)),
+			FMath::Max(1, FMath::CeilToInt((float(SequenceInfo.Dim.Y) / MipLevelDiv) / SequenceInfo.TilingDescription.TileSize.Y)));
+	}
+
+	// Number of tiles of the selections made by FImgMediaTileSelection::CreateForTargetMipLevel, from the truncated mip resolution.
+	FIntPoint GetTargetMipLevelNumTiles(const FSequenceInfo& SequenceInfo, int32 MipLevel)
+	{
+		const FIntPoint& TileSize = SequenceInfo.TilingDescription.TileSize;
+		if (TileSize.X == 0 || TileSize.Y == 0)
 		{
-			UMeshComponent* Mesh = MeshComponent.Get();
-			if (Mesh == nullptr || !Mesh->ShouldRender())
-			{
-				return;
-			}
-			
-			TSharedPtr<FMediaTextureTrackerObject, ESPMode::ThreadSafe> ObjectInfo = Tracker.Pin();
-			if (!ObjectInfo.IsValid())
+			return FIntPoint(1, 1);
+		}
+
+		const int32 MipLevelDiv = 1 << MipLevel;
+		return FIntPoint(
+			FMath::Max(1, FMath::CeilToInt(float(SequenceInfo.Dim.X / MipLevelDiv) / TileSize.X)),
+			FMath::Max(1, FMath::CeilToInt(float(SequenceInfo.Dim.Y / MipLevelDiv) / TileSize.Y)));
+	}
+} //end anonymous namespace
+
+namespace UE::ImgMedia::Private
+{
+	void CalculatePlaneVisibleTiles(const FPlaneVisibleTilesParams& Params, const FImgMediaViewInfo& ViewInfo, const FSequenceInfo& InSequenceInfo,
+		TArray<float>& CornerMipLevels, TMap<int32, FImgMediaTileSelection>& VisibleTiles)
+	{
+		const FVector& PlaneSize = Params.PlaneSize;
+		const float MipMapBias = Params.MipMapBias;
+		const float MipMapLevelPadding = Params.MipMapLevelPadding;
+
+		const FIntPoint& SequenceTileNum = InSequenceInfo.TilingDescription.TileNum;
+
+		// To avoid calculating tile corner mip levels multiple times over, we cache them in this array (in mip0 tile address space).
+		const int32 MaxCornerX = SequenceTileNum.X + 1;
+		CornerMipLevels.SetNumUninitialized((SequenceTileNum.X + 1) * (SequenceTileNum.Y + 1));
+		for (float& Level : CornerMipLevels)
+		{
+			Level = -1.0f;
+		}
+
+		const FTransform& MeshTransform = Params.MeshTransform;
+		const FVector MeshScale = MeshTransform.GetScale3D();
+
+		FVector PlaneCornerWS = MeshTransform.TransformPosition(FVector(0, -0.5f * PlaneSize.Y, 0.5f * PlaneSize.Z));
+		FVector DirXWS = MeshTransform.TransformVector(FVector(0, PlaneSize.Y, 0));
+		FVector DirYWS = MeshTransform.TransformVector(FVector(0, 0, -PlaneSize.Z));
+		FVector TexelOffsetXWS = MeshTransform.TransformVector(FVector(0, PlaneSize.Y / InSequenceInfo.Dim.X, 0));
+		FVector TexelOffsetYWS = MeshTransform.TransformVector(FVector(0, 0, -PlaneSize.Z / InSequenceInfo.Dim.Y));
+
+		// Get frustum.
+		FConvexVolume ViewFrustum;
+		GetViewFrustumBounds(ViewFrustum, ViewInfo.OverscanViewProjectionMatrix, false, false);
+
+		const int32 MaxLevel = InSequenceInfo.NumMipLevels - 1;
+		const int MipLevelDiv = 1 << MaxLevel;
+
+		FIntPoint CurrentNumTiles = FIntPoint(1, 1);
+
+		if (InSequenceInfo.IsTiled())
+		{
+			CurrentNumTiles.X = FMath::CeilToInt(float(InSequenceInfo.Dim.X / MipLevelDiv) / InSequenceInfo.TilingDescription.TileSize.X);
+			CurrentNumTiles.Y = FMath::CeilToInt(float(InSequenceInfo.Dim.Y / MipLevelDiv) / InSequenceInfo.TilingDescription.TileSize.Y);
+		}
+
+		// Starting with tiles at the highest mip level
+		TQueue<FIntVector> Tiles;
+		for (int32 TileY = 0; TileY < CurrentNumTiles.Y; ++TileY)
+		{
+			for (int32 TileX = 0; TileX < CurrentNumTiles.X; ++TileX)
 			{
-				return;
+				Tiles.Enqueue(FIntVector(TileX, TileY, MaxLevel));
 			}
+		}
 
-			if (InViewInfos.IsEmpty())
+		struct FBatchTile
+		{
+			FIntVector Tile;
+			FIntPoint NumTiles;
+			FVector2f PartialTileNum;
+		};
+
+		// Process all visible tiles with a (quadtree) breadth-first search. Tiles are dequeued in batches to test their bounds
+		// against the frustum at once, sub-tiles are still enqueued in the same order.
+		while (!Tiles.IsEmpty())
+		{
+			FTileSphereBatch Batch;
+			FBatchTile BatchTiles[FTileSphereBatch::MaxNum];
+
+			FIntVector Tile;
+			while (Batch.Num < FTileSphereBatch::MaxNum && Tiles.Dequeue(Tile))
 			{
-				return;
-			}
+				// Calculate the number of tiles at this mip level
+				const FIntPoint NumTiles = GetPlaneNumTiles(InSequenceInfo, Tile.Z);
 
-			const float MipMapBias = ObjectInfo->MipMapLODBias;
-			const float MipMapLevelPadding = FMath::Max(CVarImgMediaMipLevelPadding.GetValueOnAnyThread(), 0.0f);
+				// Exclude subdivided tiles (enqueued below) that are not present (i.e. mipped sequences with odd number of tiles)
+				if (Tile.X >= NumTiles.X || Tile.Y >= NumTiles.Y)
+				{
+					continue;
+				}
 
-			const FIntPoint& SequenceTileNum = InSequenceInfo.TilingDescription.TileNum;
+				const FVector2f PartialTileNum = InSequenceInfo.GetPartialTileNum(Tile.Z);
 
-			// To avoid calculating tile corner mip levels multiple times over, we cache them in this array.
-			CornerMipLevelsCached.SetNum((SequenceTileNum.X + 1) * (SequenceTileNum.Y + 1));
+				// Calculate the tile location in world-space
+				float StepX = float(Tile.X + 0.5f) / PartialTileNum.X;
+				float StepY = float(Tile.Y + 0.5f) / PartialTileNum.Y;
+				FVector TileCenterWS = PlaneCornerWS + (DirXWS * StepX + DirYWS * StepY);
 
-			const FTransform MeshTransform = Mesh->GetComponentTransform();
-			const FVector MeshScale = Mesh->GetComponentScale();
+				// Calculate the tile radius in world space
+				FVector TileSizeWS = (PlaneSize * MeshScale) / FVector(1, PartialTileNum.X, PartialTileNum.Y);
+				float TileRadiusInWS = 0.5f * (float)FMath::Sqrt(2 * FMath::Square(TileSizeWS.GetAbsMax()));
+
+				BatchTiles[Batch.Num] = FBatchTile{ Tile, NumTiles, PartialTileNum };
+				Batch.Add(TileCenterWS, TileRadiusInWS);
+			}
 
-			FVector PlaneCornerWS = MeshTransform.TransformPosition(FVector(0, -0.5f * PlaneSize.Y, 0.5f * PlaneSize.Z));
-			FVector DirXWS = MeshTransform.TransformVector(FVector(0, PlaneSize.Y, 0));
-			FVector DirYWS = MeshTransform.TransformVector(FVector(0, 0, -PlaneSize.Z));
-			FVector TexelOffsetXWS = MeshTransform.TransformVector(FVector(0, PlaneSize.Y / InSequenceInfo.Dim.X, 0));
-			FVector TexelOffsetYWS = MeshTransform.TransformVector(FVector(0, 0, -PlaneSize.Z / InSequenceInfo.Dim.Y));
+			// Now we check if tile spherical bounds are in view.
+			const uint32 IntersectMask = IntersectSpheres(ViewFrustum, Batch);
 
-			for (const FImgMediaViewInfo& ViewInfo : InViewInfos)
+			for (int32 BatchIndex = 0; BatchIndex < Batch.Num; ++BatchIndex)
 			{
-				if (IsPrimitiveComponentHidden(Mesh->GetPrimitiveSceneId(), ViewInfo))
+				if ((IntersectMask & (1u << BatchIndex)) == 0)
 				{
 					continue;
 				}
 
-				ResetMipLevelCache();
+				const FIntVector& CurrentTile = BatchTiles[BatchIndex].Tile;
+				const FIntPoint& CurrentTileNum = BatchTiles[BatchIndex].NumTiles;
+				const FVector2f& CurrentPartialTileNum = BatchTiles[BatchIndex].PartialTileNum;
+				const int32 CurrentMipLevel = CurrentTile.Z;
 
-				// Get frustum.
-				FConvexVolume ViewFrustum;
-				GetViewFrustumBounds(ViewFrustum, ViewInfo.OverscanViewProjectionMatrix, false, false);
+				// Calculate the visible mip level range over all tile corners.
+				int32 NumVisibleCorners = 0;
+				FIntVector2 MipLevelRange = FIntVector2(TNumericLimits<int32>::Max(), 0);
+				for (int32 CornerY = 0; CornerY < 2; ++CornerY)
+				{
+					for (int32 CornerX = 0; CornerX < 2; ++CornerX)
+					{
+						float CalculatedLevel;
+						int32 TileCornerX = CurrentTile.X + CornerX;
+						int32 TileCornerY = CurrentTile.Y + CornerY;
+
+						// First we query the cached corner mip levels.
+						FIntPoint BaseLevelCorner;
+						BaseLevelCorner.X = FMath::Clamp(TileCornerX << CurrentMipLevel, 0, SequenceTileNum.X);
+						BaseLevelCorner.Y = FMath::Clamp(TileCornerY << CurrentMipLevel, 0, SequenceTileNum.Y);
+						float& CachedLevel = CornerMipLevels[BaseLevelCorner.Y * MaxCornerX + BaseLevelCorner.X];
+						bool bValidLevel = CachedLevel >= 0.0f;
+						CalculatedLevel = CachedLevel;
+
+						// If not found, calculate and cache it.
+						if (!bValidLevel)
+						{
+							float CornerStepX = TileCornerX / CurrentPartialTileNum.X;
+							float CornerStepY = TileCornerY / CurrentPartialTileNum.Y;
+							FVector CornersWS = PlaneCornerWS + (DirXWS * CornerStepX + DirYWS * CornerStepY);
 
-				const int32 MaxLevel = InSequenceInfo.NumMipLevels - 1;
-				int MipLevelDiv = 1 << MaxLevel;
+							if (CalculateMipLevelAniso(ViewInfo, CornersWS, CornersWS + TexelOffsetXWS, CornersWS + TexelOffsetYWS, CalculatedLevel))
+							{
+								CalculatedLevel += MipMapBias + ViewInfo.MaterialTextureMipBias;
 
-				FIntPoint CurrentNumTiles = FIntPoint(1, 1);
+								CachedLevel = CalculatedLevel;
+								bValidLevel = true;
+							}
+						}
 
-				if (InSequenceInfo.IsTiled())
+						if (bValidLevel)
+						{
+							MipLevelRange[0] = FMath::Min(MipLevelRange[0], FMath::Clamp(FMath::FloorToInt32(CalculatedLevel - MipMapLevelPadding), 0, MaxLevel));
+							MipLevelRange[1] = FMath::Max(MipLevelRange[1], FMath::Clamp(FMath::CeilToInt32(CalculatedLevel + MipMapLevelPadding), 0, MaxLevel));
+							NumVisibleCorners++;
+						}
+					}
+				}
+
+				// As an approximation, we force the lowest mip to 0 if only some corners are behind camera.
+				if (NumVisibleCorners > 0 && NumVisibleCorners < 4)
 				{
-					CurrentNumTiles.X = FMath::CeilToInt(float(InSequenceInfo.Dim.X / MipLevelDiv) / InSequenceInfo.TilingDescription.TileSize.X);
-					CurrentNumTiles.Y = FMath::CeilToInt(float(InSequenceInfo.Dim.Y / MipLevelDiv) / InSequenceInfo.TilingDescription.TileSize.Y);
+					MipLevelRange[0] = 0;
 				}
 
-				// Starting with tiles at the highest mip level
-				TQueue<FIntVector> Tiles;
-				for (int32 TileY = 0; TileY < CurrentNumTiles.Y; ++TileY)
+				// If the lowest (calculated) mip level is below our current mip level, enqueue all 4 sub-tiles for further processing.
+				if (MipLevelRange[0] < CurrentMipLevel)
 				{
-					for (int32 TileX = 0; TileX < CurrentNumTiles.X; ++TileX)
+					for (int32 SubY = 0; SubY < FMath::Min(SequenceTileNum.Y, 2); ++SubY)
 					{
-						Tiles.Enqueue(FIntVector(TileX, TileY, MaxLevel));
+						for (int32 SubX = 0; SubX < FMath::Min(SequenceTileNum.X, 2); ++SubX)
+						{
+							FIntVector SubTile = FIntVector((CurrentTile.X << 1) + SubX, (CurrentTile.Y << 1) + SubY, CurrentMipLevel - 1);
+							Tiles.Enqueue(SubTile);
+						}
 					}
 				}
 
-				// Process all visible tiles with a (quadtree) breadth-first search
-				while (!Tiles.IsEmpty())
+				// If the highest (calculated) mip level equals or exceeds our current mip level, we register the tile as visible.
+				if (MipLevelRange[1] >= CurrentMipLevel)
 				{
-					FIntVector Tile;
-					Tiles.Dequeue(Tile);
+					if (!VisibleTiles.Contains(CurrentMipLevel))
+					{
+						VisibleTiles.Emplace(CurrentMipLevel, FImgMediaTileSelection(CurrentTileNum.X, CurrentTileNum.Y));
+					}
+
+					VisibleTiles[CurrentMipLevel].SetVisible(CurrentTile.X, CurrentTile.Y);
+				}
+#if false
+#if WITH_EDITOR
+				// Enable this to draw a sphere where each tile is.
+				const FVector TileCenterWS(Batch.CenterX[BatchIndex], Batch.CenterY[BatchIndex], Batch.CenterZ[BatchIndex]);
+				const float TileRadiusInWS = Batch.Radius[BatchIndex];
+				Async(EAsyncExecution::TaskGraphMainThread, [TileCenterWS, TileRadiusInWS]()
+					{
+						UWorld* World = GEditor->GetEditorWorldContext().World();
+						DrawDebugSphere(World, TileCenterWS, TileRadiusInWS, 8, FColor::Red, false, 0.05f);
+					});
+#endif // WITH_EDITOR
+#endif // false
+			}
+		}
+	}
+
+	void CalculateSphereVisibleTiles(const FSphereVisibleTilesParams& Params, const FImgMediaViewInfo& ViewInfo, const FSequenceInfo& InSequenceInfo,
+		TMap<int32, FImgMediaTileSelection>& VisibleTiles, int32& InOutMipLevelToUpscale)
+	{
+		const FVector2f& MeshRange = Params.MeshRange;
+		const float MipMapBias = Params.MipMapBias;
+		const float MipMapLevelPadding = Params.MipMapLevelPadding;
+		const FTransform& MeshTransform = Params.MeshTransform;
+		const int32 MaxLevel = InSequenceInfo.NumMipLevels - 1;
+
+		// Include all tiles containted in the visible UV region
+		const FIntPoint& SequenceTileNum = InSequenceInfo.TilingDescription.TileNum;
+		const FVector2f SequencePartialTileNum = InSequenceInfo.GetPartialTileNum();
+
+		const float PixelDimX = 1.0f / InSequenceInfo.Dim.X;
+		const float PixelDimY = 1.0f / InSequenceInfo.Dim.Y;
 
-					int32 CurrentMipLevel = Tile.Z;
-					MipLevelDiv = 1 << CurrentMipLevel;
+		const FVector ApproxTileSizeWS = MeshTransform.GetScale3D() * (UE_TWO_PI * Params.SphereRadius) / FMath::Max(SequencePartialTileNum.X, SequencePartialTileNum.Y);
+		const int32 TotalNumTiles = FMath::CeilToInt32(SequencePartialTileNum.X * SequencePartialTileNum.Y);
+
+		const float ApproxTileRadiusInWS = 0.5f * UE_SQRT_2 * ApproxTileSizeWS.GetAbsMax();
+
+		// Does user want to upscale specific mip level?
+		const int32 MipLevelToUpscaleExcludingPoles = Params.MipLevelToUpscale;
+
+		// Does user want to reduce the load at the poles?
+		const bool bAdaptivePoleMipUpscaling = Params.bAdaptivePoleMipUpscaling;
+
+		// Analytical derivation of visible tiles from the view frustum, given a sphere presumed to be infinitely large
+		FConvexVolume ViewFrustum;
+		GetViewFrustumBounds(ViewFrustum, ViewInfo.OverscanViewProjectionMatrix, false, false);
+
+		// Approximated UV coordinate for a camera centered inside the sphere
+		FVector2f ViewUV = TransformDirectionWSToSphericalUVs(MeshRange, MeshTransform, ViewInfo.ViewDirection);
+
+		// 20 Degrees equates to total 11.1% of a sphere for top and bottom poles.
+		const float PoleEdgeDegrees = 20.f;
+		// Angle from the pole at which upscaling is enabled automatically.
+		const float UpscalingEnabledEdge = 10.f;
+
+		// NumOfTilesToLoadAtThePole - how many tiles does this sphere expect to load without upscaling.
+		// PoleMipBias - automatically calculated value of which mip to upscale.
+		int32 NumOfTilesToLoadAtThePole = 0, PoleMipBias = -1;
+		// This number represents a factor by which we need to reduce the number of tiles loaded.
+		// Ex: Visible tiles at mip 0 at a 20 degree pole = 100. To improve perf we should load 100/TileReductionFactor = 50 tiles.
+		const float TileReductionFactor = 0.5f;
+		if (bAdaptivePoleMipUpscaling)
+		{
+			NumOfTilesToLoadAtThePole = FMath::CeilToInt32(SequencePartialTileNum.X * ((float)SequencePartialTileNum.Y * PoleEdgeDegrees / 180.f))* TileReductionFactor;
+			PoleMipBias = FMath::CeilToInt32(FMath::LogX(4., TotalNumTiles/ NumOfTilesToLoadAtThePole));
+		}
+
+		// Everything above this value gets upscaled.
+		float TipUpscalingEdgePercent = (1.f - PoleEdgeDegrees / 90.f);
+
+		// At which point do we consider that tip is in the view.
+		float TipInTheViewThresholdPercent = (1.f - UpscalingEnabledEdge / 90.f);
+
+		// The following bool indicates if camera is looking at the tip and if we should not load tiles above TipUpscalingEdge
+		bool bPoleTipIsInView = false;
+
+		auto ProcessTileRow = [&](int32 TileY)
+		{
+			float TileVMin = 0, TileVMax = 0;
+			if (bAdaptivePoleMipUpscaling)
+			{
+				TileVMin = ((((float)TileY) / SequencePartialTileNum.Y) - 0.5) * 2.;
+				TileVMax = ((((float)TileY + 1.) / SequencePartialTileNum.Y) - 0.5) * 2.;
+			}
+
+			for (int32 FirstTileX = 0; FirstTileX < SequenceTileNum.X; FirstTileX += FTileSphereBatch::MaxNum)
+			{
+				// Tile locations don't depend on each other, so a batch of them is tested against the frustum at once
+				FTileSphereBatch Batch;
+				FVector2f BatchTileUVs[FTileSphereBatch::MaxNum];
+				FVector BatchTileLocationsWS[FTileSphereBatch::MaxNum];
+
+				const int32 EndTileX = FMath::Min(FirstTileX + FTileSphereBatch::MaxNum, SequenceTileNum.X);
+				for (int32 TileX = FirstTileX; TileX < EndTileX; ++TileX)
+				{
+					const FVector2f TileMinCornerUV = FVector2f((float)TileX, (float)TileY) / SequencePartialTileNum;
+					const FVector2f TileMaxCornerUV = FVector2f(TileX + 1.0f, TileY + 1.0f) / SequencePartialTileNum;
+					FVector2f TileUV = 0.5f * (TileMinCornerUV + TileMaxCornerUV);
+					float CollisionSphereRadius = ApproxTileRadiusInWS;
 
-					if (InSequenceInfo.IsTiled())
+					// If the view uv is inside the tile, we use its location directly. Helpful for sequences with no tiles.
+					if (ViewUV.ComponentwiseAllGreaterOrEqual(TileMinCornerUV) && ViewUV.ComponentwiseAllLessThan(TileMaxCornerUV))
 					{
-						// Calculate the number of tiles at this mip level
-						CurrentNumTiles.X = FMath::Max(1, FMath::CeilToInt((float(InSequenceInfo.Dim.X) / MipLevelDiv) / InSequenceInfo.TilingDescription.TileSize.X));
-						CurrentNumTiles.Y = FMath::Max(1, FMath::CeilToInt((float(InSequenceInfo.Dim.Y) / MipLevelDiv) / InSequenceInfo.TilingDescription.TileSize.Y));
+						TileUV = ViewUV;
+						CollisionSphereRadius = 0.0f;
 					}
 
-					FVector2f CurrentPartialTileNum = InSequenceInfo.GetPartialTileNum(CurrentMipLevel);
+					// The resulting location used for tile mip level estimation (either directly at the view center or its closest tile corner).
+					BatchTileUVs[Batch.Num] = TileUV;
+					BatchTileLocationsWS[Batch.Num] = TransformSphericalUVsToLocationWS(MeshRange, MeshTransform, Params.SphereRadius, TileUV);
+					Batch.Add(BatchTileLocationsWS[Batch.Num], CollisionSphereRadius);
+				}
+
+				const uint32 IntersectMask = IntersectSpheres(ViewFrustum, Batch);
 
-					// Exclude subdivided tiles (enqueued below) that are not present (i.e. mipped sequences with odd number of tiles)
-					if (Tile.X >= CurrentNumTiles.X || Tile.Y >= CurrentNumTiles.Y)
+				for (int32 BatchIndex = 0; BatchIndex < Batch.Num; ++BatchIndex)
+				{
+					if ((IntersectMask & (1u << BatchIndex)) == 0)
 					{
 						continue;
 					}
 
-					// Calculate the tile location in world-space
-					float StepX = float(Tile.X + 0.5f) / CurrentPartialTileNum.X;
-					float StepY = float(Tile.Y + 0.5f) / CurrentPartialTileNum.Y;
-					FVector TileCenterWS = PlaneCornerWS + (DirXWS * StepX + DirYWS * StepY);
+					const int32 TileX = FirstTileX + BatchIndex;
+					const FVector2f& TileUV = BatchTileUVs[BatchIndex];
+					const FVector& TileLocationWS = BatchTileLocationsWS[BatchIndex];
 
-					// Calculate the tile radius in world space
-					FVector TileSizeWS = (PlaneSize * MeshScale) / FVector(1, CurrentPartialTileNum.X, CurrentPartialTileNum.Y);
-					float TileRadiusInWS = 0.5f * (float)FMath::Sqrt(2 * FMath::Square(TileSizeWS.GetAbsMax()));
-
-					// Now we check if tile spherical bounds are in view.
-					if (ViewFrustum.IntersectSphere(TileCenterWS, TileRadiusInWS))
+					if (bAdaptivePoleMipUpscaling && (TileVMin < -TipInTheViewThresholdPercent || TileVMax > TipInTheViewThresholdPercent))
 					{
-						// Calculate the visible mip level range over all tile corners.
-						int32 NumVisibleCorners = 0;
-						FIntVector2 MipLevelRange = FIntVector2(TNumericLimits<int32>::Max(), 0);
-						for (int32 CornerY = 0; CornerY < 2; ++CornerY)
-						{
-							for (int32 CornerX = 0; CornerX < 2; ++CornerX)
-							{
-								float CalculatedLevel;
-								int32 TileCornerX = Tile.X + CornerX;
-								int32 TileCornerY = Tile.Y + CornerY;
-
-								// First we query the cached corner mip levels.
-								int32 MaxCornerX = SequenceTileNum.X + 1;
-								int32 MaxCornerY = SequenceTileNum.Y + 1;
-								FIntPoint BaseLevelCorner;
-								BaseLevelCorner.X = FMath::Clamp(TileCornerX << CurrentMipLevel, 0, SequenceTileNum.X);
-								BaseLevelCorner.Y = FMath::Clamp(TileCornerY << CurrentMipLevel, 0, SequenceTileNum.Y);
-								bool bValidLevel = GetCachedMipLevel(BaseLevelCorner.X, BaseLevelCorner.Y, MaxCornerX, CalculatedLevel);
-
-								// If not found, calculate and cache it.
-								if (!bValidLevel)
-								{
-									float CornerStepX = TileCornerX / CurrentPartialTileNum.X;
-									float CornerStepY = TileCornerY / CurrentPartialTileNum.Y;
-									FVector CornersWS = PlaneCornerWS + (DirXWS * CornerStepX + DirYWS * CornerStepY);
+						bPoleTipIsInView = true;
+						// Queue upscaling of lower quality mips into this mip.
+						InOutMipLevelToUpscale = FMath::Max(PoleMipBias, MipLevelToUpscaleExcludingPoles);
+					}
 
-									if (CalculateMipLevelAniso(ViewInfo, CornersWS, CornersWS + TexelOffsetXWS, CornersWS + TexelOffsetYWS, CalculatedLevel))
-									{
-										CalculatedLevel += MipMapBias + ViewInfo.MaterialTextureMipBias;
+					float CalculatedLevel;
+					FIntVector2 MipLevelRange;
 
-										SetCachedMipLevel(BaseLevelCorner.X, BaseLevelCorner.Y, MaxCornerX, CalculatedLevel);
-										bValidLevel = true;
-									}
-								}
-								
-								if (bValidLevel)
-								{
-									MipLevelRange[0] = FMath::Min(MipLevelRange[0], FMath::Clamp(FMath::FloorToInt32(CalculatedLevel - MipMapLevelPadding), 0, MaxLevel));
-									MipLevelRange[1] = FMath::Max(MipLevelRange[1], FMath::Clamp(FMath::CeilToInt32(CalculatedLevel + MipMapLevelPadding), 0, MaxLevel));
-									NumVisibleCorners++;
-								}
-							}
-						}
+					const FVector TexelOffXWS = TransformSphericalUVsToLocationWS(MeshRange, MeshTransform, Params.SphereRadius, TileUV + FVector2f(PixelDimX, 0));
+					const FVector TexelOffYWS = TransformSphericalUVsToLocationWS(MeshRange, MeshTransform, Params.SphereRadius, TileUV + FVector2f(0, PixelDimY));
 
-						// As an approximation, we force the lowest mip to 0 if only some corners are behind camera.
-						if (NumVisibleCorners > 0 && NumVisibleCorners < 4)
+					if (CalculateMipLevelAniso(ViewInfo, TileLocationWS, TexelOffXWS, TexelOffYWS, CalculatedLevel))
+					{
+						CalculatedLevel += MipMapBias + ViewInfo.MaterialTextureMipBias;
+
+						MipLevelRange[0] = FMath::FloorToInt32(CalculatedLevel - MipMapLevelPadding);
+						MipLevelRange[1] = FMath::CeilToInt32(CalculatedLevel + MipMapLevelPadding);
+
+						const bool bIsTileAtPole = (TileY == 0 || TileY == SequenceTileNum.Y - 1);
+						/*
+						 * Since we estimate mip levels only once per tile here, this method very much approximates the
+						 * per-fragment hardware mip selection that occurs during rasterization. Discontinuities can
+						 * therefore appear where variance within one tile is strongest: the approximation delta is
+						 * indeed larger at the poles due to latlong spherical projection. So as a mitigation for pole
+						 * discontinuities, we artifically increase their mip level range, and accept the added read cost.
+						 *
+						 * NOTE: This should now be disabled by default since bAdaptivePoleMipUpscaling defaults to true.
+						 */
+						if (!bAdaptivePoleMipUpscaling && bIsTileAtPole)
 						{
-							MipLevelRange[0] = 0;
+							MipLevelRange[0]--;
+							MipLevelRange[1]++;
 						}
 
-						// If the lowest (calculated) mip level is below our current mip level, enqueue all 4 sub-tiles for further processing.
-						if (MipLevelRange[0] < CurrentMipLevel)
+						MipLevelRange[0] = FMath::Clamp(MipLevelRange[0], 0, MaxLevel);
+						MipLevelRange[1] = FMath::Clamp(MipLevelRange[1], 0, MaxLevel);
+
+						for (int32 Level = MipLevelRange[0]; Level <= MipLevelRange[1]; ++Level)
 						{
-							for (int32 SubY = 0; SubY < FMath::Min(SequenceTileNum.Y, 2); ++SubY)
+							if (bAdaptivePoleMipUpscaling && Level < PoleMipBias)
 							{
-								for (int32 SubX = 0; SubX < FMath::Min(SequenceTileNum.X, 2); ++SubX)
+								// Anything above TipUpscalingEdgePercent will be upscaled.
+								if (bPoleTipIsInView && (TileVMin < -TipUpscalingEdgePercent || TileVMax > TipUpscalingEdgePercent))
 								{
-									FIntVector SubTile = FIntVector((Tile.X << 1) + SubX, (Tile.Y << 1) + SubY, CurrentMipLevel - 1);
-									Tiles.Enqueue(SubTile);
+									continue;
 								}
 							}
-						}
 
-						// If the highest (calculated) mip level equals or exceeds our current mip level, we register the tile as visible.
-						if (MipLevelRange[1] >= CurrentMipLevel)
-						{
-							if (!VisibleTiles.Contains(CurrentMipLevel))
+							if (!VisibleTiles.Contains(Level))
 							{
-								VisibleTiles.Emplace(CurrentMipLevel, FImgMediaTileSelection(CurrentNumTiles.X, CurrentNumTiles.Y));
+								VisibleTiles.Emplace(Level, FImgMediaTileSelection::CreateForTargetMipLevel(InSequenceInfo.Dim, InSequenceInfo.TilingDescription.TileSize, Level, false));
 							}
 
-							VisibleTiles[CurrentMipLevel].SetVisible(Tile.X, Tile.Y);
+							const int MipLevelDiv = 1 << Level;
+
+							VisibleTiles[Level].SetVisible(TileX / MipLevelDiv, TileY / MipLevelDiv);
 						}
+					}
 #if false
 #if WITH_EDITOR
-						// Enable this to draw a sphere where each tile is.
-						Async(EAsyncExecution::TaskGraphMainThread, [TileCenterWS, TileRadiusInWS]()
-							{
-								UWorld* World = GEditor->GetEditorWorldContext().World();
-								DrawDebugSphere(World, TileCenterWS, TileRadiusInWS, 8, FColor::Red, false, 0.05f);
-							});
+					float DebugSphereRadius = FMath::Max((float)Batch.Radius[BatchIndex], MeshTransform.GetMaximumAxisScale());
+					// Enable this to draw a sphere where each tile is.
+					Async(EAsyncExecution::TaskGraphMainThread, [TileLocationWS, DebugSphereRadius]()
+						{
+							UWorld* World = GEditor->GetEditorWorldContext().World();
+							DrawDebugSphere(World, TileLocationWS, DebugSphereRadius, 8, FColor::Red, false, 0.05f);
+						});
 #endif // WITH_EDITOR
 #endif // false
-					}
 				}
 			}
+		};
+
+		int32 MiddleRowIndex = FMath::FloorToInt32(((float)SequenceTileNum.Y) / 2.);
+
+		for (int32 TileY = 0; TileY < MiddleRowIndex; ++TileY)
+		{
+			ProcessTileRow(TileY);
 		}
+		for (int32 TileY = SequenceTileNum.Y - 1; TileY >= MiddleRowIndex; TileY--)
+		{
+			ProcessTileRow(TileY);
+		}
+	}
 
-	private:
+	uint32 IntersectSpheres(const FConvexVolume& Frustum, const FTileSphereBatch& Spheres)
+	{
+		const VectorRegister4Double CenterX = VectorLoad(Spheres.CenterX);
+		const VectorRegister4Double CenterY = VectorLoad(Spheres.CenterY);
+		const VectorRegister4Double CenterZ = VectorLoad(Spheres.CenterZ);
+		const VectorRegister4Double Radius = VectorLoad(Spheres.Radius);
 
-		/** Convenience function to get a cached calculated mip level (in mip0 tile address space). */
-		FORCEINLINE bool GetCachedMipLevel(int32 Address0X, int32 Address0Y, int32 RowSize, float& OutCalculatedLevel) const
+		VectorRegister4Double Outside = VectorZeroDouble();
+		for (const FPlane& Plane : Frustum.Planes)
 		{
-			const int32 Index = Address0Y * RowSize + Address0X;
+			// A sphere is outside when its center is further than its radius in front of any plane
+			VectorRegister4Double Distance = VectorMultiplyAdd(CenterX, VectorSetFloat1(Plane.X), VectorSetFloat1(-Plane.W));
+			Distance = VectorMultiplyAdd(CenterY, VectorSetFloat1(Plane.Y), Distance);
+			Distance = VectorMultiplyAdd(CenterZ, VectorSetFloat1(Plane.Z), Distance);
+			Outside = VectorBitwiseOr(Outside, VectorCompareGT(Distance, Radius));
+		}
+
+		return ~(uint32)VectorMaskBits(Outside) & ((1u << Spheres.Num) - 1);
+	}
 
-			if (CornerMipLevelsCached[Index] >= 0.0f)
+	void MergeVisibleTiles(TMap<int32, FImgMediaTileSelection>& Into, const TMap<int32, FImgMediaTileSelection>& From, const FSequenceInfo& SequenceInfo)
+	{
+		for (const TPair<int32, FImgMediaTileSelection>& MipTiles : From)
+		{
+			FImgMediaTileSelection* Existing = Into.Find(MipTiles.Key);
+			if (Existing == nullptr)
 			{
-				OutCalculatedLevel = CornerMipLevelsCached[Index];
-				
-				return true;
+				Into.Add(MipTiles.Key, MipTiles.Value);
 			}
+			else if (GetPlaneNumTiles(SequenceInfo, MipTiles.Key) == GetTargetMipLevelNumTiles(SequenceInfo, MipTiles.Key))
+			{
+				Existing->Include(MipTiles.Value);
+			}
+			else
+			{
+				// Odd mip resolutions, plane and sphere selections of this level don't have the same number of tiles
+				for (const FIntPoint& Coord : MipTiles.Value.GetVisibleCoordinates())
+				{
+					Existing->SetVisible(Coord.X, Coord.Y);
+				}
+			}
+		}
+	}
+}
+
+namespace {
+	using namespace UE::ImgMedia::Private;
+
+	bool IsSameSequence(const FSequenceInfo& A, const FSequenceInfo& B)
+	{
+		return A.Dim == B.Dim && A.NumMipLevels == B.NumMipLevels
+			&& A.TilingDescription.TileNum == B.TilingDescription.TileNum && A.TilingDescription.TileSize == B.TilingDescription.TileSize;
+	}
 
-			return false;
+	// Compares what the tile calculations read, views hiding the mesh are left out of the cached views instead
+	bool IsSameView(const FImgMediaViewInfo& A, const FImgMediaViewInfo& B)
+	{
+		return A.ViewDirection == B.ViewDirection && A.ViewProjectionMatrix == B.ViewProjectionMatrix
+			&& A.OverscanViewProjectionMatrix == B.OverscanViewProjectionMatrix && A.ViewportRect == B.ViewportRect
+			&& A.MaterialTextureMipBias == B.MaterialTextureMipBias;
+	}
+
+	void GetViewsShowingMesh(const TArray<FImgMediaViewInfo>& InViewInfos, FPrimitiveComponentId ComponentId, TArray<const FImgMediaViewInfo*, TInlineAllocator<4>>& OutViewInfos)
+	{
+		for (const FImgMediaViewInfo& ViewInfo : InViewInfos)
+		{
+			if (!IsPrimitiveComponentHidden(ComponentId, ViewInfo))
+			{
+				OutViewInfos.Add(&ViewInfo);
+			}
 		}
+	}
 
-		/** Convenience function to cache a calculated mip level (in mip0 tile address space). */
-		FORCEINLINE void SetCachedMipLevel(int32 Address0X, int32 Address0Y, int32 RowSize, float InCalculatedLevel) const
+	/**
+	 * Visible tiles of an object kept across frames, recalculated only when the mesh, views, sequence or settings change.
+	 * Objects are evaluated for render and display resolution views in turn, so an entry is kept for each.
+	 */
+	template<typename ParamsType>
+	class TVisibleTilesCache
+	{
+	public:
+		struct FEntry
+		{
+			ParamsType Params;
+			FSequenceInfo SequenceInfo;
+			TArray<FImgMediaViewInfo> ViewInfos;
+			TMap<int32, FImgMediaTileSelection> VisibleTiles;
+			int32 MipLevelToUpscale = -1;
+		};
+
+		/** Returns the entry calculated for these inputs, or nullptr if there is none. */
+		FEntry* Find(const ParamsType& Params, const FSequenceInfo& SequenceInfo, TConstArrayView<const FImgMediaViewInfo*> ViewInfos)
 		{
-			CornerMipLevelsCached[Address0Y * RowSize + Address0X] = InCalculatedLevel;
+			if (!CVarImgMediaMipMapTileCache.GetValueOnAnyThread())
+			{
+				return nullptr;
+			}
+
+			for (FEntry& Entry : Entries)
+			{
+				if (Entry.Params == Params && IsSameSequence(Entry.SequenceInfo, SequenceInfo) && Entry.ViewInfos.Num() == ViewInfos.Num())
+				{
+					bool bSameViews = true;
+					for (int32 Index = 0; bSameViews && Index < ViewInfos.Num(); ++Index)
+					{
+						bSameViews = IsSameView(Entry.ViewInfos[Index], *ViewInfos[Index]);
+					}
+
+					if (bSameViews)
+					{
+						return &Entry;
+					}
+				}
+			}
+
+			return nullptr;
 		}
 
-		/** Convenience function to reset the cache. */
-		FORCEINLINE void ResetMipLevelCache() const
+		/** Returns an empty entry for these inputs to calculate the visible tiles into, replacing the oldest one. */
+		FEntry& Add(const ParamsType& Params, const FSequenceInfo& SequenceInfo, TConstArrayView<const FImgMediaViewInfo*> ViewInfos)
 		{
-			for (float& Level : CornerMipLevelsCached)
+			FEntry& Entry = (Entries.Num() < MaxEntries) ? Entries.AddDefaulted_GetRef() : Entries[NextEntry];
+			NextEntry = (NextEntry + 1) % MaxEntries;
+
+			Entry.Params = Params;
+			Entry.SequenceInfo = SequenceInfo;
+			Entry.ViewInfos.Reset(ViewInfos.Num());
+			for (const FImgMediaViewInfo* ViewInfo : ViewInfos)
 			{
-				Level = -1.0f;
+				Entry.ViewInfos.Add(*ViewInfo);
 			}
+			Entry.VisibleTiles.Reset();
+			Entry.MipLevelToUpscale = -1;
+
+			return Entry;
 		}
 
-		/** Local size of this mesh component. */
-		FVector PlaneSize;
+	private:
+		static constexpr int32 MaxEntries = 2;
 
-		/** Cached calculating mip levels (at mip0). */
-		mutable TArray<float> CornerMipLevelsCached;
+		TArray<FEntry, TInlineAllocator<MaxEntries>> Entries;
+		int32 NextEntry = 0;
 	};
 
-	class FSphereObjectInfo : public FImgMediaMipMapObjectInfo
+	class FPlaneObjectInfo : public FImgMediaMipMapObjectInfo
 	{
 	public:
-		FSphereObjectInfo(UMeshComponent* InMeshComponent, TWeakPtr<FMediaTextureTrackerObject, ESPMode::ThreadSafe> InTracker)
+		FPlaneObjectInfo(UMeshComponent* InMeshComponent, TWeakPtr<FMediaTextureTrackerObject, ESPMode::ThreadSafe> InTracker)
 			: FImgMediaMipMapObjectInfo(InMeshComponent, MoveTemp(InTracker))
-			, DefaultSphereRadius(50.0f) // as defined in FMediaPlateCustomizationMesh::GenerateSphereMesh
-			, MipLevelToUpscale(-1)
-		{
-		}
-
-		virtual int32 GetMipLevelToUpscale() const override
+			, PlaneSize(FVector::ZeroVector)
 		{
-			return MipLevelToUpscale;
+			// Get size of object.
+			if (MeshComponent != nullptr)
+			{
+				PlaneSize = 2.0f * MeshComponent->CalcLocalBounds().BoxExtent;
+			}
+			else
+			{
+				UE_LOG(LogImgMedia, Error, TEXT("FPlaneImgMediaMipMapObjectInfo is missing its plane mesh component."));
+			}
 		}
 
 		void CalculateVisibleTiles(const TArray<FImgMediaViewInfo>& InViewInfos, const FSequenceInfo& InSequenceInfo, TMap<int32, FImgMediaTileSelection>& VisibleTiles) const override
@@ -669,228 +1031,111 @@ namespace {
 				return;
 			}
 
-			const FVector2f MeshRange = FVector2f(ObjectInfo->MeshRange);
-			const float MipMapBias = ObjectInfo->MipMapLODBias;
-			const float MipMapLevelPadding = FMath::Max(CVarImgMediaMipLevelPadding.GetValueOnAnyThread(), 0.0f);
-			const FTransform MeshTransform = Mesh->GetComponentTransform();
-			const int32 MaxLevel = InSequenceInfo.NumMipLevels - 1;
-
-			// Include all tiles containted in the visible UV region
-			const FIntPoint& SequenceTileNum = InSequenceInfo.TilingDescription.TileNum;
-			const FVector2f SequencePartialTileNum = InSequenceInfo.GetPartialTileNum();
+			FPlaneVisibleTilesParams Params;
+			Params.MeshTransform = Mesh->GetComponentTransform();
+			Params.PlaneSize = PlaneSize;
+			Params.MipMapBias = ObjectInfo->MipMapLODBias;
+			Params.MipMapLevelPadding = FMath::Max(CVarImgMediaMipLevelPadding.GetValueOnAnyThread(), 0.0f);
 
-			const float PixelDimX = 1.0f / InSequenceInfo.Dim.X;
-			const float PixelDimY = 1.0f / InSequenceInfo.Dim.Y;
+			TArray<const FImgMediaViewInfo*, TInlineAllocator<4>> ViewInfos;
+			GetViewsShowingMesh(InViewInfos, Mesh->GetPrimitiveSceneId(), ViewInfos);
 
-			const FVector ApproxTileSizeWS = MeshTransform.GetScale3D() * (UE_TWO_PI * DefaultSphereRadius) / FMath::Max(SequencePartialTileNum.X, SequencePartialTileNum.Y);
-			const int32 TotalNumTiles = FMath::CeilToInt32(SequencePartialTileNum.X * SequencePartialTileNum.Y);
-
-			const float ApproxTileRadiusInWS = 0.5f * UE_SQRT_2 * ApproxTileSizeWS.GetAbsMax();
-
-			// Does user want to upscale specific mip level? 
-			int32 MipLevelToUpscaleExcludingPoles = -1;
-
-			// Does user want to reduce the load at the poles?
-			bool bAdaptivePoleMipUpscaling = false;
-			MipLevelToUpscale = -1;
-
-			TSharedPtr<FMediaTextureTrackerObject, ESPMode::ThreadSafe> PinnedTracker = Tracker.Pin();
-			if (PinnedTracker.IsValid())
+			TVisibleTilesCache<FPlaneVisibleTilesParams>::FEntry* Entry = VisibleTilesCache.Find(Params, InSequenceInfo, ViewInfos);
+			if (Entry == nullptr)
 			{
-				MipLevelToUpscaleExcludingPoles = PinnedTracker->MipLevelToUpscale;
-				bAdaptivePoleMipUpscaling = PinnedTracker->bAdaptivePoleMipUpscaling;
-				MipLevelToUpscale = MipLevelToUpscaleExcludingPoles;
-			}
-
-			for (const FImgMediaViewInfo& ViewInfo : InViewInfos)
-			{
-				if (IsPrimitiveComponentHidden(Mesh->GetPrimitiveSceneId(), ViewInfo))
-				{
-					continue;
-				}
-
-				// Analytical derivation of visible tiles from the view frustum, given a sphere presumed to be infinitely large
-				FConvexVolume ViewFrustum;
-				GetViewFrustumBounds(ViewFrustum, ViewInfo.OverscanViewProjectionMatrix, false, false);
-
-				// Approximated UV coordinate for a camera centered inside the sphere
-				FVector2f ViewUV = TransformDirectionWSToSphericalUVs(MeshRange, MeshTransform, ViewInfo.ViewDirection);
-
-
+				Entry = &VisibleTilesCache.Add(Params, InSequenceInfo, ViewInfos);
 
-				// 20 Degrees equates to total 11.1% of a sphere for top and bottom poles.
-				const float PoleEdgeDegrees = 20.f;
-				// Angle from the pole at which upscaling is enabled automatically.
-				const float UpscalingEnabledEdge = 10.f;
-
-				// NumOfTilesToLoadAtThePole - how many tiles does this sphere expect to load without upscaling.
-				// PoleMipBias - automatically calculated value of which mip to upscale.
-				int32 NumOfTilesToLoadAtThePole = 0, PoleMipBias = -1;
-				// This number represents a factor by which we need to reduce the number of tiles loaded.
-				// Ex: Visible tiles at mip 0 at a 20 degree pole = 100. To improve perf we should load 100/TileReductionFactor = 50 tiles.
-				const float TileReductionFactor = 0.5f;
-				if (bAdaptivePoleMipUpscaling)
+				for (const FImgMediaViewInfo* ViewInfo : ViewInfos)
 				{
-					NumOfTilesToLoadAtThePole = FMath::CeilToInt32(SequencePartialTileNum.X * ((float)SequencePartialTileNum.Y * PoleEdgeDegrees / 180.f))* TileReductionFactor;
-					PoleMipBias = FMath::CeilToInt32(FMath::LogX(4., TotalNumTiles/ NumOfTilesToLoadAtThePole));
+					CalculatePlaneVisibleTiles(Params, *ViewInfo, InSequenceInfo, CornerMipLevelsCached, Entry->VisibleTiles);
 				}
+			}
 
-				// Everything above this value gets upscaled.
-				float TipUpscalingEdgePercent = (1.f - PoleEdgeDegrees / 90.f);
-
-				// At which point do we consider that tip is in the view.
-				float TipInTheViewThresholdPercent = (1.f - UpscalingEnabledEdge / 90.f);
-
-				// The following bool indicates if camera is looking at the tip and if we should not load tiles above TipUpscalingEdge
-				bool bPoleTipIsInView = false;
+			MergeVisibleTiles(VisibleTiles, Entry->VisibleTiles, InSequenceInfo);
+		}
 
-				auto ProcessTileRow = [&](int32 TileY)
-				{
-					float TileVMin = 0, TileVMax = 0;
-					if (bAdaptivePoleMipUpscaling)
-					{
-						TileVMin = ((((float)TileY) / SequencePartialTileNum.Y) - 0.5) * 2.;
-						TileVMax = ((((float)TileY + 1.) / SequencePartialTileNum.Y) - 0.5) * 2.;
-					}
+	private:
 
-					for (int32 TileX = 0; TileX < SequenceTileNum.X; ++TileX)
-					{
-						const FVector2f TileMinCornerUV = FVector2f((float)TileX, (float)TileY) / SequencePartialTileNum;
-						const FVector2f TileMaxCornerUV = FVector2f(TileX + 1.0f, TileY + 1.0f) / SequencePartialTileNum;
-						FVector2f TileUV = 0.5f * (TileMinCornerUV + TileMaxCornerUV);
-						float CollisionSphereRadius = ApproxTileRadiusInWS;
+		/** Local size of this mesh component. */
+		FVector PlaneSize;
 
-						// If the view uv is inside the tile, we use its location directly. Helpful for sequences with no tiles.
-						if (ViewUV.ComponentwiseAllGreaterOrEqual(TileMinCornerUV) && ViewUV.ComponentwiseAllLessThan(TileMaxCornerUV))
-						{
-							TileUV = ViewUV;
-							CollisionSphereRadius = 0.0f;
-						}
+		/** Cached calculating mip levels (at mip0). */
+		mutable TArray<float> CornerMipLevelsCached;
 
-						// The resulting location used for tile mip level estimation (either directly at the view center or its closest tile corner).
-						const FVector TileLocationWS = TransformSphericalUVsToLocationWS(MeshRange, MeshTransform, TileUV);
+		/** Visible tiles of previous frames. */
+		mutable TVisibleTilesCache<FPlaneVisibleTilesParams> VisibleTilesCache;
+	};
 
-						if (ViewFrustum.IntersectSphere(TileLocationWS, CollisionSphereRadius))
-						{
-							if (bAdaptivePoleMipUpscaling && (TileVMin < -TipInTheViewThresholdPercent || TileVMax > TipInTheViewThresholdPercent))
-							{
-								bPoleTipIsInView = true;
-								// Queue upscaling of lower quality mips into this mip.
-								MipLevelToUpscale = FMath::Max(PoleMipBias, MipLevelToUpscaleExcludingPoles);
-							}
+	class FSphereObjectInfo : public FImgMediaMipMapObjectInfo
+	{
+	public:
+		FSphereObjectInfo(UMeshComponent* InMeshComponent, TWeakPtr<FMediaTextureTrackerObject, ESPMode::ThreadSafe> InTracker)
+			: FImgMediaMipMapObjectInfo(InMeshComponent, MoveTemp(InTracker))
+			, DefaultSphereRadius(50.0f) // as defined in FMediaPlateCustomizationMesh::GenerateSphereMesh
+			, MipLevelToUpscale(-1)
+		{
+		}
 
-							float CalculatedLevel;
-							FIntVector2 MipLevelRange;
+		virtual int32 GetMipLevelToUpscale() const override
+		{
+			return MipLevelToUpscale;
+		}
 
-							const FVector TexelOffXWS = TransformSphericalUVsToLocationWS(MeshRange, MeshTransform, TileUV + FVector2f(PixelDimX, 0));
-							const FVector TexelOffYWS = TransformSphericalUVsToLocationWS(MeshRange, MeshTransform, TileUV + FVector2f(0, PixelDimY));
+		void CalculateVisibleTiles(const TArray<FImgMediaViewInfo>& InViewInfos, const FSequenceInfo& InSequenceInfo, TMap<int32, FImgMediaTileSelection>& VisibleTiles) const override
+		{
+			UMeshComponent* Mesh = MeshComponent.Get();
+			if (Mesh == nullptr || !Mesh->ShouldRender())
+			{
+				return;
+			}
 
-							if (CalculateMipLevelAniso(ViewInfo, TileLocationWS, TexelOffXWS, TexelOffYWS, CalculatedLevel))
-							{
-								CalculatedLevel += MipMapBias + ViewInfo.MaterialTextureMipBias;
+			TSharedPtr<FMediaTextureTrackerObject, ESPMode::ThreadSafe> ObjectInfo = Tracker.Pin();
+			if (!ObjectInfo.IsValid())
+			{
+				return;
+			}
 
-								MipLevelRange[0] = FMath::FloorToInt32(CalculatedLevel - MipMapLevelPadding);
-								MipLevelRange[1] = FMath::CeilToInt32(CalculatedLevel + MipMapLevelPadding);
-
-								const bool bIsTileAtPole = (TileY == 0 || TileY == SequenceTileNum.Y - 1);
-								/*
-								 * Since we estimate mip levels only once per tile here, this method very much approximates the
-								 * per-fragment hardware mip selection that occurs during rasterization. Discontinuities can
-								 * therefore appear where variance within one tile is strongest: the approximation delta is
-								 * indeed larger at the poles due to latlong spherical projection. So as a mitigation for pole
-								 * discontinuities, we artifically increase their mip level range, and accept the added read cost.
-								 *
-								 * NOTE: This should now be disabled by default since bAdaptivePoleMipUpscaling defaults to true.
-								 */
-								if (!bAdaptivePoleMipUpscaling && bIsTileAtPole)
-								{
-									MipLevelRange[0]--;
-									MipLevelRange[1]++;
-								}
+			if (InViewInfos.IsEmpty())
+			{
+				return;
+			}
 
-								MipLevelRange[0] = FMath::Clamp(MipLevelRange[0], 0, MaxLevel);
-								MipLevelRange[1] = FMath::Clamp(MipLevelRange[1], 0, MaxLevel);
+			FSphereVisibleTilesParams Params;
+			Params.MeshTransform = Mesh->GetComponentTransform();
+			Params.MeshRange = FVector2f(ObjectInfo->MeshRange);
+			Params.SphereRadius = DefaultSphereRadius;
+			Params.MipMapBias = ObjectInfo->MipMapLODBias;
+			Params.MipMapLevelPadding = FMath::Max(CVarImgMediaMipLevelPadding.GetValueOnAnyThread(), 0.0f);
+			Params.MipLevelToUpscale = ObjectInfo->MipLevelToUpscale;
+			Params.bAdaptivePoleMipUpscaling = ObjectInfo->bAdaptivePoleMipUpscaling;
 
-								for (int32 Level = MipLevelRange[0]; Level <= MipLevelRange[1]; ++Level)
-								{
-									if (bAdaptivePoleMipUpscaling && Level < PoleMipBias)
-									{
-										// Anything above TipUpscalingEdgePercent will be upscaled.
-										if (bPoleTipIsInView && (TileVMin < -TipUpscalingEdgePercent || TileVMax > TipUpscalingEdgePercent))
-										{
-											continue;
-										}
-									}
-
-									if (!VisibleTiles.Contains(Level))
-									{
-										VisibleTiles.Emplace(Level, FImgMediaTileSelection::CreateForTargetMipLevel(InSequenceInfo.Dim, InSequenceInfo.TilingDescription.TileSize, Level, false));
-									}
-
-									const int MipLevelDiv = 1 << Level;
-
-									VisibleTiles[Level].SetVisible(TileX / MipLevelDiv, TileY / MipLevelDiv);
-								}
-							}
-#if false
-#if WITH_EDITOR
-							float DebugSphereRadius = FMath::Max(CollisionSphereRadius, MeshTransform.GetMaximumAxisScale());
-							// Enable this to draw a sphere where each tile is.
-							Async(EAsyncExecution::TaskGraphMainThread, [TileLocationWS, DebugSphereRadius]()
-								{
-									UWorld* World = GEditor->GetEditorWorldContext().World();
-									DrawDebugSphere(World, TileLocationWS, DebugSphereRadius, 8, FColor::Red, false, 0.05f);
-								});
-#endif // WITH_EDITOR
-#endif // false
-						}
-					}
-				};
+			TArray<const FImgMediaViewInfo*, TInlineAllocator<4>> ViewInfos;
+			GetViewsShowingMesh(InViewInfos, Mesh->GetPrimitiveSceneId(), ViewInfos);
 
-				int32 MiddleRowIndex = FMath::FloorToInt32(((float)SequenceTileNum.Y) / 2.);
+			TVisibleTilesCache<FSphereVisibleTilesParams>::FEntry* Entry = VisibleTilesCache.Find(Params, InSequenceInfo, ViewInfos);
+			if (Entry == nullptr)
+			{
+				Entry = &VisibleTilesCache.Add(Params, InSequenceInfo, ViewInfos);
+				Entry->MipLevelToUpscale = Params.MipLevelToUpscale;
 
-				for (int32 TileY = 0; TileY < MiddleRowIndex; ++TileY)
-				{
-					ProcessTileRow(TileY);
-				}
-				for (int32 TileY = SequenceTileNum.Y - 1; TileY >= MiddleRowIndex; TileY--)
+				for (const FImgMediaViewInfo* ViewInfo : ViewInfos)
 				{
-					ProcessTileRow(TileY);
+					CalculateSphereVisibleTiles(Params, *ViewInfo, InSequenceInfo, Entry->VisibleTiles, Entry->MipLevelToUpscale);
 				}
 			}
-		}
 
-		FVector TransformSphericalUVsToLocationWS(const FVector2f& MeshRange, const FTransform& MeshTransform, FVector2f UV) const
-		{
-			// Scale UVs by spherical mesh range
-			UV.X *= MeshRange.X / 360.0f;
-			UV.Y = (UV.Y - 0.5f) * (MeshRange.Y / 180.0f) + 0.5f;
-			// Convert from latlong UV to spherical coordinates
-			FVector2d TileCornerSpherical = FVector2d(UE_PI * UV.Y, UE_TWO_PI * UV.X);
-			FVector CornersWS = TileCornerSpherical.SphericalToUnitCartesian() * DefaultSphereRadius;
-			return MeshTransform.TransformPosition(CornersWS);
-		}
-
-		FVector2f TransformDirectionWSToSphericalUVs(const FVector2f& MeshRange, const FTransform& MeshTransform, const FVector& InDirection) const
-		{
-			//Convert direction to spherical angular coordinates.
-			FVector SphereViewPoint = MeshTransform.InverseTransformVectorNoScale(InDirection);
-			SphereViewPoint.Normalize();
-			FVector2d Spherical = SphereViewPoint.UnitCartesianToSpherical();
-			Spherical.Y = FMath::Fmod(Spherical.Y + UE_TWO_PI, UE_TWO_PI);
-			//Convert spherical to 0-1 UV range.
-			FVector2f UV = FVector2f(Spherical.Y / UE_TWO_PI, Spherical.X / UE_PI);
-			// Scale UVs by spherical mesh range
-			UV.X /= MeshRange.X / 360.0f;
-			UV.Y = (UV.Y - 0.5f) / (MeshRange.Y / 180.0f) + 0.5f;
-			return UV;
+			MipLevelToUpscale = Entry->MipLevelToUpscale;
+			MergeVisibleTiles(VisibleTiles, Entry->VisibleTiles, InSequenceInfo);
 		}
 
 		const float DefaultSphereRadius;
-	
+
 	private:
 
 		mutable int32 MipLevelToUpscale;
+
+		/** Visible tiles of previous frames. */
+		mutable TVisibleTilesCache<FSphereVisibleTilesParams> VisibleTilesCache;
 	};
 
 } //end anonymous namespace
@@ -1070,23 +1315,32 @@ TMap<int32, FImgMediaTileSelection> FImgMediaMipMapInfo::GetVisibleTiles()
 
 		FScopeLock LockObjects(&ObjectsCriticalSection);
 
-		// Loop over all objects.
-		for (FImgMediaMipMapObjectInfo* ObjectInfo : Objects)
+		// If display & render resolutions are identical, display resolution view infos will always be empty.
+		const bool bForceRenderResolution = DisplayResolutionViewInfos.IsEmpty();
+
+		// Objects only write their own tiles, so they are calculated in parallel and merged in order afterwards.
+		TArray<TMap<int32, FImgMediaTileSelection>> ObjectVisibleTiles;
+		ObjectVisibleTiles.SetNum(Objects.Num());
+
+		ParallelFor(TEXT("FImgMediaMipMapInfo::CalculateVisibleTiles"), Objects.Num(), 1, [this, bForceRenderResolution, &ObjectVisibleTiles](int32 ObjectIndex)
 		{
+			const FImgMediaMipMapObjectInfo* ObjectInfo = Objects[ObjectIndex];
 			const EMediaTextureTargetViewResolution Mask = ObjectInfo->GetTargetViewResolutionMask();
 
-			// If display & render resolutions are identical, display resolution view infos will always be empty.
-			const bool bForceRenderResolution = DisplayResolutionViewInfos.IsEmpty();
-
 			if (EnumHasAllFlags(Mask, EMediaTextureTargetViewResolution::RenderResolution) || bForceRenderResolution)
 			{
-				ObjectInfo->CalculateVisibleTiles(ViewInfos, SequenceInfo, CachedVisibleTiles);
+				ObjectInfo->CalculateVisibleTiles(ViewInfos, SequenceInfo, ObjectVisibleTiles[ObjectIndex]);
 			}
 
 			if (EnumHasAllFlags(Mask, EMediaTextureTargetViewResolution::DisplayResolution) && !bForceRenderResolution)
 			{
-				ObjectInfo->CalculateVisibleTiles(DisplayResolutionViewInfos, SequenceInfo, CachedVisibleTiles);
+				ObjectInfo->CalculateVisibleTiles(DisplayResolutionViewInfos, SequenceInfo, ObjectVisibleTiles[ObjectIndex]);
 			}
+		}, CVarImgMediaMipMapParallel.GetValueOnAnyThread() ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+		for (const TMap<int32, FImgMediaTileSelection>& VisibleTiles : ObjectVisibleTiles)
+		{
+			UE::ImgMedia::Private::MergeVisibleTiles(CachedVisibleTiles, VisibleTiles, SequenceInfo);
 		}
 
 		// Mark cache as valid.
@@ -0,0 +1,97 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Assets/ImgMediaMipMapInfo.h"
+
+struct FConvexVolume;
+
+namespace UE::ImgMedia::Private
+{
+	/** Placement and tracker settings of a plane mesh, everything its visible tiles depend on besides the views and sequence. */
+	struct FPlaneVisibleTilesParams
+	{
+		FTransform MeshTransform;
+		/** Local size of the plane mesh. */
+		FVector PlaneSize = FVector::ZeroVector;
+		float MipMapBias = 0.0f;
+		float MipMapLevelPadding = 0.0f;
+
+		bool operator==(const FPlaneVisibleTilesParams& Other) const
+		{
+			return MeshTransform.Equals(Other.MeshTransform, 0.0) && PlaneSize == Other.PlaneSize
+				&& MipMapBias == Other.MipMapBias && MipMapLevelPadding == Other.MipMapLevelPadding;
+		}
+	};
+
+	/** Placement and tracker settings of a sphere mesh, everything its visible tiles depend on besides the views and sequence. */
+	struct FSphereVisibleTilesParams
+	{
+		FTransform MeshTransform;
+		/** Horizontal and vertical range of the sphere in degrees. */
+		FVector2f MeshRange = FVector2f(360.0f, 180.0f);
+		float SphereRadius = 50.0f;
+		float MipMapBias = 0.0f;
+		float MipMapLevelPadding = 0.0f;
+		/** Mip level the user asked to upscale, -1 for none. */
+		int32 MipLevelToUpscale = -1;
+		bool bAdaptivePoleMipUpscaling = false;
+
+		bool operator==(const FSphereVisibleTilesParams& Other) const
+		{
+			return MeshTransform.Equals(Other.MeshTransform, 0.0) && MeshRange == Other.MeshRange && SphereRadius == Other.SphereRadius
+				&& MipMapBias == Other.MipMapBias && MipMapLevelPadding == Other.MipMapLevelPadding
+				&& MipLevelToUpscale == Other.MipLevelToUpscale && bAdaptivePoleMipUpscaling == Other.bAdaptivePoleMipUpscaling;
+		}
+	};
+
+	/**
+	 * Adds the tiles of a plane mesh visible in one view to VisibleTiles, with a quadtree search from the highest mip level down.
+	 *
+	 * @param CornerMipLevels	Scratch memory for the mip level of tile corners, reused between calls to avoid allocations.
+	 */
+	void CalculatePlaneVisibleTiles(const FPlaneVisibleTilesParams& Params, const FImgMediaViewInfo& ViewInfo, const FSequenceInfo& SequenceInfo,
+		TArray<float>& CornerMipLevels, TMap<int32, FImgMediaTileSelection>& VisibleTiles);
+
+	/**
+	 * Adds the tiles of a sphere mesh visible in one view to VisibleTiles.
+	 *
+	 * @param InOutMipLevelToUpscale	Raised to the pole mip level when adaptive pole upscaling kicks in for this view.
+	 */
+	void CalculateSphereVisibleTiles(const FSphereVisibleTilesParams& Params, const FImgMediaViewInfo& ViewInfo, const FSequenceInfo& SequenceInfo,
+		TMap<int32, FImgMediaTileSelection>& VisibleTiles, int32& InOutMipLevelToUpscale);
+
+	/** Up to four bounding spheres in SIMD friendly layout, to test against a frustum at once. */
+	struct FTileSphereBatch
+	{
+		static constexpr int32 MaxNum = 4;
+
+		alignas(32) double CenterX[MaxNum] = {};
+		alignas(32) double CenterY[MaxNum] = {};
+		alignas(32) double CenterZ[MaxNum] = {};
+		alignas(32) double Radius[MaxNum] = {};
+		int32 Num = 0;
+
+		void Add(const FVector& Center, double InRadius)
+		{
+			check(Num < MaxNum);
+			CenterX[Num] = Center.X;
+			CenterY[Num] = Center.Y;
+			CenterZ[Num] = Center.Z;
+			Radius[Num] = InRadius;
+			++Num;
+		}
+	};
+
+	/**
+	 * Same test as FConvexVolume::IntersectSphere for every sphere of the batch, four spheres per SIMD operation instead of four planes.
+	 * Returns a mask with bit N set if sphere N intersects the frustum.
+	 */
+	uint32 IntersectSpheres(const FConvexVolume& Frustum, const FTileSphereBatch& Spheres);
+
+	/**
+	 * Merges the tiles of one object into the tiles of all objects. Selections of the same mip level can have different dimensions
+	 * depending on the object type that created them, the first one is kept like when objects add to a shared map in turn.
+	 */
+	void MergeVisibleTiles(TMap<int32, FImgMediaTileSelection>& Into, const TMap<int32, FImgMediaTileSelection>& From, const FSequenceInfo& SequenceInfo);
+}
@@ -0,0 +1,217 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Assets/ImgMediaVisibleTiles.h"
+#include "Async/ParallelFor.h"
+#include "ConvexVolume.h"
+#include "HAL/PlatformTime.h"
+#include "Math/InverseRotationMatrix.h"
+#include "Math/PerspectiveMatrix.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UE::ImgMedia::Private::Tests
+{
+	constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+	FImgMediaViewInfo MakeViewInfo(const FVector& Location, const FRotator& Rotation, float FOVDegrees, const FIntPoint& Resolution)
+	{
+		// Same conventions as FSceneView, X forward in world space becomes Z forward in view space
+		const FMatrix ViewRotationMatrix = FInverseRotationMatrix(Rotation) * FMatrix(
+			FPlane(0, 0, 1, 0),
+			FPlane(1, 0, 0, 0),
+			FPlane(0, 1, 0, 0),
+			FPlane(0, 0, 0, 1));
+		const FMatrix ProjectionMatrix = FReversedZPerspectiveMatrix(FMath::DegreesToRadians(0.5f * FOVDegrees), Resolution.X, Resolution.Y, 10.0f);
+
+		FImgMediaViewInfo ViewInfo;
+		ViewInfo.ViewDirection = Rotation.Vector();
+		ViewInfo.ViewProjectionMatrix = FTranslationMatrix(-Location) * ViewRotationMatrix * ProjectionMatrix;
+		ViewInfo.OverscanViewProjectionMatrix = ViewInfo.ViewProjectionMatrix;
+		ViewInfo.ViewportRect = FIntRect(FIntPoint::ZeroValue, Resolution);
+		ViewInfo.MaterialTextureMipBias = 0.0f;
+		// Empty hidden primitive list, every object is shown
+		ViewInfo.bPrimitiveHiddenMode = true;
+		return ViewInfo;
+	}
+
+	/** A 16K tiled and mipped EXR sequence, like the ones played back on LED volumes */
+	FSequenceInfo MakeSequenceInfo()
+	{
+		FSequenceInfo SequenceInfo;
+		SequenceInfo.Name = TEXT("Synthetic16K");
+		SequenceInfo.Dim = FIntPoint(16384, 8192);
+		SequenceInfo.NumMipLevels = 6;
+		SequenceInfo.TilingDescription.TileSize = FIntPoint(512, 512);
+		SequenceInfo.TilingDescription.TileNum = FIntPoint(32, 16);
+		return SequenceInfo;
+	}
+
+	/** Stand-in for a plane or sphere media plate, without any mesh component */
+	struct FSyntheticObject
+	{
+		bool bIsSphere = false;
+		FPlaneVisibleTilesParams PlaneParams;
+		FSphereVisibleTilesParams SphereParams;
+	};
+
+	void CalculateVisibleTiles(const FSyntheticObject& Object, TConstArrayView<FImgMediaViewInfo> ViewInfos, const FSequenceInfo& SequenceInfo,
+		TArray<float>& CornerMipLevels, TMap<int32, FImgMediaTileSelection>& VisibleTiles)
+	{
+		int32 MipLevelToUpscale = Object.SphereParams.MipLevelToUpscale;
+		for (const FImgMediaViewInfo& ViewInfo : ViewInfos)
+		{
+			if (Object.bIsSphere)
+			{
+				CalculateSphereVisibleTiles(Object.SphereParams, ViewInfo, SequenceInfo, VisibleTiles, MipLevelToUpscale);
+			}
+			else
+			{
+				CalculatePlaneVisibleTiles(Object.PlaneParams, ViewInfo, SequenceInfo, CornerMipLevels, VisibleTiles);
+			}
+		}
+	}
+
+	int32 CountVisibleTiles(const TMap<int32, FImgMediaTileSelection>& VisibleTiles)
+	{
+		int32 NumVisibleTiles = 0;
+		for (const TPair<int32, FImgMediaTileSelection>& MipTiles : VisibleTiles)
+		{
+			NumVisibleTiles += MipTiles.Value.NumVisibleTiles();
+		}
+		return NumVisibleTiles;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImgMediaIntersectSpheresTest, "System.Media.ImgMedia.VisibleTiles.IntersectSpheres", UE::ImgMedia::Private::Tests::TestFlags)
+bool FImgMediaIntersectSpheresTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::ImgMedia::Private;
+	using namespace UE::ImgMedia::Private::Tests;
+
+	FRandomStream RandomStream(7);
+	int32 NumMismatches = 0;
+	int32 NumIntersecting = 0;
+	int32 NumTested = 0;
+
+	for (int32 ViewIndex = 0; ViewIndex < 16; ++ViewIndex)
+	{
+		const FImgMediaViewInfo ViewInfo = MakeViewInfo(RandomStream.VRand() * 1000.0, FRotator(RandomStream.FRandRange(-80.0f, 80.0f), RandomStream.FRandRange(-180.0f, 180.0f), 0.0f),
+			RandomStream.FRandRange(30.0f, 110.0f), FIntPoint(1920, 1080));
+
+		FConvexVolume Frustum;
+		GetViewFrustumBounds(Frustum, ViewInfo.OverscanViewProjectionMatrix, false, false);
+
+		for (int32 BatchIndex = 0; BatchIndex < 256; ++BatchIndex)
+		{
+			// Partial batches too, the unused lanes must never be reported
+			FTileSphereBatch Batch;
+			const int32 NumSpheres = 1 + BatchIndex % FTileSphereBatch::MaxNum;
+			for (int32 SphereIndex = 0; SphereIndex < NumSpheres; ++SphereIndex)
+			{
+				// Some zero radius spheres, like the tile a sphere mesh is viewed from the inside
+				const float Radius = (SphereIndex == 0 && BatchIndex % 5 == 0) ? 0.0f : RandomStream.FRandRange(1.0f, 500.0f);
+				Batch.Add(RandomStream.VRand() * RandomStream.FRandRange(0.0f, 5000.0f), Radius);
+			}
+
+			const uint32 IntersectMask = IntersectSpheres(Frustum, Batch);
+			TestEqual(TEXT("Unused lanes are not reported"), IntersectMask >> NumSpheres, 0u);
+
+			for (int32 SphereIndex = 0; SphereIndex < NumSpheres; ++SphereIndex)
+			{
+				const FVector Center(Batch.CenterX[SphereIndex], Batch.CenterY[SphereIndex], Batch.CenterZ[SphereIndex]);
+				const bool bExpected = Frustum.IntersectSphere(Center, (float)Batch.Radius[SphereIndex]);
+				const bool bActual = (IntersectMask & (1u << SphereIndex)) != 0;
+				NumMismatches += (bExpected != bActual) ? 1 : 0;
+				NumIntersecting += bExpected ? 1 : 0;
+				++NumTested;
+			}
+		}
+	}
+
+	TestEqual(TEXT("IntersectSpheres matches FConvexVolume::IntersectSphere"), NumMismatches, 0);
+	TestTrue(TEXT("Both intersecting and culled spheres are tested"), NumIntersecting > 0 && NumIntersecting < NumTested);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImgMediaVisibleTilesBenchmarkTest, "System.Media.ImgMedia.VisibleTiles.Benchmark", UE::ImgMedia::Private::Tests::TestFlags | EAutomationTestFlags::PerfFilter)
+bool FImgMediaVisibleTilesBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::ImgMedia::Private;
+	using namespace UE::ImgMedia::Private::Tests;
+
+	const FSequenceInfo SequenceInfo = MakeSequenceInfo();
+
+	// A wall of plane panels in front of the camera and a few surrounding spheres, seen from two views
+	constexpr int32 NumPlanes = 24;
+	constexpr int32 NumSpheres = 8;
+	constexpr int32 NumFrames = 20;
+
+	TArray<FSyntheticObject> Objects;
+	for (int32 Index = 0; Index < NumPlanes; ++Index)
+	{
+		FSyntheticObject& Object = Objects.AddDefaulted_GetRef();
+		Object.PlaneParams.PlaneSize = FVector(0.0, 200.0, 100.0);
+		Object.PlaneParams.MeshTransform = FTransform(FRotator(0.0, 180.0, 0.0), FVector(1500.0, (Index % 6 - 2.5) * 210.0, (Index / 6) * 110.0), FVector(1.0));
+	}
+	for (int32 Index = 0; Index < NumSpheres; ++Index)
+	{
+		FSyntheticObject& Object = Objects.AddDefaulted_GetRef();
+		Object.bIsSphere = true;
+		Object.SphereParams.MeshTransform = FTransform(FRotator::ZeroRotator, FVector(0.0, 0.0, Index * 10.0), FVector(40.0 + Index));
+		Object.SphereParams.bAdaptivePoleMipUpscaling = true;
+	}
+
+	const FImgMediaViewInfo ViewInfos[] =
+	{
+		MakeViewInfo(FVector(0.0, 0.0, 150.0), FRotator(0.0, 0.0, 0.0), 90.0f, FIntPoint(3840, 2160)),
+		MakeViewInfo(FVector(200.0, -300.0, 170.0), FRotator(-5.0, 20.0, 0.0), 60.0f, FIntPoint(1920, 1080)),
+	};
+
+	TArray<TMap<int32, FImgMediaTileSelection>> ObjectVisibleTiles;
+	ObjectVisibleTiles.SetNum(Objects.Num());
+
+	auto RunFrame = [&](EParallelForFlags Flags)
+	{
+		ParallelFor(TEXT("ImgMediaVisibleTilesBenchmark"), Objects.Num(), 1, [&](int32 ObjectIndex)
+		{
+			TArray<float> CornerMipLevels;
+			ObjectVisibleTiles[ObjectIndex].Reset();
+			CalculateVisibleTiles(Objects[ObjectIndex], ViewInfos, SequenceInfo, CornerMipLevels, ObjectVisibleTiles[ObjectIndex]);
+		}, Flags);
+
+		TMap<int32, FImgMediaTileSelection> VisibleTiles;
+		for (const TMap<int32, FImgMediaTileSelection>& Tiles : ObjectVisibleTiles)
+		{
+			MergeVisibleTiles(VisibleTiles, Tiles, SequenceInfo);
+		}
+		return VisibleTiles;
+	};
+
+	double SerialSeconds = 0.0;
+	double ParallelSeconds = 0.0;
+	int32 NumSerialTiles = 0;
+	int32 NumParallelTiles = 0;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		double StartTime = FPlatformTime::Seconds();
+		NumSerialTiles = CountVisibleTiles(RunFrame(EParallelForFlags::ForceSingleThread));
+		SerialSeconds += FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		NumParallelTiles = CountVisibleTiles(RunFrame(EParallelForFlags::None));
+		ParallelSeconds += FPlatformTime::Seconds() - StartTime;
+	}
+
+	TestTrue(TEXT("Some tiles are visible"), NumSerialTiles > 0);
+	TestEqual(TEXT("Parallel calculation selects the same tiles"), NumParallelTiles, NumSerialTiles);
+
+	AddInfo(FString::Printf(TEXT("%d planes and %d spheres, %d views, %d visible tiles: %.3f ms per frame on one thread, %.3f ms per frame in parallel"),
+		NumPlanes, NumSpheres, UE_ARRAY_COUNT(ViewInfos), NumSerialTiles, 1000.0 * SerialSeconds / NumFrames, 1000.0 * ParallelSeconds / NumFrames));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,325 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HarmonixDsp/Ramper.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace Harmonix::Dsp::Ramper::Tests
+{
+	constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+	constexpr float SampleRate = 48000.0f;
+	constexpr int32 NumSegments = 200;
+
+	// Ramps in blocks of varying size, so block boundaries land before, on and after the frame the target is reached
+	template<typename RamperType>
+	void RampInBlocks(RamperType& Ramper, float* Out, int32 NumFrames, FRandomStream& RandomStream)
+	{
+		for (int32 Frame = 0; Frame < NumFrames;)
+		{
+			const int32 NumBlockFrames = FMath::Min(NumFrames - Frame, RandomStream.RandRange(1, 300));
+			Ramper.RampBlock(Out + Frame, NumBlockFrames);
+			Frame += NumBlockFrames;
+		}
+	}
+
+	static int32 NumCallbacks = 0;
+	static void CountCallback(void*)
+	{
+		++NumCallbacks;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRamperBlockMatchesRampTest, "Harmonix.Dsp.Ramper.RampBlock.FRamper", Harmonix::Dsp::Ramper::Tests::TestFlags)
+bool FRamperBlockMatchesRampTest::RunTest(const FString& Parameters)
+{
+	using namespace Harmonix::Dsp::Ramper::Tests;
+
+	FRandomStream RandomStream(1);
+	TArray<float> Expected;
+	TArray<float> Actual;
+
+	for (ERamperMode Mode : { ERamperMode::Linear, ERamperMode::Log, ERamperMode::Exp })
+	{
+		FRamper Reference(SampleRate);
+		FRamper Block(SampleRate);
+		const float Start = RandomStream.FRandRange(0.01f, 2.0f);
+		Reference.SnapTo(Start);
+		Block.SnapTo(Start);
+
+		// Empty blocks write nothing and leave the ramp where it is
+		Block.SetTarget(Start * 2.0f);
+		Block.RampBlock(nullptr, 0);
+		TestEqual(TEXT("Empty block keeps the current value"), Block.GetCurrent(), Start);
+		Block.SnapTo(Start);
+
+		const float RampTimeMs = RandomStream.FRandRange(0.1f, 20.0f);
+		Reference.SetRampTimeMs(SampleRate, RampTimeMs, Mode);
+		Block.SetRampTimeMs(SampleRate, RampTimeMs, Mode);
+
+		float MaxError = 0.0f;
+		int32 NumFlatSegments = 0;
+		for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+		{
+			const float SegmentStart = Block.GetCurrent();
+			const float Target = RandomStream.FRandRange(0.01f, 2.0f);
+			const int32 NumFrames = RandomStream.RandRange(1, 2000);
+			Expected.SetNumUninitialized(NumFrames);
+			Actual.SetNumUninitialized(NumFrames);
+
+			NumCallbacks = 0;
+			Reference.SetTarget(Target, &CountCallback, nullptr);
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				Reference.Ramp();
+				Expected[Frame] = Reference.GetCurrent();
+			}
+			const int32 NumExpectedCallbacks = NumCallbacks;
+
+			NumCallbacks = 0;
+			Block.SetTarget(Target, &CountCallback, nullptr);
+			RampInBlocks(Block, Actual.GetData(), NumFrames, RandomStream);
+
+			const int32 ExpectedDoneFrame = Expected.IndexOfByKey(Target);
+			const int32 ActualDoneFrame = Actual.IndexOfByKey(Target);
+			if (Mode == ERamperMode::Linear)
+			{
+				TestEqual(TEXT("Linear ramps reach the target on the same frame"), ActualDoneFrame, ExpectedDoneFrame);
+				TestEqual(TEXT("Completion callback is called the same number of times"), NumCallbacks, NumExpectedCallbacks);
+			}
+			else
+			{
+				// Frames past the end of the segment count as not reached, reaching it one frame later can push it past the end
+				TestTrue(TEXT("Geometric ramps reach the target within a frame"),
+					FMath::Abs((ActualDoneFrame == INDEX_NONE ? NumFrames : ActualDoneFrame) - (ExpectedDoneFrame == INDEX_NONE ? NumFrames : ExpectedDoneFrame)) <= 1);
+			}
+
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				MaxError = FMath::Max(MaxError, FMath::Abs(Expected[Frame] - Actual[Frame]) / FMath::Max(FMath::Abs(Expected[Frame]), 0.001f));
+			}
+
+			// The shortest ramp takes several frames, so a segment that goes somewhere must not jump to its end on the first frame.
+			// Exponential ramps down can overshoot on their first call and snap, so only linear and log ramps are checked.
+			if (Mode != ERamperMode::Exp && NumFrames > 1 && FMath::Abs(Target - SegmentStart) > 0.01f)
+			{
+				NumFlatSegments += (Expected[0] == Expected[NumFrames - 1] || Actual[0] == Actual[NumFrames - 1]) ? 1 : 0;
+			}
+
+			// Start the next segment from the same value, so rounding differences don't add up
+			Reference.SnapTo(Block.GetCurrent());
+			Block.SnapTo(Block.GetCurrent());
+		}
+
+		TestTrue(FString::Printf(TEXT("Mode %d values match Ramp() (max relative error %g)"), (int32)Mode, MaxError), MaxError <= 1e-3f);
+		TestEqual(FString::Printf(TEXT("Mode %d ramps move from their first to their last frame"), (int32)Mode), NumFlatSegments, 0);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRamperBlockNearTargetTest, "Harmonix.Dsp.Ramper.RampBlock.FRamper.NearTarget", Harmonix::Dsp::Ramper::Tests::TestFlags)
+bool FRamperBlockNearTargetTest::RunTest(const FString& Parameters)
+{
+	using namespace Harmonix::Dsp::Ramper::Tests;
+
+	// The per sample multiplier to a target this close rounds to 1, the ramp must still complete instead of holding Current forever
+	constexpr float Start = 1.0f;
+	constexpr float Target = 1.0f - 1e-6f;
+	TArray<float> Out;
+	Out.SetNumUninitialized(1024);
+
+	for (ERamperMode Mode : { ERamperMode::Log, ERamperMode::Exp })
+	{
+		FRamper Ramper(SampleRate);
+		Ramper.SnapTo(Start);
+		Ramper.SetRampTimeMs(SampleRate, 20.0f, Mode);
+
+		NumCallbacks = 0;
+		Ramper.SetTarget(Target, &CountCallback, nullptr);
+		Ramper.RampBlock(Out.GetData(), Out.Num());
+
+		TestEqual(FString::Printf(TEXT("Mode %d reaches a target next to the current value"), (int32)Mode), Ramper.GetCurrent(), Target);
+		TestEqual(FString::Printf(TEXT("Mode %d ends the block on the target"), (int32)Mode), Out.Last(), Target);
+		TestEqual(FString::Printf(TEXT("Mode %d calls the completion callback once"), (int32)Mode), NumCallbacks, 1);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLinearRamperBlockMatchesRampTest, "Harmonix.Dsp.Ramper.RampBlock.TLinearRamper", Harmonix::Dsp::Ramper::Tests::TestFlags)
+bool FLinearRamperBlockMatchesRampTest::RunTest(const FString& Parameters)
+{
+	using namespace Harmonix::Dsp::Ramper::Tests;
+
+	FRandomStream RandomStream(2);
+	TArray<float> Expected;
+	TArray<float> Actual;
+
+	TLinearRamper<float> Reference(SampleRate);
+	TLinearRamper<float> Block(SampleRate);
+	float MaxError = 0.0f;
+
+	for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+	{
+		const float RampTimeMs = RandomStream.FRandRange(0.1f, 10.0f);
+		Reference.SetRampTimeMs(RampTimeMs);
+		Block.SetRampTimeMs(RampTimeMs);
+
+		const float Target = RandomStream.FRandRange(-2.0f, 2.0f);
+		const int32 NumFrames = RandomStream.RandRange(1, 1000);
+		Expected.SetNumUninitialized(NumFrames);
+		Actual.SetNumUninitialized(NumFrames);
+
+		Reference.SetTarget(Target);
+		int32 ExpectedDoneFrame = INDEX_NONE;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Reference.Ramp();
+			Expected[Frame] = Reference.GetCurrent();
+			if (ExpectedDoneFrame == INDEX_NONE && Reference.IsAtTarget())
+			{
+				ExpectedDoneFrame = Frame;
+			}
+		}
+
+		Block.SetTarget(Target);
+		RampInBlocks(Block, Actual.GetData(), NumFrames, RandomStream);
+
+		TestEqual(TEXT("Ramp completes on the same call"), Block.IsAtTarget(), Reference.IsAtTarget());
+		if (ExpectedDoneFrame != INDEX_NONE)
+		{
+			TestEqual(TEXT("Target is written on the frame the ramp completes"), Actual[ExpectedDoneFrame], Target);
+		}
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			MaxError = FMath::Max(MaxError, FMath::Abs(Expected[Frame] - Actual[Frame]));
+		}
+
+		Reference.SnapTo(Block.GetCurrent());
+		Block.SnapTo(Block.GetCurrent());
+	}
+
+	TestTrue(FString::Printf(TEXT("Values match Ramp() (max error %g)"), MaxError), MaxError <= 1e-3f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLinearCircularRamperBlockMatchesRampTest, "Harmonix.Dsp.Ramper.RampBlock.TLinearCircularRamper", Harmonix::Dsp::Ramper::Tests::TestFlags)
+bool FLinearCircularRamperBlockMatchesRampTest::RunTest(const FString& Parameters)
+{
+	using namespace Harmonix::Dsp::Ramper::Tests;
+
+	FRandomStream RandomStream(3);
+	TArray<float> Expected;
+	TArray<float> Actual;
+
+	TLinearCircularRamper<float> Reference(0.0f, 360.0f, SampleRate);
+	TLinearCircularRamper<float> Block(0.0f, 360.0f, SampleRate);
+	float MaxError = 0.0f;
+
+	for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+	{
+		const float RampTimeMs = RandomStream.FRandRange(0.1f, 10.0f);
+		Reference.SetRampTimeMs(RampTimeMs);
+		Block.SetRampTimeMs(RampTimeMs);
+
+		const float Target = RandomStream.FRandRange(0.0f, 359.0f);
+		const int32 NumFrames = RandomStream.RandRange(1, 1000);
+		Expected.SetNumUninitialized(NumFrames);
+		Actual.SetNumUninitialized(NumFrames);
+
+		Reference.SetTarget(Target, true);
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			Reference.Ramp();
+			Expected[Frame] = Reference.GetCurrent();
+		}
+
+		Block.SetTarget(Target, true);
+		RampInBlocks(Block, Actual.GetData(), NumFrames, RandomStream);
+
+		TestEqual(TEXT("Ramp completes on the same call"), Block.IsAtTarget(), Reference.IsAtTarget());
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			// Values just below Max may wrap to just above Min in one of the two
+			const float Error = FMath::Abs(Expected[Frame] - Actual[Frame]);
+			MaxError = FMath::Max(MaxError, FMath::Min(Error, 360.0f - Error));
+		}
+
+		Reference.SnapTo(Block.GetCurrent(), true);
+		Block.SnapTo(Block.GetCurrent(), true);
+	}
+
+	TestTrue(FString::Printf(TEXT("Values match Ramp() (max error %g)"), MaxError), MaxError <= 0.05f);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMultiChannelLinearRamperTest, "Harmonix.Dsp.Ramper.RampBlock.FMultiChannelLinearRamper", Harmonix::Dsp::Ramper::Tests::TestFlags)
+bool FMultiChannelLinearRamperTest::RunTest(const FString& Parameters)
+{
+	using namespace Harmonix::Dsp::Ramper::Tests;
+
+	FRandomStream RandomStream(4);
+	TArray<float> Actual;
+
+	for (int32 NumChannels = 1; NumChannels <= 9; ++NumChannels)
+	{
+		FMultiChannelLinearRamper MultiChannel(NumChannels, SampleRate);
+		TArray<TLinearRamper<float>> References;
+		for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+		{
+			References.Emplace(SampleRate);
+		}
+
+		const float RampTimeMs = RandomStream.FRandRange(0.1f, 5.0f);
+		MultiChannel.SetRampTimeMs(SampleRate, RampTimeMs);
+		for (TLinearRamper<float>& Reference : References)
+		{
+			Reference.SetRampTimeMs(SampleRate, RampTimeMs);
+		}
+
+		int32 NumMismatches = 0;
+		for (int32 Segment = 0; Segment < 20; ++Segment)
+		{
+			// Only some channels are retargeted, so ramping and settled channels share SIMD lanes
+			for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+			{
+				if (RandomStream.FRand() < 0.5f)
+				{
+					const float Target = RandomStream.FRandRange(0.0f, 2.0f);
+					MultiChannel.SetTarget(Channel, Target);
+					References[Channel].SetTarget(Target);
+				}
+			}
+
+			const int32 NumFrames = RandomStream.RandRange(1, 500);
+			Actual.SetNumUninitialized(NumFrames * NumChannels);
+			MultiChannel.RampBlock(Actual.GetData(), NumFrames);
+
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+				{
+					References[Channel].Ramp();
+					NumMismatches += (References[Channel].GetCurrent() != Actual[Frame * NumChannels + Channel]) ? 1 : 0;
+				}
+			}
+
+			for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+			{
+				TestEqual(TEXT("Channel completes on the same call"), MultiChannel.IsAtTarget(Channel), References[Channel].IsAtTarget());
+			}
+		}
+
+		TestEqual(FString::Printf(TEXT("%d channels match TLinearRamper<float> exactly"), NumChannels), NumMismatches, 0);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
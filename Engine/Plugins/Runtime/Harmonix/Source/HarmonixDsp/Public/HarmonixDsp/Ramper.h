@@ -3,8 +3,11 @@
 #pragma once
 
 #include "HAL/Platform.h"
+#include "Containers/Array.h"
 #include "Math/UnrealMath.h"
+#include "Math/VectorRegister.h"
 #include "Misc/AssertionMacros.h"
+#include <type_traits>
 
 enum class ERamperMode : uint8
 {
@@ -13,6 +16,81 @@ enum class ERamperMode : uint8
 	Exp
 };
 
+namespace Harmonix::Dsp::Ramper::Private
+{
+	/**
+	 * Stores the lanes of VNext that come before the first lane set in VSnap, out of the first NumLanes lanes.
+	 * Returns the index of the first snapping lane, or INDEX_NONE if none of the lanes snap.
+	 */
+	FORCEINLINE int32 StoreUntilSnap(float* Out, int32 NumLanes, const VectorRegister4Float& VNext, const VectorRegister4Float& VSnap)
+	{
+		const int32 SnapMask = VectorMaskBits(VSnap) & ((1 << NumLanes) - 1);
+		if (SnapMask == 0 && NumLanes == 4)
+		{
+			VectorStore(VNext, Out);
+			return INDEX_NONE;
+		}
+
+		alignas(16) float Next[4];
+		VectorStoreAligned(VNext, Next);
+
+		const int32 SnapLane = SnapMask ? (int32)FMath::CountTrailingZeros((uint32)SnapMask) : NumLanes;
+		for (int32 Lane = 0; Lane < SnapLane; ++Lane)
+		{
+			Out[Lane] = Next[Lane];
+		}
+
+		return SnapMask ? SnapLane : INDEX_NONE;
+	}
+
+	/** Writes Start + (Step + 1) * Increment for Step in [0, NumFrames), four frames at a time */
+	FORCEINLINE void WriteLinearSegment(float* Out, int32 NumFrames, float Start, float Increment)
+	{
+		const VectorRegister4Float VStart = VectorSetFloat1(Start);
+		const VectorRegister4Float VIncrement = VectorSetFloat1(Increment);
+		const VectorRegister4Float VFour = VectorSetFloat1(4.0f);
+		VectorRegister4Float VStep = MakeVectorRegisterFloat(1.0f, 2.0f, 3.0f, 4.0f);
+
+		int32 Frame = 0;
+		for (; Frame + 4 <= NumFrames; Frame += 4)
+		{
+			VectorStore(VectorMultiplyAdd(VStep, VIncrement, VStart), Out + Frame);
+			VStep = VectorAdd(VStep, VFour);
+		}
+		for (; Frame < NumFrames; ++Frame)
+		{
+			Out[Frame] = Start + float(Frame + 1) * Increment;
+		}
+	}
+
+	/** Like WriteLinearSegment, wrapping the values into [Min, Max) */
+	FORCEINLINE void WriteCircularSegment(float* Out, int32 NumFrames, float Start, float Increment, float Min, float Max)
+	{
+		const float Range = Max - Min;
+		const VectorRegister4Float VStart = VectorSetFloat1(Start - Min);
+		const VectorRegister4Float VIncrement = VectorSetFloat1(Increment);
+		const VectorRegister4Float VMin = VectorSetFloat1(Min);
+		const VectorRegister4Float VRange = VectorSetFloat1(Range);
+		const VectorRegister4Float VInvRange = VectorSetFloat1(1.0f / Range);
+		const VectorRegister4Float VFour = VectorSetFloat1(4.0f);
+		VectorRegister4Float VStep = MakeVectorRegisterFloat(1.0f, 2.0f, 3.0f, 4.0f);
+
+		int32 Frame = 0;
+		for (; Frame + 4 <= NumFrames; Frame += 4)
+		{
+			const VectorRegister4Float VOffset = VectorMultiplyAdd(VStep, VIncrement, VStart);
+			const VectorRegister4Float VWrapped = VectorSubtract(VOffset, VectorMultiply(VectorFloor(VectorMultiply(VOffset, VInvRange)), VRange));
+			VectorStore(VectorAdd(VWrapped, VMin), Out + Frame);
+			VStep = VectorAdd(VStep, VFour);
+		}
+		for (; Frame < NumFrames; ++Frame)
+		{
+			const float Offset = (Start - Min) + float(Frame + 1) * Increment;
+			Out[Frame] = Min + (Offset - FMath::FloorToFloat(Offset / Range) * Range);
+		}
+	}
+}
+
 class HARMONIXDSP_API FRamper
 {
 public:
@@ -90,6 +168,59 @@ public:
 		}
 	}
 
+	/**
+	 * Ramps NumFrames times, writing the value after each ramp to Out, like calling Ramp() and GetCurrent() for every frame.
+	 * The segment is generated four frames at a time in closed form (start + step * increment, or start * multiplier^step),
+	 * so values can differ from the per call ramp by float rounding, and log and exponential ramps can reach the target one
+	 * frame earlier or later. The completion callback is called at the frame the target is reached.
+	 */
+	void RampBlock(float* Out, int32 NumFrames)
+	{
+		if (NumFrames <= 0)
+		{
+			return;
+		}
+
+		int32 Frame = 0;
+		if (Current != Target)
+		{
+			if (IsSettingTarget)
+			{
+				// Being retargeted from another thread, take it one call at a time
+				for (; Frame < NumFrames; ++Frame)
+				{
+					Ramp();
+					Out[Frame] = Current;
+				}
+				return;
+			}
+
+			switch (Mode)
+			{
+			case ERamperMode::Linear:
+				Frame = LinearRampBlock(Out, NumFrames);
+				break;
+			case ERamperMode::Log:
+				Frame = GeometricRampBlock(Out, NumFrames, 1.0f < Multiplier && 0.0f < Current);
+				break;
+			case ERamperMode::Exp:
+				if (Current <= 0.0f)
+				{
+					Current = 0.001f;
+				}
+				Frame = GeometricRampBlock(Out, NumFrames, 1.0f < Multiplier);
+				break;
+			default:
+				checkNoEntry();
+			}
+		}
+
+		for (; Frame < NumFrames; ++Frame)
+		{
+			Out[Frame] = Current;
+		}
+	}
+
 	void SnapToTarget()
 	{
 		if (IsSettingTarget)
@@ -119,7 +250,7 @@ private:
 
 	void SetTargetLinear(Type InTarget, FCallback InCallback, void* InData)
 	{
-		Type DeltaTarget = Target - Current;
+		Type DeltaTarget = InTarget - Current;
 
 		{
 			IsSettingTarget = true;
@@ -187,7 +318,7 @@ private:
 
 		{
 			IsSettingTarget = true;
-			Type Ratio = FMath::Log2(Target / Current);
+			Type Ratio = FMath::Log2(InTarget / Current);
 			float RampTimeMs = GetRampTimeMs();
 			float RampCallsPerMs = NumRampCallsPerSecond / 1000.0f;
 			float NumCalls = RampTimeMs * RampCallsPerMs;
@@ -236,6 +367,7 @@ private:
 		if (!IsSettingTarget && Multiplier == 1.0f)
 		{
 			SnapToTarget();
+			return;
 		}
 
 		Current = NextValue;
@@ -308,6 +440,7 @@ private:
 		if (!IsSettingTarget && Multiplier == 1.0f)
 		{
 			SnapToTarget();
+			return;
 		}
 
 		Current = NextValue;
@@ -317,6 +450,112 @@ private:
 		}
 	}
 
+	// Returns the number of frames written, stopping after the frame the target is reached
+	int32 LinearRampBlock(float* Out, int32 NumFrames)
+	{
+		using namespace Harmonix::Dsp::Ramper::Private;
+
+		if (NumFrames <= 0)
+		{
+			return 0;
+		}
+
+		if (Increment == 0.0f)
+		{
+			SnapToTarget();
+			Out[0] = Current;
+			return 1;
+		}
+
+		const VectorRegister4Float VStart = VectorSetFloat1(Current);
+		const VectorRegister4Float VIncrement = VectorSetFloat1(Increment);
+		const VectorRegister4Float VTarget = VectorSetFloat1(Target);
+		const VectorRegister4Float VFour = VectorSetFloat1(4.0f);
+		VectorRegister4Float VStep = MakeVectorRegisterFloat(0.0f, 1.0f, 2.0f, 3.0f);
+
+		for (int32 Frame = 0; Frame < NumFrames; Frame += 4)
+		{
+			// Same tests as LinearRamp(), on the value before and after each step
+			const VectorRegister4Float VPrevious = VectorMultiplyAdd(VStep, VIncrement, VStart);
+			const VectorRegister4Float VNext = VectorAdd(VPrevious, VIncrement);
+			const VectorRegister4Float VDelta = VectorSubtract(VTarget, VPrevious);
+			const VectorRegister4Float VSnap = VectorBitwiseOr(
+				VectorSelect(VectorCompareLT(VDelta, VectorZeroFloat()), VectorCompareLE(VIncrement, VDelta), VectorCompareLE(VDelta, VIncrement)),
+				VectorCompareEQ(VNext, VTarget));
+
+			const int32 SnapLane = StoreUntilSnap(Out + Frame, FMath::Min(4, NumFrames - Frame), VNext, VSnap);
+			if (SnapLane != INDEX_NONE)
+			{
+				SnapToTarget();
+				Out[Frame + SnapLane] = Current;
+				return Frame + SnapLane + 1;
+			}
+
+			VStep = VectorAdd(VStep, VFour);
+		}
+
+		Current = Out[NumFrames - 1];
+		return NumFrames;
+	}
+
+	// Returns the number of frames written, stopping after the frame the target is reached
+	int32 GeometricRampBlock(float* Out, int32 NumFrames, bool bRampingUp)
+	{
+		using namespace Harmonix::Dsp::Ramper::Private;
+
+		if (NumFrames <= 0)
+		{
+			return 0;
+		}
+
+		if (Multiplier <= 0.0f)
+		{
+			// Sign flipping ramps are clamped on every call, only the per call ramp gets those right
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				Ramp();
+				Out[Frame] = Current;
+			}
+			return NumFrames;
+		}
+
+		// A target close enough to Current for the multiplier to round to 1 is never passed, snap like LogRamp() and ExponentialRamp()
+		if (Multiplier == 1.0f)
+		{
+			SnapToTarget();
+			Out[0] = Current;
+			return 1;
+		}
+
+		const float Multiplier2 = Multiplier * Multiplier;
+		const VectorRegister4Float VMultiplier = VectorSetFloat1(Multiplier);
+		const VectorRegister4Float VMultiplier4 = VectorSetFloat1(Multiplier2 * Multiplier2);
+		const VectorRegister4Float VTarget = VectorSetFloat1(Target);
+		VectorRegister4Float VPrevious = MakeVectorRegisterFloat(Current, Current * Multiplier, Current * Multiplier2, Current * Multiplier2 * Multiplier);
+
+		for (int32 Frame = 0; Frame < NumFrames; Frame += 4)
+		{
+			// Same tests as LogRamp() and ExponentialRamp()
+			const VectorRegister4Float VNext = VectorMultiply(VPrevious, VMultiplier);
+			const VectorRegister4Float VSnap = VectorBitwiseOr(
+				bRampingUp ? VectorCompareLT(VTarget, VNext) : VectorCompareLT(VNext, VTarget),
+				VectorCompareEQ(VNext, VTarget));
+
+			const int32 SnapLane = StoreUntilSnap(Out + Frame, FMath::Min(4, NumFrames - Frame), VNext, VSnap);
+			if (SnapLane != INDEX_NONE)
+			{
+				SnapToTarget();
+				Out[Frame + SnapLane] = Current;
+				return Frame + SnapLane + 1;
+			}
+
+			VPrevious = VectorMultiply(VPrevious, VMultiplier4);
+		}
+
+		Current = Out[NumFrames - 1];
+		return NumFrames;
+	}
+
 private:
 
 	Type Current;
@@ -427,6 +666,28 @@ protected:
 
 	void InitData() {}
 
+	/**
+	 * Accumulates ProgressPct over up to NumFrames ramp calls exactly like Ramp() does, so block ramps complete on the same frame.
+	 * Returns the number of calls before the one that reaches the target, and whether that call is within NumFrames.
+	 */
+	int32 AdvanceProgress(int32 NumFrames, bool& bOutReachesTarget)
+	{
+		int32 NumCalls = 0;
+		bOutReachesTarget = false;
+		while (NumCalls < NumFrames)
+		{
+			const float Progress = ProgressPct + NormalIncrement;
+			if (Progress >= 1.0f)
+			{
+				bOutReachesTarget = true;
+				break;
+			}
+			ProgressPct = Progress;
+			++NumCalls;
+		}
+		return NumCalls;
+	}
+
 	T CurrentValue;
 	T TargetValue;
 	T Increment;
@@ -503,6 +764,42 @@ public:
 		return true;
 	}
 
+	/**
+	 * Ramps NumFrames times, writing the value after each ramp to Out, like calling Ramp() and GetCurrent() for every frame.
+	 * For float the segment is generated four frames at a time in closed form, so values can differ from Ramp() by float
+	 * rounding, while the target is reached on the same frame. The completion callback is called at that frame.
+	 */
+	void RampBlock(T* Out, int32 NumFrames)
+	{
+		int32 Frame = 0;
+		if constexpr (std::is_same_v<T, float>)
+		{
+			if (this->ProgressPct != 1.0f && !this->IsSettingTarget)
+			{
+				bool bReachesTarget = false;
+				const int32 NumRampFrames = this->AdvanceProgress(NumFrames, bReachesTarget);
+				if (NumRampFrames > 0)
+				{
+					Harmonix::Dsp::Ramper::Private::WriteLinearSegment(Out, NumRampFrames, this->CurrentValue, this->Increment);
+					this->CurrentValue = Out[NumRampFrames - 1];
+				}
+				Frame = NumRampFrames;
+
+				if (bReachesTarget)
+				{
+					this->SnapToTarget();
+					Out[Frame++] = this->CurrentValue;
+				}
+			}
+		}
+
+		for (; Frame < NumFrames; ++Frame)
+		{
+			Ramp();
+			Out[Frame] = this->CurrentValue;
+		}
+	}
+
 	void SnapTo(const T& InValue)
 	{
 		this->SetTarget(InValue);
@@ -623,6 +920,39 @@ public:
 		return true;
 	}
 
+	/** Block version of Ramp(), see TLinearRamper::RampBlock */
+	void RampBlock(T* Out, int32 NumFrames)
+	{
+		int32 Frame = 0;
+		if constexpr (std::is_same_v<T, float>)
+		{
+			// Ramp() wraps once per call, so increments of more than the range only match when ramped one call at a time
+			if (this->ProgressPct != 1.0f && !this->IsSettingTarget && FMath::Abs(this->Increment) < (Max - Min))
+			{
+				bool bReachesTarget = false;
+				const int32 NumRampFrames = this->AdvanceProgress(NumFrames, bReachesTarget);
+				if (NumRampFrames > 0)
+				{
+					Harmonix::Dsp::Ramper::Private::WriteCircularSegment(Out, NumRampFrames, this->CurrentValue, this->Increment, Min, Max);
+					this->CurrentValue = Out[NumRampFrames - 1];
+				}
+				Frame = NumRampFrames;
+
+				if (bReachesTarget)
+				{
+					this->SnapToTarget();
+					Out[Frame++] = this->CurrentValue;
+				}
+			}
+		}
+
+		for (; Frame < NumFrames; ++Frame)
+		{
+			Ramp();
+			Out[Frame] = this->CurrentValue;
+		}
+	}
+
 	void SnapTo(T InValue, bool Circular)
 	{
 		if (Circular)
@@ -785,4 +1115,152 @@ private:
 
 	FRamper::FCallback Callback;
 	void* Data;
-};
\ No newline at end of file
+};
+
+/**
+ * A set of independent linear ramps, e.g. the gains of every channel of a voice, behaving like one TLinearRamper<float>
+ * per channel. The state is kept as structure of arrays so RampBlock advances four channels per SIMD operation. Every
+ * channel accumulates in its own lane exactly like TLinearRamper<float>::Ramp(), so the output is identical to ramping
+ * the channels one call at a time. There are no completion callbacks, poll IsAtTarget() instead.
+ */
+class FMultiChannelLinearRamper
+{
+public:
+	explicit FMultiChannelLinearRamper(int32 InNumChannels = 0, float InNumRampCallsPerSecond = 1.0f)
+		: NumRampCallsPerSecond(InNumRampCallsPerSecond)
+	{
+		SetRampTimeMs(InNumRampCallsPerSecond, 1000.0f);
+		SetNumChannels(InNumChannels);
+	}
+
+	/** Channels are added snapped to 0, existing channels keep their state */
+	void SetNumChannels(int32 InNumChannels)
+	{
+		check(InNumChannels >= 0);
+		NumChannels = InNumChannels;
+
+		// Padded to whole SIMD lanes, padding lanes stay at target
+		const int32 NumLanes = Align(NumChannels, 4);
+		CurrentValues.SetNumZeroed(NumLanes);
+		TargetValues.SetNumZeroed(NumLanes);
+		Increments.SetNumZeroed(NumLanes);
+
+		const int32 OldNumLanes = ProgressPcts.Num();
+		ProgressPcts.SetNumUninitialized(NumLanes);
+		for (int32 Lane = OldNumLanes; Lane < NumLanes; ++Lane)
+		{
+			ProgressPcts[Lane] = 1.0f;
+		}
+		for (int32 Lane = NumChannels; Lane < NumLanes; ++Lane)
+		{
+			CurrentValues[Lane] = TargetValues[Lane] = Increments[Lane] = 0.0f;
+			ProgressPcts[Lane] = 1.0f;
+		}
+	}
+
+	int32 GetNumChannels() const { return NumChannels; }
+
+	/** Same as TRamper::SetRampTimeMs, applies to all channels from their next SetTarget */
+	void SetRampTimeMs(float InNumRampCallsPerSecond, float InRampTimeMs)
+	{
+		NumRampCallsPerSecond = InNumRampCallsPerSecond;
+		NormalIncrement = (InRampTimeMs == 0.0f) ? 1.0f : 1000.0f / (NumRampCallsPerSecond * InRampTimeMs);
+	}
+
+	void SetTarget(int32 Channel, float InTarget)
+	{
+		check(Channel >= 0 && Channel < NumChannels);
+		Increments[Channel] = (InTarget + (CurrentValues[Channel] * (-1))) * NormalIncrement;
+		TargetValues[Channel] = InTarget;
+		ProgressPcts[Channel] = 0.0f;
+	}
+
+	void SnapTo(int32 Channel, float InValue)
+	{
+		check(Channel >= 0 && Channel < NumChannels);
+		CurrentValues[Channel] = TargetValues[Channel] = InValue;
+		Increments[Channel] = 0.0f;
+		ProgressPcts[Channel] = 1.0f;
+	}
+
+	float GetCurrent(int32 Channel) const { return CurrentValues[Channel]; }
+	float GetTarget(int32 Channel) const { return TargetValues[Channel]; }
+	bool IsAtTarget(int32 Channel) const { return ProgressPcts[Channel] == 1.0f; }
+
+	bool IsAtTarget() const
+	{
+		for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+		{
+			if (ProgressPcts[Channel] != 1.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Ramps every channel NumFrames times, writing the values after each ramp interleaved to Out (NumFrames * NumChannels floats) */
+	void RampBlock(float* Out, int32 NumFrames)
+	{
+		if (NumChannels == 0 || NumFrames <= 0)
+		{
+			return;
+		}
+
+		const VectorRegister4Float VNormalIncrement = VectorSetFloat1(NormalIncrement);
+		const VectorRegister4Float VOne = VectorOneFloat();
+		const int32 NumFullGroupChannels = NumChannels & ~3;
+
+		for (int32 Channel = 0; Channel < NumChannels; Channel += 4)
+		{
+			VectorRegister4Float VCurrent = VectorLoadAligned(CurrentValues.GetData() + Channel);
+			VectorRegister4Float VProgress = VectorLoadAligned(ProgressPcts.GetData() + Channel);
+			const VectorRegister4Float VTarget = VectorLoadAligned(TargetValues.GetData() + Channel);
+			const VectorRegister4Float VIncrement = VectorLoadAligned(Increments.GetData() + Channel);
+			const int32 NumGroupChannels = FMath::Min(4, NumChannels - Channel);
+
+			float* OutFrame = Out + Channel;
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				// Same as TLinearRamper::Ramp() for the lanes that are not at target yet
+				const VectorRegister4Float VRamping = VectorCompareNE(VProgress, VOne);
+				VProgress = VectorSelect(VRamping, VectorAdd(VProgress, VNormalIncrement), VProgress);
+				VCurrent = VectorSelect(VRamping, VectorAdd(VCurrent, VIncrement), VCurrent);
+
+				const VectorRegister4Float VReached = VectorCompareGE(VProgress, VOne);
+				VCurrent = VectorSelect(VReached, VTarget, VCurrent);
+				VProgress = VectorSelect(VReached, VOne, VProgress);
+
+				if (Channel < NumFullGroupChannels)
+				{
+					VectorStore(VCurrent, OutFrame);
+				}
+				else
+				{
+					alignas(16) float Values[4];
+					VectorStoreAligned(VCurrent, Values);
+					for (int32 Lane = 0; Lane < NumGroupChannels; ++Lane)
+					{
+						OutFrame[Lane] = Values[Lane];
+					}
+				}
+				OutFrame += NumChannels;
+			}
+
+			VectorStoreAligned(VCurrent, CurrentValues.GetData() + Channel);
+			VectorStoreAligned(VProgress, ProgressPcts.GetData() + Channel);
+		}
+	}
+
+private:
+	using FLaneArray = TArray<float, TAlignedHeapAllocator<16>>;
+
+	FLaneArray CurrentValues;
+	FLaneArray TargetValues;
+	FLaneArray Increments;
+	FLaneArray ProgressPcts;
+
+	float NormalIncrement = 1.0f;
+	float NumRampCallsPerSecond;
+	int32 NumChannels = 0;
+};
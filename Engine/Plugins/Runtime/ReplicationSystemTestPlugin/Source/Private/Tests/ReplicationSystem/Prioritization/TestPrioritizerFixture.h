@@ -0,0 +1,106 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Tests/ReplicationSystem/ReplicationSystemServerClientTestFixture.h"
+#include "Iris/ReplicationSystem/NetRefHandleManager.h"
+#include "Iris/ReplicationSystem/Prioritization/NetObjectPrioritizerDefinitions.h"
+#include "Iris/ReplicationSystem/Prioritization/ReplicationPrioritization.h"
+#include "Iris/ReplicationSystem/ReplicationSystemInternal.h"
+#include "HAL/PlatformTime.h"
+
+namespace UE::Net::Private
+{
+
+/** Server/client fixture that replaces the prioritizer definitions with the ones returned by GetPrioritizerDefinitions for the duration of a test. */
+class FTestPrioritizerFixture : public FReplicationSystemServerClientTestFixture
+{
+protected:
+	virtual TArray<FNetObjectPrioritizerDefinition> GetPrioritizerDefinitions() const = 0;
+
+	virtual void SetUp() override
+	{
+		InitNetObjectPrioritizerDefinitions();
+		FReplicationSystemServerClientTestFixture::SetUp();
+	}
+
+	virtual void TearDown() override
+	{
+		FReplicationSystemServerClientTestFixture::TearDown();
+		RestoreNetObjectPrioritizerDefinitions();
+	}
+
+	static FNetObjectPrioritizerDefinition MakePrioritizerDefinition(FName PrioritizerName, const TCHAR* ClassName, const TCHAR* ConfigClassName)
+	{
+		FNetObjectPrioritizerDefinition Definition;
+		Definition.PrioritizerName = PrioritizerName;
+		Definition.ClassName = ClassName;
+		Definition.ConfigClassName = ConfigClassName;
+		return Definition;
+	}
+
+	/** Average time in milliseconds the server spends in PreSendUpdate, which is where prioritization happens. */
+	double MeasurePreSendUpdateMilliseconds(uint32 IterationCount)
+	{
+		// Warm up
+		Server->PreSendUpdate();
+		Server->PostSendUpdate();
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		for (uint32 It = 0; It < IterationCount; ++It)
+		{
+			Server->PreSendUpdate();
+			Server->PostSendUpdate();
+		}
+		return FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles)/IterationCount;
+	}
+
+	/** Runs a server update and returns the priority of each object for the connection, in the order of Objects. */
+	TArray<float> PrioritizeAndGetPriorities(uint32 ConnectionId, TConstArrayView<UReplicatedTestObject*> Objects)
+	{
+		Server->PreSendUpdate();
+
+		FReplicationSystemInternal* ReplicationSystemInternal = Server->GetReplicationSystem()->GetReplicationSystemInternal();
+		const FNetRefHandleManager& NetRefHandleManager = ReplicationSystemInternal->GetNetRefHandleManager();
+		const TArrayView<const float> ConnectionPriorities = ReplicationSystemInternal->GetPrioritization().GetPrioritiesForConnection(ConnectionId);
+
+		TArray<float> Priorities;
+		Priorities.Reserve(Objects.Num());
+		for (const UReplicatedTestObject* Object : Objects)
+		{
+			Priorities.Add(ConnectionPriorities[NetRefHandleManager.GetInternalIndex(Object->NetRefHandle)]);
+		}
+
+		Server->PostSendUpdate();
+		return Priorities;
+	}
+
+private:
+	void InitNetObjectPrioritizerDefinitions()
+	{
+		const UClass* NetObjectPrioritizerDefinitionsClass = UNetObjectPrioritizerDefinitions::StaticClass();
+		const FProperty* DefinitionsProperty = NetObjectPrioritizerDefinitionsClass->FindPropertyByName(TEXT("NetObjectPrioritizerDefinitions"));
+		check(DefinitionsProperty != nullptr && DefinitionsProperty->GetClass() == FArrayProperty::StaticClass());
+
+		// Save NetObjectPrioritizerDefinitions CDO state.
+		UNetObjectPrioritizerDefinitions* PrioritizerDefinitions = GetMutableDefault<UNetObjectPrioritizerDefinitions>();
+		DefinitionsProperty->CopyCompleteValue(&OriginalPrioritizerDefinitions, (void*)(UPTRINT(PrioritizerDefinitions) + DefinitionsProperty->GetOffset_ForInternal()));
+
+		TArray<FNetObjectPrioritizerDefinition> NewPrioritizerDefinitions = GetPrioritizerDefinitions();
+		DefinitionsProperty->CopyCompleteValue((void*)(UPTRINT(PrioritizerDefinitions) + DefinitionsProperty->GetOffset_ForInternal()), &NewPrioritizerDefinitions);
+		PrioritizerDefinitions->LoadDefinitions();
+	}
+
+	void RestoreNetObjectPrioritizerDefinitions()
+	{
+		const UClass* NetObjectPrioritizerDefinitionsClass = UNetObjectPrioritizerDefinitions::StaticClass();
+		const FProperty* DefinitionsProperty = NetObjectPrioritizerDefinitionsClass->FindPropertyByName(TEXT("NetObjectPrioritizerDefinitions"));
+		UNetObjectPrioritizerDefinitions* PrioritizerDefinitions = GetMutableDefault<UNetObjectPrioritizerDefinitions>();
+		DefinitionsProperty->CopyCompleteValue((void*)(UPTRINT(PrioritizerDefinitions) + DefinitionsProperty->GetOffset_ForInternal()), &OriginalPrioritizerDefinitions);
+		PrioritizerDefinitions->LoadDefinitions();
+	}
+
+	TArray<FNetObjectPrioritizerDefinition> OriginalPrioritizerDefinitions;
+};
+
+}
@@ -0,0 +1,141 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Tests/ReplicationSystem/Prioritization/TestPrioritizerFixture.h"
+#include "Iris/ReplicationSystem/Prioritization/SpatialGridSphereWithOwnerBoostNetObjectPrioritizer.h"
+#include "Iris/ReplicationSystem/ReplicationView.h"
+
+namespace UE::Net::Private
+{
+
+class FTestSpatialGridSphereWithOwnerBoostPrioritizerPerfFixture : public FTestPrioritizerFixture
+{
+protected:
+	static inline const FName SpherePrioritizerName = TEXT("SphereWithOwnerBoostPerf");
+	static inline const FName SpatialGridPrioritizerName = TEXT("SpatialGridSphereWithOwnerBoostPerf");
+
+	virtual TArray<FNetObjectPrioritizerDefinition> GetPrioritizerDefinitions() const override
+	{
+		return
+		{
+			MakePrioritizerDefinition(SpherePrioritizerName, TEXT("/Script/IrisCore.SphereWithOwnerBoostNetObjectPrioritizer"), TEXT("/Script/IrisCore.SphereWithOwnerBoostNetObjectPrioritizerConfig")),
+			MakePrioritizerDefinition(SpatialGridPrioritizerName, TEXT("/Script/IrisCore.SpatialGridSphereWithOwnerBoostNetObjectPrioritizer"), TEXT("/Script/IrisCore.SpatialGridSphereWithOwnerBoostNetObjectPrioritizerConfig")),
+		};
+	}
+
+	virtual void SetUp() override
+	{
+		FTestPrioritizerFixture::SetUp();
+		SpherePrioritizerHandle = Server->GetReplicationSystem()->GetPrioritizerHandle(SpherePrioritizerName);
+		SpatialGridPrioritizerHandle = Server->GetReplicationSystem()->GetPrioritizerHandle(SpatialGridPrioritizerName);
+	}
+
+	void SetPrioritizer(TConstArrayView<UReplicatedTestObject*> Objects, FNetObjectPrioritizerHandle PrioritizerHandle)
+	{
+		for (const UReplicatedTestObject* Object : Objects)
+		{
+			Server->GetReplicationSystem()->SetPrioritizer(Object->NetRefHandle, PrioritizerHandle);
+		}
+	}
+
+	FNetObjectPrioritizerHandle SpherePrioritizerHandle = InvalidNetObjectPrioritizerHandle;
+	FNetObjectPrioritizerHandle SpatialGridPrioritizerHandle = InvalidNetObjectPrioritizerHandle;
+};
+
+UE_NET_TEST_FIXTURE(FTestSpatialGridSphereWithOwnerBoostPrioritizerPerfFixture, SpatialGridPrioritiesMatchSphere)
+{
+	UE_NET_ASSERT_NE(SpherePrioritizerHandle, InvalidNetObjectPrioritizerHandle);
+	UE_NET_ASSERT_NE(SpatialGridPrioritizerHandle, InvalidNetObjectPrioritizerHandle);
+
+	// Objects are at the origin. The views are inside the inner radius, between the radii and outside the outer radius,
+	// so both the objects the grid culls and the ones it passes on to the sphere prioritization are covered.
+	const FVector ViewPositions[] = {FVector::ZeroVector, FVector(5000.0, 0.0, 0.0), FVector(1.0e6, 0.0, 0.0)};
+	TArray<FReplicationSystemTestClient*> Clients;
+	for (const FVector& ViewPosition : ViewPositions)
+	{
+		FReplicationSystemTestClient* Client = CreateClient();
+		Clients.Add(Client);
+
+		FReplicationView View;
+		View.Views.AddDefaulted_GetRef().Pos = ViewPosition;
+		Server->GetReplicationSystem()->SetReplicationView(Client->ConnectionIdOnServer, View);
+	}
+
+	// Above MinObjectCountForCulling so the grid is used, with objects owned by every connection
+	constexpr uint32 ObjectCount = 2048U;
+	TArray<UReplicatedTestObject*> ServerObjects;
+	for (uint32 ObjectIt = 0; ObjectIt < ObjectCount; ++ObjectIt)
+	{
+		UReplicatedTestObject* ServerObject = Server->CreateObject(0, 0);
+		if ((ObjectIt % 5U) == 0U)
+		{
+			Server->GetReplicationSystem()->SetOwningNetConnection(ServerObject->NetRefHandle, Clients[ObjectIt % Clients.Num()]->ConnectionIdOnServer);
+		}
+		ServerObjects.Add(ServerObject);
+	}
+
+	TArray<TArray<float>> SpherePriorities;
+	SetPrioritizer(ServerObjects, SpherePrioritizerHandle);
+	Server->PreSendUpdate();
+	Server->PostSendUpdate();
+	for (const FReplicationSystemTestClient* Client : Clients)
+	{
+		SpherePriorities.Add(PrioritizeAndGetPriorities(Client->ConnectionIdOnServer, ServerObjects));
+	}
+
+	SetPrioritizer(ServerObjects, SpatialGridPrioritizerHandle);
+	Server->PreSendUpdate();
+	Server->PostSendUpdate();
+	for (int32 ClientIt = 0; ClientIt < Clients.Num(); ++ClientIt)
+	{
+		const TArray<float> SpatialGridPriorities = PrioritizeAndGetPriorities(Clients[ClientIt]->ConnectionIdOnServer, ServerObjects);
+
+		UE_NET_ASSERT_EQ(SpatialGridPriorities.Num(), SpherePriorities[ClientIt].Num());
+		uint32 MismatchCount = 0;
+		for (int32 ObjectIt = 0; ObjectIt < SpatialGridPriorities.Num(); ++ObjectIt)
+		{
+			MismatchCount += SpatialGridPriorities[ObjectIt] != SpherePriorities[ClientIt][ObjectIt] ? 1U : 0U;
+		}
+		UE_NET_ASSERT_EQ(MismatchCount, 0U);
+	}
+}
+
+UE_NET_TEST_FIXTURE(FTestSpatialGridSphereWithOwnerBoostPrioritizerPerfFixture, SpatialGridVersusSpherePrioritizationTime)
+{
+	UE_NET_ASSERT_NE(SpherePrioritizerHandle, InvalidNetObjectPrioritizerHandle);
+	UE_NET_ASSERT_NE(SpatialGridPrioritizerHandle, InvalidNetObjectPrioritizerHandle);
+
+	constexpr uint32 IterationCount = 8U;
+	constexpr uint32 ConnectionCount = 32U;
+	const uint32 ObjectCounts[] = {1024U, 8192U, 50000U};
+
+	// Objects stay at the origin. Every fourth connection looks at them, the others are far away,
+	// which is where culling by grid cell saves the sphere prioritization.
+	for (uint32 ConnectionIt = 0; ConnectionIt < ConnectionCount; ++ConnectionIt)
+	{
+		FReplicationSystemTestClient* Client = CreateClient();
+
+		FReplicationView View;
+		FReplicationView::FView& ViewInfo = View.Views.AddDefaulted_GetRef();
+		ViewInfo.Pos = (ConnectionIt % 4U) == 0U ? FVector::ZeroVector : FVector(1.0e6 + ConnectionIt*1.0e4, 0.0, 0.0);
+		Server->GetReplicationSystem()->SetReplicationView(Client->ConnectionIdOnServer, View);
+	}
+
+	TArray<UReplicatedTestObject*> ServerObjects;
+	for (const uint32 TargetObjectCount : ObjectCounts)
+	{
+		while (static_cast<uint32>(ServerObjects.Num()) < TargetObjectCount)
+		{
+			ServerObjects.Add(Server->CreateObject(0, 0));
+		}
+
+		SetPrioritizer(ServerObjects, SpherePrioritizerHandle);
+		const double SphereMilliseconds = MeasurePreSendUpdateMilliseconds(IterationCount);
+
+		SetPrioritizer(ServerObjects, SpatialGridPrioritizerHandle);
+		const double SpatialGridMilliseconds = MeasurePreSendUpdateMilliseconds(IterationCount);
+
+		UE_LOG(LogIris, Display, TEXT("%u connections, %u objects: SphereWithOwnerBoost %.3f ms, SpatialGridSphereWithOwnerBoost %.3f ms"), ConnectionCount, TargetObjectCount, SphereMilliseconds, SpatialGridMilliseconds);
+	}
+}
+
+}
@@ -0,0 +1,157 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Tests/ReplicationSystem/Prioritization/TestPrioritizerFixture.h"
+#include "Iris/ReplicationSystem/Prioritization/SphereWithOwnerBoostNetObjectPrioritizer.h"
+#include "Iris/ReplicationSystem/ReplicationView.h"
+#include "HAL/IConsoleManager.h"
+
+namespace UE::Net::Private
+{
+
+class FTestSphereWithOwnerBoostPrioritizerPerfFixture : public FTestPrioritizerFixture
+{
+protected:
+	static inline const FName PrioritizerName = TEXT("SphereWithOwnerBoostPerf");
+
+	virtual TArray<FNetObjectPrioritizerDefinition> GetPrioritizerDefinitions() const override
+	{
+		return { MakePrioritizerDefinition(PrioritizerName, TEXT("/Script/IrisCore.SphereWithOwnerBoostNetObjectPrioritizer"), TEXT("/Script/IrisCore.SphereWithOwnerBoostNetObjectPrioritizerConfig")) };
+	}
+
+	virtual void SetUp() override
+	{
+		FTestPrioritizerFixture::SetUp();
+		PrioritizerHandle = Server->GetReplicationSystem()->GetPrioritizerHandle(PrioritizerName);
+
+		ParallelObjectCountCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("net.Iris.SphereWithOwnerBoostPrioritizer.ParallelObjectCount"));
+		OriginalParallelObjectCount = ParallelObjectCountCVar ? ParallelObjectCountCVar->GetInt() : 0;
+	}
+
+	virtual void TearDown() override
+	{
+		if (ParallelObjectCountCVar)
+		{
+			ParallelObjectCountCVar->Set(OriginalParallelObjectCount, ECVF_SetByCode);
+		}
+		FTestPrioritizerFixture::TearDown();
+	}
+
+	FNetObjectPrioritizerHandle PrioritizerHandle = InvalidNetObjectPrioritizerHandle;
+	IConsoleVariable* ParallelObjectCountCVar = nullptr;
+	int32 OriginalParallelObjectCount = 0;
+};
+
+UE_NET_TEST_FIXTURE(FTestSphereWithOwnerBoostPrioritizerPerfFixture, ParallelPrioritizationMatchesSerial)
+{
+	UE_NET_ASSERT_NE(PrioritizerHandle, InvalidNetObjectPrioritizerHandle);
+	UE_NET_ASSERT_NE(ParallelObjectCountCVar, nullptr);
+
+	// Views inside the inner radius, between the radii and outside the outer radius of the objects at the origin
+	const FVector ViewPositions[] = {FVector::ZeroVector, FVector(5000.0, 0.0, 0.0), FVector(1.0e6, 0.0, 0.0)};
+	TArray<FReplicationSystemTestClient*> Clients;
+	for (const FVector& ViewPosition : ViewPositions)
+	{
+		FReplicationSystemTestClient* Client = CreateClient();
+		Clients.Add(Client);
+
+		FReplicationView View;
+		View.Views.AddDefaulted_GetRef().Pos = ViewPosition;
+		Server->GetReplicationSystem()->SetReplicationView(Client->ConnectionIdOnServer, View);
+	}
+
+	// Several batches, with objects owned by every connection spread over them
+	constexpr uint32 ObjectCount = 4500U;
+	TArray<UReplicatedTestObject*> ServerObjects;
+	for (uint32 ObjectIt = 0; ObjectIt < ObjectCount; ++ObjectIt)
+	{
+		UReplicatedTestObject* ServerObject = Server->CreateObject(0, 0);
+		Server->GetReplicationSystem()->SetPrioritizer(ServerObject->NetRefHandle, PrioritizerHandle);
+		if ((ObjectIt % 7U) == 0U)
+		{
+			Server->GetReplicationSystem()->SetOwningNetConnection(ServerObject->NetRefHandle, Clients[ObjectIt % Clients.Num()]->ConnectionIdOnServer);
+		}
+		ServerObjects.Add(ServerObject);
+	}
+
+	for (const FReplicationSystemTestClient* Client : Clients)
+	{
+		ParallelObjectCountCVar->Set(0, ECVF_SetByCode);
+		const TArray<float> SerialPriorities = PrioritizeAndGetPriorities(Client->ConnectionIdOnServer, ServerObjects);
+
+		ParallelObjectCountCVar->Set(1, ECVF_SetByCode);
+		const TArray<float> ParallelPriorities = PrioritizeAndGetPriorities(Client->ConnectionIdOnServer, ServerObjects);
+
+		UE_NET_ASSERT_EQ(SerialPriorities.Num(), ParallelPriorities.Num());
+		uint32 MismatchCount = 0;
+		for (int32 ObjectIt = 0; ObjectIt < SerialPriorities.Num(); ++ObjectIt)
+		{
+			MismatchCount += SerialPriorities[ObjectIt] != ParallelPriorities[ObjectIt] ? 1U : 0U;
+		}
+		UE_NET_ASSERT_EQ(MismatchCount, 0U);
+	}
+}
+
+UE_NET_TEST_FIXTURE(FTestSphereWithOwnerBoostPrioritizerPerfFixture, PrioritizationTimeVersusConnectionAndObjectCount)
+{
+	UE_NET_ASSERT_NE(PrioritizerHandle, InvalidNetObjectPrioritizerHandle);
+	UE_NET_ASSERT_NE(ParallelObjectCountCVar, nullptr);
+
+	constexpr uint32 IterationCount = 8U;
+	const uint32 ConnectionCounts[] = {1U, 16U, 64U, 150U};
+	const uint32 ObjectCounts[] = {2048U, 4096U, 8192U, 16384U, 32768U};
+
+	// Objects are recreated for every connection count so that each one goes through every object count
+	uint32 ConnectionCount = 0;
+	TArray<UReplicatedTestObject*> ServerObjects;
+	for (const uint32 TargetConnectionCount : ConnectionCounts)
+	{
+		for (; ConnectionCount < TargetConnectionCount; ++ConnectionCount)
+		{
+			CreateClient();
+		}
+
+		uint32 BreakEvenObjectCount = 0;
+		for (const uint32 TargetObjectCount : ObjectCounts)
+		{
+			while (static_cast<uint32>(ServerObjects.Num()) < TargetObjectCount)
+			{
+				UReplicatedTestObject* ServerObject = Server->CreateObject(0, 0);
+				Server->GetReplicationSystem()->SetPrioritizer(ServerObject->NetRefHandle, PrioritizerHandle);
+				ServerObjects.Add(ServerObject);
+			}
+			const uint32 ObjectCount = TargetObjectCount;
+
+			ParallelObjectCountCVar->Set(0, ECVF_SetByCode);
+			const double SerialMilliseconds = MeasurePreSendUpdateMilliseconds(IterationCount);
+
+			ParallelObjectCountCVar->Set(1, ECVF_SetByCode);
+			const double ParallelMilliseconds = MeasurePreSendUpdateMilliseconds(IterationCount);
+
+			if (BreakEvenObjectCount == 0U && ParallelMilliseconds < SerialMilliseconds)
+			{
+				BreakEvenObjectCount = ObjectCount;
+			}
+
+			UE_LOG(LogIris, Display, TEXT("SphereWithOwnerBoost prioritization: %u connections, %u objects: serial %.3f ms, parallel %.3f ms"), ConnectionCount, ObjectCount, SerialMilliseconds, ParallelMilliseconds);
+		}
+
+		if (BreakEvenObjectCount > 0U)
+		{
+			UE_LOG(LogIris, Display, TEXT("SphereWithOwnerBoost prioritization: %u connections: parallel is faster from %u objects, a candidate for net.Iris.SphereWithOwnerBoostPrioritizer.ParallelObjectCount"), ConnectionCount, BreakEvenObjectCount);
+		}
+		else
+		{
+			UE_LOG(LogIris, Display, TEXT("SphereWithOwnerBoost prioritization: %u connections: parallel is never faster up to %u objects, leave net.Iris.SphereWithOwnerBoostPrioritizer.ParallelObjectCount at 0"), ConnectionCount, static_cast<uint32>(ServerObjects.Num()));
+		}
+
+		for (UReplicatedTestObject* ServerObject : ServerObjects)
+		{
+			Server->DestroyObject(ServerObject);
+		}
+		ServerObjects.Reset();
+		Server->PreSendUpdate();
+		Server->PostSendUpdate();
+	}
+}
+
+}
@@ -0,0 +1,226 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "NetworkAutomationTest.h"
+#include "NetworkAutomationTestMacros.h"
+#include "Iris/Serialization/EnumNetSerializerBatch.h"
+#include "Iris/Serialization/NetSerializationContext.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "UObject/Class.h"
+#include "UObject/CoreNetTypes.h"
+#include "UObject/Package.h"
+
+namespace UE::Net::Private
+{
+
+static FEnumUint8NetSerializerConfig MakeNetRoleConfig()
+{
+	FEnumUint8NetSerializerConfig Config;
+	Config.LowerBound = ROLE_None;
+	Config.UpperBound = ROLE_MAX - 1;
+	Config.BitCount = 2;
+	Config.Enum = StaticEnum<ENetRole>();
+	return Config;
+}
+
+static FEnumInt32NetSerializerConfig MakeIntRangeConfig()
+{
+	FEnumInt32NetSerializerConfig Config;
+	Config.LowerBound = -1000;
+	Config.UpperBound = 1000;
+	Config.BitCount = 11;
+	Config.Enum = nullptr;
+	return Config;
+}
+
+/** Sets the values of a transient enum to Scale*Index + Offset for NumValues indices, too many for the scalar path to scan them. */
+static void SetGappedEnumValues(UEnum* Enum, int32 NumValues, int64 Scale, int64 Offset)
+{
+	TArray<TPair<FName, int64>> Names;
+	for (int32 Index = 0; Index < NumValues; ++Index)
+	{
+		Names.Emplace(FName(TEXT("IrisTestGappedEnumValue"), Index + 1), Scale*Index + Offset);
+	}
+	constexpr bool bAddMaxKeyIfMissing = false;
+	Enum->SetEnums(Names, UEnum::ECppForm::Regular, EEnumFlags::None, bAddMaxKeyIfMissing);
+}
+
+static bool ValidateScalar(const FEnumUint8NetSerializerConfig& Config, uint8 Value)
+{
+	FNetSerializationContext Context;
+	FNetValidateArgs Args = {};
+	Args.NetSerializerConfig = NetSerializerConfigParam(&Config);
+	Args.Source = NetSerializerValuePointer(&Value);
+	return UE_NET_GET_SERIALIZER(FEnumUint8NetSerializer).Validate(Context, Args);
+}
+
+static bool ValidateScalar(const FEnumInt32NetSerializerConfig& Config, int32 Value)
+{
+	FNetSerializationContext Context;
+	FNetValidateArgs Args = {};
+	Args.NetSerializerConfig = NetSerializerConfigParam(&Config);
+	Args.Source = NetSerializerValuePointer(&Value);
+	return UE_NET_GET_SERIALIZER(FEnumInt32NetSerializer).Validate(Context, Args);
+}
+
+static uint32 QuantizeScalar(const FEnumInt32NetSerializerConfig& Config, int32 Value)
+{
+	FNetSerializationContext Context;
+	uint32 Quantized = 0;
+	FNetQuantizeArgs Args = {};
+	Args.NetSerializerConfig = NetSerializerConfigParam(&Config);
+	Args.Source = NetSerializerValuePointer(&Value);
+	Args.Target = NetSerializerValuePointer(&Quantized);
+	UE_NET_GET_SERIALIZER(FEnumInt32NetSerializer).Quantize(Context, Args);
+	return Quantized;
+}
+
+UE_NET_TEST(EnumNetSerializerBatch, ValidateMatchesScalarValidate)
+{
+	const FEnumUint8NetSerializerConfig Config = MakeNetRoleConfig();
+	const FNetSerializer& Serializer = UE_NET_GET_SERIALIZER(FEnumUint8NetSerializer);
+
+	// Every value on its own, including the generated _MAX value and values outside of the range
+	for (uint32 Value = 0; Value < 256U; ++Value)
+	{
+		const uint8 Value8 = static_cast<uint8>(Value);
+
+		FNetSerializationContext Context;
+		FNetValidateArgs Args = {};
+		Args.NetSerializerConfig = NetSerializerConfigParam(&Config);
+		Args.Source = NetSerializerValuePointer(&Value8);
+		UE_NET_ASSERT_EQ(ValidateEnumValues(Config, &Value8, 1U), Serializer.Validate(Context, Args));
+	}
+
+	// Arrays of valid values with one invalid value at every position, covering whole blocks and the tail
+	TArray<uint8> Values;
+	for (uint32 ValueIt = 0; ValueIt < 37U; ++ValueIt)
+	{
+		Values.Add(static_cast<uint8>(ValueIt % ROLE_MAX));
+	}
+	UE_NET_ASSERT_TRUE(ValidateEnumValues(Config, Values.GetData(), Values.Num()));
+	UE_NET_ASSERT_TRUE(ValidateEnumValues(Config, Values.GetData(), 0U));
+
+	for (int32 InvalidIt = 0; InvalidIt < Values.Num(); ++InvalidIt)
+	{
+		const uint8 PrevValue = Values[InvalidIt];
+		Values[InvalidIt] = ROLE_MAX;
+		UE_NET_ASSERT_FALSE(ValidateEnumValues(Config, Values.GetData(), Values.Num()));
+		Values[InvalidIt] = PrevValue;
+	}
+}
+
+UE_NET_TEST(EnumNetSerializerBatch, ValidateIntRangeMatchesScalarValidate)
+{
+	const FEnumInt32NetSerializerConfig Config = MakeIntRangeConfig();
+
+	FRandomStream Random(0x1715);
+	TArray<int32> Values;
+	for (uint32 ValueIt = 0; ValueIt < 1000U; ++ValueIt)
+	{
+		const int32 Value = Random.RandRange(-1100, 1100);
+		UE_NET_ASSERT_EQ(ValidateEnumValues(Config, &Value, 1U), ValidateScalar(Config, Value));
+		if (Value >= Config.LowerBound && Value <= Config.UpperBound)
+		{
+			Values.Add(Value);
+		}
+	}
+
+	UE_NET_ASSERT_TRUE(ValidateEnumValues(Config, Values.GetData(), Values.Num()));
+	Values.Add(Config.UpperBound + 1);
+	UE_NET_ASSERT_FALSE(ValidateEnumValues(Config, Values.GetData(), Values.Num()));
+}
+
+UE_NET_TEST(EnumNetSerializerBatch, ValidateGappedEnumMatchesEnum)
+{
+	constexpr int32 NumValues = 40;
+	UEnum* Enum = NewObject<UEnum>(GetTransientPackage(), TEXT("IrisTestGappedEnum"), RF_Transient);
+	SetGappedEnumValues(Enum, NumValues, 3, 0);
+
+	FEnumUint8NetSerializerConfig Config;
+	Config.LowerBound = 0;
+	Config.UpperBound = 3*NumValues;
+	Config.BitCount = 7;
+	Config.Enum = Enum;
+
+	for (uint8 Value = Config.LowerBound; Value <= Config.UpperBound; ++Value)
+	{
+		const bool bIsValid = Enum->IsValidEnumValue(Value);
+		UE_NET_ASSERT_EQ(ValidateScalar(Config, Value), bIsValid);
+		UE_NET_ASSERT_EQ(ValidateEnumValues(Config, &Value, 1U), bIsValid);
+	}
+
+#if WITH_EDITOR
+	// Same number of values, different values, as when a user defined enum is edited. The enum editor finishes with PostEditChange.
+	SetGappedEnumValues(Enum, NumValues, 3, 1);
+	Enum->PostEditChange();
+	for (uint8 Value = Config.LowerBound; Value <= Config.UpperBound; ++Value)
+	{
+		const bool bIsValid = Enum->IsValidEnumValue(Value);
+		UE_NET_ASSERT_EQ(ValidateScalar(Config, Value), bIsValid);
+		UE_NET_ASSERT_EQ(ValidateEnumValues(Config, &Value, 1U), bIsValid);
+	}
+#endif
+
+	Enum->MarkAsGarbage();
+}
+
+UE_NET_TEST(EnumNetSerializerBatch, QuantizeMatchesScalarQuantize)
+{
+	const FEnumInt32NetSerializerConfig Config = MakeIntRangeConfig();
+
+	FRandomStream Random(0x2a11);
+	TArray<int32> Values;
+	for (uint32 ValueIt = 0; ValueIt < 1000U; ++ValueIt)
+	{
+		Values.Add(Random.RandRange(-1100, 1100));
+	}
+
+	TArray<uint32> Quantized;
+	Quantized.SetNumZeroed(Values.Num());
+	QuantizeEnumValues(Config, Values.GetData(), Quantized.GetData(), Values.Num());
+
+	for (int32 ValueIt = 0; ValueIt < Values.Num(); ++ValueIt)
+	{
+		const uint32 Expected = QuantizeScalar(Config, Values[ValueIt]);
+		UE_NET_ASSERT_EQ(Quantized[ValueIt], Expected);
+	}
+}
+
+UE_NET_TEST(EnumNetSerializerBatch, ValidateThroughput)
+{
+	const FEnumUint8NetSerializerConfig Config = MakeNetRoleConfig();
+	const FNetSerializer& Serializer = UE_NET_GET_SERIALIZER(FEnumUint8NetSerializer);
+
+	constexpr int32 ValueCount = 1024*1024;
+	TArray<uint8> Values;
+	Values.SetNumUninitialized(ValueCount);
+	for (int32 ValueIt = 0; ValueIt < ValueCount; ++ValueIt)
+	{
+		Values[ValueIt] = static_cast<uint8>(ValueIt % ROLE_MAX);
+	}
+
+	const uint64 ScalarStartCycles = FPlatformTime::Cycles64();
+	bool bScalarValid = true;
+	for (const uint8& Value : Values)
+	{
+		FNetSerializationContext Context;
+		FNetValidateArgs Args = {};
+		Args.NetSerializerConfig = NetSerializerConfigParam(&Config);
+		Args.Source = NetSerializerValuePointer(&Value);
+		bScalarValid &= Serializer.Validate(Context, Args);
+	}
+	const double ScalarSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - ScalarStartCycles);
+
+	const uint64 BatchStartCycles = FPlatformTime::Cycles64();
+	const bool bBatchValid = ValidateEnumValues(Config, Values.GetData(), ValueCount);
+	const double BatchSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - BatchStartCycles);
+
+	UE_NET_ASSERT_TRUE(bScalarValid);
+	UE_NET_ASSERT_TRUE(bBatchValid);
+
+	const double ValidatedBits = double(ValueCount)*Config.BitCount;
+	UE_LOG(LogIris, Display, TEXT("Enum validation: scalar %.1f Mbit/s, batch %.1f Mbit/s"), ValidatedBits/FMath::Max(ScalarSeconds, 1e-9)/1e6, ValidatedBits/FMath::Max(BatchSeconds, 1e-9)/1e6);
+}
+
+}
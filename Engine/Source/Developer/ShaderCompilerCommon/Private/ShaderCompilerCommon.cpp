@@ -16,6 +16,8 @@
 #include "ShaderPreprocessor.h"
 #include "ShaderPreprocessTypes.h"
 #include "ShaderSymbolExport.h"
+#include "ShaderSourceTokenizer.h"
+#include "ShaderTransformCache.h"
 #include "ShaderMinifier.h"
 #include "Algo/Sort.h"
 #include "ProfilingDebugging/CpuProfilerTrace.h"
@@ -1037,35 +1039,8 @@ const FShaderSource::CharType* ParseUniformBufferDefinition(const FShaderSource:
 	return EndPtr;
 }
 
-enum class AsciiFlags
-{
-	TerminatorOrSlash = (1 << 0),	// Null terminator OR slash (latter we care about for skipping commented out uniform blocks)
-	Whitespace = (1 << 1),			// Includes other special characters below 32 (in addition to tab / newline)
-	Other = (1 << 2),				// Anything else not one of the other types
-	SymbolStart = (1<<3),			// Letters plus underscore (anything that can start a symbol)
-	Digit = (1 << 4),
-	Dot = (1 << 5),
-	Quote = (1 << 6),
-	Hash = (1 << 7),
-};
-
-static uint8 AsciiFlagTable[256] =
-{
-	1,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2,		// Treat all special characters as whitespace
-
-	2,4,64,128,4,4,4,4,			// 34 == Quote  35 == Hash
-	4,4,4,4,4,4,32,1,			// 46 == Dot    47 == Slash
-	16,16,16,16,16,16,16,16,	// Digits 0-7
-	16,16,4,4,4,4,4,4,			// Digits 8-9
-
-	4,8,8,8,8,8,8,8, 8,8,8,8,8,8,8,8, 8,8,8,8,8,8,8,8, 8,8,8,4,4,4,4,8,		// Upper case letters,  95 == Underscore
-	4,8,8,8,8,8,8,8, 8,8,8,8,8,8,8,8, 8,8,8,8,8,8,8,8, 8,8,8,4,4,4,4,4,		// Lower case letters
-
-	4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4,		// Treat all non-ASCII characters as Other
-	4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4,
-	4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4,
-	4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4,
-};
+using UE::ShaderCompilerCommon::Private::AsciiFlags;
+using UE::ShaderCompilerCommon::Private::AsciiFlagTable;
 
 struct FCompoundIdentifierResult
 {
@@ -1255,6 +1230,9 @@ bool FindNextCompoundIdentifier(const FShaderSource::CharType*& Search, const ui
 							SearchCharFlag = AsciiFlagTable[(uint8)*SearchChar];
 							break;
 						}
+
+						// Comment ending in "*" at the end of string, not terminated
+						return false;
 					}
 					else
 					{
@@ -1316,9 +1294,75 @@ const FShaderSource::CharType* FindPreviousDot(const FShaderSource::CharType* Se
 	return SearchPtr;
 }
 
+// Flattens a compound identifier found by FindNextCompoundIdentifier in place, if its root is a uniform buffer and it references one of its members
+template<typename CompoundIdentifierType>
+static void FlattenUniformBufferMemberReference(CompoundIdentifierType& Result, TArray<FUniformBufferInfoNew>& UniformBufferInfos, const int32 UniformBuffersByLength[64])
+{
+	// Check if the identifier corresponds to a uniform buffer
+	FShaderSource::FViewType IdentifierRoot(Result.Identifier, Result.IdentifierRootEnd - Result.Identifier);
+	for (int32 UniformInfoIndex = UniformBuffersByLength[IdentifierRoot.Len()]; UniformInfoIndex != INDEX_NONE; UniformInfoIndex = UniformBufferInfos[UniformInfoIndex].NextWithSameLength)
+	{
+		FUniformBufferInfoNew& Info = UniformBufferInfos[UniformInfoIndex];
+		if (IdentifierRoot.Equals(Info.Name, ESearchCase::CaseSensitive))
+		{
+			// Found the uniform buffer, clean up potential whitespace
+			Result.IdentifierEnd = CompactCompoundIdentifier(const_cast<FShaderSource::CharType*>(Result.Identifier), const_cast<FShaderSource::CharType*>(Result.IdentifierEnd));
+
+			// Now try to find a matching member.  We need to check subsets of the full "identifier", to strip away function calls, components, or child structures.
+			bool bMatchFound = false;
+
+			for (; Result.IdentifierEnd > Result.IdentifierRootEnd; Result.IdentifierEnd = FindPreviousDot(Result.IdentifierEnd - 1, Result.IdentifierRootEnd))
+			{
+				FShaderSource::FViewType Identifier(Result.Identifier, Result.IdentifierEnd - Result.Identifier);
+				if (Identifier.Len() < Info.MembersByLength.Num())
+				{
+					const FUniformBufferMemberView& MemberView = Info.MembersByLength[Identifier.Len()];
+
+					for (int32 MemberIndex = MemberView.MemberOffset; MemberIndex < MemberView.MemberOffset + MemberView.MemberCount; MemberIndex++)
+					{
+						if (Info.Members[MemberIndex].NameAsStructMember.Equals(Identifier, ESearchCase::CaseSensitive))
+						{
+							bMatchFound = true;
+
+							const int32 OriginalTextLen = Info.Members[MemberIndex].NameAsStructMember.Len();
+							const int32 ReplacementTextLen = Info.Members[MemberIndex].GlobalName.Len();
+
+							const FShaderSource::CharType* GlobalNameStart = GetData(Info.Members[MemberIndex].GlobalName);
+							FShaderSource::CharType* IdentifierStart = const_cast<FShaderSource::CharType*>(Result.Identifier);
+
+							int32 Index = 0;
+							for (; Index < ReplacementTextLen; Index++)
+							{
+								IdentifierStart[Index] = GlobalNameStart[Index];
+							}
+							for (; Index < OriginalTextLen; Index++)
+							{
+								IdentifierStart[Index] = ' ';
+							}
+							break;
+						}
+					}
+
+					if (bMatchFound)
+					{
+						break;
+					}
+				}
+			}
+
+			break;
+		}
+	}
+}
+
 // The cross compiler doesn't yet support struct initializers needed to construct static structs for uniform buffers
 // Replace all uniform buffer struct member references (View.WorldToClip) with a flattened name that removes the struct dependency (View_WorldToClip)
 void CleanupUniformBufferCode(const FShaderCompilerEnvironment& Environment, FShaderSource& PreprocessedShaderSource)
+{
+	UE::ShaderCompilerCommon::Private::CleanupUniformBufferCode(Environment, PreprocessedShaderSource, true);
+}
+
+void UE::ShaderCompilerCommon::Private::CleanupUniformBufferCode(const FShaderCompilerEnvironment& Environment, FShaderSource& PreprocessedShaderSource, bool bUseTokenStream)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE(CleanupUniformBufferCode);
 
@@ -1337,6 +1381,7 @@ void CleanupUniformBufferCode(const FShaderCompilerEnvironment& Environment, FSh
 	FShaderSource::CharType* SearchPtr = SourceStart;
 	FShaderSource::CharType* EndOfPreviousUniformBuffer = SourceStart;
 	bool bUniformBufferFound;
+	TArray<UE::ShaderCompilerCommon::Private::FShaderSourceToken> Tokens;
 
 	do
 	{
@@ -1358,65 +1403,28 @@ void CleanupUniformBufferCode(const FShaderCompilerEnvironment& Environment, FSh
 		// were found).  If there are no uniform buffers yet, we don't need to parse anything.
 		if (UniformBufferInfos.Num())
 		{
-			const FShaderSource::CharType* ParsePtr = EndOfPreviousUniformBuffer;
-
-			FCompoundIdentifierResult Result;
-			while (FindNextCompoundIdentifier(ParsePtr, UniformBufferFilter, Result))
+			if (bUseTokenStream)
 			{
-				// Check if the identifier corresponds to a uniform buffer
-				FShaderSource::FViewType IdentifierRoot(Result.Identifier, Result.IdentifierRootEnd - Result.Identifier);
-				for (int32 UniformInfoIndex = UniformBuffersByLength[IdentifierRoot.Len()]; UniformInfoIndex != INDEX_NONE; UniformInfoIndex = UniformBufferInfos[UniformInfoIndex].NextWithSameLength)
-				{
-					FUniformBufferInfoNew& Info = UniformBufferInfos[UniformInfoIndex];
-					if (IdentifierRoot.Equals(Info.Name, ESearchCase::CaseSensitive))
-					{
-						// Found the uniform buffer, clean up potential whitespace
-						Result.IdentifierEnd = CompactCompoundIdentifier(const_cast<FShaderSource::CharType*>(Result.Identifier), const_cast<FShaderSource::CharType*>(Result.IdentifierEnd));
+				// Tokenize the whole span in one pass, member references are flattened in place without moving any of the remaining tokens
+				const int32 ParseLen = (int32)((SearchPtr ? SearchPtr : SourceStart + PreprocessedShaderSource.Len()) - EndOfPreviousUniformBuffer);
+				Tokens.Reset();
+				UE::ShaderCompilerCommon::Private::TokenizeShaderSource(EndOfPreviousUniformBuffer, ParseLen, Tokens);
 
-						// Now try to find a matching member.  We need to check subsets of the full "identifier", to strip away function calls, components, or child structures.
-						bool bMatchFound = false;
-
-						for (; Result.IdentifierEnd > Result.IdentifierRootEnd; Result.IdentifierEnd = FindPreviousDot(Result.IdentifierEnd - 1, Result.IdentifierRootEnd))
-						{
-							FShaderSource::FViewType Identifier(Result.Identifier, Result.IdentifierEnd - Result.Identifier);
-							if (Identifier.Len() < Info.MembersByLength.Num())
-							{
-								const FUniformBufferMemberView& MemberView = Info.MembersByLength[Identifier.Len()];
-
-								for (int32 MemberIndex = MemberView.MemberOffset; MemberIndex < MemberView.MemberOffset + MemberView.MemberCount; MemberIndex++)
-								{
-									if (Info.Members[MemberIndex].NameAsStructMember.Equals(Identifier, ESearchCase::CaseSensitive))
-									{
-										bMatchFound = true;
-
-										const int32 OriginalTextLen = Info.Members[MemberIndex].NameAsStructMember.Len();
-										const int32 ReplacementTextLen = Info.Members[MemberIndex].GlobalName.Len();
-
-										const FShaderSource::CharType* GlobalNameStart = GetData(Info.Members[MemberIndex].GlobalName);
-										FShaderSource::CharType* IdentifierStart = const_cast<FShaderSource::CharType*>(Result.Identifier);
-
-										int32 Index = 0;
-										for (; Index < ReplacementTextLen; Index++)
-										{
-											IdentifierStart[Index] = GlobalNameStart[Index];
-										}
-										for (; Index < OriginalTextLen; Index++)
-										{
-											IdentifierStart[Index] = ' ';
-										}
-										break;
-									}
-								}
-
-								if (bMatchFound)
-								{
-									break;
-								}
-							}
-						}
+				int32 TokenCursor = 0;
+				UE::ShaderCompilerCommon::Private::TCompoundIdentifierTokens<FShaderSource::CharType> Result;
+				while (UE::ShaderCompilerCommon::Private::FindNextCompoundIdentifier<FShaderSource::CharType>(EndOfPreviousUniformBuffer, Tokens, TokenCursor, UniformBufferFilter, Result))
+				{
+					FlattenUniformBufferMemberReference(Result, UniformBufferInfos, UniformBuffersByLength);
+				}
+			}
+			else
+			{
+				const FShaderSource::CharType* ParsePtr = EndOfPreviousUniformBuffer;
 
-						break;
-					}
+				FCompoundIdentifierResult Result;
+				while (::FindNextCompoundIdentifier(ParsePtr, UniformBufferFilter, Result))
+				{
+					FlattenUniformBufferMemberReference(Result, UniformBufferInfos, UniformBuffersByLength);
 				}
 			}
 		}
@@ -2080,13 +2088,40 @@ namespace UE::ShaderCompilerCommon
 		bool bSuccess = ::PreprocessShader(PreprocessOutput, Input, Environment, AdditionalDefines);
 		if (bSuccess)
 		{
+			const bool bRemoveDeadCode = Input.Environment.CompilerFlags.Contains(CFLAG_RemoveDeadCode);
+			const TArray<FStringView> RequiredSymbols(MakeArrayView(Input.RequiredSymbols));
+
+			// Permutations sharing preprocessed source, entry point and required symbols get the same transformed source
+			Private::FShaderTransformCache& TransformCache = Private::FShaderTransformCache::Get();
+			const bool bUseTransformCache = Private::FShaderTransformCache::IsEnabled();
+			Private::FShaderTransformCache::FKey TransformCacheKey;
+			if (bUseTransformCache)
+			{
+				TransformCacheKey = bRemoveDeadCode
+					? Private::FShaderTransformCache::MakeKey(PreprocessOutput.EditSource(), Input.EntryPointName, RequiredSymbols)
+					: Private::FShaderTransformCache::MakeKey(PreprocessOutput.EditSource(), {}, {});
+
+				if (TransformCache.Find(TransformCacheKey, PreprocessOutput.EditSource(), PreprocessOutput.EditErrors()))
+				{
+					return bSuccess;
+				}
+			}
+
+			const double TransformStartTime = FPlatformTime::Seconds();
+			const int32 NumErrorsBeforeTransform = PreprocessOutput.EditErrors().Num();
+
 			CleanupUniformBufferCode(Environment, PreprocessOutput.EditSource());
 
-			if (Input.Environment.CompilerFlags.Contains(CFLAG_RemoveDeadCode))
+			if (bRemoveDeadCode)
 			{
-				const TArray<FStringView> RequiredSymbols(MakeArrayView(Input.RequiredSymbols));
 				UE::ShaderCompilerCommon::RemoveDeadCode(PreprocessOutput.EditSource(), Input.EntryPointName, RequiredSymbols, PreprocessOutput.EditErrors());
 			}
+
+			if (bUseTransformCache)
+			{
+				const TArray<FShaderCompilerError>& Errors = PreprocessOutput.EditErrors();
+				TransformCache.Add(TransformCacheKey, PreprocessOutput.EditSource(), MakeArrayView(Errors).RightChop(NumErrorsBeforeTransform), FPlatformTime::Seconds() - TransformStartTime);
+			}
 		}
 
 		return bSuccess;
@@ -0,0 +1,293 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShaderSourceTokenizer.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#endif
+
+namespace UE::ShaderCompilerCommon::Private
+{
+
+static constexpr uint8 AsciiFlagsSymbol = (uint8)AsciiFlags::SymbolStart | (uint8)AsciiFlags::Digit;
+static constexpr uint8 AsciiFlagsNumberOrDirective = (uint8)AsciiFlags::SymbolStart | (uint8)AsciiFlags::Digit | (uint8)AsciiFlags::Dot | (uint8)AsciiFlags::Hash;
+
+template<typename CharType>
+static FORCEINLINE uint8 GetAsciiFlags(CharType Char)
+{
+	// Wide characters are classified by their low byte, like the original scanner did
+	return AsciiFlagTable[(uint8)Char];
+}
+
+static FORCEINLINE bool IsOtherRunChar(uint8 Flags, uint32 Char)
+{
+	return (Flags & (uint8)AsciiFlags::Other) && Char != '{' && Char != '}' && Char != '(' && Char != ')';
+}
+
+/**
+ * Character run scanning. The generic versions test one character at a time with the flag table, the ANSICHAR versions
+ * below test 16 characters per iteration with SSE2 compares and only fall back to the table for the last few characters.
+ */
+template<typename CharType>
+struct TShaderSourceScanner
+{
+	static const CharType* SkipFlags(const CharType* Ptr, const CharType* End, uint8 Flags)
+	{
+		while (Ptr < End && (GetAsciiFlags(*Ptr) & Flags))
+		{
+			++Ptr;
+		}
+		return Ptr;
+	}
+
+	static const CharType* SkipIdentifier(const CharType* Ptr, const CharType* End) { return SkipFlags(Ptr, End, AsciiFlagsSymbol); }
+	static const CharType* SkipWhitespace(const CharType* Ptr, const CharType* End) { return SkipFlags(Ptr, End, (uint8)AsciiFlags::Whitespace); }
+	static const CharType* SkipNumberOrDirective(const CharType* Ptr, const CharType* End) { return SkipFlags(Ptr, End, AsciiFlagsNumberOrDirective); }
+
+	static const CharType* SkipOther(const CharType* Ptr, const CharType* End)
+	{
+		while (Ptr < End && IsOtherRunChar(GetAsciiFlags(*Ptr), (uint32)*Ptr))
+		{
+			++Ptr;
+		}
+		return Ptr;
+	}
+
+	// Finds Char or a null terminator
+	static const CharType* FindCharOrNull(const CharType* Ptr, const CharType* End, CharType Char)
+	{
+		while (Ptr < End && *Ptr && *Ptr != Char)
+		{
+			++Ptr;
+		}
+		return Ptr;
+	}
+
+	// Finds the next slash or character the scanner treats as a terminator
+	static const CharType* FindSlashOrTerminator(const CharType* Ptr, const CharType* End)
+	{
+		while (Ptr < End && GetAsciiFlags(*Ptr) != (uint8)AsciiFlags::TerminatorOrSlash)
+		{
+			++Ptr;
+		}
+		return Ptr;
+	}
+};
+
+#if PLATFORM_CPU_X86_FAMILY
+template<>
+struct TShaderSourceScanner<ANSICHAR>
+{
+	static FORCEINLINE __m128i InRange(__m128i Chars, ANSICHAR Min, ANSICHAR Max)
+	{
+		// Signed compares, so characters above 127 are never in range
+		return _mm_and_si128(_mm_cmpgt_epi8(Chars, _mm_set1_epi8(Min - 1)), _mm_cmplt_epi8(Chars, _mm_set1_epi8(Max + 1)));
+	}
+
+	static FORCEINLINE __m128i IsChar(__m128i Chars, ANSICHAR Char)
+	{
+		return _mm_cmpeq_epi8(Chars, _mm_set1_epi8(Char));
+	}
+
+	static FORCEINLINE __m128i IsSymbol(__m128i Chars)
+	{
+		const __m128i Letter = InRange(_mm_or_si128(Chars, _mm_set1_epi8(0x20)), 'a', 'z');
+		return _mm_or_si128(_mm_or_si128(Letter, InRange(Chars, '0', '9')), IsChar(Chars, '_'));
+	}
+
+	// Returns a pointer to the first of 16 characters at a time for which Match has a zero bit
+	template<typename MatchType>
+	static FORCEINLINE const ANSICHAR* SkipMatching(const ANSICHAR* Ptr, const ANSICHAR* End, const MatchType& Match)
+	{
+		while (End - Ptr >= 16)
+		{
+			const uint32 Mask = (uint32)_mm_movemask_epi8(Match(_mm_loadu_si128((const __m128i*)Ptr))) ^ 0xffffu;
+			if (Mask)
+			{
+				return Ptr + FMath::CountTrailingZeros(Mask);
+			}
+			Ptr += 16;
+		}
+		return Ptr;
+	}
+
+	static const ANSICHAR* SkipIdentifier(const ANSICHAR* Ptr, const ANSICHAR* End)
+	{
+		Ptr = SkipMatching(Ptr, End, [](__m128i Chars) { return IsSymbol(Chars); });
+		return ScalarSkipFlags(Ptr, End, AsciiFlagsSymbol);
+	}
+
+	static const ANSICHAR* SkipWhitespace(const ANSICHAR* Ptr, const ANSICHAR* End)
+	{
+		Ptr = SkipMatching(Ptr, End, [](__m128i Chars) { return InRange(Chars, 1, ' '); });
+		return ScalarSkipFlags(Ptr, End, (uint8)AsciiFlags::Whitespace);
+	}
+
+	static const ANSICHAR* SkipNumberOrDirective(const ANSICHAR* Ptr, const ANSICHAR* End)
+	{
+		Ptr = SkipMatching(Ptr, End, [](__m128i Chars) { return _mm_or_si128(IsSymbol(Chars), _mm_or_si128(IsChar(Chars, '.'), IsChar(Chars, '#'))); });
+		return ScalarSkipFlags(Ptr, End, AsciiFlagsNumberOrDirective);
+	}
+
+	static const ANSICHAR* SkipOther(const ANSICHAR* Ptr, const ANSICHAR* End)
+	{
+		Ptr = SkipMatching(Ptr, End, [](__m128i Chars)
+		{
+			__m128i NotOther = _mm_or_si128(IsSymbol(Chars), InRange(Chars, 0, ' '));
+			NotOther = _mm_or_si128(NotOther, _mm_or_si128(IsChar(Chars, '\"'), IsChar(Chars, '#')));
+			NotOther = _mm_or_si128(NotOther, _mm_or_si128(IsChar(Chars, '.'), IsChar(Chars, '/')));
+			NotOther = _mm_or_si128(NotOther, _mm_or_si128(IsChar(Chars, '{'), IsChar(Chars, '}')));
+			NotOther = _mm_or_si128(NotOther, _mm_or_si128(IsChar(Chars, '('), IsChar(Chars, ')')));
+			return _mm_andnot_si128(NotOther, _mm_set1_epi8(-1));
+		});
+		while (Ptr < End && IsOtherRunChar(GetAsciiFlags(*Ptr), (uint32)(uint8)*Ptr))
+		{
+			++Ptr;
+		}
+		return Ptr;
+	}
+
+	static const ANSICHAR* FindCharOrNull(const ANSICHAR* Ptr, const ANSICHAR* End, ANSICHAR Char)
+	{
+		Ptr = SkipMatching(Ptr, End, [Char](__m128i Chars) { return _mm_andnot_si128(_mm_or_si128(IsChar(Chars, Char), IsChar(Chars, 0)), _mm_set1_epi8(-1)); });
+		while (Ptr < End && *Ptr && *Ptr != Char)
+		{
+			++Ptr;
+		}
+		return Ptr;
+	}
+
+	static const ANSICHAR* FindSlashOrTerminator(const ANSICHAR* Ptr, const ANSICHAR* End)
+	{
+		return FindCharOrNull(Ptr, End, '/');
+	}
+
+private:
+	static const ANSICHAR* ScalarSkipFlags(const ANSICHAR* Ptr, const ANSICHAR* End, uint8 Flags)
+	{
+		while (Ptr < End && (GetAsciiFlags(*Ptr) & Flags))
+		{
+			++Ptr;
+		}
+		return Ptr;
+	}
+};
+#endif
+
+template<typename CharType>
+static void TokenizeShaderSourceImpl(const CharType* Source, int32 Len, TArray<FShaderSourceToken>& OutTokens)
+{
+	using FScanner = TShaderSourceScanner<CharType>;
+
+	const CharType* Ptr = Source;
+	const CharType* End = Source + Len;
+	bool bAfterIdentifier = false;
+
+	// Rough token density of HLSL, avoids most reallocations
+	OutTokens.Reserve(OutTokens.Num() + Len / 4);
+
+	while (Ptr < End)
+	{
+		const uint8 Flags = GetAsciiFlags(*Ptr);
+		if (Flags & (uint8)AsciiFlags::Whitespace)
+		{
+			// Whitespace doesn't break up a compound identifier, so bAfterIdentifier is kept
+			Ptr = FScanner::SkipWhitespace(Ptr + 1, End);
+			continue;
+		}
+
+		const CharType* TokenStart = Ptr;
+		EShaderSourceTokenType Type;
+		if (Flags & (uint8)AsciiFlags::SymbolStart)
+		{
+			Ptr = FScanner::SkipIdentifier(Ptr + 1, End);
+			Type = EShaderSourceTokenType::Identifier;
+		}
+		else if ((Flags & (uint8)AsciiFlags::Dot) && bAfterIdentifier)
+		{
+			++Ptr;
+			Type = EShaderSourceTokenType::Dot;
+		}
+		else if (Flags & ((uint8)AsciiFlags::Digit | (uint8)AsciiFlags::Dot | (uint8)AsciiFlags::Hash))
+		{
+			// Numbers may contain letters or #, i.e. "1.#INF" for infinity, or "e" for an exponent
+			Ptr = FScanner::SkipNumberOrDirective(Ptr + 1, End);
+			Type = EShaderSourceTokenType::NumberOrDirective;
+		}
+		else if (Flags & (uint8)AsciiFlags::Quote)
+		{
+			// Skip to next quote (or end of string if text is malformed), ignoring the quote if it's escaped
+			Ptr = FScanner::FindCharOrNull(Ptr + 1, End, '\"');
+			while (Ptr < End && *Ptr && *(Ptr - 1) == '\\')
+			{
+				Ptr = FScanner::FindCharOrNull(Ptr + 1, End, '\"');
+			}
+			if (Ptr < End && *Ptr)
+			{
+				++Ptr;
+			}
+			Type = EShaderSourceTokenType::String;
+		}
+		else if (Flags & (uint8)AsciiFlags::Other)
+		{
+			switch (*Ptr)
+			{
+			case '{':	Type = EShaderSourceTokenType::OpenBrace;	++Ptr; break;
+			case '}':	Type = EShaderSourceTokenType::CloseBrace;	++Ptr; break;
+			case '(':	Type = EShaderSourceTokenType::OpenParen;	++Ptr; break;
+			case ')':	Type = EShaderSourceTokenType::CloseParen;	++Ptr; break;
+			default:	Type = EShaderSourceTokenType::Other;		Ptr = FScanner::SkipOther(Ptr + 1, End); break;
+			}
+		}
+		else if (*Ptr == '/')
+		{
+			// A block comment needs at least one more character after "/*"
+			if (End - Ptr > 2 && Ptr[1] == '*' && Ptr[2] != 0)
+			{
+				// Search for the closing slash starting at +3, so that "/*/" doesn't end the comment
+				Ptr = FScanner::FindSlashOrTerminator(Ptr + 3, End);
+				while (true)
+				{
+					if (Ptr == End || !*Ptr)
+					{
+						// Unterminated comment, the rest of the source is not scanned
+						return;
+					}
+					if (*(Ptr - 1) == '*')
+					{
+						++Ptr;
+						break;
+					}
+					Ptr = FScanner::FindSlashOrTerminator(Ptr + 1, End);
+				}
+				Type = EShaderSourceTokenType::Comment;
+			}
+			else
+			{
+				// Just a slash, not part of a block comment
+				++Ptr;
+				Type = EShaderSourceTokenType::Other;
+			}
+		}
+		else
+		{
+			// End of string
+			return;
+		}
+
+		OutTokens.Add({ (int32)(TokenStart - Source), (int32)(Ptr - TokenStart), Type });
+		bAfterIdentifier = Type == EShaderSourceTokenType::Identifier;
+	}
+}
+
+void TokenizeShaderSource(const ANSICHAR* Source, int32 Len, TArray<FShaderSourceToken>& OutTokens)
+{
+	TokenizeShaderSourceImpl(Source, Len, OutTokens);
+}
+
+void TokenizeShaderSource(const WIDECHAR* Source, int32 Len, TArray<FShaderSourceToken>& OutTokens)
+{
+	TokenizeShaderSourceImpl(Source, Len, OutTokens);
+}
+
+}
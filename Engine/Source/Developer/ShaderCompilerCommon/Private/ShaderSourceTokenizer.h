@@ -0,0 +1,142 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShaderSource.h"
+
+struct FShaderCompilerEnvironment;
+
+namespace UE::ShaderCompilerCommon::Private
+{
+
+enum class AsciiFlags
+{
+	TerminatorOrSlash = (1 << 0),	// Null terminator OR slash (latter we care about for skipping commented out uniform blocks)
+	Whitespace = (1 << 1),			// Includes other special characters below 32 (in addition to tab / newline)
+	Other = (1 << 2),				// Anything else not one of the other types
+	SymbolStart = (1<<3),			// Letters plus underscore (anything that can start a symbol)
+	Digit = (1 << 4),
+	Dot = (1 << 5),
+	Quote = (1 << 6),
+	Hash = (1 << 7),
+};
+
+inline constexpr uint8 AsciiFlagTable[256] =
+{
+	1,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2,		// Treat all special characters as whitespace
+
+	2,4,64,128,4,4,4,4,			// 34 == Quote  35 == Hash
+	4,4,4,4,4,4,32,1,			// 46 == Dot    47 == Slash
+	16,16,16,16,16,16,16,16,	// Digits 0-7
+	16,16,4,4,4,4,4,4,			// Digits 8-9
+
+	4,8,8,8,8,8,8,8, 8,8,8,8,8,8,8,8, 8,8,8,8,8,8,8,8, 8,8,8,4,4,4,4,8,		// Upper case letters,  95 == Underscore
+	4,8,8,8,8,8,8,8, 8,8,8,8,8,8,8,8, 8,8,8,8,8,8,8,8, 8,8,8,4,4,4,4,4,		// Lower case letters
+
+	4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4,		// Treat all non-ASCII characters as Other
+	4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4,
+	4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4,
+	4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4, 4,4,4,4,4,4,4,4,
+};
+
+enum class EShaderSourceTokenType : uint8
+{
+	Identifier,			// Letter or underscore followed by letters, digits and underscores
+	Dot,				// A dot following an identifier, possibly separated by whitespace, i.e. part of a compound identifier
+	NumberOrDirective,	// Starts with a digit, dot or hash and runs up to whitespace, a quote, a slash or other punctuation ("1.#INF", "#line")
+	String,				// Quoted string including the quotes
+	Comment,			// Block comment including the delimiters
+	OpenBrace,
+	CloseBrace,
+	OpenParen,
+	CloseParen,
+	Other,				// Run of any other punctuation
+};
+
+struct FShaderSourceToken
+{
+	int32 Offset;
+	int32 Len;
+	EShaderSourceTokenType Type;
+};
+
+/**
+ * Splits preprocessed shader source into a stream of tokens in a single pass, skipping whitespace. Runs of identifier,
+ * whitespace and punctuation characters as well as the ends of strings and comments are found 16 characters at a time
+ * with SIMD compares where available. The lexing rules match the uniform buffer cleanup scanner exactly, including
+ * how unterminated strings and comments are handled, so passes consuming the stream produce identical output.
+ *
+ * Tokenization stops at Len characters, a null terminator, or an unterminated block comment.
+ */
+void TokenizeShaderSource(const ANSICHAR* Source, int32 Len, TArray<FShaderSourceToken>& OutTokens);
+void TokenizeShaderSource(const WIDECHAR* Source, int32 Len, TArray<FShaderSourceToken>& OutTokens);
+
+/** Result of FindNextCompoundIdentifier, as pointers into the tokenized source */
+template<typename CharType>
+struct TCompoundIdentifierTokens
+{
+	const CharType* Identifier;			// Start of identifier
+	const CharType* IdentifierEnd;		// End of entire identifier
+	const CharType* IdentifierRootEnd;	// End of root token of identifier
+};
+
+/**
+ * Token stream version of the compound identifier ("View.WorldToClip") search used to flatten uniform buffer references.
+ * Advances Cursor past the returned identifier. The root identifier has to pass RootIdentifierFilter, a mask of valid
+ * start characters (ASCII 64..127) indexed by identifier length.
+ */
+template<typename CharType>
+bool FindNextCompoundIdentifier(const CharType* Source, TConstArrayView<FShaderSourceToken> Tokens, int32& Cursor, const uint64 RootIdentifierFilter[64], TCompoundIdentifierTokens<CharType>& OutResult)
+{
+	while (Cursor < Tokens.Num())
+	{
+		const FShaderSourceToken& Root = Tokens[Cursor++];
+		if (Root.Type != EShaderSourceTokenType::Identifier)
+		{
+			continue;
+		}
+
+		OutResult.Identifier = Source + Root.Offset;
+		OutResult.IdentifierRootEnd = Source + Root.Offset + Root.Len;
+
+		if (Cursor == Tokens.Num() || Tokens[Cursor].Type != EShaderSourceTokenType::Dot)
+		{
+			continue;
+		}
+		++Cursor;
+
+		if (Root.Len >= 64 || !(RootIdentifierFilter[Root.Len] & (1ull << (*OutResult.Identifier - 64))))
+		{
+			// Clear this, marking that we didn't find a candidate root identifier
+			OutResult.IdentifierRootEnd = nullptr;
+		}
+
+		// Repeatedly consume additional parts of the identifier separated by dots
+		while (Cursor < Tokens.Num() && Tokens[Cursor].Type == EShaderSourceTokenType::Identifier)
+		{
+			const FShaderSourceToken& Part = Tokens[Cursor++];
+			OutResult.IdentifierEnd = Source + Part.Offset + Part.Len;
+
+			if (Cursor == Tokens.Num() || Tokens[Cursor].Type != EShaderSourceTokenType::Dot)
+			{
+				if (OutResult.IdentifierRootEnd)
+				{
+					return true;
+				}
+				break;
+			}
+			++Cursor;
+		}
+	}
+	return false;
+}
+
+/**
+ * Flattens uniform buffer member references (View.WorldToClip to View_WorldToClip) and removes the uniform buffer declarations.
+ * With bUseTokenStream the source between declarations is tokenized once with TokenizeShaderSource, otherwise it is scanned
+ * character by character. Both produce identical output, the scalar scanner is kept as a reference.
+ */
+void CleanupUniformBufferCode(const FShaderCompilerEnvironment& Environment, FShaderSource& PreprocessedShaderSource, bool bUseTokenStream);
+
+}
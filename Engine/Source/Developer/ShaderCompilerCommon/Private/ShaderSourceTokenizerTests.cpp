@@ -0,0 +1,168 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShaderSourceTokenizer.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "ShaderCore.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UE::ShaderCompilerCommon::Private::Tests
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+static const TCHAR* UniformBufferDeclarations =
+	TEXT("\nUniformBuffer View\n{\n\tView.WorldToClip = View_WorldToClip;\n\tView.ViewSizeAndInvSize = View_ViewSizeAndInvSize;\n\tView.PreExposure = View_PreExposure;\n};\n")
+	TEXT("\nUniformBuffer Primitive\n{\n\tPrimitive.LocalToWorld = Primitive_LocalToWorld;\n\tPrimitive.Flags = Primitive_Flags;\n};\n");
+
+// Edge cases of the scanner: references inside strings and comments, escaped quotes, comments that do not end, numbers with dots and
+// hashes, whitespace inside compound identifiers, and identifiers that look like uniform buffers without being one.
+static const TCHAR* EdgeCaseBodies[] =
+{
+	TEXT("float4 Main(float4 P : POSITION) : SV_Position { return mul(P, View.WorldToClip); }\n"),
+	TEXT("float2 Size = View . ViewSizeAndInvSize.xy * View.PreExposure;\n"),
+	TEXT("float3 X = View\n\t.\n\tViewSizeAndInvSize.zw;\n"),
+	TEXT("float A = Primitive.LocalToWorld[3].x + Primitive.Flags.y + Primitive . Unknown.x;\n"),
+	TEXT("// View.WorldToClip in a line comment is replaced, the scanner only knows block comments\nfloat B = 0;\n"),
+	TEXT("/* View.WorldToClip */ float C = View.PreExposure; /*/ View.PreExposure */ float D = 1;\n"),
+	TEXT("#define S \"View.WorldToClip\" \"\\\"View.PreExposure\" View.PreExposure\n"),
+	TEXT("float E = 1.#INF + 2.0f.x + .5 + 0x1F.View.PreExposure;\n"),
+	TEXT("float F = NotView.PreExposure + ViewX.PreExposure + _View.PreExposure + View.PreExposureX;\n"),
+	TEXT("float G = View.View.PreExposure + a . b . c + View. + View.;\n"),
+	TEXT("float H = View.PreExposure / 2 / View.PreExposure; float I = a/b;\n"),
+	TEXT("#line 12 \"/Engine/Private/Common.ush\"\nfloat J = View.PreExposure;\n"),
+	TEXT("float K = View.PreExposure; /* unterminated comment View.PreExposure\n"),
+	TEXT("float L = View.PreExposure; \"unterminated string View.PreExposure\n"),
+	TEXT("float M = View.PreExposure; /"),
+	TEXT("float N = View.PreExposure; /*"),
+	TEXT("float P = View.PreExposure; /* View.PreExposure *"),
+	TEXT("float O = View."),
+	TEXT("View"),
+};
+
+static FString RunCleanup(const FString& Source, bool bUseTokenStream)
+{
+	FShaderCompilerEnvironment Environment;
+	FShaderSource ShaderSource;
+	ShaderSource.Set(Source);
+	CleanupUniformBufferCode(Environment, ShaderSource, bUseTokenStream);
+	return FString(ShaderSource.GetView());
+}
+
+// Repeats typical generated shader code with uniform buffer references, for benchmarking when no corpus is given
+static FString MakeSyntheticSource(int32 NumRepeats)
+{
+	FString Source = UniformBufferDeclarations;
+	for (int32 Index = 0; Index < NumRepeats; Index++)
+	{
+		Source += FString::Printf(TEXT(
+			"#line %d \"/Engine/Private/BasePassPixelShader.usf\"\n"
+			"float4 Function%d(float4 Position, float2 UV)\n"
+			"{\n"
+			"\t/* Transform to clip space */\n"
+			"\tfloat4 ClipPosition = mul(mul(Position, Primitive.LocalToWorld), View.WorldToClip);\n"
+			"\tfloat2 ScreenUV = (ClipPosition.xy / ClipPosition.w * float2(0.5f, -0.5f) + 0.5f) * View.ViewSizeAndInvSize.xy;\n"
+			"\tif ((Primitive.Flags & 0x%x) != 0 && UV.x > 1.#INF)\n"
+			"\t{\n"
+			"\t\treturn float4(ScreenUV, 0.0f, 1.0f) * View.PreExposure;\n"
+			"\t}\n"
+			"\treturn ClipPosition;\n"
+			"}\n"), Index + 1, Index, Index & 0xff);
+	}
+	return Source;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShaderSourceTokenizerTestCleanupUniformBufferCode, "System.Shaders.ShaderSourceTokenizer.CleanupUniformBufferCode", TestFlags)
+bool FShaderSourceTokenizerTestCleanupUniformBufferCode::RunTest(const FString& Parameters)
+{
+	// Each case on its own, so unterminated strings and comments are also tested at the end of the source
+	for (const TCHAR* Body : EdgeCaseBodies)
+	{
+		const FString Source = FString(UniformBufferDeclarations) + Body;
+		TestEqual(FString::Printf(TEXT("Token stream output matches scalar scanner for \"%s\""), Body), RunCleanup(Source, true), RunCleanup(Source, false));
+	}
+
+	// All cases concatenated, with uniform buffer declarations in between so parsing resumes after a declaration
+	FString Combined;
+	for (const TCHAR* Body : EdgeCaseBodies)
+	{
+		Combined += Body;
+		Combined += TEXT("\n");
+		if (Combined.Len() < 400)
+		{
+			Combined += UniformBufferDeclarations;
+		}
+	}
+	TestEqual(TEXT("Token stream output matches scalar scanner for combined source"), RunCleanup(Combined, true), RunCleanup(Combined, false));
+
+	const FString Flattened = RunCleanup(FString(UniformBufferDeclarations) + EdgeCaseBodies[0], true);
+	TestTrue(TEXT("Member references are flattened"), Flattened.Contains(TEXT("mul(P, View_WorldToClip)")));
+	TestFalse(TEXT("Uniform buffer declarations are removed"), Flattened.Contains(TEXT("UniformBuffer")));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShaderSourceTokenizerTestBenchmark, "System.Shaders.ShaderSourceTokenizer.Benchmark", TestFlags | EAutomationTestFlags::PerfFilter)
+bool FShaderSourceTokenizerTestBenchmark::RunTest(const FString& Parameters)
+{
+	// Preprocessed shader sources can be dumped with r.DumpShaderDebugInfo=1 and passed with -ShaderSourceCorpus=<Directory>
+	TArray<FString> Sources;
+	FString CorpusDirectory;
+	if (FParse::Value(FCommandLine::Get(), TEXT("ShaderSourceCorpus="), CorpusDirectory))
+	{
+		TArray<FString> FileNames;
+		IFileManager::Get().FindFilesRecursive(FileNames, *CorpusDirectory, TEXT("*.usf"), true, false);
+		for (const FString& FileName : FileNames)
+		{
+			FFileHelper::LoadFileToString(Sources.AddDefaulted_GetRef(), *FileName);
+		}
+	}
+	if (Sources.Num() == 0)
+	{
+		Sources.Add(MakeSyntheticSource(4096));
+	}
+
+	int64 TotalChars = 0;
+	for (const FString& Source : Sources)
+	{
+		TotalChars += Source.Len();
+	}
+
+	double Seconds[2] = { 0.0, 0.0 };
+	for (int32 PathIndex = 0; PathIndex < 2; PathIndex++)
+	{
+		const bool bUseTokenStream = PathIndex == 0;
+		for (const FString& Source : Sources)
+		{
+			FShaderCompilerEnvironment Environment;
+			FShaderSource ShaderSource;
+			ShaderSource.Set(Source);
+
+			const double StartTime = FPlatformTime::Seconds();
+			CleanupUniformBufferCode(Environment, ShaderSource, bUseTokenStream);
+			Seconds[PathIndex] += FPlatformTime::Seconds() - StartTime;
+		}
+	}
+
+	int32 NumMismatches = 0;
+	for (const FString& Source : Sources)
+	{
+		NumMismatches += RunCleanup(Source, true) != RunCleanup(Source, false) ? 1 : 0;
+	}
+	TestEqual(TEXT("Token stream output matches scalar scanner for all sources"), NumMismatches, 0);
+
+	const double MegaBytes = double(TotalChars * sizeof(FShaderSource::CharType)) / (1024.0 * 1024.0);
+	AddInfo(FString::Printf(TEXT("CleanupUniformBufferCode over %d sources (%.1f MB): token stream %.1f MB/s, scalar %.1f MB/s"),
+		Sources.Num(), MegaBytes, MegaBytes / FMath::Max(Seconds[0], UE_SMALL_NUMBER), MegaBytes / FMath::Max(Seconds[1], UE_SMALL_NUMBER)));
+
+	return true;
+}
+
+} // namespace UE::ShaderCompilerCommon::Private::Tests
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,290 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShaderTransformCache.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "ShaderCompilerCore.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShaderTransformCache, Log, All);
+
+namespace UE::ShaderCompilerCommon::Private
+{
+	static int32 GShaderTransformCacheEnabled = 1;
+	static FAutoConsoleVariableRef CVarShaderTransformCacheEnabled(
+		TEXT("r.ShaderCompiler.TransformCache"),
+		GShaderTransformCacheEnabled,
+		TEXT("Caches the result of uniform buffer flattening and dead code removal by preprocessed source, entry point and required symbols, ")
+		TEXT("so permutations that preprocess to the same source skip the transforms (default 1)."),
+		ECVF_Default);
+
+	static int32 GShaderTransformCacheMaxMemoryMB = 256;
+	static FAutoConsoleVariableRef CVarShaderTransformCacheMaxMemoryMB(
+		TEXT("r.ShaderCompiler.TransformCache.MaxMemoryMB"),
+		GShaderTransformCacheMaxMemoryMB,
+		TEXT("Memory budget of the in memory shader transform cache, the oldest entries are evicted first (default 256)."),
+		ECVF_Default);
+
+	static FString GShaderTransformCacheDirectory;
+	static FAutoConsoleVariableRef CVarShaderTransformCacheDirectory(
+		TEXT("r.ShaderCompiler.TransformCache.Directory"),
+		GShaderTransformCacheDirectory,
+		TEXT("When set, shader transform cache entries are also stored in this directory, to be shared between worker processes and kept across cooks. ")
+		TEXT("Typically a folder next to the local derived data cache. Empty disables the directory (default)."),
+		ECVF_Default);
+
+	static FAutoConsoleCommand CmdShaderTransformCacheStats(
+		TEXT("r.ShaderCompiler.TransformCache.Stats"),
+		TEXT("Logs hit rate and time saved by the shader transform cache."),
+		FConsoleCommandDelegate::CreateLambda([]() { FShaderTransformCache::Get().LogStats(); }));
+
+	// Bump when the output of CleanupUniformBufferCode or RemoveDeadCode changes, to invalidate entries in the cache directory
+	static const FGuid ShaderTransformCacheVersion(TEXT("3C9A1E52-7D4B-4F0E-9B63-2A8D5C17E4F1"));
+	static constexpr uint32 ShaderTransformCacheFileMagic = 0x43525453;	// "STRC"
+
+	FShaderTransformCache& FShaderTransformCache::Get()
+	{
+		static FShaderTransformCache Cache;
+		return Cache;
+	}
+
+	bool FShaderTransformCache::IsEnabled()
+	{
+		return GShaderTransformCacheEnabled != 0;
+	}
+
+	FShaderTransformCache::FKey FShaderTransformCache::MakeKey(const FShaderSource& Source, FStringView EntryPoint, TConstArrayView<FStringView> RequiredSymbols)
+	{
+		FBlake3 Hasher;
+		Hasher.Update(&ShaderTransformCacheVersion, sizeof(ShaderTransformCacheVersion));
+
+		// Every part is prefixed with its length, so moving characters between parts changes the key
+		auto UpdateWithView = [&Hasher](const void* Data, int32 Len, int32 CharSize)
+		{
+			Hasher.Update(&Len, sizeof(Len));
+			Hasher.Update(Data, Len * CharSize);
+		};
+
+		const FShaderSource::FViewType SourceView = Source.GetView();
+		UpdateWithView(SourceView.GetData(), SourceView.Len(), sizeof(FShaderSource::CharType));
+		UpdateWithView(EntryPoint.GetData(), EntryPoint.Len(), sizeof(TCHAR));
+
+		const int32 NumRequiredSymbols = RequiredSymbols.Num();
+		Hasher.Update(&NumRequiredSymbols, sizeof(NumRequiredSymbols));
+		for (FStringView Symbol : RequiredSymbols)
+		{
+			UpdateWithView(Symbol.GetData(), Symbol.Len(), sizeof(TCHAR));
+		}
+
+		return Hasher.Finalize();
+	}
+
+	int64 FShaderTransformCache::FEntry::GetAllocatedSize() const
+	{
+		// Diagnostics are rare and short, only the code is worth accounting for precisely
+		return sizeof(FEntry) + Code.GetAllocatedSize() + Errors.GetAllocatedSize();
+	}
+
+	bool FShaderTransformCache::Find(const FKey& Key, FShaderSource& OutSource, TArray<FShaderCompilerError>& OutErrors)
+	{
+		TSharedPtr<const FEntry> Entry;
+		{
+			FReadScopeLock ReadLock(EntriesLock);
+			if (const TSharedRef<const FEntry>* Found = Entries.Find(Key))
+			{
+				Entry = *Found;
+			}
+		}
+
+		bool bFromDirectory = false;
+		if (!Entry.IsValid())
+		{
+			const FString Directory = GShaderTransformCacheDirectory;
+			if (!Directory.IsEmpty())
+			{
+				Entry = LoadFromDirectory(Directory, Key);
+				if (Entry.IsValid())
+				{
+					bFromDirectory = true;
+					AddToMemory(Key, Entry.ToSharedRef());
+				}
+			}
+		}
+
+		{
+			FScopeLock StatsLock(&StatsCriticalSection);
+			if (Entry.IsValid())
+			{
+				Stats.NumHits++;
+				Stats.NumDiskHits += bFromDirectory ? 1 : 0;
+				Stats.SecondsSaved += Entry->TransformSeconds;
+			}
+			else
+			{
+				Stats.NumMisses++;
+			}
+		}
+
+		if (!Entry.IsValid())
+		{
+			return false;
+		}
+
+		OutSource.Set(FShaderSource::FViewType(Entry->Code.GetData(), Entry->Code.Num()));
+		OutErrors.Append(Entry->Errors);
+		return true;
+	}
+
+	void FShaderTransformCache::Add(const FKey& Key, const FShaderSource& Source, TConstArrayView<FShaderCompilerError> Errors, double TransformSeconds)
+	{
+		const FShaderSource::FViewType SourceView = Source.GetView();
+
+		TSharedRef<FEntry> Entry = MakeShared<FEntry>();
+		Entry->Code.Append(SourceView.GetData(), SourceView.Len());
+		Entry->Errors.Append(Errors.GetData(), Errors.Num());
+		Entry->TransformSeconds = TransformSeconds;
+
+		{
+			FScopeLock StatsLock(&StatsCriticalSection);
+			Stats.SecondsSpent += TransformSeconds;
+		}
+
+		const FString Directory = GShaderTransformCacheDirectory;
+		if (!Directory.IsEmpty())
+		{
+			SaveToDirectory(Directory, Key, *Entry);
+		}
+
+		AddToMemory(Key, Entry);
+	}
+
+	void FShaderTransformCache::AddToMemory(const FKey& Key, TSharedRef<const FEntry> Entry)
+	{
+		const int64 MaxMemory = int64(FMath::Max(GShaderTransformCacheMaxMemoryMB, 0)) * 1024 * 1024;
+		const int64 EntrySize = Entry->GetAllocatedSize();
+		if (EntrySize > MaxMemory)
+		{
+			return;
+		}
+
+		FWriteScopeLock WriteLock(EntriesLock);
+
+		// Another thread may have transformed the same source concurrently
+		if (Entries.Contains(Key))
+		{
+			return;
+		}
+
+		FScopeLock StatsLock(&StatsCriticalSection);
+
+		while (Stats.MemoryUsed + EntrySize > MaxMemory && OldestIndex < InsertionOrder.Num())
+		{
+			TSharedRef<const FEntry> Evicted = Entries.FindAndRemoveChecked(InsertionOrder[OldestIndex++]);
+			Stats.MemoryUsed -= Evicted->GetAllocatedSize();
+			Stats.NumEvictions++;
+		}
+
+		if (OldestIndex > InsertionOrder.Num() / 2)
+		{
+			InsertionOrder.RemoveAt(0, OldestIndex, EAllowShrinking::No);
+			OldestIndex = 0;
+		}
+
+		Entries.Add(Key, MoveTemp(Entry));
+		InsertionOrder.Add(Key);
+		Stats.MemoryUsed += EntrySize;
+	}
+
+	static FString GetEntryFilename(const FString& Directory, const FShaderTransformCache::FKey& Key)
+	{
+		// Sharded by the first byte of the hash, like the file system derived data cache
+		const FString KeyString = LexToString(Key);
+		return FPaths::Combine(Directory, KeyString.Left(2), KeyString + TEXT(".shadertransform"));
+	}
+
+	TSharedPtr<const FShaderTransformCache::FEntry> FShaderTransformCache::LoadFromDirectory(const FString& Directory, const FKey& Key) const
+	{
+		TArray<uint8> Data;
+		if (!FFileHelper::LoadFileToArray(Data, *GetEntryFilename(Directory, Key), FILEREAD_Silent))
+		{
+			return nullptr;
+		}
+
+		FMemoryReader Ar(Data);
+
+		uint32 Magic = 0;
+		FGuid Version;
+		FKey StoredKey;
+		Ar << Magic << Version << StoredKey;
+		if (Magic != ShaderTransformCacheFileMagic || Version != ShaderTransformCacheVersion || StoredKey != Key)
+		{
+			return nullptr;
+		}
+
+		TSharedRef<FEntry> Entry = MakeShared<FEntry>();
+		Ar << Entry->Code << Entry->Errors << Entry->TransformSeconds;
+		if (Ar.IsError() || !Ar.AtEnd())
+		{
+			UE_LOG(LogShaderTransformCache, Warning, TEXT("Ignoring corrupt shader transform cache entry %s"), *GetEntryFilename(Directory, Key));
+			return nullptr;
+		}
+
+		return Entry;
+	}
+
+	void FShaderTransformCache::SaveToDirectory(const FString& Directory, const FKey& Key, FEntry& Entry) const
+	{
+		TArray<uint8> Data;
+		FMemoryWriter Ar(Data);
+
+		uint32 Magic = ShaderTransformCacheFileMagic;
+		FGuid Version = ShaderTransformCacheVersion;
+		FKey StoredKey = Key;
+		Ar << Magic << Version << StoredKey;
+
+		Ar << Entry.Code << Entry.Errors << Entry.TransformSeconds;
+
+		// Write to a temporary file and move it in place, so other processes never see a partial entry
+		const FString Filename = GetEntryFilename(Directory, Key);
+		const FString TempFilename = FPaths::Combine(FPaths::GetPath(Filename), FGuid::NewGuid().ToString() + TEXT(".tmp"));
+		if (FFileHelper::SaveArrayToFile(Data, *TempFilename))
+		{
+			if (!IFileManager::Get().Move(*Filename, *TempFilename, true, true, false, true))
+			{
+				IFileManager::Get().Delete(*TempFilename, false, false, true);
+			}
+		}
+	}
+
+	FShaderTransformCacheStats FShaderTransformCache::GetStats() const
+	{
+		FScopeLock StatsLock(&StatsCriticalSection);
+		return Stats;
+	}
+
+	void FShaderTransformCache::LogStats() const
+	{
+		const FShaderTransformCacheStats CurrentStats = GetStats();
+		UE_LOG(LogShaderTransformCache, Display, TEXT("Shader transform cache: %lld hits (%lld from directory), %lld misses, %.1f%% hit rate, %.2fs saved, %.2fs spent transforming, %lld evictions, %.1f MB in memory"),
+			CurrentStats.NumHits, CurrentStats.NumDiskHits, CurrentStats.NumMisses, CurrentStats.GetHitRate() * 100.0,
+			CurrentStats.SecondsSaved, CurrentStats.SecondsSpent, CurrentStats.NumEvictions, double(CurrentStats.MemoryUsed) / (1024.0 * 1024.0));
+	}
+
+	void FShaderTransformCache::Empty()
+	{
+		FWriteScopeLock WriteLock(EntriesLock);
+		Entries.Empty();
+		InsertionOrder.Empty();
+		OldestIndex = 0;
+
+		FScopeLock StatsLock(&StatsCriticalSection);
+		Stats.MemoryUsed = 0;
+	}
+}
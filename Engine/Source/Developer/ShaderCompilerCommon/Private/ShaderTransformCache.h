@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Hash/Blake3.h"
+#include "ShaderSource.h"
+
+struct FShaderCompilerError;
+
+namespace UE::ShaderCompilerCommon::Private
+{
+
+/** Counters of FShaderTransformCache, since process start */
+struct FShaderTransformCacheStats
+{
+	int64 NumHits = 0;
+	int64 NumDiskHits = 0;			// Subset of NumHits that were loaded from the cache directory
+	int64 NumMisses = 0;
+	int64 NumEvictions = 0;
+	int64 MemoryUsed = 0;
+	double SecondsSaved = 0.0;		// Sum of the original transform time of every hit
+	double SecondsSpent = 0.0;		// Time spent transforming on misses
+
+	double GetHitRate() const
+	{
+		const int64 NumLookups = NumHits + NumMisses;
+		return NumLookups ? double(NumHits) / double(NumLookups) : 0.0;
+	}
+};
+
+/**
+ * Content addressed cache of the source transforms done after preprocessing (uniform buffer flattening and dead code removal).
+ * Permutations of the same shader often preprocess to identical source, so the key is a hash of the preprocessed source, the
+ * entry point and the required symbols. Entries hold the transformed source along with the diagnostics the transforms emitted.
+ *
+ * Entries are kept in memory up to r.ShaderCompiler.TransformCache.MaxMemoryMB, evicting the oldest first. When
+ * r.ShaderCompiler.TransformCache.Directory is set they are also written there, one file per key, so incremental cooks and
+ * other worker processes can reuse them.
+ */
+class FShaderTransformCache
+{
+public:
+	using FKey = FBlake3Hash;
+
+	static FShaderTransformCache& Get();
+
+	static bool IsEnabled();
+
+	/** Key for transforming Source. EntryPoint and RequiredSymbols should be empty when dead code removal is not done. */
+	static FKey MakeKey(const FShaderSource& Source, FStringView EntryPoint, TConstArrayView<FStringView> RequiredSymbols);
+
+	/** On a hit, replaces OutSource with the transformed source and appends the diagnostics of the original transform to OutErrors. */
+	bool Find(const FKey& Key, FShaderSource& OutSource, TArray<FShaderCompilerError>& OutErrors);
+
+	/** Stores the result of a transform that took TransformSeconds and added Errors. */
+	void Add(const FKey& Key, const FShaderSource& Source, TConstArrayView<FShaderCompilerError> Errors, double TransformSeconds);
+
+	FShaderTransformCacheStats GetStats() const;
+
+	void LogStats() const;
+
+	/** Drops all in memory entries, the cache directory is left as is */
+	void Empty();
+
+private:
+	struct FEntry
+	{
+		TArray<FShaderSource::CharType> Code;
+		TArray<FShaderCompilerError> Errors;
+		double TransformSeconds = 0.0;
+
+		int64 GetAllocatedSize() const;
+	};
+
+	void AddToMemory(const FKey& Key, TSharedRef<const FEntry> Entry);
+	TSharedPtr<const FEntry> LoadFromDirectory(const FString& Directory, const FKey& Key) const;
+	void SaveToDirectory(const FString& Directory, const FKey& Key, FEntry& Entry) const;
+
+	mutable FRWLock EntriesLock;
+	TMap<FKey, TSharedRef<const FEntry>> Entries;
+	TArray<FKey> InsertionOrder;	// Oldest first, starting at OldestIndex
+	int32 OldestIndex = 0;
+
+	mutable FCriticalSection StatsCriticalSection;
+	FShaderTransformCacheStats Stats;
+};
+
+}
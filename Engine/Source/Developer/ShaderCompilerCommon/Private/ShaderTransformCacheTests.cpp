@@ -0,0 +1,56 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ShaderTransformCache.h"
+#include "Misc/AutomationTest.h"
+#include "ShaderCompilerCore.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace UE::ShaderCompilerCommon::Private::Tests
+{
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShaderTransformCacheTest, "System.Shaders.ShaderTransformCache", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+bool FShaderTransformCacheTest::RunTest(const FString& Parameters)
+{
+	FShaderTransformCache& Cache = FShaderTransformCache::Get();
+
+	FShaderSource Preprocessed;
+	Preprocessed.Set(TEXTVIEW("float4 Main() : SV_Target { return View.PreExposure; } float4 Unused() { return 0; }"));
+	const TArray<FStringView> RequiredSymbols = { TEXTVIEW("Main") };
+
+	const FShaderTransformCache::FKey Key = FShaderTransformCache::MakeKey(Preprocessed, TEXTVIEW("Main"), RequiredSymbols);
+	TestTrue(TEXT("Keys are deterministic"), FShaderTransformCache::MakeKey(Preprocessed, TEXTVIEW("Main"), RequiredSymbols) == Key);
+	TestTrue(TEXT("Entry point is part of the key"), FShaderTransformCache::MakeKey(Preprocessed, TEXTVIEW("Unused"), RequiredSymbols) != Key);
+	TestTrue(TEXT("Required symbols are part of the key"), FShaderTransformCache::MakeKey(Preprocessed, TEXTVIEW("Main"), {}) != Key);
+	TestTrue(TEXT("Characters moving between entry point and required symbols change the key"),
+		FShaderTransformCache::MakeKey(Preprocessed, TEXTVIEW("Mai"), { TEXTVIEW("nMain") }) != FShaderTransformCache::MakeKey(Preprocessed, TEXTVIEW("Main"), { TEXTVIEW("Main") }));
+
+	// Drop entries from earlier runs of this test
+	Cache.Empty();
+	const FShaderTransformCacheStats StatsBefore = Cache.GetStats();
+
+	FShaderSource Result;
+	TArray<FShaderCompilerError> Errors;
+	TestFalse(TEXT("Unknown key misses"), Cache.Find(Key, Result, Errors));
+
+	FShaderSource Transformed;
+	Transformed.Set(TEXTVIEW("float4 Main() : SV_Target { return View_PreExposure; }"));
+	TArray<FShaderCompilerError> TransformErrors;
+	TransformErrors.Add(TEXT("warning: Shader minification failed."));
+	Cache.Add(Key, Transformed, TransformErrors, 0.5);
+
+	TestTrue(TEXT("Added key hits"), Cache.Find(Key, Result, Errors));
+	TestTrue(TEXT("Hit returns the transformed source"), Result.GetView().Equals(Transformed.GetView()));
+	TestEqual(TEXT("Hit returns the transform diagnostics"), Errors.Num(), 1);
+
+	const FShaderTransformCacheStats StatsAfter = Cache.GetStats();
+	TestEqual(TEXT("Hits are counted"), StatsAfter.NumHits - StatsBefore.NumHits, (int64)1);
+	TestEqual(TEXT("Misses are counted"), StatsAfter.NumMisses - StatsBefore.NumMisses, (int64)1);
+	TestTrue(TEXT("Time saved is counted"), StatsAfter.SecondsSaved - StatsBefore.SecondsSaved >= 0.5);
+
+	return true;
+}
+
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
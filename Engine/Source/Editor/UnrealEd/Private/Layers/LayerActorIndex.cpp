@@ -0,0 +1,159 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Layers/LayerActorIndex.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+static bool GLayersUseActorIndex = true;
+static FAutoConsoleVariableRef CVarLayersUseActorIndex(
+	TEXT("Layers.UseActorIndex"),
+	GLayersUseActorIndex,
+	TEXT("When true, the layers subsystem finds the actors of a layer with an index of the actors of each layer instead of iterating the world."));
+
+bool FLayerActorIndex::IsEnabled()
+{
+	return GLayersUseActorIndex;
+}
+
+void FLayerActorIndex::Invalidate()
+{
+	bBuilt = false;
+	IndexedWorld.Reset();
+	Actors.Reset();
+	ActorLayers.Reset();
+	FreeIndices.Reset();
+	ActorIndices.Reset();
+	LayerActors.Reset();
+}
+
+void FLayerActorIndex::EnsureBuilt(UWorld* World)
+{
+	if (bBuilt && IndexedWorld.Get() == World)
+	{
+		return;
+	}
+
+	Invalidate();
+	bBuilt = true;
+	IndexedWorld = World;
+
+	if (World)
+	{
+		// Same actors as the queries iterated before the index
+		for (FActorIterator It(World); It; ++It)
+		{
+			if (It->Layers.Num() > 0)
+			{
+				AddActor(*It);
+			}
+		}
+	}
+}
+
+void FLayerActorIndex::AddActor(AActor* Actor)
+{
+	int32 ActorIndex;
+	if (FreeIndices.Num() > 0)
+	{
+		ActorIndex = FreeIndices.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		ActorIndex = Actors.AddDefaulted();
+		ActorLayers.AddDefaulted();
+	}
+
+	Actors[ActorIndex] = Actor;
+	ActorLayers[ActorIndex] = Actor->Layers;
+	ActorIndices.Add(Actor, ActorIndex);
+
+	for (const FName& LayerName : ActorLayers[ActorIndex])
+	{
+		TBitArray<>& LayerBits = LayerActors.FindOrAdd(LayerName);
+		if (LayerBits.Num() <= ActorIndex)
+		{
+			LayerBits.Add(false, ActorIndex + 1 - LayerBits.Num());
+		}
+		LayerBits[ActorIndex] = true;
+	}
+}
+
+void FLayerActorIndex::RemoveActorAt(int32 ActorIndex)
+{
+	for (const FName& LayerName : ActorLayers[ActorIndex])
+	{
+		if (TBitArray<>* LayerBits = LayerActors.Find(LayerName))
+		{
+			if (LayerBits->IsValidIndex(ActorIndex))
+			{
+				(*LayerBits)[ActorIndex] = false;
+			}
+		}
+	}
+
+	ActorIndices.Remove(Actors[ActorIndex]);
+	Actors[ActorIndex] = TObjectKey<AActor>();
+	ActorLayers[ActorIndex].Reset();
+	FreeIndices.Add(ActorIndex);
+}
+
+void FLayerActorIndex::UpdateActor(AActor* Actor)
+{
+	// Not built yet, the actor will be indexed with the others
+	if (!bBuilt || !Actor || Actor->GetWorld() != IndexedWorld.Get())
+	{
+		return;
+	}
+
+	if (const int32* ActorIndex = ActorIndices.Find(Actor))
+	{
+		if (ActorLayers[*ActorIndex] == Actor->Layers)
+		{
+			return;
+		}
+		RemoveActorAt(*ActorIndex);
+	}
+
+	if (Actor->Layers.Num() > 0)
+	{
+		AddActor(Actor);
+	}
+}
+
+void FLayerActorIndex::RemoveActor(AActor* Actor)
+{
+	if (!bBuilt || !Actor)
+	{
+		return;
+	}
+
+	if (const int32* ActorIndex = ActorIndices.Find(Actor))
+	{
+		RemoveActorAt(*ActorIndex);
+	}
+}
+
+void FLayerActorIndex::ForEachActorInLayers(UWorld* World, TConstArrayView<FName> LayerNames, TFunctionRef<void(AActor*)> Func)
+{
+	EnsureBuilt(World);
+
+	// Not a member, Func can change the layers of actors and update the index
+	TBitArray<> ActorsInLayers(false, Actors.Num());
+	for (const FName& LayerName : LayerNames)
+	{
+		if (const TBitArray<>* LayerBits = LayerActors.Find(LayerName))
+		{
+			ActorsInLayers.CombineWithBitwiseOR(*LayerBits, EBitwiseOperatorFlags::MaintainSize);
+		}
+	}
+
+	for (TConstSetBitIterator<> It(ActorsInLayers); It; ++It)
+	{
+		AActor* Actor = Actors[It.GetIndex()].ResolveObjectPtr();
+		if (IsValid(Actor))
+		{
+			Func(Actor);
+		}
+	}
+}
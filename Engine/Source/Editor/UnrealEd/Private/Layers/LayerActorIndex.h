@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class UWorld;
+
+/**
+ * Layer membership of the actors of the editor world, so the layers subsystem finds the actors of a layer without iterating the whole world
+ * and testing Actor->Layers of every actor.
+ *
+ * Actors in at least one layer get a dense index, and each layer a bit array over those indices: queries on several layers OR the bit arrays.
+ * The index is built on the first query for a world and then kept up to date by the layers subsystem as actors are added, removed or change
+ * layers. Changes it can't follow one by one (undo, map change, actor list changes) invalidate it, and it is built again on the next query.
+ */
+class FLayerActorIndex
+{
+public:
+	/** Whether the layers subsystem uses the index, Layers.UseActorIndex. */
+	static bool IsEnabled();
+
+	void Invalidate();
+
+	/** Updates the layers of Actor after they changed. */
+	void UpdateActor(AActor* Actor);
+
+	void RemoveActor(AActor* Actor);
+
+	/** Calls Func for every valid actor of World in any of LayerNames. */
+	void ForEachActorInLayers(UWorld* World, TConstArrayView<FName> LayerNames, TFunctionRef<void(AActor*)> Func);
+
+	/** Number of actors in the index. */
+	int32 Num() const
+	{
+		return ActorIndices.Num();
+	}
+
+private:
+	void EnsureBuilt(UWorld* World);
+	void AddActor(AActor* Actor);
+	void RemoveActorAt(int32 ActorIndex);
+
+	bool bBuilt = false;
+	TWeakObjectPtr<UWorld> IndexedWorld;
+
+	/** Indexed actors, and the layers they were indexed with. Free indices have a null key and no layers. */
+	TArray<TObjectKey<AActor>> Actors;
+	TArray<TArray<FName>> ActorLayers;
+	TArray<int32> FreeIndices;
+	TMap<TObjectKey<AActor>, int32> ActorIndices;
+
+	/** Bit ActorIndex of a layer is set when the actor is in that layer. */
+	TMap<FName, TBitArray<>> LayerActors;
+};
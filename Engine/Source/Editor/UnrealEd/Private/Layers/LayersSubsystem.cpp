@@ -4,6 +4,7 @@
 #include "Engine/Brush.h"
 #include "Components/PrimitiveComponent.h"
 #include "Layers/Layer.h"
+#include "Layers/LayerActorIndex.h"
 #include "LevelEditorViewport.h"
 #include "Misc/IFilter.h"
 #include "Engine/Selection.h"
@@ -30,6 +31,12 @@ public:
 
 	void Deinitialize();
 
+	/** Layer membership of the actors of the editor world, kept here since this object lives as long as the subsystem. */
+	FLayerActorIndex& GetActorIndex()
+	{
+		return ActorIndex;
+	}
+
 private:
 	void Initialize();
 
@@ -46,8 +53,16 @@ private:
 	 **/
 	void OnPostUndoRedo();
 
+	/** Delegate handlers keeping ActorIndex up to date. */
+	void OnLevelActorAdded(AActor* Actor);
+	void OnLevelActorDeleted(AActor* Actor);
+	void OnLevelActorListChanged();
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent);
+
 	ULayersSubsystem* LayersSubsystem;
 
+	FLayerActorIndex ActorIndex;
+
 	bool bIsInitialized;
 };
 
@@ -72,6 +87,14 @@ void FLayersBroadcast::Deinitialize()
 		FEditorDelegates::MapChange.RemoveAll(this);
 		FEditorDelegates::RefreshLayerBrowser.RemoveAll(this);
 		FEditorDelegates::PostUndoRedo.RemoveAll(this);
+		FCoreUObjectDelegates::OnObjectPropertyChanged.RemoveAll(this);
+		if (GEngine)
+		{
+			GEngine->OnLevelActorAdded().RemoveAll(this);
+			GEngine->OnLevelActorDeleted().RemoveAll(this);
+			GEngine->OnLevelActorListChanged().RemoveAll(this);
+		}
+		ActorIndex.Invalidate();
 	}
 }
 
@@ -84,11 +107,20 @@ void FLayersBroadcast::Initialize()
 		FEditorDelegates::MapChange.AddRaw(this, &FLayersBroadcast::OnEditorMapChange);
 		FEditorDelegates::RefreshLayerBrowser.AddRaw(this, &FLayersBroadcast::OnEditorRefreshLayerBrowser);
 		FEditorDelegates::PostUndoRedo.AddRaw(this, &FLayersBroadcast::OnPostUndoRedo);
+		// Keep the actor index up to date with changes made without the layers subsystem
+		FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FLayersBroadcast::OnObjectPropertyChanged);
+		if (GEngine)
+		{
+			GEngine->OnLevelActorAdded().AddRaw(this, &FLayersBroadcast::OnLevelActorAdded);
+			GEngine->OnLevelActorDeleted().AddRaw(this, &FLayersBroadcast::OnLevelActorDeleted);
+			GEngine->OnLevelActorListChanged().AddRaw(this, &FLayersBroadcast::OnLevelActorListChanged);
+		}
 	}
 }
 
 void FLayersBroadcast::OnEditorMapChange(uint32 MapChangeFlags)
 {
+	ActorIndex.Invalidate();
 	LayersSubsystem->EditorMapChange();
 }
 
@@ -99,9 +131,78 @@ void FLayersBroadcast::OnEditorRefreshLayerBrowser()
 
 void FLayersBroadcast::OnPostUndoRedo()
 {
+	// Undo can restore the layers of any actor
+	ActorIndex.Invalidate();
 	LayersSubsystem->PostUndoRedo();
 }
 
+void FLayersBroadcast::OnLevelActorAdded(AActor* Actor)
+{
+	ActorIndex.UpdateActor(Actor);
+}
+
+void FLayersBroadcast::OnLevelActorDeleted(AActor* Actor)
+{
+	ActorIndex.RemoveActor(Actor);
+}
+
+void FLayersBroadcast::OnLevelActorListChanged()
+{
+	// Broadcast for bulk changes (actors loaded or unloaded together), cheaper to build the index again when it is next needed
+	ActorIndex.Invalidate();
+}
+
+void FLayersBroadcast::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	if (PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(AActor, Layers))
+	{
+		if (AActor* Actor = Cast<AActor>(Object))
+		{
+			ActorIndex.UpdateActor(Actor);
+		}
+	}
+}
+
+namespace UE::Layers::Private
+{
+	/** Appends the actors of LayerNames found with the actor index, instead of testing the layers of every actor of the world. */
+	template <typename ActorPtrType>
+	static void AppendIndexedActorsFromLayers(FLayerActorIndex& ActorIndex, UWorld* World, TConstArrayView<FName> LayerNames, TArray<ActorPtrType>& InOutActors, const TSharedPtr<ULayersSubsystem::ActorFilter>& Filter)
+	{
+		ActorIndex.ForEachActorInLayers(World, LayerNames, [&InOutActors, &Filter](AActor* Actor)
+		{
+			if (!Filter.IsValid() || Filter->PassesFilter(Actor))
+			{
+				InOutActors.Add(Actor);
+			}
+		});
+	}
+
+	/**
+	 * UpdateAllActorsVisibility for the actors of LayerNames only: showing or hiding layers can't change the visibility of actors outside them.
+	 */
+	static void UpdateActorsVisibilityInLayers(ULayersSubsystem& LayersSubsystem, FLayerActorIndex& ActorIndex, TConstArrayView<FName> LayerNames)
+	{
+		bool bSelectionChanged = false;
+		ActorIndex.ForEachActorInLayers(LayersSubsystem.GetWorld(), LayerNames, [&LayersSubsystem, &bSelectionChanged](AActor* Actor)
+		{
+			bool bActorModified = false;
+			bool bActorSelectionChanged = false;
+			const bool bActorNotifySelectionChange = false;
+			const bool bActorRedrawViewports = false;
+			LayersSubsystem.UpdateActorVisibility(Actor, bActorSelectionChanged, bActorModified, bActorNotifySelectionChange, bActorRedrawViewports);
+			bSelectionChanged |= bActorSelectionChanged;
+		});
+
+		if (bSelectionChanged)
+		{
+			GEditor->NoteSelectionChange();
+		}
+
+		GEditor->RedrawLevelEditingViewports();
+	}
+}
+
 void ULayersSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
@@ -164,6 +265,7 @@ void ULayersSubsystem::RemoveLevelLayerInformation(ULevel* Level)
 		for (auto ActorIter = Level->Actors.CreateConstIterator(); ActorIter; ++ActorIter)
 		{
 			DisassociateActorFromLayers(*ActorIter);
+			LayersBroadcast->GetActorIndex().RemoveActor(*ActorIter);
 		}
 	}
 }
@@ -196,6 +298,8 @@ bool ULayersSubsystem::InitializeNewActorLayers(AActor* Actor)
 		AddActorToStats( Layer, Actor);
 	}
 
+	LayersBroadcast->GetActorIndex().UpdateActor(Actor);
+
 	// update per-view visibility info
 	UpdateActorAllViewsVisibility(Actor);
 
@@ -302,6 +406,8 @@ bool ULayersSubsystem::AddActorsToLayers( const TArray< AActor* >& Actors, const
 
 			if( bActorWasModified )
 			{
+				LayersBroadcast->GetActorIndex().UpdateActor(Actor);
+
 				// update per-view visibility info
 				UpdateActorAllViewsVisibility(Actor);
 
@@ -434,6 +540,8 @@ bool ULayersSubsystem::RemoveActorsFromLayers( const TArray< AActor* >& Actors,
 
 		if( ActorWasModified )
 		{
+			LayersBroadcast->GetActorIndex().UpdateActor(Actor);
+
 			// update per-view visibility info
 			UpdateActorAllViewsVisibility(Actor);
 
@@ -521,6 +629,11 @@ bool ULayersSubsystem::SelectActorsInLayer(const FName& LayerName, const bool bS
 
 bool ULayersSubsystem::SelectActorsInLayer(const FName& LayerName, const bool bSelect, const bool bNotify, const bool bSelectEvenIfHidden, const TSharedPtr< ActorFilter >& Filter)
 {
+	if (FLayerActorIndex::IsEnabled())
+	{
+		return SelectActorsInLayers({ LayerName }, bSelect, bNotify, bSelectEvenIfHidden, Filter);
+	}
+
 	GEditor->GetSelectedActors()->BeginBatchSelectOperation();
 	bool bChangesOccurred = false;
 	// Iterate over all actors, looking for actors in the specified layers.
@@ -574,6 +687,31 @@ bool ULayersSubsystem::SelectActorsInLayers(const TArray< FName >& LayerNames, c
 	GEditor->GetSelectedActors()->BeginBatchSelectOperation();
 	bool bChangesOccurred = false;
 
+	if (FLayerActorIndex::IsEnabled())
+	{
+		TArray<AActor*> LayerActors;
+		AppendActorsFromLayers(LayerNames, LayerActors, Filter);
+		for (AActor* Actor : LayerActors)
+		{
+			if (IsActorValidForLayer(Actor))
+			{
+				bool bNotifyForActor = false;
+				GEditor->GetSelectedActors()->Modify();
+				GEditor->SelectActor(Actor, bSelect, bNotifyForActor, bSelectEvenIfHidden);
+				bChangesOccurred = true;
+			}
+		}
+
+		GEditor->GetSelectedActors()->EndBatchSelectOperation();
+
+		if (bNotify)
+		{
+			GEditor->NoteSelectionChange();
+		}
+
+		return bChangesOccurred;
+	}
+
 	// Iterate over all actors, looking for actors in the specified layers.
 	for (AActor* Actor : FActorRange(GetWorld()))
 	{
@@ -627,6 +765,22 @@ void ULayersSubsystem::UpdatePerViewVisibility( FLevelEditorViewportClient* View
 	{
 		return;
 	}
+
+	// only the actors in the layer that changed can change visibility in a view hiding some layers
+	if (FLayerActorIndex::IsEnabled() && ViewportClient->ViewHiddenLayers.Num() > 0 && LayerThatChanged != NAME_Skip && ViewportClient->GetWorld() == GetWorld())
+	{
+		LayersBroadcast->GetActorIndex().ForEachActorInLayers(GetWorld(), { LayerThatChanged }, [this, ViewportClient](AActor* Actor)
+		{
+			if (IsActorValidForLayer(Actor))
+			{
+				UpdateActorViewVisibility(ViewportClient, Actor);
+			}
+		});
+
+		ViewportClient->Invalidate();
+		return;
+	}
+
 	for( FActorIterator It(ViewportClient->GetWorld()) ; It ; ++It )
 	{
 		AActor* Actor = *It;
@@ -974,6 +1128,12 @@ void ULayersSubsystem::AppendActorsFromLayer(const FName& LayerName, TArray< AAc
 
 void ULayersSubsystem::AppendActorsFromLayer(const FName& LayerName, TArray< AActor* >& InOutActors, const TSharedPtr< ActorFilter >& Filter) const
 {
+	if (FLayerActorIndex::IsEnabled())
+	{
+		UE::Layers::Private::AppendIndexedActorsFromLayers(LayersBroadcast->GetActorIndex(), GetWorld(), { LayerName }, InOutActors, Filter);
+		return;
+	}
+
 	LAYERS_SUBSYSTEM_APPEND_ACTORS_FOR_LAYER_PART_1
 		AActor* Actor = *ActorIt;
 	LAYERS_SUBSYSTEM_APPEND_ACTORS_FOR_LAYER_PART_2
@@ -981,6 +1141,12 @@ void ULayersSubsystem::AppendActorsFromLayer(const FName& LayerName, TArray< AAc
 
 void ULayersSubsystem::AppendActorsFromLayer(const FName& LayerName, TArray< TWeakObjectPtr< AActor > >& InOutActors, const TSharedPtr< ActorFilter >& Filter) const
 {
+	if (FLayerActorIndex::IsEnabled())
+	{
+		UE::Layers::Private::AppendIndexedActorsFromLayers(LayersBroadcast->GetActorIndex(), GetWorld(), { LayerName }, InOutActors, Filter);
+		return;
+	}
+
 	LAYERS_SUBSYSTEM_APPEND_ACTORS_FOR_LAYER_PART_1
 		const TWeakObjectPtr< AActor > Actor = *ActorIt;
 	LAYERS_SUBSYSTEM_APPEND_ACTORS_FOR_LAYER_PART_2
@@ -1015,6 +1181,12 @@ void ULayersSubsystem::AppendActorsFromLayers(const TArray< FName >& LayerNames,
 
 void ULayersSubsystem::AppendActorsFromLayers(const TArray< FName >& LayerNames, TArray< AActor* >& InOutActors, const TSharedPtr< ActorFilter >& Filter) const
 {
+	if (FLayerActorIndex::IsEnabled())
+	{
+		UE::Layers::Private::AppendIndexedActorsFromLayers(LayersBroadcast->GetActorIndex(), GetWorld(), LayerNames, InOutActors, Filter);
+		return;
+	}
+
 	LAYERS_SUBSYSTEM_APPEND_ACTORS_FOR_LAYERS_PART_1
 		AActor* Actor = *ActorIt;
 	LAYERS_SUBSYSTEM_APPEND_ACTORS_FOR_LAYERS_PART_2
@@ -1022,6 +1194,12 @@ void ULayersSubsystem::AppendActorsFromLayers(const TArray< FName >& LayerNames,
 
 void ULayersSubsystem::AppendActorsFromLayers(const TArray< FName >& LayerNames, TArray< TWeakObjectPtr< AActor > >& InOutActors, const TSharedPtr< ActorFilter >& Filter) const
 {
+	if (FLayerActorIndex::IsEnabled())
+	{
+		UE::Layers::Private::AppendIndexedActorsFromLayers(LayersBroadcast->GetActorIndex(), GetWorld(), LayerNames, InOutActors, Filter);
+		return;
+	}
+
 	LAYERS_SUBSYSTEM_APPEND_ACTORS_FOR_LAYERS_PART_1
 		const TWeakObjectPtr< AActor > Actor = *ActorIt;
 	LAYERS_SUBSYSTEM_APPEND_ACTORS_FOR_LAYERS_PART_2
@@ -1082,7 +1260,14 @@ void ULayersSubsystem::SetLayersVisibility( const TArray< FName >& LayerNames, c
 
 	if( bChangeOccurred )
 	{
-		UpdateAllActorsVisibility( true, true );
+		if (FLayerActorIndex::IsEnabled())
+		{
+			UE::Layers::Private::UpdateActorsVisibilityInLayers(*this, LayersBroadcast->GetActorIndex(), LayerNames);
+		}
+		else
+		{
+			UpdateAllActorsVisibility( true, true );
+		}
 	}
 }
 
@@ -1096,7 +1281,14 @@ void ULayersSubsystem::ToggleLayerVisibility( const FName& LayerName )
 	Layer->SetVisible(!Layer->IsVisible());
 
 	LayersChanged.Broadcast( ELayersAction::Modify, Layer, "bIsVisible" );
-	UpdateAllActorsVisibility( true, true );
+	if (FLayerActorIndex::IsEnabled())
+	{
+		UE::Layers::Private::UpdateActorsVisibilityInLayers(*this, LayersBroadcast->GetActorIndex(), { LayerName });
+	}
+	else
+	{
+		UpdateAllActorsVisibility( true, true );
+	}
 }
 
 
@@ -1117,12 +1309,20 @@ void ULayersSubsystem::ToggleLayersVisibility( const TArray< FName >& LayerNames
 		LayersChanged.Broadcast( ELayersAction::Modify, Layer, "bIsVisible" );
 	}
 
-	UpdateAllActorsVisibility( true, true );
+	if (FLayerActorIndex::IsEnabled())
+	{
+		UE::Layers::Private::UpdateActorsVisibilityInLayers(*this, LayersBroadcast->GetActorIndex(), LayerNames);
+	}
+	else
+	{
+		UpdateAllActorsVisibility( true, true );
+	}
 }
 
 
 void ULayersSubsystem::MakeAllLayersVisible()
 {
+	TArray<FName> ShownLayerNames;
 	for (auto Layer : GetWorld()->Layers)
 	{
 		if( !Layer->IsVisible() )
@@ -1130,10 +1330,18 @@ void ULayersSubsystem::MakeAllLayersVisible()
 			Layer->Modify();
 			Layer->SetVisible(true);
 			LayersChanged.Broadcast( ELayersAction::Modify, TWeakObjectPtr< ULayer >(Layer), "bIsVisible" );
+			ShownLayerNames.Add(Layer->GetLayerName());
 		}
 	}
 
-	UpdateAllActorsVisibility( true, true );
+	if (FLayerActorIndex::IsEnabled())
+	{
+		UE::Layers::Private::UpdateActorsVisibilityInLayers(*this, LayersBroadcast->GetActorIndex(), ShownLayerNames);
+	}
+	else
+	{
+		UpdateAllActorsVisibility( true, true );
+	}
 }
 
 
@@ -1219,11 +1427,12 @@ void ULayersSubsystem::DeleteLayers( const TArray< FName >& LayersToDelete )
 		}
 	}
 
-	// Iterate over all actors, looking for actors in the specified layers.
-	for( FActorIterator It(GetWorld()); It ; ++It )
+	// Only the actors in the layers have anything to remove.
+	// Gathered first since removing them from the layers updates the actor index.
+	TArray< AActor* > LayerActors;
+	AppendActorsFromLayers( ValidLayersToDelete, LayerActors );
+	for( AActor* Actor : LayerActors )
 	{
-		AActor* Actor = *It;
-
 		//The Layer must exist in order to remove actors from it,
 		//so we have to wait to delete the ULayer object till after
 		//all the actors have been disassociated with it.
@@ -1251,11 +1460,12 @@ void ULayersSubsystem::DeleteLayer( const FName& LayerToDelete )
 	{
 		return;
 	}
-	// Iterate over all actors, looking for actors in the specified layer.
-	for( FActorIterator It(GetWorld()) ; It ; ++It )
+	// Only the actors in the layer have anything to remove.
+	// Gathered first since removing them from the layer updates the actor index.
+	TArray< AActor* > LayerActors;
+	AppendActorsFromLayer( LayerToDelete, LayerActors );
+	for( AActor* Actor : LayerActors )
 	{
-		AActor* Actor = *It;
-
 		//The Layer must exist in order to remove actors from it,
 		//so we have to wait to delete the ULayer object till after
 		//all the actors have been disassociated with it.
@@ -1296,10 +1506,12 @@ bool ULayersSubsystem::RenameLayer( const FName& OriginalLayerName, const FName&
 	const FName OriginalLayerNameCopy = OriginalLayerName; // Otherwise, bug if RenameLayer(Layer->LayerName, NewLayerName) after the next LayerName rename
 	Layer->SetLayerName(NewLayerName);
 	Layer->ClearActorStats();
-	// Iterate over all actors, swapping layers.
-	for( FActorIterator It(GetWorld()) ; It ; ++It )
+	// Iterate over the actors of the layer, swapping layers.
+	// Gathered first since swapping their layers updates the actor index.
+	TArray< AActor* > LayerActors;
+	AppendActorsFromLayer( OriginalLayerNameCopy, LayerActors );
+	for( AActor* Actor : LayerActors )
 	{
-		AActor* Actor = *It;
 		if( !IsActorValidForLayer( Actor ) )
 		{
 			continue;
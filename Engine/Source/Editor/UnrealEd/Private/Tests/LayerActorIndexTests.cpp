@@ -0,0 +1,352 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Algo/Transform.h"
+#include "Editor.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Layers/LayerActorIndex.h"
+#include "Layers/LayersSubsystem.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace LayerActorIndexTest
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_EditorContext | EAutomationTestFlags::EngineFilter;
+
+static FName GetLayerName(int32 LayerIndex)
+{
+	return FName(TEXT("Layer"), LayerIndex + 1);
+}
+
+/** Editor world of NumActors actors, each in one or two of NumLayers layers, or in none for a quarter of them. */
+static UWorld* CreateLayeredWorld(int32 NumActors, int32 NumLayers)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false);
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags = RF_Transient;
+
+	FRandomStream Stream(0x1a7e5);
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+	{
+		AActor* Actor = World->SpawnActor<AActor>(SpawnParameters);
+		const int32 NumActorLayers = Stream.RandRange(0, 3) == 0 ? 0 : Stream.RandRange(1, 2);
+		for (int32 Index = 0; Index < NumActorLayers; ++Index)
+		{
+			Actor->Layers.AddUnique(GetLayerName(Stream.RandHelper(NumLayers)));
+		}
+	}
+	return World;
+}
+
+/** What ULayersSubsystem::AppendActorsFromLayers does without the index. */
+static void AppendActorsFromLayersByIteration(UWorld* World, TConstArrayView<FName> LayerNames, TArray<AActor*>& OutActors)
+{
+	for (FActorIterator It(World); It; ++It)
+	{
+		for (const FName& LayerName : LayerNames)
+		{
+			if (It->Layers.Contains(LayerName))
+			{
+				OutActors.Add(*It);
+				break;
+			}
+		}
+	}
+}
+
+static bool SameActors(TArray<AActor*> A, TArray<AActor*> B)
+{
+	A.Sort();
+	B.Sort();
+	return A == B;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLayerActorIndexTest, "Editor.Layers.ActorIndex", TestFlags)
+bool FLayerActorIndexTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = CreateLayeredWorld(2000, 8);
+	FLayerActorIndex ActorIndex;
+
+	const FName Layers[] = { GetLayerName(0), GetLayerName(3) };
+	TArray<AActor*> Expected;
+	TArray<AActor*> Actual;
+	AppendActorsFromLayersByIteration(World, Layers, Expected);
+	ActorIndex.ForEachActorInLayers(World, Layers, [&Actual](AActor* Actor) { Actual.Add(Actor); });
+	TestTrue(TEXT("Index finds the actors of the layers"), SameActors(Expected, Actual));
+
+	// move some actors between layers, remove others
+	int32 Count = 0;
+	for (FActorIterator It(World); It && Count < 300; ++It, ++Count)
+	{
+		if (Count % 3 == 0)
+		{
+			It->Layers.Reset();
+			It->Layers.Add(GetLayerName(3));
+			ActorIndex.UpdateActor(*It);
+		}
+		else if (Count % 3 == 1)
+		{
+			ActorIndex.RemoveActor(*It);
+			World->DestroyActor(*It);
+		}
+	}
+
+	Expected.Reset();
+	Actual.Reset();
+	AppendActorsFromLayersByIteration(World, Layers, Expected);
+	ActorIndex.ForEachActorInLayers(World, Layers, [&Actual](AActor* Actor) { Actual.Add(Actor); });
+	TestTrue(TEXT("Index follows layer changes and removed actors"), SameActors(Expected, Actual));
+
+	World->DestroyWorld(false);
+	return true;
+}
+
+/** Runs Layers.UseActorIndex at 0 then 1 through the subsystem and compares what the two find. */
+class FSubsystemComparer
+{
+public:
+	FSubsystemComparer(FAutomationTestBase& InTest, ULayersSubsystem& InLayers)
+		: Test(InTest)
+		, Layers(InLayers)
+		, UseActorIndex(IConsoleManager::Get().FindConsoleVariable(TEXT("Layers.UseActorIndex")))
+	{
+		check(UseActorIndex);
+		bPreviousUseActorIndex = UseActorIndex->GetBool();
+	}
+
+	~FSubsystemComparer()
+	{
+		SetUseActorIndex(bPreviousUseActorIndex);
+	}
+
+	void SetUseActorIndex(bool bUseActorIndex)
+	{
+		UseActorIndex->Set(bUseActorIndex, ECVF_SetByCode);
+	}
+
+	/** Queries every layer on its own, then the first and last layers together, without and with the index. */
+	bool CompareQueries(const TCHAR* What, TConstArrayView<FName> LayerNames)
+	{
+		bool bSame = true;
+		for (int32 LayerIndex = 0; LayerIndex < LayerNames.Num(); ++LayerIndex)
+		{
+			TArray<AActor*> Actors[2];
+			for (int32 UseIndex = 0; UseIndex < 2; ++UseIndex)
+			{
+				SetUseActorIndex(UseIndex != 0);
+				Layers.AppendActorsFromLayer(LayerNames[LayerIndex], Actors[UseIndex]);
+			}
+			bSame &= Test.TestTrue(FString::Printf(TEXT("%s: actors of %s"), What, *LayerNames[LayerIndex].ToString()), SameActors(Actors[0], Actors[1]));
+		}
+
+		const TArray<FName> LayerPair = { LayerNames[0], LayerNames.Last() };
+		TArray<TWeakObjectPtr<AActor>> WeakActors[2];
+		for (int32 UseIndex = 0; UseIndex < 2; ++UseIndex)
+		{
+			SetUseActorIndex(UseIndex != 0);
+			Layers.AppendActorsFromLayers(LayerPair, WeakActors[UseIndex], nullptr);
+		}
+		auto Resolve = [](const TArray<TWeakObjectPtr<AActor>>& InActors)
+		{
+			TArray<AActor*> Resolved;
+			Algo::Transform(InActors, Resolved, [](const TWeakObjectPtr<AActor>& Actor) { return Actor.Get(); });
+			return Resolved;
+		};
+		bSame &= Test.TestTrue(FString::Printf(TEXT("%s: actors of two layers"), What), SameActors(Resolve(WeakActors[0]), Resolve(WeakActors[1])));
+		return bSame;
+	}
+
+private:
+	FAutomationTestBase& Test;
+	ULayersSubsystem& Layers;
+	IConsoleVariable* UseActorIndex;
+	bool bPreviousUseActorIndex;
+};
+
+/**
+ * Edits layers through ULayersSubsystem and the editor delegates the index listens to, on the editor world, and checks the subsystem
+ * finds and hides the same actors with and without the index.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLayerActorIndexSubsystemTest, "Editor.Layers.ActorIndex.Subsystem", TestFlags)
+bool FLayerActorIndexSubsystemTest::RunTest(const FString& Parameters)
+{
+	ULayersSubsystem* Layers = GEditor ? GEditor->GetEditorSubsystem<ULayersSubsystem>() : nullptr;
+	UWorld* World = Layers ? Layers->GetWorld() : nullptr;
+	if (!TestNotNull(TEXT("Editor world"), World))
+	{
+		return false;
+	}
+
+	constexpr int32 NumLayers = 4;
+	constexpr int32 NumActors = 64;
+	TArray<FName> LayerNames;
+	for (int32 LayerIndex = 0; LayerIndex < NumLayers; ++LayerIndex)
+	{
+		LayerNames.Add(FName(TEXT("LayerActorIndexTest"), LayerIndex + 1));
+		Layers->CreateLayer(LayerNames.Last());
+	}
+
+	FSubsystemComparer Comparer(*this, *Layers);
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.ObjectFlags = RF_Transient;
+	TArray<AActor*> Actors;
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+	{
+		Actors.Add(World->SpawnActor<AActor>(SpawnParameters));
+	}
+
+	// actor N is in the layers of the set bits of N, the query builds the index
+	for (int32 LayerIndex = 0; LayerIndex < NumLayers; ++LayerIndex)
+	{
+		TArray<AActor*> LayerActors;
+		for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+		{
+			if ((ActorIndex >> LayerIndex) & 1)
+			{
+				LayerActors.Add(Actors[ActorIndex]);
+			}
+		}
+		Layers->AddActorsToLayers(LayerActors, { LayerNames[LayerIndex] });
+	}
+	Comparer.CompareQueries(TEXT("Added to layers"), LayerNames);
+
+	Layers->RemoveActorsFromLayers(TArray<AActor*>(Actors.GetData(), NumActors / 2), { LayerNames[0], LayerNames[2] });
+	Comparer.CompareQueries(TEXT("Removed from layers"), LayerNames);
+
+	// changes made without the subsystem, followed through the editor delegates
+	const FProperty* LayersProperty = FindFProperty<FProperty>(AActor::StaticClass(), GET_MEMBER_NAME_CHECKED(AActor, Layers));
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ActorIndex += 5)
+	{
+		Actors[ActorIndex]->Layers = { LayerNames[3] };
+		FPropertyChangedEvent PropertyChangedEvent(const_cast<FProperty*>(LayersProperty));
+		FCoreUObjectDelegates::OnObjectPropertyChanged.Broadcast(Actors[ActorIndex], PropertyChangedEvent);
+	}
+	Comparer.CompareQueries(TEXT("Property changed"), LayerNames);
+
+	SpawnParameters.Template = Actors[NumActors - 1];
+	Actors.Add(World->SpawnActor<AActor>(SpawnParameters));
+	SpawnParameters.Template = nullptr;
+	TestTrue(TEXT("Spawned from a template in every layer"), Actors.Last()->Layers.Num() == NumLayers);
+	World->DestroyActor(Actors[7]);
+	Actors.RemoveAt(7);
+	Comparer.CompareQueries(TEXT("Actor added and deleted"), LayerNames);
+
+	// changes the index can't see, until a bulk change or an undo invalidates it
+	Actors[1]->Layers = { LayerNames[1] };
+	Actors[2]->Layers.Reset();
+	GEngine->BroadcastLevelActorListChanged();
+	Comparer.CompareQueries(TEXT("Actor list changed"), LayerNames);
+
+	Actors[3]->Layers = { LayerNames[0], LayerNames[2] };
+	FEditorDelegates::PostUndoRedo.Broadcast();
+	Comparer.CompareQueries(TEXT("Undo"), LayerNames);
+
+	// showing and hiding layers only updates the actors of those layers with the index, the actors hidden must be the same
+	TArray<bool> HiddenActors[2];
+	for (int32 UseIndex = 0; UseIndex < 2; ++UseIndex)
+	{
+		Comparer.SetUseActorIndex(UseIndex != 0);
+		auto RecordHidden = [&Actors, &Hidden = HiddenActors[UseIndex]]()
+		{
+			for (AActor* Actor : Actors)
+			{
+				Hidden.Add(Actor->IsHiddenEd());
+			}
+		};
+		Layers->SetLayersVisibility({ LayerNames[0], LayerNames[1] }, false);
+		RecordHidden();
+		Layers->ToggleLayerVisibility(LayerNames[3]);
+		RecordHidden();
+		Layers->ToggleLayersVisibility({ LayerNames[0], LayerNames[3] });
+		RecordHidden();
+		Layers->MakeAllLayersVisible();
+		RecordHidden();
+	}
+	TestTrue(TEXT("Hiding a layer hides its actors"), HiddenActors[1].Contains(true));
+	TestTrue(TEXT("Same actors hidden with and without the index"), HiddenActors[0] == HiddenActors[1]);
+
+	Layers->DeleteLayers(LayerNames);
+	Comparer.CompareQueries(TEXT("Layers deleted"), LayerNames);
+	for (AActor* Actor : Actors)
+	{
+		World->DestroyActor(Actor);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLayerActorIndexBenchmarkTest, "Editor.Layers.ActorIndex.Benchmark", TestFlags | EAutomationTestFlags::PerfFilter)
+bool FLayerActorIndexBenchmarkTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumActors = 500000;
+	constexpr int32 NumLayers = 64;
+	constexpr int32 NumQueries = 20;
+
+	UWorld* World = CreateLayeredWorld(NumActors, NumLayers);
+	FLayerActorIndex ActorIndex;
+
+	double StartTime = FPlatformTime::Seconds();
+	ActorIndex.ForEachActorInLayers(World, {}, [](AActor*) {});
+	const double BuildSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// one layer, as when toggling a layer, then eight, as when selecting several layers in the layer browser
+	TArray<FName> ManyLayers;
+	for (int32 LayerIndex = 0; LayerIndex < 8; ++LayerIndex)
+	{
+		ManyLayers.Add(GetLayerName(LayerIndex * 7));
+	}
+	const TArray<FName> OneLayer = { GetLayerName(5) };
+
+	double IterationSeconds[2] = {};
+	double IndexSeconds[2] = {};
+	int32 NumMismatches = 0;
+	TArray<AActor*> Iterated;
+	TArray<AActor*> Indexed;
+	for (int32 Query = 0; Query < NumQueries; ++Query)
+	{
+		const int32 QueryType = Query % 2;
+		TConstArrayView<FName> QueryLayers = QueryType == 0 ? TConstArrayView<FName>(OneLayer) : TConstArrayView<FName>(ManyLayers);
+
+		Iterated.Reset();
+		StartTime = FPlatformTime::Seconds();
+		AppendActorsFromLayersByIteration(World, QueryLayers, Iterated);
+		IterationSeconds[QueryType] += FPlatformTime::Seconds() - StartTime;
+
+		Indexed.Reset();
+		StartTime = FPlatformTime::Seconds();
+		ActorIndex.ForEachActorInLayers(World, QueryLayers, [&Indexed](AActor* Actor) { Indexed.Add(Actor); });
+		IndexSeconds[QueryType] += FPlatformTime::Seconds() - StartTime;
+
+		NumMismatches += SameActors(Iterated, Indexed) ? 0 : 1;
+	}
+	TestEqual(TEXT("Index and iteration find the same actors"), NumMismatches, 0);
+
+	// layer edits on a selection of actors
+	constexpr int32 NumEdits = 10000;
+	StartTime = FPlatformTime::Seconds();
+	int32 Count = 0;
+	for (FActorIterator It(World); It && Count < NumEdits; ++It, ++Count)
+	{
+		It->Layers.AddUnique(GetLayerName(NumLayers - 1));
+		ActorIndex.UpdateActor(*It);
+	}
+	const double UpdateSeconds = FPlatformTime::Seconds() - StartTime;
+
+	const int32 QueriesPerType = NumQueries / 2;
+	AddInfo(FString::Printf(TEXT("%d actors, %d layers: index built in %.3f ms, %d actors indexed"), NumActors, NumLayers, 1000.0 * BuildSeconds, ActorIndex.Num()));
+	AddInfo(FString::Printf(TEXT("One layer: %.3f ms iterating the world, %.3f ms with the index"), 1000.0 * IterationSeconds[0] / QueriesPerType, 1000.0 * IndexSeconds[0] / QueriesPerType));
+	AddInfo(FString::Printf(TEXT("Eight layers: %.3f ms iterating the world, %.3f ms with the index"), 1000.0 * IterationSeconds[1] / QueriesPerType, 1000.0 * IndexSeconds[1] / QueriesPerType));
+	AddInfo(FString::Printf(TEXT("%d actor layer edits: %.3f ms"), NumEdits, 1000.0 * UpdateSeconds));
+
+	World->DestroyWorld(false);
+	return true;
+}
+
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,343 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HeadlessChaosTestGJK.h"
+#include "HeadlessChaos.h"
+
+#include "Chaos/Box.h"
+#include "Chaos/Capsule.h"
+#include "Chaos/Collision/ShapeBatchCache.h"
+#include "Chaos/Convex.h"
+#include "Chaos/GJK.h"
+#include "Chaos/Sphere.h"
+#include "ChaosLog.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace ChaosTest
+{
+	using namespace Chaos;
+	using namespace Chaos::Private;
+
+	// Runs Test with the ISPC kernels and the scalar fallback, when the kernels can be toggled
+	template<typename TestType>
+	void ForEachShapeBatchKernelPath(const TestType& Test)
+	{
+#if INTEL_ISPC && !UE_BUILD_SHIPPING
+		const bool bWasISPCEnabled = bChaos_ShapeBatch_ISPC_Enabled;
+		for (const bool bISPCEnabled : { false, true })
+		{
+			bChaos_ShapeBatch_ISPC_Enabled = bISPCEnabled;
+			Test();
+		}
+		bChaos_ShapeBatch_ISPC_Enabled = bWasISPCEnabled;
+#else
+		Test();
+#endif
+	}
+
+	FRigidTransform3 RandomShapeBatchTransform(FRandomStream& Stream, const FReal Range)
+	{
+		const FVec3 Position = FVec3(Stream.FRandRange(-Range, Range), Stream.FRandRange(-Range, Range), Stream.FRandRange(-Range, Range));
+		const FRotation3 Rotation = FRotation3(FQuat(FVector(Stream.VRand()), Stream.FRandRange(0, UE_TWO_PI)));
+		return FRigidTransform3(Position, Rotation);
+	}
+
+	// The batched kernels agree with GJKDistance for separated pairs and report a negative phi when GJK reports overlap
+	template<typename ShapeBType>
+	void ShapeBatchCacheMatchesGJK(const TArray<TUniquePtr<ShapeBType>>& ShapesB, TFunctionRef<void(const FShapeBatchCache&, TArrayView<const FShapeBatchPair>, TArrayView<FRealSingle>, TArrayView<FVec3f>)> Kernel)
+	{
+		const FReal Tolerance = (FReal)1e-2;
+		const FVec3 Origin = FVec3(10000, -20000, 500);
+		const int32 NumPairs = 256;
+
+		FRandomStream Stream(NumPairs + ShapesB.Num());
+		TArray<TUniquePtr<FImplicitSphere3>> Spheres;
+		TArray<FRigidTransform3> SphereTransforms;
+		TArray<FRigidTransform3> ShapeTransforms;
+		TArray<FShapeBatchPair> Pairs;
+
+		FShapeBatchCache Cache;
+		Cache.Reset(Origin);
+		for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+		{
+			Spheres.Add(MakeUnique<FImplicitSphere3>(FVec3(0), Stream.FRandRange(1, 20)));
+		}
+		for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+		{
+			SphereTransforms.Add(FRigidTransform3(Origin + RandomShapeBatchTransform(Stream, 50).GetTranslation(), FRotation3::FromIdentity()));
+			ShapeTransforms.Add(FRigidTransform3(Origin + RandomShapeBatchTransform(Stream, 50).GetTranslation(), RandomShapeBatchTransform(Stream, 0).GetRotation()));
+
+			const FShapeBatchHandle SphereHandle = Cache.AddImplicitObject(Spheres[PairIndex].Get(), SphereTransforms[PairIndex]);
+			const FShapeBatchHandle ShapeHandle = Cache.AddImplicitObject(ShapesB[PairIndex % ShapesB.Num()].Get(), ShapeTransforms[PairIndex]);
+			EXPECT_TRUE(SphereHandle.IsValid());
+			EXPECT_TRUE(ShapeHandle.IsValid());
+			Pairs.Add({ SphereHandle.Index, ShapeHandle.Index });
+		}
+
+		ForEachShapeBatchKernelPath([&]()
+		{
+			TArray<FRealSingle> Phis;
+			TArray<FVec3f> Normals;
+			Phis.SetNumZeroed(NumPairs);
+			Normals.SetNumZeroed(NumPairs);
+			Kernel(Cache, Pairs, Phis, Normals);
+
+			for (int32 PairIndex = 0; PairIndex < NumPairs; ++PairIndex)
+			{
+				const FImplicitSphere3& A = *Spheres[PairIndex];
+				const ShapeBType& B = *ShapesB[PairIndex % ShapesB.Num()];
+				const FRigidTransform3 BToATm = ShapeTransforms[PairIndex].GetRelativeTransform(SphereTransforms[PairIndex]);
+
+				FVec3 NearestA = { 0,0,0 };
+				FVec3 NearestB = { 0,0,0 };
+				FReal Distance = 0;
+				FVec3 Normal = { 0,0,1 };
+				const EGJKDistanceResult Result = GJKDistance<FReal>(
+					TGJKCoreShape(A),
+					TGJKCoreShapeTransformed(B, BToATm),
+					GJKDistanceInitialVFromRelativeTransform(A, B, BToATm),
+					Distance, NearestA, NearestB, Normal);
+
+				if (Result == EGJKDistanceResult::Separated)
+				{
+					EXPECT_NEAR(Phis[PairIndex], Distance, Tolerance);
+
+					// Batched normals point from B to A in world space
+					const FVec3 ExpectedNormal = SphereTransforms[PairIndex].TransformVectorNoScale((NearestA - NearestB).GetSafeNormal());
+					if (Distance > Tolerance)
+					{
+						EXPECT_NEAR(Normals[PairIndex].X, ExpectedNormal.X, Tolerance);
+						EXPECT_NEAR(Normals[PairIndex].Y, ExpectedNormal.Y, Tolerance);
+						EXPECT_NEAR(Normals[PairIndex].Z, ExpectedNormal.Z, Tolerance);
+					}
+				}
+				else
+				{
+					EXPECT_LT(Phis[PairIndex], Tolerance);
+				}
+			}
+		});
+	}
+
+	TEST(ShapeBatchCacheTests, TestSphereSphereMatchesGJK)
+	{
+		TArray<TUniquePtr<FImplicitSphere3>> Shapes;
+		Shapes.Add(MakeUnique<FImplicitSphere3>(FVec3(0), 5));
+		Shapes.Add(MakeUnique<FImplicitSphere3>(FVec3(2, 0, -3), 12));
+		ShapeBatchCacheMatchesGJK(Shapes,
+			[](const FShapeBatchCache& Cache, TArrayView<const FShapeBatchPair> Pairs, TArrayView<FRealSingle> Phis, TArrayView<FVec3f> Normals)
+			{
+				// Spheres and shapes share the sphere batch, at interleaved indices
+				Cache.ComputeSphereSphereDistances(Pairs, Phis, Normals);
+			});
+	}
+
+	TEST(ShapeBatchCacheTests, TestSphereBoxMatchesGJK)
+	{
+		TArray<TUniquePtr<FImplicitBox3>> Shapes;
+		Shapes.Add(MakeUnique<FImplicitBox3>(FVec3(-10, -5, -2), FVec3(10, 5, 2)));
+		Shapes.Add(MakeUnique<FImplicitBox3>(FVec3(-1, -30, -15), FVec3(3, 30, 5), 0.5));
+		ShapeBatchCacheMatchesGJK(Shapes,
+			[](const FShapeBatchCache& Cache, TArrayView<const FShapeBatchPair> Pairs, TArrayView<FRealSingle> Phis, TArrayView<FVec3f> Normals)
+			{
+				Cache.ComputeSphereBoxDistances(Pairs, Phis, Normals);
+			});
+	}
+
+	TEST(ShapeBatchCacheTests, TestSphereCapsuleMatchesGJK)
+	{
+		TArray<TUniquePtr<FImplicitCapsule3>> Shapes;
+		Shapes.Add(MakeUnique<FImplicitCapsule3>(FVec3(0, 0, -20), FVec3(0, 0, 20), 6));
+		Shapes.Add(MakeUnique<FImplicitCapsule3>(FVec3(-3, 2, 0), FVec3(10, 2, 4), 2));
+		ShapeBatchCacheMatchesGJK(Shapes,
+			[](const FShapeBatchCache& Cache, TArrayView<const FShapeBatchPair> Pairs, TArrayView<FRealSingle> Phis, TArrayView<FVec3f> Normals)
+			{
+				Cache.ComputeSphereCapsuleDistances(Pairs, Phis, Normals);
+			});
+	}
+
+	TEST(ShapeBatchCacheTests, TestSphereInsideBox)
+	{
+		const FImplicitSphere3 Sphere(FVec3(0), 1);
+		const FImplicitBox3 Box(FVec3(-10, -5, -2), FVec3(10, 5, 2));
+
+		FShapeBatchCache Cache;
+		Cache.Reset(FVec3(0));
+		const FShapeBatchHandle SphereHandle = Cache.AddImplicitObject(&Sphere, FRigidTransform3(FVec3(3, 1, 1.5), FRotation3::FromIdentity()));
+		const FShapeBatchHandle BoxHandle = Cache.AddImplicitObject(&Box, FRigidTransform3::Identity);
+		const FShapeBatchPair Pair = { SphereHandle.Index, BoxHandle.Index };
+
+		ForEachShapeBatchKernelPath([&]()
+		{
+			FRealSingle Phi = 0;
+			FVec3f Normal = FVec3f(0);
+			Cache.ComputeSphereBoxDistances(MakeArrayView(&Pair, 1), MakeArrayView(&Phi, 1), MakeArrayView(&Normal, 1));
+
+			// Pushed out through the nearest (+Z) face
+			EXPECT_NEAR(Phi, -1.5f, 1e-4f);
+			EXPECT_NEAR(Normal.X, 0.0f, 1e-4f);
+			EXPECT_NEAR(Normal.Y, 0.0f, 1e-4f);
+			EXPECT_NEAR(Normal.Z, 1.0f, 1e-4f);
+		});
+	}
+
+	TEST(ShapeBatchCacheTests, TestUnsupportedTypesNotCached)
+	{
+		const FImplicitSphere3 Sphere(FVec3(0), 1);
+		TArray<FConvex::FVec3Type> Points = { FConvex::FVec3Type(0, 0, 0), FConvex::FVec3Type(1, 0, 0), FConvex::FVec3Type(0, 1, 0), FConvex::FVec3Type(0, 0, 1) };
+		const FImplicitConvex3 Convex(Points, 0);
+
+		FShapeBatchCache Cache;
+		Cache.Reset(FVec3(0));
+		EXPECT_TRUE(Cache.AddImplicitObject(&Sphere, FRigidTransform3::Identity).IsValid());
+		EXPECT_FALSE(Cache.AddImplicitObject(&Convex, FRigidTransform3::Identity).IsValid());
+		EXPECT_FALSE(Cache.AddImplicitObject(nullptr, FRigidTransform3::Identity).IsValid());
+		EXPECT_EQ(Cache.Num(EShapeBatchType::Sphere), 1);
+		EXPECT_EQ(Cache.Num(EShapeBatchType::Box), 0);
+		EXPECT_EQ(Cache.Num(EShapeBatchType::Capsule), 0);
+
+		Cache.Reset(FVec3(0));
+		EXPECT_EQ(Cache.Num(EShapeBatchType::Sphere), 0);
+	}
+
+	// Broad phase (sweep and prune on X) followed by the narrow phase for a field of spheres falling on a field of boxes,
+	// comparing one GJK query per pair against the batched kernels. Logs pairs per second for both.
+	TEST(ShapeBatchCacheTests, TestBroadNarrowPhaseThroughput)
+	{
+		const int32 NumSpheres = 4096;
+		const int32 NumBoxes = 4096;
+		const FReal WorldSize = 4000;
+		const int32 NumIterations = 8;
+
+		FRandomStream Stream(0x5ba7c4);
+		const FImplicitSphere3 Sphere(FVec3(0), 15);
+		const FImplicitBox3 Box(FVec3(-20, -20, -10), FVec3(20, 20, 10), 1);
+
+		struct FProxy
+		{
+			FReal MinX;
+			FReal MaxX;
+			FAABB3 Bounds;
+			FRigidTransform3 Transform;
+			FShapeBatchHandle Handle;
+		};
+
+		TArray<FProxy> Proxies;
+		for (int32 Index = 0; Index < NumSpheres + NumBoxes; ++Index)
+		{
+			const bool bIsSphere = Index < NumSpheres;
+			const FImplicitObject& Implicit = bIsSphere ? (const FImplicitObject&)Sphere : (const FImplicitObject&)Box;
+			const FRigidTransform3 Transform = RandomShapeBatchTransform(Stream, 0.5 * WorldSize);
+			const FAABB3 Bounds = Implicit.CalculateTransformedBounds(Transform);
+			Proxies.Add({ Bounds.Min().X, Bounds.Max().X, Bounds, Transform, FShapeBatchHandle() });
+		}
+
+		FShapeBatchCache Cache;
+		TArray<FShapeBatchPair> SphereSpherePairs;
+		TArray<FShapeBatchPair> SphereBoxPairs;
+		TArray<TPair<int32, int32>> ProxyPairs;
+		TArray<FRealSingle> Phis;
+		TArray<FVec3f> Normals;
+
+		uint64 BroadPhaseCycles = 0;
+		uint64 GJKCycles = 0;
+		uint64 BatchedCycles = 0;
+		int32 NumGJKContacts = 0;
+		int32 NumBatchedContacts = 0;
+
+		for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+		{
+			const uint64 BroadPhaseStart = FPlatformTime::Cycles64();
+			TArray<int32> Sorted;
+			for (int32 Index = 0; Index < Proxies.Num(); ++Index)
+			{
+				Sorted.Add(Index);
+			}
+			Sorted.Sort([&Proxies](const int32 L, const int32 R) { return Proxies[L].MinX < Proxies[R].MinX; });
+
+			ProxyPairs.Reset();
+			for (int32 SortedIndex = 0; SortedIndex < Sorted.Num(); ++SortedIndex)
+			{
+				const FProxy& Proxy = Proxies[Sorted[SortedIndex]];
+				for (int32 OtherIndex = SortedIndex + 1; OtherIndex < Sorted.Num() && Proxies[Sorted[OtherIndex]].MinX <= Proxy.MaxX; ++OtherIndex)
+				{
+					if (Proxy.Bounds.Intersects(Proxies[Sorted[OtherIndex]].Bounds))
+					{
+						// Sphere first, box-box pairs are not batched
+						const int32 IndexA = FMath::Min(Sorted[SortedIndex], Sorted[OtherIndex]);
+						const int32 IndexB = FMath::Max(Sorted[SortedIndex], Sorted[OtherIndex]);
+						if (IndexA < NumSpheres)
+						{
+							ProxyPairs.Emplace(IndexA, IndexB);
+						}
+					}
+				}
+			}
+			BroadPhaseCycles += FPlatformTime::Cycles64() - BroadPhaseStart;
+
+			// One GJK query per pair
+			{
+				const uint64 Start = FPlatformTime::Cycles64();
+				for (const TPair<int32, int32>& ProxyPair : ProxyPairs)
+				{
+					const FRigidTransform3& TransformA = Proxies[ProxyPair.Key].Transform;
+					const FRigidTransform3& TransformB = Proxies[ProxyPair.Value].Transform;
+					const FRigidTransform3 BToATm = TransformB.GetRelativeTransform(TransformA);
+
+					FVec3 NearestA, NearestB, Normal;
+					FReal Distance = 0;
+					EGJKDistanceResult Result;
+					if (ProxyPair.Value < NumSpheres)
+					{
+						Result = GJKDistance<FReal>(TGJKCoreShape(Sphere), TGJKCoreShapeTransformed(Sphere, BToATm), GJKDistanceInitialVFromRelativeTransform(Sphere, Sphere, BToATm), Distance, NearestA, NearestB, Normal);
+					}
+					else
+					{
+						Result = GJKDistance<FReal>(TGJKCoreShape(Sphere), TGJKCoreShapeTransformed(Box, BToATm), GJKDistanceInitialVFromRelativeTransform(Sphere, Box, BToATm), Distance, NearestA, NearestB, Normal);
+					}
+					NumGJKContacts += (Result != EGJKDistanceResult::Separated) ? 1 : 0;
+				}
+				GJKCycles += FPlatformTime::Cycles64() - Start;
+			}
+
+			// Batched, including building the cache
+			{
+				const uint64 Start = FPlatformTime::Cycles64();
+				Cache.Reset(FVec3(0));
+				for (int32 Index = 0; Index < Proxies.Num(); ++Index)
+				{
+					Proxies[Index].Handle = Cache.AddImplicitObject(Index < NumSpheres ? (const FImplicitObject*)&Sphere : (const FImplicitObject*)&Box, Proxies[Index].Transform);
+				}
+
+				SphereSpherePairs.Reset();
+				SphereBoxPairs.Reset();
+				for (const TPair<int32, int32>& ProxyPair : ProxyPairs)
+				{
+					const FShapeBatchHandle HandleB = Proxies[ProxyPair.Value].Handle;
+					TArray<FShapeBatchPair>& Pairs = (HandleB.Type == EShapeBatchType::Sphere) ? SphereSpherePairs : SphereBoxPairs;
+					Pairs.Add({ Proxies[ProxyPair.Key].Handle.Index, HandleB.Index });
+				}
+
+				Phis.SetNum(ProxyPairs.Num(), EAllowShrinking::No);
+				Normals.SetNum(ProxyPairs.Num(), EAllowShrinking::No);
+				Cache.ComputeSphereSphereDistances(SphereSpherePairs, Phis, Normals);
+				Cache.ComputeSphereBoxDistances(SphereBoxPairs, MakeArrayView(Phis).RightChop(SphereSpherePairs.Num()), MakeArrayView(Normals).RightChop(SphereSpherePairs.Num()));
+				for (const FRealSingle Phi : Phis)
+				{
+					NumBatchedContacts += (Phi <= 0) ? 1 : 0;
+				}
+				BatchedCycles += FPlatformTime::Cycles64() - Start;
+			}
+		}
+
+		// Float precision may flip a handful of grazing contacts
+		EXPECT_NEAR(NumBatchedContacts, NumGJKContacts, FMath::Max(4, NumGJKContacts / 1000));
+
+		const double NumPairsTotal = double(ProxyPairs.Num()) * NumIterations;
+		UE_LOG(LogChaos, Display, TEXT("ShapeBatchCache: %d pairs, broad phase %.2f ms, GJK %.2f M pairs/s, batched %.2f M pairs/s"),
+			ProxyPairs.Num(),
+			FPlatformTime::ToMilliseconds64(BroadPhaseCycles) / NumIterations,
+			NumPairsTotal / FPlatformTime::ToSeconds64(GJKCycles) / 1e6,
+			NumPairsTotal / FPlatformTime::ToSeconds64(BatchedCycles) / 1e6);
+	}
+}
@@ -0,0 +1,542 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Async/Mutex.h"
+#include "HAL/Platform.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/UnrealMemory.h"
+#include "Math/UnrealMath.h"
+#include "Misc/AssertionMacros.h"
+#include "SetKeyFuncs.h"
+#include "Templates/UnrealTemplate.h"
+
+#include <atomic>
+#include <type_traits>
+
+/**
+ * Variant of TSetKeyFuncs that can be read from any number of threads while one thread at a time writes to it.
+ *
+ * Readers are wait-free: Find and FindByHash never take a lock and never retry. Writers are serialized by an
+ * internal mutex. Add writes new elements in place with a single atomic store, so a concurrent reader either sees
+ * the element or the invalid element that was there before. Operations that move existing elements (Reallocate,
+ * Remove, Empty) instead build a new table, publish it with an atomic swap, and wait for a grace period: every
+ * reader that could still be looking at the old table has to leave its read scope before the old table is freed.
+ *
+ * Readers announce themselves by incrementing one of two sharded counters selected by the parity of an epoch, and
+ * retry on the other parity if the epoch moved while they did. Retiring a table flips the epoch and waits for the
+ * counters of the previous parity to drain.
+ *
+ * Because elements can be read while being overwritten, ElementType must be trivially copyable and no larger
+ * than 8 bytes (typically a pointer), and Find returns the element by value instead of a pointer into the table.
+ * KeyFuncs is shared by all readers, so its GetTypeHash, Matches and IsInvalid functions must be safe to call
+ * concurrently. See TSetKeyFuncs for the rest of the KeyFuncs requirements.
+ *
+ * Unlike TSetKeyFuncs, Remove is O(HashSize) because it republishes the table; it is meant for containers
+ * such as the asset registry maps that are mostly appended to while being read.
+ */
+template <typename ElementType, typename KeyFuncsType>
+class TConcurrentSetKeyFuncs
+{
+	static_assert(std::is_trivially_copyable_v<ElementType> && sizeof(ElementType) <= sizeof(uint64),
+		"TConcurrentSetKeyFuncs requires an ElementType that can be read and written atomically.");
+
+public:
+	TConcurrentSetKeyFuncs(KeyFuncsType KeyFuncs, int32 ExpectedNumElements = 0);
+	TConcurrentSetKeyFuncs(const TConcurrentSetKeyFuncs&) = delete;
+	TConcurrentSetKeyFuncs& operator=(const TConcurrentSetKeyFuncs&) = delete;
+	~TConcurrentSetKeyFuncs();
+
+	// Functions that can be called from any thread at any time
+
+	int32 Num() const;
+	SIZE_T GetAllocatedSize() const;
+	FSetKeyFuncsStats GetStats() const;
+
+	/** Returns the element matching Key, or KeyFuncs.GetInvalidElement() if there is none. */
+	template <typename CompareType>
+	ElementType Find(const CompareType& Key) const;
+	template <typename CompareType>
+	ElementType FindByHash(uint32 TypeHash, const CompareType& Key) const;
+
+	/** Calls Func on every element of a snapshot of the container. Func must not write to the container. */
+	template <typename FuncType>
+	void ForEach(FuncType&& Func) const;
+
+	// Functions that modify the container; concurrent callers are serialized
+
+	void Empty(int32 ExpectedNumElements = 0);
+	void Reserve(int32 ExpectedNumElements);
+	void Add(ElementType Value, bool* bAlreadyExists = nullptr);
+	void AddByHash(uint32 TypeHash, ElementType Value, bool* bAlreadyExists = nullptr);
+	int32 Remove(ElementType Value);
+	int32 RemoveByHash(uint32 TypeHash, ElementType Value);
+
+private:
+	struct FTable
+	{
+		uint32 HashSize;
+		std::atomic<ElementType>* Buckets;
+	};
+
+	/** Scope during which the currently published table is guaranteed to stay allocated. */
+	struct FReadScope
+	{
+		explicit FReadScope(const TConcurrentSetKeyFuncs& InOwner);
+		~FReadScope();
+
+		const TConcurrentSetKeyFuncs& Owner;
+		std::atomic<uint32>* Counter;
+	};
+
+	/** Scope holding the writer lock, counting how often it had to wait for another writer. */
+	struct FWriteScope
+	{
+		explicit FWriteScope(TConcurrentSetKeyFuncs& InOwner);
+		~FWriteScope();
+
+		TConcurrentSetKeyFuncs& Owner;
+	};
+
+	FTable* AllocateTable(uint32 HashSize) const;
+	static void FreeTable(FTable* Table);
+	/** Inserts into a table no reader can see yet, or into the published one if Value is new. */
+	bool AddToTable(FTable& Table, uint32 TypeHash, ElementType Value) const;
+	/** Swaps in NewTable and frees the previously published table once no reader can reference it. */
+	void PublishAndRetire(FTable* NewTable);
+	void WaitForReaders();
+	void Reallocate(uint32 NewHashSize, const ElementType* SkipValue = nullptr);
+	uint32 GetTargetHashSize(uint32 TargetNumValues) const;
+
+private:
+	constexpr static float MaxLoadFactorDuringAdd = 0.75f;
+	constexpr static float TargetLoadFactor = 0.5f;
+	constexpr static uint32 InitialAllocationSize = 8;
+	constexpr static uint32 MinimumNonZeroSize = 8;
+	constexpr static uint32 NumReaderShards = 16;
+
+	struct alignas(PLATFORM_CACHE_LINE_SIZE) FReaderShard
+	{
+		std::atomic<uint32> Count{ 0 };
+	};
+
+	mutable KeyFuncsType KeyFuncs;
+	std::atomic<FTable*> PublishedTable{ nullptr };
+	std::atomic<uint32> NumValues{ 0 };
+
+	mutable std::atomic<uint32> ReaderEpoch{ 0 };
+	mutable FReaderShard ReaderShards[2][NumReaderShards];
+
+	UE::FMutex WriterLock;
+	std::atomic<uint64> WriterContentionCount{ 0 };
+	std::atomic<uint64> NumTablesPublished{ 0 };
+	std::atomic<uint64> NumGracePeriodYields{ 0 };
+};
+
+
+///////////////////////////////////////////////////////
+// Inline implementations
+///////////////////////////////////////////////////////
+
+
+template <typename ElementType, typename KeyFuncsType>
+inline TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::FReadScope::FReadScope(const TConcurrentSetKeyFuncs& InOwner)
+	: Owner(InOwner)
+{
+	const uint32 Shard = FPlatformTLS::GetCurrentThreadId() % NumReaderShards;
+	uint32 Epoch = Owner.ReaderEpoch.load();
+	for (;;)
+	{
+		// Sequentially consistent so that the epoch check and the table load that follow cannot be reordered before the increment
+		Counter = &Owner.ReaderShards[Epoch & 1][Shard].Count;
+		Counter->fetch_add(1);
+
+		// A writer that flipped the epoch between our load and our increment may already have drained this parity
+		// without seeing us. If the epoch did not move, any later flip happens after the increment and waits for us.
+		const uint32 CurrentEpoch = Owner.ReaderEpoch.load();
+		if (CurrentEpoch == Epoch)
+		{
+			break;
+		}
+		Counter->fetch_sub(1);
+		Epoch = CurrentEpoch;
+	}
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::FReadScope::~FReadScope()
+{
+	Counter->fetch_sub(1);
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::FWriteScope::FWriteScope(TConcurrentSetKeyFuncs& InOwner)
+	: Owner(InOwner)
+{
+	if (!Owner.WriterLock.TryLock())
+	{
+		Owner.WriterContentionCount.fetch_add(1, std::memory_order_relaxed);
+		Owner.WriterLock.Lock();
+	}
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::FWriteScope::~FWriteScope()
+{
+	Owner.WriterLock.Unlock();
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::TConcurrentSetKeyFuncs(KeyFuncsType InKeyFuncs, int32 ExpectedNumElements)
+	: KeyFuncs(MoveTemp(InKeyFuncs))
+{
+	Empty(ExpectedNumElements);
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::~TConcurrentSetKeyFuncs()
+{
+	// Destroying the container while it is being read is a usage error, no need to wait for readers
+	FreeTable(PublishedTable.load());
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline int32 TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::Num() const
+{
+	return IntCastChecked<int32>(NumValues.load(std::memory_order_relaxed));
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline SIZE_T TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::GetAllocatedSize() const
+{
+	FReadScope ReadScope(*this);
+	const FTable* Table = PublishedTable.load();
+	return Table ? sizeof(FTable) + sizeof(std::atomic<ElementType>) * Table->HashSize : 0;
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline FSetKeyFuncsStats TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::GetStats() const
+{
+	FSetKeyFuncsStats Result;
+	Result.WriterContentionCount = WriterContentionCount.load(std::memory_order_relaxed);
+	Result.NumTablesPublished = NumTablesPublished.load(std::memory_order_relaxed);
+	Result.NumGracePeriodYields = NumGracePeriodYields.load(std::memory_order_relaxed);
+
+	FReadScope ReadScope(*this);
+	const FTable* Table = PublishedTable.load();
+	if (!Table)
+	{
+		return Result;
+	}
+
+	uint64 SumOfSearches = 0;
+	uint32 NumFound = 0;
+	for (uint32 Bucket = 0; Bucket < Table->HashSize; ++Bucket)
+	{
+		const ElementType Element = Table->Buckets[Bucket].load(std::memory_order_acquire);
+		if (KeyFuncs.IsInvalid(Element))
+		{
+			continue;
+		}
+		// Collision chains only move forward and may wrap around the end of the bucket array
+		const uint32 RealBucket = KeyFuncs.GetTypeHash(Element) % Table->HashSize;
+		const int32 SearchLength = static_cast<int32>((Bucket + Table->HashSize - RealBucket) % Table->HashSize) + 1;
+		Result.LongestSearch = FMath::Max(Result.LongestSearch, SearchLength);
+		Result.AddSearchLength(SearchLength);
+		SumOfSearches += SearchLength;
+		++NumFound;
+	}
+
+	Result.AverageSearch = NumFound ? static_cast<float>(SumOfSearches) / static_cast<float>(NumFound) : 0.f;
+	return Result;
+}
+
+template <typename ElementType, typename KeyFuncsType>
+template <typename CompareType>
+inline ElementType TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::Find(const CompareType& Key) const
+{
+	return FindByHash(KeyFuncs.GetTypeHash(Key), Key);
+}
+
+template <typename ElementType, typename KeyFuncsType>
+template <typename CompareType>
+inline ElementType TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::FindByHash(uint32 TypeHash, const CompareType& Key) const
+{
+	FReadScope ReadScope(*this);
+	const FTable* Table = PublishedTable.load();
+	if (Table == nullptr)
+	{
+		return KeyFuncs.GetInvalidElement();
+	}
+
+	uint32 Bucket = TypeHash % Table->HashSize;
+	uint32 CollisionCount;
+	for (CollisionCount = 0; CollisionCount < Table->HashSize; ++CollisionCount)
+	{
+		const ElementType Element = Table->Buckets[Bucket].load(std::memory_order_acquire);
+		if (KeyFuncs.IsInvalid(Element))
+		{
+			break;
+		}
+		if (KeyFuncs.Matches(Element, Key))
+		{
+			return Element;
+		}
+		Bucket = Bucket + 1 < Table->HashSize ? Bucket + 1 : 0;
+	}
+	// We do not allow the container to become completely full, so we should always find an unused bucket
+	check(CollisionCount < Table->HashSize);
+	return KeyFuncs.GetInvalidElement();
+}
+
+template <typename ElementType, typename KeyFuncsType>
+template <typename FuncType>
+inline void TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::ForEach(FuncType&& Func) const
+{
+	FReadScope ReadScope(*this);
+	const FTable* Table = PublishedTable.load();
+	if (Table == nullptr)
+	{
+		return;
+	}
+
+	for (uint32 Bucket = 0; Bucket < Table->HashSize; ++Bucket)
+	{
+		const ElementType Element = Table->Buckets[Bucket].load(std::memory_order_acquire);
+		if (!KeyFuncs.IsInvalid(Element))
+		{
+			Func(Element);
+		}
+	}
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline void TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::Empty(int32 ExpectedNumElements)
+{
+	FWriteScope WriteScope(*this);
+
+	const uint32 HashSize = GetTargetHashSize(static_cast<uint32>(FMath::Max(0, ExpectedNumElements)));
+	NumValues.store(0, std::memory_order_relaxed);
+	PublishAndRetire(HashSize > 0 ? AllocateTable(HashSize) : nullptr);
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline void TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::Reserve(int32 ExpectedNumElements)
+{
+	FWriteScope WriteScope(*this);
+
+	const uint32 NewHashSize = GetTargetHashSize(static_cast<uint32>(FMath::Max(0, ExpectedNumElements)));
+	const FTable* Table = PublishedTable.load(std::memory_order_relaxed);
+	if (NewHashSize > (Table ? Table->HashSize : 0))
+	{
+		Reallocate(NewHashSize);
+	}
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline void TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::Add(ElementType Value, bool* bAlreadyExists)
+{
+	AddByHash(KeyFuncs.GetTypeHash(Value), Value, bAlreadyExists);
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline void TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::AddByHash(uint32 TypeHash, ElementType Value, bool* bAlreadyExists)
+{
+	if (KeyFuncs.IsInvalid(Value))
+	{
+		checkf(false, TEXT("Add called with invalid element."));
+		return;
+	}
+
+	FWriteScope WriteScope(*this);
+
+	FTable* Table = PublishedTable.load(std::memory_order_relaxed);
+	if (Table == nullptr)
+	{
+		Table = AllocateTable(GetTargetHashSize(InitialAllocationSize));
+		PublishAndRetire(Table);
+	}
+
+	const bool bAdded = AddToTable(*Table, TypeHash, Value);
+	if (bAlreadyExists)
+	{
+		*bAlreadyExists = !bAdded;
+	}
+	if (!bAdded)
+	{
+		return;
+	}
+
+	const uint32 NewNumValues = NumValues.load(std::memory_order_relaxed) + 1;
+	NumValues.store(NewNumValues, std::memory_order_relaxed);
+
+	float LoadFactor = static_cast<float>(NewNumValues) / static_cast<float>(Table->HashSize);
+	if (LoadFactor > MaxLoadFactorDuringAdd)
+	{
+		Reallocate(GetTargetHashSize(NewNumValues));
+	}
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline int32 TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::Remove(ElementType Value)
+{
+	return RemoveByHash(KeyFuncs.GetTypeHash(Value), Value);
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline int32 TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::RemoveByHash(uint32 TypeHash, ElementType Value)
+{
+	if (KeyFuncs.IsInvalid(Value))
+	{
+		checkf(false, TEXT("Remove called with invalid element."));
+		return 0;
+	}
+
+	FWriteScope WriteScope(*this);
+
+	const FTable* Table = PublishedTable.load(std::memory_order_relaxed);
+	if (Table == nullptr || NumValues.load(std::memory_order_relaxed) == 0)
+	{
+		return 0;
+	}
+
+	uint32 Bucket = TypeHash % Table->HashSize;
+	for (uint32 CollisionCount = 0; CollisionCount < Table->HashSize; ++CollisionCount)
+	{
+		const ElementType Existing = Table->Buckets[Bucket].load(std::memory_order_relaxed);
+		if (KeyFuncs.IsInvalid(Existing))
+		{
+			// Does not exist
+			return 0;
+		}
+		if (KeyFuncs.Matches(Existing, Value))
+		{
+			// Shifting the rest of the collision chain down in place could hide elements from readers that are
+			// already past the hole, so publish a copy of the table without the element instead.
+			NumValues.store(NumValues.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+			Reallocate(Table->HashSize, &Existing);
+			return 1;
+		}
+		Bucket = Bucket + 1 < Table->HashSize ? Bucket + 1 : 0;
+	}
+	return 0;
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline typename TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::FTable*
+TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::AllocateTable(uint32 HashSize) const
+{
+	check(HashSize > 0);
+	// Buckets follow the header in the same allocation
+	const SIZE_T HeaderSize = Align(sizeof(FTable), alignof(std::atomic<ElementType>));
+	uint8* Memory = reinterpret_cast<uint8*>(FMemory::Malloc(HeaderSize + sizeof(std::atomic<ElementType>) * HashSize,
+		FMath::Max(alignof(FTable), alignof(std::atomic<ElementType>))));
+
+	FTable* Table = new (Memory) FTable;
+	Table->HashSize = HashSize;
+	Table->Buckets = reinterpret_cast<std::atomic<ElementType>*>(Memory + HeaderSize);
+
+	const ElementType InvalidValue = KeyFuncs.GetInvalidElement();
+	for (uint32 Bucket = 0; Bucket < HashSize; ++Bucket)
+	{
+		new (&Table->Buckets[Bucket]) std::atomic<ElementType>(InvalidValue);
+	}
+	return Table;
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline void TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::FreeTable(FTable* Table)
+{
+	// Buckets and FTable are trivially destructible
+	FMemory::Free(Table);
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline bool TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::AddToTable(FTable& Table, uint32 TypeHash, ElementType Value) const
+{
+	uint32 Bucket = TypeHash % Table.HashSize;
+	uint32 CollisionCount;
+	for (CollisionCount = 0; CollisionCount < Table.HashSize; ++CollisionCount)
+	{
+		const ElementType Existing = Table.Buckets[Bucket].load(std::memory_order_relaxed);
+		if (KeyFuncs.IsInvalid(Existing))
+		{
+			break;
+		}
+		if (KeyFuncs.Matches(Existing, Value))
+		{
+			return false;
+		}
+		Bucket = Bucket + 1 < Table.HashSize ? Bucket + 1 : 0;
+	}
+	// We do not allow the container to become completely full, so we should always find an unused bucket
+	check(CollisionCount < Table.HashSize);
+
+	// Release so that readers observing the element also observe whatever it points to
+	Table.Buckets[Bucket].store(Value, std::memory_order_release);
+	return true;
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline void TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::PublishAndRetire(FTable* NewTable)
+{
+	FTable* OldTable = PublishedTable.exchange(NewTable);
+	NumTablesPublished.fetch_add(1, std::memory_order_relaxed);
+	if (OldTable)
+	{
+		WaitForReaders();
+		FreeTable(OldTable);
+	}
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline void TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::WaitForReaders()
+{
+	// Readers that enter after the flip use the other parity and can only have loaded the new table. Readers
+	// that entered before it are counted in the old parity; once those drain nobody references the old table.
+	// A reader that increments the old parity after the flip sees the epoch change and retries, see FReadScope.
+	const uint32 OldParity = ReaderEpoch.fetch_add(1) & 1;
+	for (FReaderShard& Shard : ReaderShards[OldParity])
+	{
+		while (Shard.Count.load() != 0)
+		{
+			NumGracePeriodYields.fetch_add(1, std::memory_order_relaxed);
+			FPlatformProcess::Yield();
+		}
+	}
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline void TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::Reallocate(uint32 NewHashSize, const ElementType* SkipValue)
+{
+	const FTable* OldTable = PublishedTable.load(std::memory_order_relaxed);
+	check(NewHashSize > NumValues.load(std::memory_order_relaxed));
+
+	FTable* NewTable = AllocateTable(NewHashSize);
+	if (OldTable)
+	{
+		for (uint32 OldBucket = 0; OldBucket < OldTable->HashSize; ++OldBucket)
+		{
+			const ElementType OldElement = OldTable->Buckets[OldBucket].load(std::memory_order_relaxed);
+			if (!KeyFuncs.IsInvalid(OldElement) && !(SkipValue && KeyFuncs.Matches(OldElement, *SkipValue)))
+			{
+				AddToTable(*NewTable, KeyFuncs.GetTypeHash(OldElement), OldElement);
+			}
+		}
+	}
+	PublishAndRetire(NewTable);
+}
+
+template <typename ElementType, typename KeyFuncsType>
+inline uint32 TConcurrentSetKeyFuncs<ElementType, KeyFuncsType>::GetTargetHashSize(uint32 TargetNumValues) const
+{
+	if (TargetNumValues == 0)
+	{
+		return 0;
+	}
+	uint32 TargetHashSize = static_cast<uint32>(FMath::CeilToInt32(
+		static_cast<float>(TargetNumValues) / static_cast<float>(TargetLoadFactor)));
+	TargetHashSize = FMath::Max(TargetHashSize, MinimumNonZeroSize);
+	return TargetHashSize;
+}
@@ -134,10 +134,29 @@ private:
 
 struct FSetKeyFuncsStats
 {
+	constexpr static int32 ProbeLengthHistogramSize = 16;
+
 	/** Average number of compares per Find across all keys in the container. */
-	float AverageSearch;
+	float AverageSearch = 0.f;
 	/** The longest number of compares in Find for a key in the container. */
-	int32 LongestSearch;
+	int32 LongestSearch = 0;
+	/**
+	 * Number of keys in the container by the number of compares Find needs for them. Entry N counts keys
+	 * found after N+1 compares; the last entry also counts every key that needs more compares than that.
+	 */
+	uint32 ProbeLengthHistogram[ProbeLengthHistogramSize] = {};
+
+	/** TConcurrentSetKeyFuncs only: number of writes that had to wait for another writer. */
+	uint64 WriterContentionCount = 0;
+	/** TConcurrentSetKeyFuncs only: number of hash tables published by Reallocate, Remove or Empty. */
+	uint64 NumTablesPublished = 0;
+	/** TConcurrentSetKeyFuncs only: number of yields writers spent waiting for readers to leave a retired table. */
+	uint64 NumGracePeriodYields = 0;
+
+	void AddSearchLength(int32 SearchLength)
+	{
+		++ProbeLengthHistogram[FMath::Clamp(SearchLength, 1, ProbeLengthHistogramSize) - 1];
+	}
 };
 
 
@@ -298,8 +317,6 @@ TSetKeyFuncs<ElementType, KeyFuncsType>::GetStats() const
 	FSetKeyFuncsStats Result;
 	if (NumValues == 0)
 	{
-		Result.AverageSearch = 0.f;
-		Result.LongestSearch = 0;
 		return Result;
 	}
 	check(HashSize > 0 && Hash != nullptr);
@@ -374,6 +391,7 @@ TSetKeyFuncs<ElementType, KeyFuncsType>::GetStats() const
 			}
 			Result.LongestSearch = FMath::Max(Result.LongestSearch, SearchLength);
 			SumOfSearches += SearchLength;
+			Result.AddSearchLength(SearchLength);
 		}
 		CollisionChainStart = Bucket;
 	}
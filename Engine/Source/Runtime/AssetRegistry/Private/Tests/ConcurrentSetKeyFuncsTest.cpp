@@ -0,0 +1,165 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Async/Async.h"
+#include "ConcurrentSetKeyFuncs.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ConcurrentSetKeyFuncsTest
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+struct FKey
+{
+	uint32 Id;
+};
+
+/** Elements pack an id in the high bits and a check value derived from it in the low bits, so torn or freed reads are detectable. */
+static uint64 MakeElement(uint32 Id)
+{
+	return (uint64(Id) << 32) | ((Id * 2654435761u) | 1u);
+}
+
+static bool IsWellFormed(uint64 Element)
+{
+	return Element == MakeElement(uint32(Element >> 32));
+}
+
+struct FTestKeyFuncs
+{
+	uint64 GetInvalidElement() const
+	{
+		return 0;
+	}
+	bool IsInvalid(uint64 Element) const
+	{
+		return Element == 0;
+	}
+	uint32 GetTypeHash(uint64 Element) const
+	{
+		return ::GetTypeHash(uint32(Element >> 32));
+	}
+	bool Matches(uint64 Element, uint64 Comparison) const
+	{
+		return (Element >> 32) == (Comparison >> 32);
+	}
+	uint32 GetTypeHash(FKey Key) const
+	{
+		return ::GetTypeHash(Key.Id);
+	}
+	bool Matches(uint64 Element, FKey Key) const
+	{
+		return uint32(Element >> 32) == Key.Id;
+	}
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConcurrentSetKeyFuncsTest, "System.AssetRegistry.ConcurrentSetKeyFuncs", TestFlags)
+bool FConcurrentSetKeyFuncsTest::RunTest(const FString& Parameters)
+{
+	TConcurrentSetKeyFuncs<uint64, FTestKeyFuncs> Set(FTestKeyFuncs{});
+	for (uint32 Id = 1; Id <= 100; ++Id)
+	{
+		Set.Add(MakeElement(Id));
+	}
+	TestEqual(TEXT("Num"), Set.Num(), 100);
+	TestEqual(TEXT("Find"), Set.Find(FKey{ 42 }), MakeElement(42));
+	TestEqual(TEXT("Remove"), Set.Remove(MakeElement(42)), 1);
+	TestEqual(TEXT("Find removed"), Set.Find(FKey{ 42 }), uint64(0));
+	TestEqual(TEXT("Find kept"), Set.Find(FKey{ 43 }), MakeElement(43));
+
+	int32 NumVisited = 0;
+	Set.ForEach([&NumVisited](uint64) { ++NumVisited; });
+	TestEqual(TEXT("ForEach"), NumVisited, 99);
+	return true;
+}
+
+/**
+ * Readers look up keys that are never removed while a writer keeps adding, removing and reserving, which republishes the table
+ * and retires the old one thousands of times. Readers must always find the stable keys and never see a malformed element.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FConcurrentSetKeyFuncsStressTest, "System.AssetRegistry.ConcurrentSetKeyFuncs.ReadersAndWriter", TestFlags)
+bool FConcurrentSetKeyFuncsStressTest::RunTest(const FString& Parameters)
+{
+	constexpr uint32 NumStableKeys = 512;
+	constexpr uint32 FirstTransientKey = 1000000;
+	constexpr int32 NumReaders = 6;
+	constexpr int32 NumWriterRounds = 2000;
+
+	TConcurrentSetKeyFuncs<uint64, FTestKeyFuncs> Set(FTestKeyFuncs{});
+	for (uint32 Id = 1; Id <= NumStableKeys; ++Id)
+	{
+		Set.Add(MakeElement(Id));
+	}
+
+	std::atomic<bool> bStop{ false };
+	std::atomic<int32> NumMissing{ 0 };
+	std::atomic<int32> NumMalformed{ 0 };
+	std::atomic<int64> NumLookups{ 0 };
+
+	TArray<TFuture<void>> Readers;
+	for (int32 ReaderIndex = 0; ReaderIndex < NumReaders; ++ReaderIndex)
+	{
+		Readers.Add(Async(EAsyncExecution::Thread, [&, ReaderIndex]()
+		{
+			FRandomStream Stream(ReaderIndex + 1);
+			int64 LocalLookups = 0;
+			while (!bStop.load(std::memory_order_relaxed))
+			{
+				const uint32 StableId = 1 + Stream.RandHelper(NumStableKeys);
+				const uint64 Stable = Set.Find(FKey{ StableId });
+				NumMissing.fetch_add(Stable == MakeElement(StableId) ? 0 : 1, std::memory_order_relaxed);
+
+				const uint32 TransientId = FirstTransientKey + Stream.RandHelper(256);
+				const uint64 Transient = Set.Find(FKey{ TransientId });
+				NumMalformed.fetch_add(Transient == 0 || Transient == MakeElement(TransientId) ? 0 : 1, std::memory_order_relaxed);
+
+				if ((++LocalLookups & 1023) == 0)
+				{
+					Set.ForEach([&NumMalformed](uint64 Element)
+					{
+						NumMalformed.fetch_add(IsWellFormed(Element) ? 0 : 1, std::memory_order_relaxed);
+					});
+				}
+			}
+			NumLookups.fetch_add(LocalLookups, std::memory_order_relaxed);
+		}));
+	}
+
+	FRandomStream Stream(0x5e7);
+	for (int32 Round = 0; Round < NumWriterRounds; ++Round)
+	{
+		const uint32 TransientId = FirstTransientKey + Stream.RandHelper(256);
+		Set.Add(MakeElement(TransientId));
+		Set.Remove(MakeElement(FirstTransientKey + Stream.RandHelper(256)));
+		if (Round % 100 == 0)
+		{
+			Set.Reserve(Set.Num() * 4);
+		}
+	}
+	bStop.store(true);
+	for (TFuture<void>& Reader : Readers)
+	{
+		Reader.Wait();
+	}
+
+	const FSetKeyFuncsStats Stats = Set.GetStats();
+	AddInfo(FString::Printf(TEXT("%lld lookups, %llu tables published, %llu grace period yields"),
+		NumLookups.load(), Stats.NumTablesPublished, Stats.NumGracePeriodYields));
+	TestEqual(TEXT("Stable keys are always found"), NumMissing.load(), 0);
+	TestEqual(TEXT("Elements are never malformed"), NumMalformed.load(), 0);
+	for (uint32 Id = 1; Id <= NumStableKeys; ++Id)
+	{
+		if (!TestEqual(TEXT("Stable key after the stress"), Set.Find(FKey{ Id }), MakeElement(Id)))
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
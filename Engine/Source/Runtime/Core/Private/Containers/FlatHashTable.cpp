@@ -0,0 +1,543 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Containers/FlatHashTable.h"
+#include "Math/UnrealMathUtility.h"
+#include "Math/VectorRegister.h"
+#include "Misc/AssertionMacros.h"
+
+namespace UE::Core::Private::FlatHashTable
+{
+	// Control byte states. Full slots store the low 7 bits of the mixed key.
+	static constexpr uint8 CtrlEmpty	= 0x80;
+	static constexpr uint8 CtrlDeleted	= 0xfe;
+
+	// Keys handed to hash indices are frequently weak hashes or plain integers, so mix them before splitting
+	FORCEINLINE uint32 MixKey( uint32 Key )
+	{
+		Key ^= Key >> 16;
+		Key *= 0x85ebca6b;
+		Key ^= Key >> 13;
+		Key *= 0xc2b2ae35;
+		Key ^= Key >> 16;
+		return Key;
+	}
+
+	FORCEINLINE uint32	H1( uint32 Hash )	{ return Hash >> 7; }
+	FORCEINLINE uint8	H2( uint32 Hash )	{ return (uint8)( Hash & 0x7f ); }
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+	FORCEINLINE uint32 MoveMask( uint8x16_t Compare )
+	{
+		static const uint8 BitsData[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+		const uint8x16_t Bits = vandq_u8( Compare, vld1q_u8( BitsData ) );
+		return (uint32)vaddv_u8( vget_low_u8( Bits ) ) | ( (uint32)vaddv_u8( vget_high_u8( Bits ) ) << 8 );
+	}
+
+	FORCEINLINE uint32 MatchTag( const uint8* Ctrl, uint8 Tag )
+	{
+		return MoveMask( vceqq_u8( vld1q_u8( Ctrl ), vdupq_n_u8( Tag ) ) );
+	}
+
+	FORCEINLINE uint32 MatchEmpty( const uint8* Ctrl )
+	{
+		return MoveMask( vceqq_u8( vld1q_u8( Ctrl ), vdupq_n_u8( CtrlEmpty ) ) );
+	}
+
+	FORCEINLINE uint32 MatchEmptyOrDeleted( const uint8* Ctrl )
+	{
+		return MoveMask( vcltq_s8( vreinterpretq_s8_u8( vld1q_u8( Ctrl ) ), vdupq_n_s8( 0 ) ) );
+	}
+#elif PLATFORM_ENABLE_VECTORINTRINSICS
+	FORCEINLINE uint32 MatchTag( const uint8* Ctrl, uint8 Tag )
+	{
+		return (uint32)_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_load_si128( (const __m128i*)Ctrl ), _mm_set1_epi8( (char)Tag ) ) );
+	}
+
+	FORCEINLINE uint32 MatchEmpty( const uint8* Ctrl )
+	{
+		return (uint32)_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_load_si128( (const __m128i*)Ctrl ), _mm_set1_epi8( (char)CtrlEmpty ) ) );
+	}
+
+	FORCEINLINE uint32 MatchEmptyOrDeleted( const uint8* Ctrl )
+	{
+		// Empty and deleted are the only states with the top bit set
+		return (uint32)_mm_movemask_epi8( _mm_load_si128( (const __m128i*)Ctrl ) );
+	}
+#else
+	FORCEINLINE uint32 MatchTag( const uint8* Ctrl, uint8 Tag )
+	{
+		uint32 Mask = 0;
+		for( uint32 i = 0; i < FFlatHashTable::GroupWidth; i++ )
+		{
+			Mask |= ( Ctrl[i] == Tag ? 1u : 0u ) << i;
+		}
+		return Mask;
+	}
+
+	FORCEINLINE uint32 MatchEmpty( const uint8* Ctrl )
+	{
+		return MatchTag( Ctrl, CtrlEmpty );
+	}
+
+	FORCEINLINE uint32 MatchEmptyOrDeleted( const uint8* Ctrl )
+	{
+		uint32 Mask = 0;
+		for( uint32 i = 0; i < FFlatHashTable::GroupWidth; i++ )
+		{
+			Mask |= ( Ctrl[i] >> 7 ) << i;
+		}
+		return Mask;
+	}
+#endif
+}
+
+using namespace UE::Core::Private::FlatHashTable;
+
+FFlatHashTable::FFlatHashTable( uint32 InIndexSize )
+	: MigrateCursor( 0 )
+	, IndexSize( 0 )
+	, SlotOfIndex( nullptr )
+{
+	Resize( InIndexSize );
+}
+
+FFlatHashTable::FFlatHashTable( const FFlatHashTable& Other )
+	: MigrateCursor( Other.MigrateCursor )
+	, IndexSize( Other.IndexSize )
+	, SlotOfIndex( nullptr )
+{
+	CopyTable( Current, Other.Current );
+	CopyTable( Old, Other.Old );
+
+	if( IndexSize )
+	{
+		SlotOfIndex = new uint32[ IndexSize ];
+		FMemory::Memcpy( SlotOfIndex, Other.SlotOfIndex, IndexSize * 4 );
+	}
+}
+
+FFlatHashTable::FFlatHashTable( FFlatHashTable&& Other )
+	: Current( Other.Current )
+	, Old( Other.Old )
+	, MigrateCursor( Other.MigrateCursor )
+	, IndexSize( Other.IndexSize )
+	, SlotOfIndex( Other.SlotOfIndex )
+{
+	Other.Current = FTable();
+	Other.Old = FTable();
+	Other.MigrateCursor = 0;
+	Other.IndexSize = 0;
+	Other.SlotOfIndex = nullptr;
+}
+
+FFlatHashTable::~FFlatHashTable()
+{
+	Free();
+}
+
+FFlatHashTable& FFlatHashTable::operator=( const FFlatHashTable& Other )
+{
+	if( this != &Other )
+	{
+		FFlatHashTable Copy( Other );
+		*this = MoveTemp( Copy );
+	}
+	return *this;
+}
+
+FFlatHashTable& FFlatHashTable::operator=( FFlatHashTable&& Other )
+{
+	if( this != &Other )
+	{
+		Free();
+
+		Current			= Other.Current;
+		Old				= Other.Old;
+		MigrateCursor	= Other.MigrateCursor;
+		IndexSize		= Other.IndexSize;
+		SlotOfIndex		= Other.SlotOfIndex;
+
+		Other.Current = FTable();
+		Other.Old = FTable();
+		Other.MigrateCursor = 0;
+		Other.IndexSize = 0;
+		Other.SlotOfIndex = nullptr;
+	}
+	return *this;
+}
+
+void FFlatHashTable::Clear()
+{
+	FreeTable( Old );
+	MigrateCursor = 0;
+
+	if( Current.NumGroups )
+	{
+		FMemory::Memset( Current.Control, CtrlEmpty, Current.Capacity() );
+		Current.NumUsed = 0;
+		Current.NumDeleted = 0;
+	}
+
+	if( IndexSize )
+	{
+		FMemory::Memset( SlotOfIndex, 0xff, IndexSize * 4 );
+	}
+}
+
+void FFlatHashTable::Free()
+{
+	FreeTable( Current );
+	FreeTable( Old );
+	MigrateCursor = 0;
+
+	delete[] SlotOfIndex;
+	SlotOfIndex = nullptr;
+	IndexSize = 0;
+}
+
+void FFlatHashTable::Resize( uint32 NewIndexSize )
+{
+	if( NewIndexSize == IndexSize )
+	{
+		return;
+	}
+
+	if( NewIndexSize == 0 )
+	{
+		Free();
+		return;
+	}
+
+	uint32* NewSlotOfIndex = new uint32[ NewIndexSize ];
+	const uint32 NumToCopy = FMath::Min( IndexSize, NewIndexSize );
+
+	if( SlotOfIndex )
+	{
+		FMemory::Memcpy( NewSlotOfIndex, SlotOfIndex, NumToCopy * 4 );
+		delete[] SlotOfIndex;
+	}
+	FMemory::Memset( NewSlotOfIndex + NumToCopy, 0xff, ( NewIndexSize - NumToCopy ) * 4 );
+
+	IndexSize = NewIndexSize;
+	SlotOfIndex = NewSlotOfIndex;
+}
+
+SIZE_T FFlatHashTable::GetAllocatedSize() const
+{
+	const SIZE_T BytesPerSlot = 1 + sizeof( FSlot );
+	return
+		(SIZE_T)( Current.Capacity() + Old.Capacity() ) * BytesPerSlot +
+		(SIZE_T)IndexSize * sizeof( uint32 );
+}
+
+uint32 FFlatHashTable::First( uint32 Key ) const
+{
+	uint32 Slot = FindInTable( Current, Key, ~0u );
+	if( Slot != ~0u )
+	{
+		return Current.Slots[ Slot ].Index;
+	}
+
+	if( IsRehashing() )
+	{
+		Slot = FindInTable( Old, Key, ~0u );
+		if( Slot != ~0u )
+		{
+			return Old.Slots[ Slot ].Index;
+		}
+	}
+
+	return ~0u;
+}
+
+uint32 FFlatHashTable::Next( uint32 Index ) const
+{
+	checkSlow( Index < IndexSize && SlotOfIndex[ Index ] != ~0u );
+
+	const uint32 Encoded = SlotOfIndex[ Index ];
+	const bool bInCurrent = ( Encoded & TableBitMask ) == Current.TableBit;
+	const FTable& Table = bInCurrent ? Current : Old;
+	const uint32 Slot = Encoded & ~TableBitMask;
+	const uint32 Key = Table.Slots[ Slot ].Key;
+
+	uint32 NextSlot = FindInTable( Table, Key, Slot );
+	if( NextSlot != ~0u )
+	{
+		return Table.Slots[ NextSlot ].Index;
+	}
+
+	// Current is always searched first, continue with whatever hasn't been migrated yet
+	if( bInCurrent && IsRehashing() )
+	{
+		NextSlot = FindInTable( Old, Key, ~0u );
+		if( NextSlot != ~0u )
+		{
+			return Old.Slots[ NextSlot ].Index;
+		}
+	}
+
+	return ~0u;
+}
+
+void FFlatHashTable::Add( uint32 Key, uint32 Index )
+{
+	if( Index >= IndexSize )
+	{
+		Resize( FMath::Max< uint32 >( 32u, FMath::RoundUpToPowerOfTwo( Index + 1 ) ) );
+	}
+	checkSlow( SlotOfIndex[ Index ] == ~0u );
+
+	if( IsRehashing() )
+	{
+		MigrateStep();
+	}
+
+	if( Current.NumUsed + Current.NumDeleted >= Current.GrowthLimit() )
+	{
+		Grow();
+	}
+
+	SlotOfIndex[ Index ] = InsertSlot( Current, Key, Index ) | Current.TableBit;
+}
+
+void FFlatHashTable::Remove( uint32 Key, uint32 Index )
+{
+	if( Index >= IndexSize || SlotOfIndex[ Index ] == ~0u )
+	{
+		return;
+	}
+
+	const uint32 Encoded = SlotOfIndex[ Index ];
+	FTable& Table = ( Encoded & TableBitMask ) == Current.TableBit ? Current : Old;
+	const uint32 Slot = Encoded & ~TableBitMask;
+	checkSlow( Table.Slots[ Slot ].Key == Key && Table.Slots[ Slot ].Index == Index );
+
+	EraseSlot( Table, Slot );
+	SlotOfIndex[ Index ] = ~0u;
+
+	if( IsRehashing() )
+	{
+		MigrateStep();
+	}
+}
+
+void FFlatHashTable::FinishRehash()
+{
+	while( IsRehashing() )
+	{
+		MigrateStep();
+	}
+}
+
+float FFlatHashTable::AverageSearch() const
+{
+	uint64 SumProbes = 0;
+	uint32 NumElements = 0;
+
+	for( const FTable* Table : { &Current, &Old } )
+	{
+		const uint32 GroupMask = Table->NumGroups - 1;
+		for( uint32 Slot = 0; Slot < Table->Capacity(); Slot++ )
+		{
+			if( ( Table->Control[ Slot ] & 0x80 ) == 0 )
+			{
+				const uint32 HomeGroup = H1( MixKey( Table->Slots[ Slot ].Key ) ) & GroupMask;
+				SumProbes += ( ( Slot / GroupWidth - HomeGroup ) & GroupMask ) + 1;
+				NumElements++;
+			}
+		}
+	}
+
+	return NumElements ? (float)SumProbes / (float)NumElements : 0.0f;
+}
+
+void FFlatHashTable::AllocTable( FTable& Table, uint32 NumGroups )
+{
+	check( FMath::IsPowerOfTwo( NumGroups ) && NumGroups * GroupWidth < TableBitMask );
+
+	// Control bytes first so groups are naturally aligned for the vector loads, slots follow in the same block
+	const SIZE_T ControlBytes = (SIZE_T)NumGroups * GroupWidth;
+	uint8* Memory = (uint8*)FMemory::Malloc( ControlBytes * ( 1 + sizeof( FSlot ) ), GroupWidth );
+	FMemory::Memset( Memory, CtrlEmpty, ControlBytes );
+
+	Table.Control		= Memory;
+	Table.Slots			= (FSlot*)( Memory + ControlBytes );
+	Table.NumGroups		= NumGroups;
+	Table.NumUsed		= 0;
+	Table.NumDeleted	= 0;
+}
+
+void FFlatHashTable::FreeTable( FTable& Table )
+{
+	// Slots share the control allocation
+	FMemory::Free( Table.Control );
+	Table = FTable();
+}
+
+void FFlatHashTable::CopyTable( FTable& Dest, const FTable& Source )
+{
+	Dest = FTable();
+	if( Source.NumGroups )
+	{
+		AllocTable( Dest, Source.NumGroups );
+		FMemory::Memcpy( Dest.Control, Source.Control, (SIZE_T)Source.Capacity() * ( 1 + sizeof( FSlot ) ) );
+		Dest.NumUsed	= Source.NumUsed;
+		Dest.NumDeleted	= Source.NumDeleted;
+		Dest.TableBit	= Source.TableBit;
+	}
+}
+
+uint32 FFlatHashTable::InsertSlot( FTable& Table, uint32 Key, uint32 Index )
+{
+	const uint32 Hash = MixKey( Key );
+	const uint32 GroupMask = Table.NumGroups - 1;
+
+	// Growth limit guarantees at least one free slot
+	for( uint32 Group = H1( Hash ) & GroupMask; ; Group = ( Group + 1 ) & GroupMask )
+	{
+		uint8* Ctrl = Table.Control + Group * GroupWidth;
+		const uint32 FreeMask = MatchEmptyOrDeleted( Ctrl );
+		if( FreeMask )
+		{
+			const uint32 Offset = FMath::CountTrailingZeros( FreeMask );
+			if( Ctrl[ Offset ] == CtrlDeleted )
+			{
+				Table.NumDeleted--;
+			}
+			Ctrl[ Offset ] = H2( Hash );
+			Table.NumUsed++;
+
+			const uint32 Slot = Group * GroupWidth + Offset;
+			Table.Slots[ Slot ] = { Key, Index };
+			return Slot;
+		}
+	}
+}
+
+uint32 FFlatHashTable::FindInTable( const FTable& Table, uint32 Key, uint32 StartSlot )
+{
+	if( Table.NumUsed == 0 )
+	{
+		return ~0u;
+	}
+
+	const uint32 Hash = MixKey( Key );
+	const uint8 Tag = H2( Hash );
+	const uint32 GroupMask = Table.NumGroups - 1;
+
+	// Either start at the home group or resume right after the previous match
+	uint32 Group;
+	uint32 SkipMask;
+	if( StartSlot == ~0u )
+	{
+		Group = H1( Hash ) & GroupMask;
+		SkipMask = ~0u;
+	}
+	else
+	{
+		Group = StartSlot / GroupWidth;
+		SkipMask = ~0u << ( StartSlot % GroupWidth + 1 );
+	}
+
+	for( uint32 Probe = 0; Probe < Table.NumGroups; Probe++ )
+	{
+		const uint8* Ctrl = Table.Control + Group * GroupWidth;
+		for( uint32 Matches = MatchTag( Ctrl, Tag ) & SkipMask; Matches; Matches &= Matches - 1 )
+		{
+			const uint32 Slot = Group * GroupWidth + FMath::CountTrailingZeros( Matches );
+			if( Table.Slots[ Slot ].Key == Key )
+			{
+				return Slot;
+			}
+		}
+
+		// A probe sequence never continues past a group that still has an empty slot
+		if( MatchEmpty( Ctrl ) )
+		{
+			break;
+		}
+
+		Group = ( Group + 1 ) & GroupMask;
+		SkipMask = ~0u;
+	}
+
+	return ~0u;
+}
+
+void FFlatHashTable::EraseSlot( FTable& Table, uint32 Slot )
+{
+	uint8* Ctrl = Table.Control + ( Slot & ~( GroupWidth - 1 ) );
+
+	// If this group already has an empty slot no probe ever went past it, so the slot can become empty again
+	if( MatchEmpty( Ctrl ) )
+	{
+		Table.Control[ Slot ] = CtrlEmpty;
+	}
+	else
+	{
+		Table.Control[ Slot ] = CtrlDeleted;
+		Table.NumDeleted++;
+	}
+	Table.NumUsed--;
+}
+
+void FFlatHashTable::Grow()
+{
+	// Migration always outpaces growth of the new table, this only guards against pathological patterns
+	if( IsRehashing() )
+	{
+		FinishRehash();
+	}
+
+	if( Current.NumGroups == 0 )
+	{
+		AllocTable( Current, 1 );
+		return;
+	}
+
+	// Mostly tombstones means the table is not actually full, rehash into the same size to clean them up
+	const uint32 NewNumGroups = Current.NumDeleted > Current.NumUsed ? Current.NumGroups : Current.NumGroups * 2;
+
+	Old = Current;
+	Current = FTable();
+	AllocTable( Current, NewNumGroups );
+	Current.TableBit = Old.TableBit ^ TableBitMask;
+	MigrateCursor = 0;
+
+	if( Old.NumUsed == 0 )
+	{
+		FreeTable( Old );
+	}
+}
+
+void FFlatHashTable::MigrateStep()
+{
+	const uint32 EndGroup = FMath::Min( MigrateCursor + MigrateGroupsPerStep, Old.NumGroups );
+	for( ; MigrateCursor < EndGroup; MigrateCursor++ )
+	{
+		MigrateGroup( MigrateCursor );
+	}
+
+	if( MigrateCursor == Old.NumGroups || Old.NumUsed == 0 )
+	{
+		FreeTable( Old );
+		MigrateCursor = 0;
+	}
+}
+
+void FFlatHashTable::MigrateGroup( uint32 Group )
+{
+	uint8* Ctrl = Old.Control + Group * GroupWidth;
+	for( uint32 FullMask = ~MatchEmptyOrDeleted( Ctrl ) & 0xffff; FullMask; FullMask &= FullMask - 1 )
+	{
+		const uint32 Offset = FMath::CountTrailingZeros( FullMask );
+		const FSlot& Slot = Old.Slots[ Group * GroupWidth + Offset ];
+
+		SlotOfIndex[ Slot.Index ] = InsertSlot( Current, Slot.Key, Slot.Index ) | Current.TableBit;
+
+		// Leave a tombstone so lookups of not yet migrated keys still probe past this group
+		Ctrl[ Offset ] = CtrlDeleted;
+		Old.NumDeleted++;
+		Old.NumUsed--;
+	}
+}
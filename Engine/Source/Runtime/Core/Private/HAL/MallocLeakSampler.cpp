@@ -0,0 +1,428 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "HAL/MallocLeakSampler.h"
+#include "Algo/Sort.h"
+#include "HAL/PlatformStackWalk.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/UnrealMemory.h"
+#include "Misc/Crc.h"
+#include "Misc/OutputDevice.h"
+#include "Misc/ScopeLock.h"
+
+/**
+ * Events of one thread. Chunks are allocated with the system allocator so recording never goes through GMalloc and back into the sampler.
+ */
+struct FMallocLeakSampler::FThreadEvents
+{
+	/**
+	 * Events of one kind. The thread appends to its last chunk and publishes each event by bumping NumWritten,
+	 * the drain reads up to NumWritten and frees the chunks the thread has moved on from.
+	 */
+	template<typename EventType, int32 ChunkSize>
+	struct TEventList
+	{
+		struct FChunk
+		{
+			EventType Events[ChunkSize];
+			std::atomic<int32> NumWritten{ 0 };
+			std::atomic<FChunk*> Next{ nullptr };
+		};
+
+		/** Owning thread only. */
+		FChunk* WriteChunk = nullptr;
+
+		/** Drain only, under DrainLock. */
+		FChunk* ReadChunk = nullptr;
+		int32 ReadIndex = 0;
+
+		void Init()
+		{
+			WriteChunk = ReadChunk = NewChunk();
+		}
+
+		/** Returns where to write the next event, bOutNewChunk tells whether it started a new chunk. */
+		EventType* BeginEvent(bool& bOutNewChunk)
+		{
+			FChunk* Chunk = WriteChunk;
+			bOutNewChunk = Chunk->NumWritten.load(std::memory_order_relaxed) == ChunkSize;
+			if (bOutNewChunk)
+			{
+				FChunk* Next = NewChunk();
+				Chunk->Next.store(Next, std::memory_order_release);
+				WriteChunk = Chunk = Next;
+			}
+			return &Chunk->Events[Chunk->NumWritten.load(std::memory_order_relaxed)];
+		}
+
+		void PublishEvent()
+		{
+			WriteChunk->NumWritten.fetch_add(1, std::memory_order_release);
+		}
+
+		void Drain(TArray<EventType>& OutEvents)
+		{
+			for (;;)
+			{
+				FChunk* Chunk = ReadChunk;
+				const int32 NumWritten = Chunk->NumWritten.load(std::memory_order_acquire);
+				OutEvents.Append(Chunk->Events + ReadIndex, NumWritten - ReadIndex);
+				ReadIndex = NumWritten;
+
+				FChunk* NextChunk = (NumWritten == ChunkSize) ? Chunk->Next.load(std::memory_order_acquire) : nullptr;
+				if (NextChunk == nullptr)
+				{
+					break;
+				}
+				ReadChunk = NextChunk;
+				ReadIndex = 0;
+				DeleteChunk(Chunk);
+			}
+		}
+
+		static FChunk* NewChunk()
+		{
+			return new (FMemory::SystemMalloc(sizeof(FChunk))) FChunk();
+		}
+
+		static void DeleteChunk(FChunk* Chunk)
+		{
+			Chunk->~FChunk();
+			FMemory::SystemFree(Chunk);
+		}
+	};
+
+	/** About 14 KB of samples and 4 KB of frees per chunk. */
+	TEventList<FSampleEvent, 64> Samples;
+	TEventList<FFreeEvent, 256> Frees;
+
+	/** Owning thread only. */
+	int64 BytesUntilSample = 0;
+	uint64 RandomState = 0;
+	bool bRecording = false;
+
+	FThreadEvents* NextThread = nullptr;
+
+	/** Exponentially distributed distance to the next sampled byte, what makes the samples a Poisson process over allocated bytes. */
+	int64 NextSampleDistance(uint64 SampleInterval)
+	{
+		// xorshift64*, a uniform double in (0, 1]
+		RandomState ^= RandomState >> 12;
+		RandomState ^= RandomState << 25;
+		RandomState ^= RandomState >> 27;
+		const double Uniform = double(((RandomState * 0x2545F4914F6CDD1DULL) >> 11) + 1) * (1.0 / 9007199254740992.0);
+		return FMath::Max<int64>(1, int64(-FMath::Loge(Uniform) * double(SampleInterval)));
+	}
+};
+
+FMallocLeakSampler& FMallocLeakSampler::Get()
+{
+	static FMallocLeakSampler Sampler;
+	return Sampler;
+}
+
+FMallocLeakSampler::FMallocLeakSampler()
+{
+	for (std::atomic<uint16>& Count : FilterCounts)
+	{
+		Count.store(0, std::memory_order_relaxed);
+	}
+}
+
+void FMallocLeakSampler::Start(uint64 InSampleInterval)
+{
+	SampleInterval = FMath::Max<uint64>(1, InSampleInterval);
+	bTrackingFrees.store(true, std::memory_order_relaxed);
+	bSampling.store(true, std::memory_order_relaxed);
+}
+
+void FMallocLeakSampler::Stop()
+{
+	// Frees stay tracked, the samples taken so far are kept for reports until Clear
+	bSampling.store(false, std::memory_order_relaxed);
+}
+
+void FMallocLeakSampler::Clear()
+{
+	FScopeLock Lock(&DrainLock);
+	Drain();
+	LiveAllocations.Empty();
+	PendingFrees.Empty();
+	Callstacks.Empty();
+	for (std::atomic<uint16>& Count : FilterCounts)
+	{
+		Count.store(0, std::memory_order_relaxed);
+	}
+	bTrackingFrees.store(IsSampling(), std::memory_order_relaxed);
+}
+
+FMallocLeakSampler::FThreadEvents& FMallocLeakSampler::GetThreadEvents()
+{
+	static thread_local FThreadEvents* ThreadEvents = nullptr;
+	if (UNLIKELY(ThreadEvents == nullptr))
+	{
+		// Never freed, the drain may still be reading the events of a thread after it exits
+		FThreadEvents* NewThreadEvents = new (FMemory::SystemMalloc(sizeof(FThreadEvents))) FThreadEvents();
+		NewThreadEvents->Samples.Init();
+		NewThreadEvents->Frees.Init();
+		NewThreadEvents->RandomState = (uint64(FPlatformTLS::GetCurrentThreadId()) << 32) ^ FPlatformTime::Cycles64() ^ 0x9E3779B97F4A7C15ULL;
+		NewThreadEvents->BytesUntilSample = NewThreadEvents->NextSampleDistance(SampleInterval);
+
+		FThreadEvents* Head = ThreadEventsHead.load(std::memory_order_relaxed);
+		do
+		{
+			NewThreadEvents->NextThread = Head;
+		}
+		while (!ThreadEventsHead.compare_exchange_weak(Head, NewThreadEvents, std::memory_order_release, std::memory_order_relaxed));
+
+		ThreadEvents = NewThreadEvents;
+	}
+	return *ThreadEvents;
+}
+
+void FMallocLeakSampler::OnMalloc(void* Ptr, SIZE_T Size)
+{
+	if (Ptr == nullptr || Size == 0)
+	{
+		return;
+	}
+
+	FThreadEvents& ThreadEvents = GetThreadEvents();
+	ThreadEvents.BytesUntilSample -= (int64)Size;
+	if (LIKELY(ThreadEvents.BytesUntilSample > 0) || ThreadEvents.bRecording)
+	{
+		return;
+	}
+
+	ThreadEvents.BytesUntilSample = ThreadEvents.NextSampleDistance(SampleInterval);
+	if (RecordSample(Ptr, Size) && NumChunksSinceDrain.fetch_add(1, std::memory_order_relaxed) + 1 >= DrainChunkThreshold)
+	{
+		TryDrain();
+	}
+}
+
+bool FMallocLeakSampler::RecordSample(void* Ptr, SIZE_T Size)
+{
+	FThreadEvents& ThreadEvents = GetThreadEvents();
+	TGuardValue<bool> RecordingGuard(ThreadEvents.bRecording, true);
+
+	// Counted before the allocation is handed out, so a free on any thread sees it
+	FilterCounts[GetFilterSlot(Ptr)].fetch_add(1, std::memory_order_relaxed);
+
+	bool bNewChunk = false;
+	FSampleEvent* Event = ThreadEvents.Samples.BeginEvent(bNewChunk);
+	Event->Ptr = Ptr;
+	Event->Size = Size;
+	Event->Sequence = NextSequence.fetch_add(1, std::memory_order_relaxed);
+	const uint32 Depth = FPlatformStackWalk::CaptureStackBackTrace(Event->Callstack, MaxCallstackDepth);
+	FMemory::Memzero(Event->Callstack + Depth, (MaxCallstackDepth - Depth) * sizeof(uint64));
+	Event->CallstackHash = FCrc::MemCrc32(Event->Callstack, sizeof(Event->Callstack));
+
+	ThreadEvents.Samples.PublishEvent();
+	return bNewChunk;
+}
+
+void FMallocLeakSampler::OnFree(void* Ptr)
+{
+	if (Ptr == nullptr || FilterCounts[GetFilterSlot(Ptr)].load(std::memory_order_relaxed) == 0)
+	{
+		return;
+	}
+
+	FThreadEvents& ThreadEvents = GetThreadEvents();
+	if (ThreadEvents.bRecording)
+	{
+		return;
+	}
+
+	bool bNewChunk = false;
+	{
+		TGuardValue<bool> RecordingGuard(ThreadEvents.bRecording, true);
+
+		FFreeEvent* Event = ThreadEvents.Frees.BeginEvent(bNewChunk);
+		Event->Ptr = Ptr;
+		Event->Sequence = NextSequence.fetch_add(1, std::memory_order_relaxed);
+		ThreadEvents.Frees.PublishEvent();
+	}
+
+	// Once sampling stops only frees are recorded, nothing else would drain them until the next report
+	if (bNewChunk && NumChunksSinceDrain.fetch_add(1, std::memory_order_relaxed) + 1 >= DrainChunkThreshold)
+	{
+		TryDrain();
+	}
+}
+
+double FMallocLeakSampler::GetSampleWeight(SIZE_T Size) const
+{
+	// Probability that at least one sampled byte falls in an allocation of this size
+	const double Probability = 1.0 - FMath::Exp(-double(Size) / double(SampleInterval));
+	return 1.0 / FMath::Max(Probability, UE_DOUBLE_SMALL_NUMBER);
+}
+
+void FMallocLeakSampler::Drain()
+{
+	TGuardValue<bool> DrainingGuard(bDraining, true);
+	NumChunksSinceDrain.store(0, std::memory_order_relaxed);
+
+	DrainedSamples.Reset();
+	DrainedFrees.Reset();
+	for (FThreadEvents* ThreadEvents = ThreadEventsHead.load(std::memory_order_acquire); ThreadEvents; ThreadEvents = ThreadEvents->NextThread)
+	{
+		ThreadEvents->Samples.Drain(DrainedSamples);
+		ThreadEvents->Frees.Drain(DrainedFrees);
+	}
+
+	// Threads publish independently, sequence order puts every free after the allocation it frees
+	Algo::SortBy(DrainedSamples, &FSampleEvent::Sequence);
+	Algo::SortBy(DrainedFrees, &FFreeEvent::Sequence);
+	int32 FreeIndex = 0;
+	for (const FSampleEvent& Sample : DrainedSamples)
+	{
+		for (; FreeIndex < DrainedFrees.Num() && DrainedFrees[FreeIndex].Sequence < Sample.Sequence; ++FreeIndex)
+		{
+			ApplyFree(DrainedFrees[FreeIndex]);
+		}
+		ApplySample(Sample);
+	}
+	for (; FreeIndex < DrainedFrees.Num(); ++FreeIndex)
+	{
+		ApplyFree(DrainedFrees[FreeIndex]);
+	}
+	DrainedSamples.Reset();
+	DrainedFrees.Reset();
+
+	// A free whose allocation hasn't shown up by the next drain was of an allocation that was never sampled, sharing a filter slot with one that was
+	for (auto It = PendingFrees.CreateIterator(); It; ++It)
+	{
+		if (It->Value.DrainIndex < DrainIndex)
+		{
+			It.RemoveCurrent();
+		}
+	}
+	++DrainIndex;
+}
+
+void FMallocLeakSampler::TryDrain()
+{
+	if (DrainLock.TryLock())
+	{
+		if (!bDraining)
+		{
+			Drain();
+		}
+		DrainLock.Unlock();
+	}
+}
+
+void FMallocLeakSampler::ApplyFree(const FFreeEvent& Event)
+{
+	FLiveAllocation FreedAllocation;
+	if (LiveAllocations.RemoveAndCopyValue(Event.Ptr, FreedAllocation))
+	{
+		FilterCounts[GetFilterSlot(Event.Ptr)].fetch_sub(1, std::memory_order_relaxed);
+	}
+	else
+	{
+		// The allocation may have been published after this drain went past its thread
+		PendingFrees.Add(Event.Ptr, FPendingFree{ Event.Sequence, DrainIndex });
+	}
+}
+
+void FMallocLeakSampler::ApplySample(const FSampleEvent& Event)
+{
+	std::atomic<uint16>& FilterCount = FilterCounts[GetFilterSlot(Event.Ptr)];
+
+	if (const FPendingFree* PendingFree = PendingFrees.Find(Event.Ptr); PendingFree && PendingFree->Sequence > Event.Sequence)
+	{
+		PendingFrees.Remove(Event.Ptr);
+		FilterCount.fetch_sub(1, std::memory_order_relaxed);
+		return;
+	}
+
+	if (LiveAllocations.Contains(Event.Ptr))
+	{
+		// Reused address whose free was never seen, only the newest allocation is alive
+		FilterCount.fetch_sub(1, std::memory_order_relaxed);
+	}
+	LiveAllocations.Add(Event.Ptr, FLiveAllocation{ Event.Size, GetSampleWeight(Event.Size), Event.CallstackHash });
+
+	if (!Callstacks.Contains(Event.CallstackHash))
+	{
+		Callstacks.Add(Event.CallstackHash, TArray<uint64>(Event.Callstack, MaxCallstackDepth));
+	}
+}
+
+TArray<FMallocLeakSampledCallstack> FMallocLeakSampler::GetLiveCallstacks(uint64 MinEstimatedBytes)
+{
+	FScopeLock Lock(&DrainLock);
+	Drain();
+
+	TMap<uint32, FMallocLeakSampledCallstack> CallstackStats;
+	for (const TPair<void*, FLiveAllocation>& Allocation : LiveAllocations)
+	{
+		FMallocLeakSampledCallstack& Stats = CallstackStats.FindOrAdd(Allocation.Value.CallstackHash);
+		Stats.CallstackHash = Allocation.Value.CallstackHash;
+		Stats.NumSamples++;
+		Stats.SampledBytes += Allocation.Value.Size;
+		Stats.EstimatedCount += Allocation.Value.Weight;
+		Stats.EstimatedBytes += Allocation.Value.Weight * double(Allocation.Value.Size);
+	}
+
+	TArray<FMallocLeakSampledCallstack> Result;
+	Result.Reserve(CallstackStats.Num());
+	for (const TPair<uint32, FMallocLeakSampledCallstack>& Stats : CallstackStats)
+	{
+		if (Stats.Value.EstimatedBytes >= double(MinEstimatedBytes))
+		{
+			Result.Add(Stats.Value);
+		}
+	}
+	Algo::SortBy(Result, &FMallocLeakSampledCallstack::EstimatedBytes, TGreater<>());
+	return Result;
+}
+
+double FMallocLeakSampler::GetEstimatedLiveBytes()
+{
+	FScopeLock Lock(&DrainLock);
+	Drain();
+
+	double EstimatedBytes = 0.0;
+	for (const TPair<void*, FLiveAllocation>& Allocation : LiveAllocations)
+	{
+		EstimatedBytes += Allocation.Value.Weight * double(Allocation.Value.Size);
+	}
+	return EstimatedBytes;
+}
+
+void FMallocLeakSampler::DumpLiveCallstacks(FOutputDevice& Ar, uint64 MinEstimatedBytes)
+{
+	const TArray<FMallocLeakSampledCallstack> LiveCallstacks = GetLiveCallstacks(MinEstimatedBytes);
+
+	double TotalEstimatedBytes = 0.0;
+	for (const FMallocLeakSampledCallstack& Stats : LiveCallstacks)
+	{
+		TotalEstimatedBytes += Stats.EstimatedBytes;
+	}
+
+	Ar.Logf(TEXT("Dumping out of %d sampled callstacks with more than %.2f KB estimated alive, sampling one allocation every %llu KB allocated"),
+		LiveCallstacks.Num(), double(MinEstimatedBytes) / 1024.0, SampleInterval / 1024);
+	Ar.Logf(TEXT("Estimated alive: %.2f KB"), TotalEstimatedBytes / 1024.0);
+
+	FScopeLock Lock(&DrainLock);
+	for (const FMallocLeakSampledCallstack& Stats : LiveCallstacks)
+	{
+		Ar.Logf(TEXT("AllocSize: %.2f KB (estimated), Num: %.0f (estimated), Sampled: %d allocations, %.2f KB"),
+			Stats.EstimatedBytes / 1024.0, Stats.EstimatedCount, Stats.NumSamples, double(Stats.SampledBytes) / 1024.0);
+
+		if (const TArray<uint64>* Callstack = Callstacks.Find(Stats.CallstackHash))
+		{
+			for (int32 Depth = 0; Depth < Callstack->Num() && (*Callstack)[Depth] != 0; ++Depth)
+			{
+				ANSICHAR HumanReadableString[1024] = { 0 };
+				FPlatformStackWalk::ProgramCounterToHumanReadableString(Depth, (*Callstack)[Depth], HumanReadableString, UE_ARRAY_COUNT(HumanReadableString));
+				Ar.Logf(TEXT("%s"), ANSI_TO_TCHAR(HumanReadableString));
+			}
+		}
+		Ar.Logf(TEXT(""));
+	}
+}
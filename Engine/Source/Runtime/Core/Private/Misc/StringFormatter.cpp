@@ -2,7 +2,9 @@
 
 #include "Misc/StringFormatter.h"
 #include "Misc/AutomationTest.h"
+#include "Misc/CompiledStringFormat.h"
 #include "Misc/ExpressionParser.h"
+#include "Misc/StringBuilder.h"
 
 #define LOCTEXT_NAMESPACE "StringFormatter"
 
@@ -484,4 +486,95 @@ FString FString::Format(const TCHAR* InFormatString, const FStringFormatOrderedA
 	return DefaultFormatter.Format(InFormatString, InOrderedArguments);
 }
 
+namespace UE::String::Private
+{
+	/** Same output as AppendToString, without the LexToString temporaries */
+	static void AppendFormatArg(FStringBuilderBase& Out, const FStringFormatArg& Arg)
+	{
+		switch(Arg.Type)
+		{
+			case FStringFormatArg::Int: 				Out.Appendf(TEXT("%" INT64_FMT), Arg.IntValue); break;
+			case FStringFormatArg::UInt: 				Out.Appendf(TEXT("%" UINT64_FMT), Arg.UIntValue); break;
+			case FStringFormatArg::Double: 				Out.Appendf(TEXT("%f"), Arg.DoubleValue); break;
+			case FStringFormatArg::String: 				Out.Append(*Arg.StringValue, Arg.StringValue.Len()); break;
+			case FStringFormatArg::StringLiteralANSI: 	Out << Arg.StringLiteralANSIValue; break;
+			case FStringFormatArg::StringLiteralWIDE: 	Out << Arg.StringLiteralWIDEValue; break;
+			case FStringFormatArg::StringLiteralUCS2: 	Out << Arg.StringLiteralUCS2Value; break;
+			case FStringFormatArg::StringLiteralUTF8: 	Out << Arg.StringLiteralUTF8Value; break;
+		}
+	}
+
+	static void AppendFormatArg(FStringBuilderBase& Out, const FCompiledFormatArg& Arg)
+	{
+		switch(Arg.Type)
+		{
+			case FCompiledFormatArg::Int: 				Out.Appendf(TEXT("%" INT64_FMT), Arg.IntValue); break;
+			case FCompiledFormatArg::UInt: 				Out.Appendf(TEXT("%" UINT64_FMT), Arg.UIntValue); break;
+			case FCompiledFormatArg::Double: 			Out.Appendf(TEXT("%f"), Arg.DoubleValue); break;
+			case FCompiledFormatArg::StringView: 		Out.Append(Arg.StringValue, Arg.StringLen); break;
+			case FCompiledFormatArg::AnsiString: 		Out << Arg.AnsiValue; break;
+			case FCompiledFormatArg::Utf8String: 		Out << Arg.Utf8Value; break;
+			case FCompiledFormatArg::FormatArg: 		AppendFormatArg(Out, *Arg.FormatArgValue); break;
+		}
+	}
+
+	template <typename ArgType>
+	static void ExecuteCompiledFormatImpl(FStringBuilderBase& Out, const TCHAR* Pattern, TConstArrayView<FCompiledFormatOp> Ops, TConstArrayView<ArgType> Args)
+	{
+		for (const FCompiledFormatOp& Op : Ops)
+		{
+			if (Args.IsValidIndex(Op.ArgIndex))
+			{
+				AppendFormatArg(Out, Args[Op.ArgIndex]);
+			}
+			else
+			{
+				// Pattern characters, or the original token when no argument was given for it
+				Out.Append(Pattern + Op.Start, Op.Len);
+			}
+		}
+	}
+
+	void ExecuteCompiledFormat(FStringBuilderBase& Out, const TCHAR* Pattern, TConstArrayView<FCompiledFormatOp> Ops, TConstArrayView<FCompiledFormatArg> Args)
+	{
+		ExecuteCompiledFormatImpl(Out, Pattern, Ops, Args);
+	}
+
+	void ExecuteCompiledFormat(FStringBuilderBase& Out, const TCHAR* Pattern, TConstArrayView<FCompiledFormatOp> Ops, TConstArrayView<FStringFormatArg> Args)
+	{
+		ExecuteCompiledFormatImpl(Out, Pattern, Ops, Args);
+	}
+}
+
+FCompiledStringFormat::FCompiledStringFormat(FStringView InPattern)
+	: Pattern(InPattern)
+{
+	using namespace UE::String::Private;
+
+	const bool bTokenized = CompileFormatPattern(*Pattern, Pattern.Len(), [this](const FCompiledFormatOp& Op)
+	{
+		int32 NumOps = Ops.Num();
+		Ops.AddUninitialized();
+		AddCompiledFormatOp(Ops.GetData(), NumOps, Op);
+		Ops.SetNum(NumOps, EAllowShrinking::No);
+		NumArgs = FMath::Max(NumArgs, Op.ArgIndex + 1);
+	});
+
+	if (!bTokenized)
+	{
+		// FString::Format returns the pattern as is when it fails to tokenize it
+		Ops.Reset();
+		Ops.Add(FCompiledFormatOp{ 0, Pattern.Len(), INDEX_NONE });
+		NumArgs = 0;
+	}
+	Ops.Shrink();
+}
+
+FString FCompiledStringFormat::Format(TConstArrayView<FStringFormatArg> Args) const
+{
+	TStringBuilder<512> Formatted;
+	AppendOrdered(Formatted, Args);
+	return FString(Formatted.ToView());
+}
+
 #undef LOCTEXT_NAMESPACE
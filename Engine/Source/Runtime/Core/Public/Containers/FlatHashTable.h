@@ -0,0 +1,110 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "HAL/UnrealMemory.h"
+
+/*-----------------------------------------------------------------------------
+	Open addressed hash index.
+
+	Drop in sibling of FHashTable with the same First/Next/Add/Remove interface.
+	Instead of a bucket array plus a NextIndex linked list, keys and indices are
+	stored inline in slots that are tagged by one control byte each. Lookups
+	compare a 16 wide group of control bytes at once (SSE2/NEON) so most
+	searches touch a single cache line of metadata plus the matching slot.
+
+	Unlike FHashTable, First/Next only ever return indices that were added with
+	exactly the same Key, but callers are still expected to compare their own
+	element since Key is usually a hash of it.
+
+	Growth is incremental: once the table is 7/8 full a table twice the size is
+	allocated and every subsequent Add/Remove migrates a couple of groups from
+	the old table. Lookups search both tables until the migration finishes.
+-----------------------------------------------------------------------------*/
+
+class FFlatHashTable
+{
+public:
+	CORE_API FFlatHashTable( uint32 InIndexSize = 0 );
+	CORE_API FFlatHashTable( const FFlatHashTable& Other );
+	CORE_API FFlatHashTable( FFlatHashTable&& Other );
+	CORE_API ~FFlatHashTable();
+
+	CORE_API FFlatHashTable& operator=( const FFlatHashTable& Other );
+	CORE_API FFlatHashTable& operator=( FFlatHashTable&& Other );
+
+	/** Removes every index but keeps the allocations. */
+	CORE_API void			Clear();
+	/** Removes every index and frees all memory. */
+	CORE_API void			Free();
+	/** Resizes the Index -> Slot lookup without rehashing. Resize( 0 ) frees all memory like Free(), as FHashTable::Resize does. */
+	CORE_API void			Resize( uint32 NewIndexSize );
+	CORE_API SIZE_T			GetAllocatedSize() const;
+
+	// Functions used to search
+	CORE_API uint32			First( uint32 Key ) const;
+	CORE_API uint32			Next( uint32 Index ) const;
+	bool					IsValid( uint32 Index ) const	{ return Index != ~0u; }
+
+	CORE_API void			Add( uint32 Key, uint32 Index );
+	CORE_API void			Remove( uint32 Key, uint32 Index );
+
+	/** Number of indices currently stored. */
+	uint32					Num() const						{ return Current.NumUsed + Old.NumUsed; }
+	/** True while a previous table is still being migrated. */
+	bool					IsRehashing() const				{ return Old.NumGroups != 0; }
+
+	/** Migrates everything left in the previous table right away. */
+	CORE_API void			FinishRehash();
+
+	// Average # of groups probed per successful search
+	CORE_API float			AverageSearch() const;
+
+	static constexpr uint32	GroupWidth = 16;
+
+private:
+	struct FSlot
+	{
+		uint32 Key;
+		uint32 Index;
+	};
+
+	struct FTable
+	{
+		uint8*	Control = nullptr;
+		FSlot*	Slots = nullptr;
+		uint32	NumGroups = 0;
+		uint32	NumUsed = 0;
+		uint32	NumDeleted = 0;
+		uint32	TableBit = 0;
+
+		uint32	Capacity() const		{ return NumGroups * GroupWidth; }
+		uint32	GrowthLimit() const		{ return Capacity() - Capacity() / 8; }
+	};
+
+	static void				AllocTable( FTable& Table, uint32 NumGroups );
+	static void				FreeTable( FTable& Table );
+	static void				CopyTable( FTable& Dest, const FTable& Source );
+
+	static uint32			InsertSlot( FTable& Table, uint32 Key, uint32 Index );
+	static uint32			FindInTable( const FTable& Table, uint32 Key, uint32 StartSlot );
+	static void				EraseSlot( FTable& Table, uint32 Slot );
+
+	void					Grow();
+	void					MigrateStep();
+	void					MigrateGroup( uint32 Group );
+
+	// Top bit of SlotOfIndex tells which table the slot lives in. It alternates
+	// every time a table is replaced so growing never has to touch SlotOfIndex.
+	static constexpr uint32	TableBitMask = 0x80000000u;
+	// Groups migrated per Add/Remove while rehashing
+	static constexpr uint32	MigrateGroupsPerStep = 2;
+
+	FTable		Current;
+	FTable		Old;
+	uint32		MigrateCursor;
+
+	uint32		IndexSize;
+	uint32*		SlotOfIndex;
+};
@@ -81,6 +81,21 @@ namespace CoroTask_Detail
 	template<typename>
 	class TFramePromise;
 
+	/*
+	* How a coroutine that waits on another one gets resumed once that one completes
+	*/
+	enum class ECoroResumePolicy : uint8
+	{
+		// Launch the waiting coroutine on the local queue of the completing worker
+		Default,
+		// Launch the waiting coroutine on the local queue of the completing worker and immediately try to take it back
+		// and resume it on the same thread once the completed coroutine has suspended (symmetric transfer).
+		// Chains of awaits then stay in one core's cache, while idle workers can still steal the waiting
+		// coroutine from the local queue until it is taken back.
+		// The policy is handed down to everything a coroutine with this policy awaits.
+		InlineContinuations,
+	};
+
 	class IPromise
 	{
 		template<typename>
@@ -94,13 +109,11 @@ namespace CoroTask_Detail
 
 	protected:
 		mutable FPromise* Prerequisite = nullptr;
+		//read when something this coroutine waits on completes, which can happen on any thread
+		mutable std::atomic<ECoroResumePolicy> ResumePolicy { ECoroResumePolicy::Default };
 
 	public:
-		COROFORCEINLINE void Suspend(const FPromise* InPrerequisite) const
-		{
-			coroCheck(Prerequisite == nullptr && InPrerequisite != nullptr);
-			Prerequisite = const_cast<FPromise*>(InPrerequisite);
-		}
+		COROFORCEINLINE void Suspend(const FPromise* InPrerequisite) const;
 	};
 
 	/*
@@ -140,6 +153,14 @@ namespace CoroTask_Detail
 		COROTASKTRACE(TaskTrace::FId TraceId = ~0);
 		FCoroLocalState ClsData;
 		FMemStack MemStack;
+		//only accessed by the thread executing this coroutine
+		FPromise* DeferredSubsequent = nullptr;
+		uint8 InlineDepth = 0;
+		bool bExecuting = false;
+		std::atomic<bool> bExpeditingPrerequisite { false };
+
+		//bounds the recursion of continuations resumed inline from within Execute
+		static constexpr uint8 MaxInlineDepth = 16;
 
 	public:
 		COROFORCEINLINE bool IsExpeditable() const
@@ -165,13 +186,39 @@ namespace CoroTask_Detail
 			FMemStack* PrevMemStack = FMemStack::Get().Inject(&MemStack);
 			COROTASKTRACE(TaskTrace::Started(TraceId));
 			COROPROFILERTRACE(FCpuProfilerTrace::OutputResumeEvent(CoroId, TimerScopeDepth));
+			bExecuting = true;
 			CoroutineHandle();
+			bExecuting = false;
 			COROPROFILERTRACE(FCpuProfilerTrace::OutputSuspendEvent());
 			COROTASKTRACE(CompleteTaskTraceContext());
 			TaskTag = FTaskTagScope::SwapTag(TaskTag);	
 			coroVerify(FCoroLocalState::SetCoroLocalState(PrevCls) == &ClsData);
 			coroVerify(FMemStack::Get().Inject(PrevMemStack) == &MemStack);	
 			coroCheck(IsExpeditable());
+
+			ResumeDeferredSubsequent();
+		}
+
+		//symmetric transfer for ECoroResumePolicy::InlineContinuations, the waiting coroutine was handed over by Complete
+		inline void ResumeDeferredSubsequent()
+		{
+			FPromise* LocalSubsequent = DeferredSubsequent;
+			if (LocalSubsequent == nullptr)
+			{
+				return;
+			}
+			DeferredSubsequent = nullptr;
+
+			//launch first so that an idle worker can still steal it, then try to take it back and run it on this thread
+			//the worker may run the subsequent to completion before TryExpedite, hold a reference so its frame outlives both
+			LocalSubsequent->InlineDepth = InlineDepth + 1;
+			LocalSubsequent->IncrementRefCount();
+			while(!LowLevelTasks::TryLaunch(LocalSubsequent->Task, LowLevelTasks::EQueuePreference::LocalQueuePreference))
+			{
+				FPlatformProcess::Yield();
+			}
+			LocalSubsequent->TryExpedite(true);
+			LocalSubsequent->DecrementRefCount();
 		}
 
 		class FTaskExecutor
@@ -196,6 +243,7 @@ namespace CoroTask_Detail
 				if(Promise->Prerequisite == nullptr || Promise->Prerequisite->IsCompleted())
 				{
 					Promise->Prerequisite = nullptr;
+					Promise->InlineDepth = 0;
 					Promise->Execute();
 				}
 				bDeferCleanup = !Promise->CoroutineHandle.done();
@@ -258,6 +306,15 @@ namespace CoroTask_Detail
 			if (FPromise* LocalSubsequent = Subsequent.exchange(reinterpret_cast<FPromise*>(~0ull), std::memory_order_acq_rel))
 			{
 				COROTASKTRACE(TaskTrace::Scheduled(LocalSubsequent->TraceId));
+				if (bExecuting && InlineDepth < MaxInlineDepth
+					&& LocalSubsequent->ResumePolicy.load(std::memory_order_relaxed) == ECoroResumePolicy::InlineContinuations
+					&& !LocalSubsequent->bExpeditingPrerequisite.load(std::memory_order_relaxed))
+				{
+					//this coroutine is still running, Execute resumes the subsequent once it has suspended
+					coroCheck(DeferredSubsequent == nullptr);
+					DeferredSubsequent = LocalSubsequent;
+					return;
+				}
 				while(!LowLevelTasks::TryLaunch(LocalSubsequent->Task, LowLevelTasks::EQueuePreference::LocalQueuePreference))
 				{
 					FPlatformProcess::Yield();
@@ -339,10 +396,17 @@ namespace CoroTask_Detail
 				}
 
 				//try to execute the Prerequisite if it has one
-				if(Prerequisite && Prerequisite->TryExpedite(bAllowNested))
+				if(Prerequisite)
 				{
-					Prerequisite = nullptr;
-					continue;
+					//this coroutine continues right here when the Prerequisite completes, it must not be resumed inline by it as well
+					bExpeditingPrerequisite.store(true, std::memory_order_relaxed);
+					const bool bPrerequisiteDone = Prerequisite->TryExpedite(bAllowNested);
+					bExpeditingPrerequisite.store(false, std::memory_order_relaxed);
+					if(bPrerequisiteDone)
+					{
+						Prerequisite = nullptr;
+						continue;
+					}
 				}
 
 				//if the Coroutine is done we succeeded expediting
@@ -400,7 +464,8 @@ namespace CoroTask_Detail
 
 		COROFORCEINLINE void IncrementRefCount()
 		{
-			coroVerify(RefCount.fetch_add(1, std::memory_order_acquire) <= 2);
+			//the owner, the task, ResumeDeferredSubsequent and TryExpedite after a failed revival can each hold one
+			coroVerify(RefCount.fetch_add(1, std::memory_order_acquire) <= 3);
 		}
 
 		COROFORCEINLINE void DecrementRefCount()
@@ -425,6 +490,19 @@ namespace CoroTask_Detail
 		COROFORCEINLINE auto final_suspend() noexcept { return suspend_always(); }
 	};
 
+	COROFORCEINLINE void IPromise::Suspend(const FPromise* InPrerequisite) const
+	{
+		coroCheck(Prerequisite == nullptr && InPrerequisite != nullptr);
+		Prerequisite = const_cast<FPromise*>(InPrerequisite);
+
+		//hand the policy down so that everything this coroutine waits on resumes its own waiters the same way
+		const ECoroResumePolicy LocalResumePolicy = ResumePolicy.load(std::memory_order_relaxed);
+		if (LocalResumePolicy != ECoroResumePolicy::Default)
+		{
+			Prerequisite->ResumePolicy.store(LocalResumePolicy, std::memory_order_relaxed);
+		}
+	}
+
 
 	template<typename TReturnType>
 	class alignas((CORO_ALIGNMENT > alignof(TReturnType)) ? CORO_ALIGNMENT : alignof(TReturnType)) TPromise final : public FPromise
@@ -667,6 +745,16 @@ public:
 		LowLevelTasks::EQueuePreference QueuePreference = LowLevelTasks::EQueuePreference::DefaultPreference,
 		LowLevelTasks::ETaskFlags Flags = LowLevelTasks::ETaskFlags::DefaultFlags) &&;
 
+	//Select how the Task is resumed after the things it awaits complete, has to be called before it is launched or awaited.
+	inline ThisClass&& SetResumePolicy(CoroTask_Detail::ECoroResumePolicy ResumePolicy) &&
+	{
+		if(Promise)
+		{
+			Promise->ResumePolicy.store(ResumePolicy, std::memory_order_relaxed);
+		}
+		return MoveTemp(*this);
+	}
+
 	//Abandon the Task and freeing its memory if this is the last reference to it.
 	inline void Reset()
 	{
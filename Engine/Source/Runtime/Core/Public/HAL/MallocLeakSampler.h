@@ -0,0 +1,259 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/MemoryBase.h"
+#include <atomic>
+
+class FOutputDevice;
+
+/** Live sampled allocations of one callstack, with totals extrapolated to every allocation made there. */
+struct FMallocLeakSampledCallstack
+{
+	uint32 CallstackHash = 0;
+	/** Sampled allocations still alive. */
+	int32 NumSamples = 0;
+	/** Bytes of the sampled allocations still alive. */
+	uint64 SampledBytes = 0;
+	/** Expected number of allocations still alive, each sample standing for 1 / (probability of sampling it). */
+	double EstimatedCount = 0.0;
+	/** Expected bytes still alive. */
+	double EstimatedBytes = 0.0;
+};
+
+/**
+ * Low overhead alternative to FMallocLeakDetection for long soak tests.
+ *
+ * Instead of recording every allocation, it records a Poisson sampled subset: each thread counts down an exponentially distributed number
+ * of bytes (SampleInterval on average) and records the allocation that crosses zero, so big allocations are sampled more often than small ones
+ * and every allocated byte has the same chance to be sampled. Estimated leak sizes divide each sample by its sampling probability.
+ *
+ * Recording never takes a lock: samples and frees go to per-thread buffers that only their thread writes. The buffers are drained when
+ * a report is written, or by a recording thread once DrainChunkThreshold chunks were filled since the last drain, so that frees recorded
+ * between reports don't pile up. Frees only look up a small shared counter table to find out whether the pointer could have been sampled.
+ *
+ * Frees are tracked from Start until Clear, so allocations sampled before Stop and freed after it don't show as leaks in later reports.
+ *
+ * Allocations reach the sampler through FMallocLeakSamplingProxy.
+ */
+class FMallocLeakSampler
+{
+public:
+	static CORE_API FMallocLeakSampler& Get();
+
+	/** Starts sampling, on average one allocation every SampleInterval bytes allocated. */
+	CORE_API void Start(uint64 SampleInterval = 512 * 1024);
+	CORE_API void Stop();
+	/** Forgets every sample. */
+	CORE_API void Clear();
+
+	bool IsSampling() const
+	{
+		return bSampling.load(std::memory_order_relaxed);
+	}
+
+	/** Whether frees have to reach OnFree, from Start until Clear. */
+	bool IsTrackingFrees() const
+	{
+		return bTrackingFrees.load(std::memory_order_relaxed);
+	}
+
+	uint64 GetSampleInterval() const
+	{
+		return SampleInterval;
+	}
+
+	/** Allocation hooks, called by the malloc proxy for every allocation while sampling and for every free while tracking frees. */
+	void OnMalloc(void* Ptr, SIZE_T Size);
+	void OnFree(void* Ptr);
+
+	/**
+	 * Returns the sampled allocations still alive grouped by callstack, largest estimated size first.
+	 *
+	 * @param MinEstimatedBytes		Leaves out callstacks with less estimated bytes alive.
+	 */
+	CORE_API TArray<FMallocLeakSampledCallstack> GetLiveCallstacks(uint64 MinEstimatedBytes = 0);
+
+	/** Estimated bytes of every allocation still alive. */
+	CORE_API double GetEstimatedLiveBytes();
+
+	/** Writes the live callstacks with their symbolicated frames, in the layout of the FMallocLeakDetection open callstack dumps. */
+	CORE_API void DumpLiveCallstacks(FOutputDevice& Ar, uint64 MinEstimatedBytes = 0);
+
+private:
+	static constexpr int32 MaxCallstackDepth = 24;
+	static constexpr int32 NumFilterSlots = 1 << 16;
+	/** Number of event chunks filled since the last drain that makes the recording thread drain. */
+	static constexpr int32 DrainChunkThreshold = 256;
+
+	struct FSampleEvent
+	{
+		void* Ptr;
+		SIZE_T Size;
+		/** Orders events of different threads, a free can only be recorded after the allocation it frees. */
+		uint64 Sequence;
+		uint32 CallstackHash;
+		uint64 Callstack[MaxCallstackDepth];
+	};
+
+	/** Frees are recorded far more often than samples and only need the pointer and their place in the event order. */
+	struct FFreeEvent
+	{
+		void* Ptr;
+		uint64 Sequence;
+	};
+
+	struct FThreadEvents;
+
+	struct FLiveAllocation
+	{
+		SIZE_T Size = 0;
+		double Weight = 0.0;
+		uint32 CallstackHash = 0;
+	};
+
+	struct FPendingFree
+	{
+		uint64 Sequence = 0;
+		uint32 DrainIndex = 0;
+	};
+
+	FMallocLeakSampler();
+
+	FThreadEvents& GetThreadEvents();
+	/** Returns whether the event started a new chunk. */
+	bool RecordSample(void* Ptr, SIZE_T Size);
+	/** Moves the events of every thread into LiveAllocations, under DrainLock. */
+	void Drain();
+	/** Drains if no other thread is, called by recording threads once DrainChunkThreshold chunks were filled. */
+	void TryDrain();
+	void ApplySample(const FSampleEvent& Event);
+	void ApplyFree(const FFreeEvent& Event);
+	double GetSampleWeight(SIZE_T Size) const;
+
+	static uint32 GetFilterSlot(const void* Ptr)
+	{
+		const UPTRINT Value = (UPTRINT)Ptr;
+		return uint32((Value >> 4) ^ (Value >> 20)) & (NumFilterSlots - 1);
+	}
+
+	std::atomic<bool> bSampling{ false };
+	std::atomic<bool> bTrackingFrees{ false };
+	uint64 SampleInterval = 512 * 1024;
+	std::atomic<uint64> NextSequence{ 0 };
+	/** Number of live sampled allocations hashing to each slot, frees of pointers in empty slots are never recorded. */
+	std::atomic<uint16> FilterCounts[NumFilterSlots];
+	/** Event buffers of every thread that ever sampled, newest first. */
+	std::atomic<FThreadEvents*> ThreadEventsHead{ nullptr };
+	std::atomic<int32> NumChunksSinceDrain{ 0 };
+
+	FCriticalSection DrainLock;
+	/** Set while draining, DrainLock is recursive and allocations made by the drain can reach TryDrain. */
+	bool bDraining = false;
+	uint32 DrainIndex = 0;
+	TMap<void*, FLiveAllocation> LiveAllocations;
+	TMap<void*, FPendingFree> PendingFrees;
+	TMap<uint32, TArray<uint64>> Callstacks;
+	TArray<FSampleEvent> DrainedSamples;
+	TArray<FFreeEvent> DrainedFrees;
+};
+
+/** Malloc proxy feeding FMallocLeakSampler, costs a flag check per call when not sampling. */
+class FMallocLeakSamplingProxy : public FMalloc
+{
+public:
+	explicit FMallocLeakSamplingProxy(FMalloc* InMalloc)
+		: UsedMalloc(InMalloc)
+	{
+		check(UsedMalloc);
+	}
+
+	virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+	{
+		void* Result = UsedMalloc->Malloc(Size, Alignment);
+		FMallocLeakSampler& Sampler = FMallocLeakSampler::Get();
+		if (Sampler.IsSampling() && Result)
+		{
+			Sampler.OnMalloc(Result, Size);
+		}
+		return Result;
+	}
+
+	virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override
+	{
+		void* Result = UsedMalloc->TryMalloc(Size, Alignment);
+		FMallocLeakSampler& Sampler = FMallocLeakSampler::Get();
+		if (Sampler.IsSampling() && Result)
+		{
+			Sampler.OnMalloc(Result, Size);
+		}
+		return Result;
+	}
+
+	virtual void* Realloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		FMallocLeakSampler& Sampler = FMallocLeakSampler::Get();
+		OnReallocFree(Sampler, Ptr);
+		void* Result = UsedMalloc->Realloc(Ptr, NewSize, Alignment);
+		if (Sampler.IsSampling() && Result)
+		{
+			Sampler.OnMalloc(Result, NewSize);
+		}
+		return Result;
+	}
+
+	virtual void* TryRealloc(void* Ptr, SIZE_T NewSize, uint32 Alignment) override
+	{
+		FMallocLeakSampler& Sampler = FMallocLeakSampler::Get();
+		OnReallocFree(Sampler, Ptr);
+		void* Result = UsedMalloc->TryRealloc(Ptr, NewSize, Alignment);
+		if (Sampler.IsSampling() && Result)
+		{
+			Sampler.OnMalloc(Result, NewSize);
+		}
+		return Result;
+	}
+
+	virtual void Free(void* Ptr) override
+	{
+		FMallocLeakSampler& Sampler = FMallocLeakSampler::Get();
+		if (Sampler.IsTrackingFrees() && Ptr)
+		{
+			Sampler.OnFree(Ptr);
+		}
+		UsedMalloc->Free(Ptr);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return UsedMalloc->QuantizeSize(Count, Alignment); }
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return UsedMalloc->GetAllocationSize(Original, SizeOut); }
+	virtual void Trim(bool bTrimThreadCaches) override { UsedMalloc->Trim(bTrimThreadCaches); }
+	virtual void SetupTLSCachesOnCurrentThread() override { UsedMalloc->SetupTLSCachesOnCurrentThread(); }
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override { UsedMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+	virtual void InitializeStatsMetadata() override { UsedMalloc->InitializeStatsMetadata(); }
+	virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { UsedMalloc->GetAllocatorStats(OutStats); }
+	virtual void DumpAllocatorStats(FOutputDevice& Ar) override { UsedMalloc->DumpAllocatorStats(Ar); }
+	virtual bool IsInternallyThreadSafe() const override { return UsedMalloc->IsInternallyThreadSafe(); }
+	virtual bool ValidateHeap() override { return UsedMalloc->ValidateHeap(); }
+	virtual void UpdateStats() override { UsedMalloc->UpdateStats(); }
+	virtual const TCHAR* GetDescriptiveName() override { return UsedMalloc->GetDescriptiveName(); }
+
+private:
+	/**
+	 * Records the free of a reallocated block before the allocator can free it: once freed, another thread can get the address back
+	 * and sample it, and a free recorded after that would drop the new sample. If the realloc fails the block stays allocated without
+	 * its sample, which can hide a leak but never reports one.
+	 */
+	static void OnReallocFree(FMallocLeakSampler& Sampler, void* Ptr)
+	{
+		if (Sampler.IsTrackingFrees() && Ptr)
+		{
+			Sampler.OnFree(Ptr);
+		}
+	}
+
+	FMalloc* UsedMalloc;
+};
@@ -0,0 +1,13 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+
+/**
+ * Computes CityHash64 for Num independent buffers, meant for large batches of short names and paths.
+ *
+ * Out[i] is bit-exact with CityHash64(Ptrs[i], Lens[i]). The batch prefetches buffers ahead of the one being
+ * hashed so that cache misses on scattered strings overlap instead of stalling every hash.
+ */
+CORE_API void CityHash64Batch(const char* const* Ptrs, const uint32* Lens, uint64* Out, int32 Num);
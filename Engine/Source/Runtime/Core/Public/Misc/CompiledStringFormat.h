@@ -0,0 +1,250 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "Containers/ArrayView.h"
+#include "Containers/StringView.h"
+#include "Containers/UnrealString.h"
+#include "CoreTypes.h"
+#include "Math/UnrealMathUtility.h"
+#include "Misc/StringBuilder.h"
+#include "Misc/StringFormatArg.h"
+
+namespace UE::String::Private
+{
+	/** One step of a compiled format pattern */
+	struct FCompiledFormatOp
+	{
+		/** Range of pattern characters to append, or the entire argument token when ArgIndex is set */
+		int32 Start = 0;
+		int32 Len = 0;
+		/** Index of the argument to append, INDEX_NONE for a run of pattern characters */
+		int32 ArgIndex = INDEX_NONE;
+	};
+
+	/** Non-owning view of a single format argument, numbers are formatted straight into the output */
+	struct FCompiledFormatArg
+	{
+		enum EType : uint8 { Int, UInt, Double, StringView, AnsiString, Utf8String, FormatArg };
+
+		FCompiledFormatArg(const int32 Value) : Type(Int), IntValue(Value) {}
+		FCompiledFormatArg(const uint32 Value) : Type(UInt), UIntValue(Value) {}
+		FCompiledFormatArg(const int64 Value) : Type(Int), IntValue(Value) {}
+		FCompiledFormatArg(const uint64 Value) : Type(UInt), UIntValue(Value) {}
+		FCompiledFormatArg(const float Value) : Type(Double), DoubleValue(Value) {}
+		FCompiledFormatArg(const double Value) : Type(Double), DoubleValue(Value) {}
+		FCompiledFormatArg(const FString& Value) : Type(StringView), StringValue(*Value), StringLen(Value.Len()) {}
+		FCompiledFormatArg(FStringView Value) : Type(StringView), StringValue(Value.GetData()), StringLen(Value.Len()) {}
+		FCompiledFormatArg(const TCHAR* Value) : Type(StringView), StringValue(Value), StringLen(FCString::Strlen(Value)) {}
+		FCompiledFormatArg(const ANSICHAR* Value) : Type(AnsiString), AnsiValue(Value) {}
+		FCompiledFormatArg(const UTF8CHAR* Value) : Type(Utf8String), Utf8Value(Value) {}
+		FCompiledFormatArg(const FStringFormatArg& Value) : Type(FormatArg), FormatArgValue(&Value) {}
+
+		EType Type;
+		union
+		{
+			int64 IntValue;
+			uint64 UIntValue;
+			double DoubleValue;
+			const TCHAR* StringValue;
+			const ANSICHAR* AnsiValue;
+			const UTF8CHAR* Utf8Value;
+			const FStringFormatArg* FormatArgValue;
+		};
+		int32 StringLen = 0;
+	};
+
+	/** Matches FChar::IsWhitespace for TCHAR, usable in constant expressions */
+	constexpr bool IsFormatWhitespace(const TCHAR Char)
+	{
+		const uint32 C = (uint32)Char;
+		return C == ' ' || (C >= 0x09 && C <= 0x0D) || C == 0x85 || C == 0xA0 || C == 0x1680 || (C >= 0x2000 && C <= 0x200A)
+			|| C == 0x2028 || C == 0x2029 || C == 0x202F || C == 0x205F || C == 0x3000;
+	}
+
+	/**
+	 * Splits an ordered format pattern into ops exactly the way FString::Format tokenizes it, calling Emit for each op.
+	 * Returns false when FString::Format would fail to tokenize the pattern (an escape character that does not escape
+	 * '{' or '`'), in which case FString::Format returns the pattern unchanged.
+	 */
+	template <typename EmitType>
+	constexpr bool CompileFormatPattern(const TCHAR* Pattern, const int32 Len, EmitType&& Emit)
+	{
+		int32 Pos = 0;
+		while (Pos < Len)
+		{
+			if (Pattern[Pos] == TEXT('`'))
+			{
+				if (Pos + 1 < Len && (Pattern[Pos + 1] == TEXT('{') || Pattern[Pos + 1] == TEXT('`')))
+				{
+					Emit(FCompiledFormatOp{ Pos + 1, 1, INDEX_NONE });
+					Pos += 2;
+					continue;
+				}
+				return false;
+			}
+
+			if (Pattern[Pos] == TEXT('{'))
+			{
+				int32 End = Pos + 1;
+				while (End < Len && IsFormatWhitespace(Pattern[End]))
+				{
+					++End;
+				}
+
+				const int32 DigitsStart = End;
+				int64 Index = 0;
+				while (End < Len && Pattern[End] >= TEXT('0') && Pattern[End] <= TEXT('9'))
+				{
+					Index = FMath::Min<int64>(Index * 10 + (Pattern[End] - TEXT('0')), MAX_int32);
+					++End;
+				}
+
+				// An index too large to ever be valid stays in the output as is, like any unresolved token
+				if (End > DigitsStart && Index < MAX_int32)
+				{
+					while (End < Len && IsFormatWhitespace(Pattern[End]))
+					{
+						++End;
+					}
+					if (End < Len && Pattern[End] == TEXT('}'))
+					{
+						Emit(FCompiledFormatOp{ Pos, End + 1 - Pos, (int32)Index });
+						Pos = End + 1;
+						continue;
+					}
+				}
+			}
+
+			// A literal runs up to the next '{' or escape character, including a leading '{' that did not form an argument
+			int32 End = Pos + 1;
+			while (End < Len && Pattern[End] != TEXT('{') && Pattern[End] != TEXT('`'))
+			{
+				++End;
+			}
+			Emit(FCompiledFormatOp{ Pos, End - Pos, INDEX_NONE });
+			Pos = End;
+		}
+		return true;
+	}
+
+	/** Appends Op to Ops, merging it into the previous op when both are adjacent runs of pattern characters */
+	constexpr void AddCompiledFormatOp(FCompiledFormatOp* Ops, int32& NumOps, const FCompiledFormatOp& Op)
+	{
+		if (Op.ArgIndex == INDEX_NONE && NumOps > 0)
+		{
+			FCompiledFormatOp& Last = Ops[NumOps - 1];
+			if (Last.ArgIndex == INDEX_NONE && Last.Start + Last.Len == Op.Start)
+			{
+				Last.Len += Op.Len;
+				return;
+			}
+		}
+		Ops[NumOps++] = Op;
+	}
+
+	CORE_API void ExecuteCompiledFormat(FStringBuilderBase& Out, const TCHAR* Pattern, TConstArrayView<FCompiledFormatOp> Ops, TConstArrayView<FCompiledFormatArg> Args);
+	CORE_API void ExecuteCompiledFormat(FStringBuilderBase& Out, const TCHAR* Pattern, TConstArrayView<FCompiledFormatOp> Ops, TConstArrayView<FStringFormatArg> Args);
+}
+
+/**
+ * An ordered format pattern such as "{0} took {1}ms", tokenized once so that it can be applied many times.
+ *
+ * Produces the same output as FString::Format with ordered arguments, including escapes and unresolved tokens,
+ * but appends straight into a string builder: numeric arguments are formatted in place and string arguments
+ * are not copied when passed through AppendTo.
+ *
+ *		static const FCompiledStringFormat LineFormat(TEXT("{0}: {1} ({2}ms)"));
+ *		TStringBuilder<256> Line;
+ *		LineFormat.AppendTo(Line, *Name, Count, Elapsed);
+ */
+class FCompiledStringFormat
+{
+public:
+	CORE_API explicit FCompiledStringFormat(FStringView InPattern);
+
+	/** Number of arguments the pattern refers to, one more than its highest argument index */
+	int32 GetNumArgs() const
+	{
+		return NumArgs;
+	}
+
+	/** Appends the formatted pattern, arguments can be numbers, strings or FStringFormatArg */
+	template <typename... ArgTypes>
+	void AppendTo(FStringBuilderBase& Out, const ArgTypes&... Args) const
+	{
+		const UE::String::Private::FCompiledFormatArg ArgArray[sizeof...(Args) + 1] = { Args..., 0 };
+		UE::String::Private::ExecuteCompiledFormat(Out, *Pattern, Ops, MakeArrayView(ArgArray, (int32)sizeof...(Args)));
+	}
+
+	/** Appends the formatted pattern using FString::Format style arguments */
+	void AppendOrdered(FStringBuilderBase& Out, TConstArrayView<FStringFormatArg> Args) const
+	{
+		UE::String::Private::ExecuteCompiledFormat(Out, *Pattern, Ops, Args);
+	}
+
+	/** Equivalent to FString::Format(Pattern, Args) */
+	CORE_API FString Format(TConstArrayView<FStringFormatArg> Args) const;
+
+private:
+	FString Pattern;
+	TArray<UE::String::Private::FCompiledFormatOp> Ops;
+	int32 NumArgs = 0;
+};
+
+/**
+ * FCompiledStringFormat for a literal pattern, tokenized at compile time when declared constexpr.
+ *
+ *		static constexpr TCompiledStringFormatLiteral LineFormat(TEXT("{0}: {1}"));
+ */
+template <int32 PatternSize>
+class TCompiledStringFormatLiteral
+{
+public:
+	constexpr explicit TCompiledStringFormatLiteral(const TCHAR (&InPattern)[PatternSize])
+		: Pattern(InPattern)
+	{
+		const bool bTokenized = UE::String::Private::CompileFormatPattern(InPattern, PatternSize - 1,
+			[this](const UE::String::Private::FCompiledFormatOp& Op)
+			{
+				UE::String::Private::AddCompiledFormatOp(Ops, NumOps, Op);
+				NumArgs = Op.ArgIndex >= NumArgs ? Op.ArgIndex + 1 : NumArgs;
+			});
+
+		if (!bTokenized)
+		{
+			Ops[0] = UE::String::Private::FCompiledFormatOp{ 0, PatternSize - 1, INDEX_NONE };
+			NumOps = 1;
+			NumArgs = 0;
+		}
+	}
+
+	constexpr int32 GetNumArgs() const
+	{
+		return NumArgs;
+	}
+
+	constexpr int32 GetNumOps() const
+	{
+		return NumOps;
+	}
+
+	template <typename... ArgTypes>
+	void AppendTo(FStringBuilderBase& Out, const ArgTypes&... Args) const
+	{
+		const UE::String::Private::FCompiledFormatArg ArgArray[sizeof...(Args) + 1] = { Args..., 0 };
+		UE::String::Private::ExecuteCompiledFormat(Out, Pattern, MakeArrayView(Ops, NumOps), MakeArrayView(ArgArray, (int32)sizeof...(Args)));
+	}
+
+	void AppendOrdered(FStringBuilderBase& Out, TConstArrayView<FStringFormatArg> Args) const
+	{
+		UE::String::Private::ExecuteCompiledFormat(Out, Pattern, MakeArrayView(Ops, NumOps), Args);
+	}
+
+private:
+	const TCHAR* Pattern;
+	UE::String::Private::FCompiledFormatOp Ops[PatternSize];
+	int32 NumOps = 0;
+	int32 NumArgs = 0;
+};
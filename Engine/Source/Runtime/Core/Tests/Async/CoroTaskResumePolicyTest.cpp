@@ -0,0 +1,213 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#if WITH_TESTS
+
+#include "Experimental/Coroutine/Coroutine.h"
+
+#if WITH_CPP_COROUTINES
+
+#include "Algo/Sort.h"
+#include "Containers/Array.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Tests/Benchmark.h"
+#include "Tests/TestHarnessAdapter.h"
+
+namespace UE::CoroTaskResumePolicyTest
+{
+	using CoroTask_Detail::ECoroResumePolicy;
+
+	/** Completion timestamp of every leaf, indexed by Branch * NumLeaves + Leaf. */
+	struct FResumeStats
+	{
+		TArray<uint64> CompletedAt;
+
+		explicit FResumeStats(int32 NumResumes)
+		{
+			CompletedAt.SetNumZeroed(NumResumes);
+		}
+	};
+
+	TCoroTask<int32> Leaf(FResumeStats& Stats, int32 Index)
+	{
+		Stats.CompletedAt[Index] = FPlatformTime::Cycles64();
+		co_return 1;
+	}
+
+	/** Fans out to NumLeaves launched coroutines and fans back in by awaiting each of them. */
+	TCoroTask<int32> Branch(FResumeStats& Stats, ECoroResumePolicy Policy, int32 BranchIndex, int32 NumLeaves)
+	{
+		TArray<TLaunchedCoroTask<int32>> Leaves;
+		Leaves.Reserve(NumLeaves);
+		for (int32 LeafIndex = 0; LeafIndex < NumLeaves; ++LeafIndex)
+		{
+			Leaves.Add(Leaf(Stats, BranchIndex * NumLeaves + LeafIndex).SetResumePolicy(Policy).Launch(TEXT("CoroTaskResumePolicyTest::Leaf")));
+		}
+
+		int32 Sum = 0;
+		for (int32 LeafIndex = 0; LeafIndex < NumLeaves; ++LeafIndex)
+		{
+			Sum += co_await Leaves[LeafIndex];
+		}
+		co_return Sum;
+	}
+
+	TCoroTask<int32> Root(FResumeStats& Stats, ECoroResumePolicy Policy, int32 NumBranches, int32 NumLeaves)
+	{
+		TArray<TLaunchedCoroTask<int32>> Branches;
+		Branches.Reserve(NumBranches);
+		for (int32 BranchIndex = 0; BranchIndex < NumBranches; ++BranchIndex)
+		{
+			Branches.Add(Branch(Stats, Policy, BranchIndex, NumLeaves).SetResumePolicy(Policy).Launch(TEXT("CoroTaskResumePolicyTest::Branch")));
+		}
+
+		int32 Sum = 0;
+		for (TLaunchedCoroTask<int32>& BranchTask : Branches)
+		{
+			Sum += co_await BranchTask;
+		}
+		co_return Sum;
+	}
+
+	static int32 RunFanOutFanIn(FResumeStats& Stats, ECoroResumePolicy Policy, int32 NumBranches, int32 NumLeaves)
+	{
+		return Root(Stats, Policy, NumBranches, NumLeaves).SetResumePolicy(Policy).Launch(TEXT("CoroTaskResumePolicyTest::Root")).SpinWait();
+	}
+
+	/** One waiter suspended on one leaf. The leaf only completes once the benchmark thread opens the gate. */
+	struct FWakeGate
+	{
+		std::atomic<bool> bAwaiting { false };
+		std::atomic<bool> bOpen { false };
+		std::atomic<bool> bResumed { false };
+		uint64 CompletedAt = 0;
+		uint64 ResumedAt = 0;
+	};
+
+	TCoroTask<void> GatedLeaf(FWakeGate& Gate)
+	{
+		while (!Gate.bOpen.load(std::memory_order_acquire))
+		{
+			FPlatformProcess::Yield();
+		}
+		Gate.CompletedAt = FPlatformTime::Cycles64();
+		co_return;
+	}
+
+	TCoroTask<void> GatedWaiter(FWakeGate& Gate, ECoroResumePolicy Policy)
+	{
+		TLaunchedCoroTask<void> LeafTask = GatedLeaf(Gate).SetResumePolicy(Policy).Launch(TEXT("CoroTaskResumePolicyTest::GatedLeaf"));
+		Gate.bAwaiting.store(true, std::memory_order_release);
+		co_await LeafTask;
+		Gate.ResumedAt = FPlatformTime::Cycles64();
+		Gate.bResumed.store(true, std::memory_order_release);
+	}
+
+	static const TCHAR* GetPolicyName(ECoroResumePolicy Policy)
+	{
+		return Policy == ECoroResumePolicy::InlineContinuations ? TEXT("InlineContinuations") : TEXT("Default");
+	}
+
+	/** Throughput of the fan-out/fan-in graph. Most leaves have completed before their branch awaits them, so this counts co_awaits, not wake-ups. */
+	static void BenchmarkFanOutFanIn(ECoroResumePolicy Policy)
+	{
+		constexpr int32 NumBranches = 1000;
+		constexpr int32 NumLeaves = 1000;
+		FResumeStats Stats(NumBranches * NumLeaves);
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		CHECK(RunFanOutFanIn(Stats, Policy, NumBranches, NumLeaves) == NumBranches * NumLeaves);
+		const double Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+		UE_LOG(LogCore, Display, TEXT("%s: %.2f M co_awaits/s"), GetPolicyName(Policy), (NumBranches * NumLeaves) / Seconds / 1e6);
+	}
+
+	/** Opens the gate of a leaf once its waiter is suspended on it and returns the cycles from the leaf completing to the waiter running again. */
+	static uint64 WakeOnce(ECoroResumePolicy Policy)
+	{
+		// Long enough for the waiter to have registered itself on the leaf before the gate opens
+		const uint64 SuspendGraceCycles = uint64(0.00005 / FPlatformTime::GetSecondsPerCycle64());
+
+		FWakeGate Gate;
+		TLaunchedCoroTask<void> Waiter = GatedWaiter(Gate, Policy).SetResumePolicy(Policy).Launch(TEXT("CoroTaskResumePolicyTest::GatedWaiter"));
+		while (!Gate.bAwaiting.load(std::memory_order_acquire))
+		{
+			FPlatformProcess::Yield();
+		}
+		const uint64 AwaitingAt = FPlatformTime::Cycles64();
+		while (FPlatformTime::Cycles64() - AwaitingAt < SuspendGraceCycles)
+		{
+			FPlatformProcess::Yield();
+		}
+
+		Gate.bOpen.store(true, std::memory_order_release);
+		// Don't expedite the waiter from here, that would resume it on this thread instead of through the policy under test
+		while (!Gate.bResumed.load(std::memory_order_acquire))
+		{
+			FPlatformProcess::Yield();
+		}
+		Waiter.SpinWait();
+
+		return Gate.ResumedAt > Gate.CompletedAt ? Gate.ResumedAt - Gate.CompletedAt : 0;
+	}
+
+	/** Time from a leaf completing to its suspended waiter running again, with the leaf woken from outside the task graph. */
+	static void BenchmarkWakeToResume(ECoroResumePolicy Policy)
+	{
+		constexpr int32 NumWakes = 10000;
+
+		TArray<uint64> ResumeLatency;
+		ResumeLatency.Reserve(NumWakes);
+		for (int32 WakeIndex = 0; WakeIndex < NumWakes; ++WakeIndex)
+		{
+			ResumeLatency.Add(WakeOnce(Policy));
+		}
+
+		Algo::Sort(ResumeLatency);
+		UE_LOG(LogCore, Display, TEXT("%s: wake to resume p50 %.2f us, p99 %.2f us"), GetPolicyName(Policy),
+			FPlatformTime::ToSeconds64(ResumeLatency[NumWakes / 2]) * 1e6,
+			FPlatformTime::ToSeconds64(ResumeLatency[(NumWakes * 99) / 100]) * 1e6);
+	}
+
+	static void BenchmarkDefault()
+	{
+		BenchmarkFanOutFanIn(ECoroResumePolicy::Default);
+		BenchmarkWakeToResume(ECoroResumePolicy::Default);
+	}
+
+	static void BenchmarkInlineContinuations()
+	{
+		BenchmarkFanOutFanIn(ECoroResumePolicy::InlineContinuations);
+		BenchmarkWakeToResume(ECoroResumePolicy::InlineContinuations);
+	}
+}
+
+TEST_CASE_NAMED(FCoroTaskResumePolicyTest, "System::Core::Async::CoroTask::Resume Policy", "[Core][Async][SmokeFilter]")
+{
+	using namespace UE::CoroTaskResumePolicyTest;
+
+	for (ECoroResumePolicy Policy : { ECoroResumePolicy::Default, ECoroResumePolicy::InlineContinuations })
+	{
+		FResumeStats Stats(16 * 64);
+		CHECK(RunFanOutFanIn(Stats, Policy, 16, 64) == 16 * 64);
+		for (uint64 CompletedAt : Stats.CompletedAt)
+		{
+			CHECK(CompletedAt != 0);
+		}
+
+		// Returns only once the waiter has resumed after the leaf completed
+		WakeOnce(Policy);
+	}
+}
+
+TEST_CASE_NAMED(FCoroTaskResumePolicyTestPerf, "System::Core::Async::CoroTask::Resume Policy::Perf", "[.][Core][Async][Perf]")
+{
+	using namespace UE::CoroTaskResumePolicyTest;
+
+	UE_BENCHMARK(3, BenchmarkDefault);
+	UE_BENCHMARK(3, BenchmarkInlineContinuations);
+}
+
+#endif // WITH_CPP_COROUTINES
+
+#endif // WITH_TESTS
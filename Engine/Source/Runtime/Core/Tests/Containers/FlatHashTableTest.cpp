@@ -0,0 +1,174 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#if WITH_TESTS
+
+#include "Containers/FlatHashTable.h"
+#include "Containers/HashTable.h"
+#include "Containers/Array.h"
+#include "Math/RandomStream.h"
+#include "Tests/Benchmark.h"
+#include "Tests/TestHarnessAdapter.h"
+
+namespace UE::FlatHashTableTest
+{
+	static TArray<uint32> CollectIndices(const FFlatHashTable& Table, uint32 Key)
+	{
+		TArray<uint32> Result;
+		for (uint32 Index = Table.First(Key); Table.IsValid(Index); Index = Table.Next(Index))
+		{
+			Result.Add(Index);
+		}
+		Result.Sort();
+		return Result;
+	}
+
+	static TArray<uint32> MakeKeys(int32 Num, int32 Seed)
+	{
+		FRandomStream Stream(Seed);
+		TArray<uint32> Keys;
+		Keys.SetNumUninitialized(Num);
+		for (uint32& Key : Keys)
+		{
+			Key = (uint32)Stream.GetUnsignedInt();
+		}
+		return Keys;
+	}
+}
+
+TEST_CASE_NAMED(FFlatHashTableTestBasic, "System::Core::Containers::FlatHashTable::Basic", "[Core][Containers][SmokeFilter]")
+{
+	FFlatHashTable Table;
+	CHECK(!Table.IsValid(Table.First(42)));
+
+	Table.Add(42, 0);
+	Table.Add(7, 1);
+	Table.Add(42, 2);
+
+	CHECK(UE::FlatHashTableTest::CollectIndices(Table, 42) == TArray<uint32>({ 0, 2 }));
+	CHECK(UE::FlatHashTableTest::CollectIndices(Table, 7) == TArray<uint32>({ 1 }));
+	CHECK(Table.Num() == 3);
+
+	Table.Remove(42, 0);
+	CHECK(UE::FlatHashTableTest::CollectIndices(Table, 42) == TArray<uint32>({ 2 }));
+
+	Table.Clear();
+	CHECK(Table.Num() == 0);
+	CHECK(!Table.IsValid(Table.First(7)));
+
+	// Like FHashTable, Resize(0) frees everything
+	Table.Add(7, 1);
+	Table.Resize(0);
+	CHECK(Table.Num() == 0);
+	CHECK(Table.GetAllocatedSize() == 0);
+	CHECK(!Table.IsValid(Table.First(7)));
+}
+
+TEST_CASE_NAMED(FFlatHashTableTestIncrementalRehash, "System::Core::Containers::FlatHashTable::Incremental Rehash", "[Core][Containers][SmokeFilter]")
+{
+	constexpr int32 NumKeys = 4096;
+	const TArray<uint32> Keys = UE::FlatHashTableTest::MakeKeys(NumKeys, 0x1234);
+
+	FFlatHashTable Table;
+	bool bSawRehash = false;
+	for (int32 Index = 0; Index < NumKeys; ++Index)
+	{
+		// Every few keys share a key with their neighbour to exercise Next()
+		Table.Add(Keys[Index & ~1], Index);
+		bSawRehash |= Table.IsRehashing();
+
+		// Lookups have to succeed in the middle of a migration as well
+		const TArray<uint32> Found = UE::FlatHashTableTest::CollectIndices(Table, Keys[Index & ~1]);
+		REQUIRE(Found.Contains((uint32)Index));
+	}
+	CHECK(bSawRehash);
+
+	for (int32 Index = 0; Index < NumKeys; Index += 2)
+	{
+		Table.Remove(Keys[Index], Index);
+	}
+	Table.FinishRehash();
+
+	CHECK(Table.Num() == NumKeys / 2);
+	for (int32 Index = 1; Index < NumKeys; Index += 2)
+	{
+		CHECK(UE::FlatHashTableTest::CollectIndices(Table, Keys[Index & ~1]) == TArray<uint32>({ (uint32)Index }));
+	}
+}
+
+TEST_CASE_NAMED(FFlatHashTableTestCopy, "System::Core::Containers::FlatHashTable::Copy and Move", "[Core][Containers][SmokeFilter]")
+{
+	FFlatHashTable Table;
+	for (uint32 Index = 0; Index < 100; ++Index)
+	{
+		Table.Add(Index * 31, Index);
+	}
+
+	FFlatHashTable Copy(Table);
+	FFlatHashTable Moved(MoveTemp(Table));
+	for (uint32 Index = 0; Index < 100; ++Index)
+	{
+		CHECK(Copy.First(Index * 31) == Index);
+		CHECK(Moved.First(Index * 31) == Index);
+	}
+	CHECK(Table.Num() == 0);
+}
+
+namespace UE::FlatHashTableTest
+{
+	template<typename HashTableType>
+	void BenchmarkLookups(HashTableType& Table, const TArray<uint32>& Keys)
+	{
+		for (int32 Index = 0; Index < Keys.Num(); ++Index)
+		{
+			Table.Add(Keys[Index], Index);
+		}
+
+		uint64 Found = 0;
+		for (int32 Pass = 0; Pass < 4; ++Pass)
+		{
+			for (int32 Index = 0; Index < Keys.Num(); ++Index)
+			{
+				// FHashTable returns every index in the bucket, compare keys like real call sites do
+				for (uint32 It = Table.First(Keys[Index]); Table.IsValid(It); It = Table.Next(It))
+				{
+					if (Keys[It] == Keys[Index])
+					{
+						++Found;
+						break;
+					}
+				}
+			}
+		}
+		CHECK(Found == 4 * (uint64)Keys.Num());
+	}
+
+	template<int32 NumKeys>
+	void FHashTableLookups()
+	{
+		const TArray<uint32> Keys = MakeKeys(NumKeys, NumKeys);
+		FHashTable Table(FMath::Min<uint32>(FMath::RoundUpToPowerOfTwo(NumKeys), 65536), NumKeys);
+		BenchmarkLookups(Table, Keys);
+	}
+
+	template<int32 NumKeys>
+	void FFlatHashTableLookups()
+	{
+		const TArray<uint32> Keys = MakeKeys(NumKeys, NumKeys);
+		FFlatHashTable Table(NumKeys);
+		BenchmarkLookups(Table, Keys);
+	}
+}
+
+TEST_CASE_NAMED(FFlatHashTableTestPerf, "System::Core::Containers::FlatHashTable::Perf", "[.][Core][Containers][Perf]")
+{
+	using namespace UE::FlatHashTableTest;
+
+	UE_BENCHMARK(5, FHashTableLookups<1000>);
+	UE_BENCHMARK(5, FFlatHashTableLookups<1000>);
+	UE_BENCHMARK(5, FHashTableLookups<100000>);
+	UE_BENCHMARK(5, FFlatHashTableLookups<100000>);
+	UE_BENCHMARK(1, FHashTableLookups<10000000>);
+	UE_BENCHMARK(1, FFlatHashTableLookups<10000000>);
+}
+
+#endif // WITH_TESTS
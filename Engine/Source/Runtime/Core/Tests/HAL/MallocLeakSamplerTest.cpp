@@ -0,0 +1,185 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#if WITH_TESTS
+
+#include "HAL/MallocLeakSampler.h"
+#include "Async/ParallelFor.h"
+#include "Containers/Array.h"
+#include "HAL/UnrealMemory.h"
+#include "Math/RandomStream.h"
+#include "Tests/Benchmark.h"
+#include "Tests/TestHarnessAdapter.h"
+
+namespace UE::MallocLeakSamplerTest
+{
+	/** Random sizes with the long tail of a game heap: mostly small blocks, a few big buffers. */
+	static SIZE_T RandomAllocationSize(FRandomStream& Stream)
+	{
+		const float Shape = Stream.GetFraction();
+		return (SIZE_T)(Shape < 0.9f ? Stream.RandRange(16, 1024) : Stream.RandRange(1024, 256 * 1024));
+	}
+}
+
+TEST_CASE_NAMED(FMallocLeakSamplerTestEstimate, "System::Core::HAL::MallocLeakSampler::Estimate", "[Core][HAL][SmokeFilter]")
+{
+	using namespace UE::MallocLeakSamplerTest;
+
+	FMallocLeakSampler& Sampler = FMallocLeakSampler::Get();
+	FMallocLeakSamplingProxy Proxy(GMalloc);
+	Sampler.Clear();
+	Sampler.Start(64 * 1024);
+
+	// Leak 64 MB in 32 KB blocks among churn that is all freed again
+	constexpr int32 NumLeaks = 2048;
+	constexpr SIZE_T LeakSize = 32 * 1024;
+	FRandomStream Stream(0x1eac);
+	TArray<void*> Leaks;
+	for (int32 Index = 0; Index < NumLeaks; ++Index)
+	{
+		Leaks.Add(Proxy.Malloc(LeakSize, 0));
+		for (int32 Churn = 0; Churn < 50; ++Churn)
+		{
+			Proxy.Free(Proxy.Malloc(RandomAllocationSize(Stream), 0));
+		}
+	}
+
+	const double ExpectedBytes = double(NumLeaks) * double(LeakSize);
+	const double EstimatedBytes = Sampler.GetEstimatedLiveBytes();
+	CHECK(FMath::Abs(EstimatedBytes - ExpectedBytes) < 0.2 * ExpectedBytes);
+
+	// Every leak comes from the same callstack
+	const TArray<FMallocLeakSampledCallstack> Callstacks = Sampler.GetLiveCallstacks();
+	REQUIRE(Callstacks.Num() == 1);
+	CHECK(Callstacks[0].SampledBytes == Callstacks[0].NumSamples * LeakSize);
+
+	for (void* Leak : Leaks)
+	{
+		Proxy.Free(Leak);
+	}
+	CHECK(Sampler.GetEstimatedLiveBytes() == 0.0);
+
+	Sampler.Stop();
+	Sampler.Clear();
+}
+
+TEST_CASE_NAMED(FMallocLeakSamplerTestCrossThreadFrees, "System::Core::HAL::MallocLeakSampler::Cross Thread Frees", "[Core][HAL][SmokeFilter]")
+{
+	using namespace UE::MallocLeakSamplerTest;
+
+	FMallocLeakSampler& Sampler = FMallocLeakSampler::Get();
+	FMallocLeakSamplingProxy Proxy(GMalloc);
+	Sampler.Clear();
+	Sampler.Start(16 * 1024);
+
+	// Allocated on some workers and freed on others, with drains in between so frees can show up before their allocations
+	constexpr int32 NumAllocations = 1 << 16;
+	TArray<void*> Allocations;
+	Allocations.SetNumZeroed(NumAllocations);
+	for (int32 Round = 0; Round < 4; ++Round)
+	{
+		ParallelFor(NumAllocations, [&Proxy, &Allocations, Round](int32 Index)
+		{
+			FRandomStream Stream(Index * 4 + Round);
+			Allocations[Index] = Proxy.Malloc(RandomAllocationSize(Stream), 0);
+		});
+		Sampler.GetEstimatedLiveBytes();
+		ParallelFor(NumAllocations, [&Proxy, &Allocations](int32 Index)
+		{
+			const int32 Reversed = NumAllocations - 1 - Index;
+			Proxy.Free(Allocations[Reversed]);
+			Allocations[Reversed] = nullptr;
+		});
+	}
+
+	CHECK(Sampler.GetLiveCallstacks().Num() == 0);
+
+	Sampler.Stop();
+	Sampler.Clear();
+}
+
+TEST_CASE_NAMED(FMallocLeakSamplerTestFreesAfterStop, "System::Core::HAL::MallocLeakSampler::Frees After Stop", "[Core][HAL][SmokeFilter]")
+{
+	FMallocLeakSampler& Sampler = FMallocLeakSampler::Get();
+	FMallocLeakSamplingProxy Proxy(GMalloc);
+	Sampler.Clear();
+	Sampler.Start(16 * 1024);
+
+	// Half of the blocks move through Realloc, which records the free of the old block before the allocator can hand it out again
+	constexpr int32 NumAllocations = 4096;
+	TArray<void*> Allocations;
+	for (int32 Index = 0; Index < NumAllocations; ++Index)
+	{
+		Allocations.Add(Proxy.Malloc(16 * 1024, 0));
+	}
+	for (int32 Index = 0; Index < NumAllocations; Index += 2)
+	{
+		Allocations[Index] = Proxy.Realloc(Allocations[Index], 48 * 1024, 0);
+	}
+	Sampler.Stop();
+	CHECK(Sampler.GetEstimatedLiveBytes() > 0.0);
+
+	// Stopping keeps tracking frees, so blocks freed afterwards don't show as leaks
+	for (void* Allocation : Allocations)
+	{
+		Proxy.Free(Allocation);
+	}
+	CHECK(Sampler.GetEstimatedLiveBytes() == 0.0);
+	CHECK(Sampler.IsTrackingFrees());
+
+	Sampler.Clear();
+	CHECK(!Sampler.IsTrackingFrees());
+}
+
+namespace UE::MallocLeakSamplerTest
+{
+	// Allocation churn of a busy server frame, most blocks freed soon after they are allocated
+	static void AllocationChurn(FMalloc& Malloc)
+	{
+		constexpr int32 NumLive = 1024;
+		constexpr int32 NumOperations = 1 << 20;
+		void* Live[NumLive] = {};
+		FRandomStream Stream(0xc4a7);
+		for (int32 Index = 0; Index < NumOperations; ++Index)
+		{
+			const int32 Slot = Stream.RandHelper(NumLive);
+			Malloc.Free(Live[Slot]);
+			Live[Slot] = Malloc.Malloc(RandomAllocationSize(Stream), 0);
+		}
+		for (void* Ptr : Live)
+		{
+			Malloc.Free(Ptr);
+		}
+	}
+
+	static void ChurnWithoutProxy()
+	{
+		AllocationChurn(*GMalloc);
+	}
+
+	static void ChurnProxyNotSampling()
+	{
+		FMallocLeakSamplingProxy Proxy(GMalloc);
+		FMallocLeakSampler::Get().Stop();
+		AllocationChurn(Proxy);
+	}
+
+	static void ChurnProxySampling512KB()
+	{
+		FMallocLeakSamplingProxy Proxy(GMalloc);
+		FMallocLeakSampler::Get().Start(512 * 1024);
+		AllocationChurn(Proxy);
+		FMallocLeakSampler::Get().Stop();
+		FMallocLeakSampler::Get().Clear();
+	}
+}
+
+TEST_CASE_NAMED(FMallocLeakSamplerTestPerf, "System::Core::HAL::MallocLeakSampler::Perf", "[.][Core][HAL][Perf]")
+{
+	using namespace UE::MallocLeakSamplerTest;
+
+	UE_BENCHMARK(5, ChurnWithoutProxy);
+	UE_BENCHMARK(5, ChurnProxyNotSampling);
+	UE_BENCHMARK(5, ChurnProxySampling512KB);
+}
+
+#endif // WITH_TESTS
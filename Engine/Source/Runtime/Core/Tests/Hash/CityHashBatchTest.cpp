@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#if WITH_TESTS
+
+#include "Hash/CityHash.h"
+#include "Hash/CityHashBatch.h"
+#include "Containers/Array.h"
+#include "Math/RandomStream.h"
+#include "Tests/Benchmark.h"
+#include "Tests/TestHarnessAdapter.h"
+
+namespace UE::CityHashBatchTest
+{
+	struct FStrings
+	{
+		TArray<char> Storage;
+		TArray<const char*> Ptrs;
+		TArray<uint32> Lens;
+	};
+
+	/** Random strings scattered over a pool larger than the caches, with lengths like FName display strings. */
+	static FStrings MakeNameLikeStrings(int32 Num, int32 PoolSize, int32 Seed)
+	{
+		FRandomStream Stream(Seed);
+		FStrings Result;
+		Result.Storage.SetNumUninitialized(PoolSize + 256);
+		for (char& Char : Result.Storage)
+		{
+			Char = (char)Stream.RandRange(32, 126);
+		}
+
+		Result.Ptrs.SetNumUninitialized(Num);
+		Result.Lens.SetNumUninitialized(Num);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			// Mostly short identifiers, with a tail of long object paths
+			const float Shape = Stream.GetFraction();
+			Result.Lens[Index] = (uint32)(Shape < 0.9f ? Stream.RandRange(3, 32) : Stream.RandRange(33, 128));
+			Result.Ptrs[Index] = Result.Storage.GetData() + Stream.RandRange(0, PoolSize);
+		}
+		return Result;
+	}
+}
+
+TEST_CASE_NAMED(FCityHashBatchTestMatchesScalar, "System::Core::Hash::CityHash64Batch::Matches Scalar", "[Core][Hash][SmokeFilter]")
+{
+	char Buffer[512];
+	FRandomStream Stream(0xc17);
+	for (char& Char : Buffer)
+	{
+		Char = (char)Stream.RandHelper(256);
+	}
+
+	// Every length and alignment up to a few 64 byte blocks
+	TArray<const char*> Ptrs;
+	TArray<uint32> Lens;
+	for (uint32 Len = 0; Len <= 200; ++Len)
+	{
+		for (uint32 Offset = 0; Offset < 8; ++Offset)
+		{
+			Ptrs.Add(Buffer + Offset);
+			Lens.Add(Len);
+		}
+	}
+
+	TArray<uint64> Hashes;
+	Hashes.SetNumUninitialized(Ptrs.Num());
+	CityHash64Batch(Ptrs.GetData(), Lens.GetData(), Hashes.GetData(), Ptrs.Num());
+
+	for (int32 Index = 0; Index < Ptrs.Num(); ++Index)
+	{
+		CHECK(Hashes[Index] == CityHash64(Ptrs[Index], Lens[Index]));
+	}
+
+	// Empty batch is a no-op
+	CityHash64Batch(nullptr, nullptr, nullptr, 0);
+}
+
+namespace UE::CityHashBatchTest
+{
+	static const FStrings& GetBenchmarkStrings()
+	{
+		static FStrings Strings = MakeNameLikeStrings(1 << 20, 64 << 20, 0xf4a3e);
+		return Strings;
+	}
+
+	static void HashScalar()
+	{
+		const FStrings& Strings = GetBenchmarkStrings();
+		uint64 Sum = 0;
+		for (int32 Index = 0; Index < Strings.Ptrs.Num(); ++Index)
+		{
+			Sum += CityHash64(Strings.Ptrs[Index], Strings.Lens[Index]);
+		}
+		CHECK(Sum != 0);
+	}
+
+	static void HashBatch()
+	{
+		const FStrings& Strings = GetBenchmarkStrings();
+		TArray<uint64> Hashes;
+		Hashes.SetNumUninitialized(Strings.Ptrs.Num());
+		CityHash64Batch(Strings.Ptrs.GetData(), Strings.Lens.GetData(), Hashes.GetData(), Strings.Ptrs.Num());
+		CHECK(Hashes.Num() != 0);
+	}
+}
+
+TEST_CASE_NAMED(FCityHashBatchTestPerf, "System::Core::Hash::CityHash64Batch::Perf", "[.][Core][Hash][Perf]")
+{
+	using namespace UE::CityHashBatchTest;
+
+	GetBenchmarkStrings();
+	UE_BENCHMARK(5, HashScalar);
+	UE_BENCHMARK(5, HashBatch);
+}
+
+#endif // WITH_TESTS
@@ -3,6 +3,9 @@
 #if WITH_TESTS
 
 #include "Containers/UnrealString.h"
+#include "Misc/CompiledStringFormat.h"
+#include "Misc/StringBuilder.h"
+#include "Tests/Benchmark.h"
 #include "Tests/TestHarnessAdapter.h"
 
 TEST_CASE_NAMED(FStringFormattingTestStaticRequirements, "System::Core::String Formatting::Static Requirements", "[Core][String][EditorContext][SmokeFilter]")
@@ -202,4 +205,99 @@ TEST_CASE_NAMED(FStringFormattingTestOrderedAllTypes, "System::Core::String Form
 	CHECK_MESSAGE(*FString::Printf(TEXT("FString::Format failed. Expected: \"%s\", Actual: \"%s\""), ExpectedResult, *ActualResult), FCString::Strcmp(ExpectedResult, *ActualResult) == 0);
 }
 
+TEST_CASE_NAMED(FStringFormattingTestCompiledEquivalence, "System::Core::String Formatting::Compiled Equivalence (Ordered)", "[Core][String][EditorContext][SmokeFilter]")
+{
+	TArray<FStringFormatArg> Args;
+	Args.Add(100);
+	Args.Add(200u);
+	Args.Add(-300ll);
+	Args.Add(400ull);
+	Args.Add(500.25f);
+	Args.Add(600.0);
+	Args.Add(FString(TEXT("Text")));
+	Args.Add(TEXT("Literal"));
+	Args.Add("Ansi");
+
+	const TCHAR* Patterns[] =
+	{
+		TEXT(""),
+		TEXT("No arguments"),
+		TEXT("{0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}, {8}"),
+		TEXT("{ 0 } and {1 }{2}{ 3}"),
+		TEXT("{0}{0}{0}"),
+		TEXT("Escaped `{ 0 } and ``{0}"),
+		TEXT("Bad escape `x {0}"),
+		TEXT("Trailing escape {0}`"),
+		TEXT("Unbounded { 0"),
+		TEXT("Non-existent { 42 } and {9}"),
+		TEXT("Invalid {Argument1 1}  { a8f7690-23\\ {} } {0 1} {-1}"),
+		TEXT("{{0}}"),
+		TEXT("{"),
+		TEXT("}"),
+	};
+
+	for (const TCHAR* Pattern : Patterns)
+	{
+		const FString Expected = FString::Format(Pattern, Args);
+
+		const FCompiledStringFormat Compiled(Pattern);
+		CHECK_MESSAGE(*FString::Printf(TEXT("FCompiledStringFormat::Format failed for \"%s\""), Pattern), Compiled.Format(Args) == Expected);
+
+		TStringBuilder<256> Builder;
+		Compiled.AppendTo(Builder, 100, 200u, -300ll, 400ull, 500.25f, 600.0, FString(TEXT("Text")), TEXT("Literal"), "Ansi");
+		CHECK_MESSAGE(*FString::Printf(TEXT("FCompiledStringFormat::AppendTo failed for \"%s\""), Pattern), Expected.Equals(FString(Builder.ToView()), ESearchCase::CaseSensitive));
+	}
+}
+
+TEST_CASE_NAMED(FStringFormattingTestCompiledLiteral, "System::Core::String Formatting::Compiled Literal (Ordered)", "[Core][String][EditorContext][SmokeFilter]")
+{
+	static constexpr TCompiledStringFormatLiteral Format(TEXT("{0} took {1}ms, `{escaped} {2}"));
+	STATIC_REQUIRE(Format.GetNumArgs() == 3);
+	STATIC_REQUIRE(Format.GetNumOps() == 6);
+
+	static constexpr TCompiledStringFormatLiteral BadEscape(TEXT("{0} `x"));
+	STATIC_REQUIRE(BadEscape.GetNumArgs() == 0);
+	STATIC_REQUIRE(BadEscape.GetNumOps() == 1);
+
+	TStringBuilder<128> Builder;
+	Format.AppendTo(Builder, TEXT("Load"), 12, 1.5);
+	CHECK(FString(Builder.ToView()) == FString::Format(TEXT("{0} took {1}ms, `{escaped} {2}"), { TEXT("Load"), 12, 1.5 }));
+}
+
+namespace UE::StringFormatTest
+{
+	static const TCHAR* BenchmarkPattern = TEXT("[{0}] {1} hit {2} for {3} damage at ({4}, {5}, {6})");
+	static constexpr int32 BenchmarkLines = 200000;
+
+	static void FormatLines()
+	{
+		int32 TotalLen = 0;
+		for (int32 Line = 0; Line < BenchmarkLines; ++Line)
+		{
+			TotalLen += FString::Format(BenchmarkPattern, { Line, TEXT("Attacker"), TEXT("Victim"), 42.5, 1.0, 2.0, 3.0 }).Len();
+		}
+		CHECK(TotalLen > 0);
+	}
+
+	static void FormatLinesCompiled()
+	{
+		static const FCompiledStringFormat Compiled(BenchmarkPattern);
+		int32 TotalLen = 0;
+		TStringBuilder<256> Builder;
+		for (int32 Line = 0; Line < BenchmarkLines; ++Line)
+		{
+			Builder.Reset();
+			Compiled.AppendTo(Builder, Line, TEXT("Attacker"), TEXT("Victim"), 42.5, 1.0, 2.0, 3.0);
+			TotalLen += Builder.Len();
+		}
+		CHECK(TotalLen > 0);
+	}
+}
+
+TEST_CASE_NAMED(FStringFormattingTestCompiledPerf, "System::Core::String Formatting::Compiled Throughput", "[.][Core][String][Perf]")
+{
+	UE_BENCHMARK(5, UE::StringFormatTest::FormatLines);
+	UE_BENCHMARK(5, UE::StringFormatTest::FormatLinesCompiled);
+}
+
 #endif //WITH_TESTS
\ No newline at end of file
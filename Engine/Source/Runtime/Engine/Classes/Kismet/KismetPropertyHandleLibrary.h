@@ -0,0 +1,87 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/FieldPath.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "KismetPropertyHandleLibrary.generated.h"
+
+/** A property of a class resolved by name once, to set it on many objects without looking it up again. */
+USTRUCT(BlueprintType)
+struct FResolvedPropertyHandle
+{
+	GENERATED_BODY()
+
+	/** Property the handle resolved to, stays safe to use if the owning class is recompiled or unloaded. */
+	UPROPERTY()
+	TFieldPath<FProperty> Property;
+};
+
+/**
+ * "Resolve once, set many" versions of the UKismetSystemLibrary Set*PropertyByName nodes, for tools that set the same property on many objects.
+ * Setting through a handle on an object that isn't of the class the handle was resolved on, or a subclass, does nothing.
+ */
+UCLASS(MinimalAPI)
+class UKismetPropertyHandleLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/** Finds the property named PropertyName on Class, the handle is invalid if there is none. */
+	UFUNCTION(BlueprintPure, Category="Utilities|Property Handles")
+	static ENGINE_API FResolvedPropertyHandle ResolvePropertyHandle(const UClass* Class, FName PropertyName);
+
+	/** Returns true if the handle refers to a property. */
+	UFUNCTION(BlueprintPure, Category="Utilities|Property Handles")
+	static ENGINE_API bool IsValidPropertyHandle(const FResolvedPropertyHandle& Handle);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetIntPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, int32 Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetInt64PropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, int64 Value);
+
+	/** Sets byte properties and enum properties alike. */
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetBytePropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, uint8 Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetFloatPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, float Value);
+
+	/** Sets double properties, and float properties with the value narrowed to float. */
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetDoublePropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, double Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetBoolPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, bool Value);
+
+	/** Value must be of the class of the property, or null. */
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetObjectPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, UObject* Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetStringPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FString& Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetNamePropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, FName Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetTextPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FText& Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetVectorPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FVector& Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetRotatorPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FRotator& Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetLinearColorPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FLinearColor& Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetColorPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FColor& Value);
+
+	UFUNCTION(BlueprintCallable, Category="Utilities|Property Handles")
+	static ENGINE_API void SetTransformPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FTransform& Value);
+};
@@ -0,0 +1,128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/HitResult.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "WorldCollision.h"
+#include "KismetTraceBatchLibrary.generated.h"
+
+/**
+ * Batched versions of the UKismetSystemLibrary trace nodes, for Blueprints that issue many traces per frame.
+ *
+ * Every batch shares one channel, ignore list and complex setting, the collision query params are built once per batch instead of once per trace.
+ * Trace I goes from Starts[I] to Ends[I]. Shape arrays (Radii, HalfSizes, HalfHeights, Orientations) either have one element used by every
+ * trace or one element per trace. The traces themselves run in parallel on worker threads, see bp.TraceBatch.Parallel.
+ */
+UCLASS(MinimalAPI)
+class UKismetTraceBatchLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Does a collision trace for every Start/End pair and returns the first blocking hit of each.
+	 *
+	 * @param OutHits		One hit per trace, bBlockingHit is false for traces that did not hit anything.
+	 * @return				Number of traces that hit something.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="ActorsToIgnore", DisplayName="Line Trace By Channel (Batch)", Keywords="raycast"))
+	static ENGINE_API int32 LineTraceSingleBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, bool bIgnoreSelf = true);
+
+	/**
+	 * Does a collision trace for every Start/End pair and returns all the hits of each, up to and including its first blocking hit.
+	 *
+	 * @param OutHits		Hits of all the traces, those of trace I follow those of trace I - 1.
+	 * @param OutNumHits	Number of hits of each trace in OutHits.
+	 * @return				Number of traces that found a blocking hit.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="ActorsToIgnore", DisplayName="Multi Line Trace By Channel (Batch)", Keywords="raycast"))
+	static ENGINE_API int32 LineTraceMultiBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, TArray<int32>& OutNumHits, bool bIgnoreSelf = true);
+
+	/** Sweeps a sphere for every Start/End pair, see LineTraceSingleBatch. */
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="ActorsToIgnore", DisplayName="Sphere Trace By Channel (Batch)", Keywords="sweep"))
+	static ENGINE_API int32 SphereTraceSingleBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<float>& Radii, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, bool bIgnoreSelf = true);
+
+	/** Sweeps a sphere for every Start/End pair, see LineTraceMultiBatch. */
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="ActorsToIgnore", DisplayName="Multi Sphere Trace By Channel (Batch)", Keywords="sweep"))
+	static ENGINE_API int32 SphereTraceMultiBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<float>& Radii, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, TArray<int32>& OutNumHits, bool bIgnoreSelf = true);
+
+	/** Sweeps a box for every Start/End pair, see LineTraceSingleBatch. An empty Orientations array sweeps axis aligned boxes. */
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="Orientations, ActorsToIgnore", DisplayName="Box Trace By Channel (Batch)", Keywords="sweep"))
+	static ENGINE_API int32 BoxTraceSingleBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<FVector>& HalfSizes, const TArray<FRotator>& Orientations, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, bool bIgnoreSelf = true);
+
+	/** Sweeps a box for every Start/End pair, see LineTraceMultiBatch. An empty Orientations array sweeps axis aligned boxes. */
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="Orientations, ActorsToIgnore", DisplayName="Multi Box Trace By Channel (Batch)", Keywords="sweep"))
+	static ENGINE_API int32 BoxTraceMultiBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<FVector>& HalfSizes, const TArray<FRotator>& Orientations, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, TArray<int32>& OutNumHits, bool bIgnoreSelf = true);
+
+	/** Sweeps an upright capsule for every Start/End pair, see LineTraceSingleBatch. */
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="ActorsToIgnore", DisplayName="Capsule Trace By Channel (Batch)", Keywords="sweep"))
+	static ENGINE_API int32 CapsuleTraceSingleBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<float>& Radii, const TArray<float>& HalfHeights, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, bool bIgnoreSelf = true);
+
+	/** Sweeps an upright capsule for every Start/End pair, see LineTraceMultiBatch. */
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(WorldContext="WorldContextObject", AutoCreateRefTerm="ActorsToIgnore", DisplayName="Multi Capsule Trace By Channel (Batch)", Keywords="sweep"))
+	static ENGINE_API int32 CapsuleTraceMultiBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<float>& Radii, const TArray<float>& HalfHeights, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, TArray<int32>& OutNumHits, bool bIgnoreSelf = true);
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnTraceBatchCompleted, const TArray<FHitResult>&, Hits, const TArray<int32>&, NumHits);
+
+/**
+ * Latent version of the batch trace nodes. The traces go through the world async trace queue, they run on worker threads alongside the rest
+ * of the frame and OnCompleted fires on the game thread next frame, without ever blocking the calling Blueprint.
+ *
+ * Hits are reported like the Multi batch nodes for single and multi hit traces alike: all hits flattened in trace order, with NumHits[I] hits for trace I.
+ */
+UCLASS(MinimalAPI)
+class UAsyncTraceBatchAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FOnTraceBatchCompleted OnCompleted;
+
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(BlueprintInternalUseOnly="true", WorldContext="WorldContextObject", AutoCreateRefTerm="ActorsToIgnore", DisplayName="Async Line Trace By Channel (Batch)"))
+	static ENGINE_API UAsyncTraceBatchAction* AsyncLineTraceBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, bool bMultiHit = false, bool bIgnoreSelf = true);
+
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(BlueprintInternalUseOnly="true", WorldContext="WorldContextObject", AutoCreateRefTerm="ActorsToIgnore", DisplayName="Async Sphere Trace By Channel (Batch)"))
+	static ENGINE_API UAsyncTraceBatchAction* AsyncSphereTraceBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<float>& Radii, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, bool bMultiHit = false, bool bIgnoreSelf = true);
+
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(BlueprintInternalUseOnly="true", WorldContext="WorldContextObject", AutoCreateRefTerm="Orientations, ActorsToIgnore", DisplayName="Async Box Trace By Channel (Batch)"))
+	static ENGINE_API UAsyncTraceBatchAction* AsyncBoxTraceBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<FVector>& HalfSizes, const TArray<FRotator>& Orientations, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, bool bMultiHit = false, bool bIgnoreSelf = true);
+
+	UFUNCTION(BlueprintCallable, Category="Collision", meta=(BlueprintInternalUseOnly="true", WorldContext="WorldContextObject", AutoCreateRefTerm="ActorsToIgnore", DisplayName="Async Capsule Trace By Channel (Batch)"))
+	static ENGINE_API UAsyncTraceBatchAction* AsyncCapsuleTraceBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<float>& Radii, const TArray<float>& HalfHeights, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, bool bMultiHit = false, bool bIgnoreSelf = true);
+
+	//~ Begin UBlueprintAsyncActionBase Interface
+	ENGINE_API virtual void Activate() override;
+	//~ End UBlueprintAsyncActionBase Interface
+
+private:
+	static UAsyncTraceBatchAction* CreateAction(const UObject* WorldContextObject, FName TraceTag, ECollisionShape::Type ShapeType, const TArray<FVector>& Starts, const TArray<FVector>& Ends,
+		ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, bool bMultiHit, bool bIgnoreSelf);
+
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Data);
+	void Complete();
+
+	TWeakObjectPtr<UWorld> World;
+	FCollisionQueryParams QueryParams;
+	ECollisionChannel CollisionChannel = ECC_Visibility;
+	ECollisionShape::Type ShapeType = ECollisionShape::Line;
+	bool bMultiHit = false;
+
+	TArray<FVector> Starts;
+	TArray<FVector> Ends;
+	TArray<float> Radii;
+	TArray<float> HalfHeights;
+	TArray<FVector> HalfSizes;
+	TArray<FRotator> Orientations;
+
+	/** Hits of each trace, filled in as the trace delegates come in. */
+	TArray<TArray<FHitResult>> TraceHits;
+	int32 NumPendingTraces = 0;
+	FTraceDelegate TraceDelegate;
+};
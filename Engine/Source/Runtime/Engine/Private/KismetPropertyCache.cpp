@@ -0,0 +1,97 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "KismetPropertyCache.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace UE::Blueprint::Private
+{
+	static bool bPropertyByNameCache = true;
+	FAutoConsoleVariableRef CVarPropertyByNameCache(
+		TEXT("bp.PropertyByNameCache"),
+		bPropertyByNameCache,
+		TEXT("When true, the Set*PropertyByName nodes remember which property a name resolves to on each class instead of searching the class every call."));
+
+	class FPropertyByNameCache
+	{
+	public:
+		static FPropertyByNameCache& Get()
+		{
+			static FPropertyByNameCache Cache;
+			return Cache;
+		}
+
+		FProperty* Find(const UStruct* Struct, FName PropertyName)
+		{
+			// Object keys rather than pointers, a new class allocated where a destroyed one was doesn't pick up its entries
+			const FKey Key(Struct, PropertyName);
+			{
+				FReadScopeLock ReadLock(Lock);
+				if (FProperty* const* Property = Properties.Find(Key))
+				{
+					return *Property;
+				}
+			}
+
+			FProperty* Property = FindFProperty<FProperty>(Struct, PropertyName);
+
+			FWriteScopeLock WriteLock(Lock);
+			Properties.Add(Key, Property);
+			return Property;
+		}
+
+		void Reset()
+		{
+			FWriteScopeLock WriteLock(Lock);
+			Properties.Reset();
+		}
+
+	private:
+		FPropertyByNameCache()
+		{
+#if WITH_RELOAD
+			FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason)
+			{
+				Get().Reset();
+			});
+#endif
+#if WITH_EDITOR
+			// Blueprint compilation recreates the properties of the classes it reinstances
+			FCoreUObjectDelegates::OnObjectsReinstanced.AddLambda([](const FCoreUObjectDelegates::FReplacementObjectMap&)
+			{
+				Get().Reset();
+			});
+			FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([](const TMap<UObject*, UObject*>&)
+			{
+				Get().Reset();
+			});
+#endif
+			// Entries of destroyed classes can never be found again, drop them
+			FCoreUObjectDelegates::GetPostGarbageCollect().AddLambda([]()
+			{
+				Get().Reset();
+			});
+		}
+
+		using FKey = TTuple<TObjectKey<UStruct>, FName>;
+
+		FRWLock Lock;
+		TMap<FKey, FProperty*> Properties;
+	};
+
+	FProperty* FindPropertyByNameCached(const UStruct* Struct, FName PropertyName)
+	{
+		if (!bPropertyByNameCache || Struct == nullptr)
+		{
+			return Struct ? FindFProperty<FProperty>(Struct, PropertyName) : nullptr;
+		}
+		return FPropertyByNameCache::Get().Find(Struct, PropertyName);
+	}
+
+	void ResetPropertyByNameCache()
+	{
+		FPropertyByNameCache::Get().Reset();
+	}
+}
@@ -0,0 +1,26 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "UObject/UnrealType.h"
+
+namespace UE::Blueprint::Private
+{
+	/**
+	 * Same result as FindFProperty<FProperty>(Struct, PropertyName), remembered per (struct, name) so the Set*PropertyByName nodes don't walk
+	 * the property chain of the class on every call. Missing properties are remembered too.
+	 *
+	 * The cache is flushed when classes are reinstanced or reloaded, which is when resolved properties can go away. bp.PropertyByNameCache 0 turns it off.
+	 */
+	FProperty* FindPropertyByNameCached(const UStruct* Struct, FName PropertyName);
+
+	/** Cached version of FindFProperty<FieldType>. */
+	template<typename FieldType>
+	FieldType* FindFPropertyCached(const UStruct* Struct, FName PropertyName)
+	{
+		return CastField<FieldType>(FindPropertyByNameCached(Struct, PropertyName));
+	}
+
+	/** Forgets every resolved property. */
+	void ResetPropertyByNameCache();
+}
@@ -0,0 +1,170 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Kismet/KismetPropertyHandleLibrary.h"
+#include "KismetPropertyCache.h"
+#include "UObject/UnrealType.h"
+#include UE_INLINE_GENERATED_CPP_BY_NAME(KismetPropertyHandleLibrary)
+
+namespace UE::Blueprint::Private
+{
+	/** Returns the property of the handle if it can be set on Object and is of type FieldType. */
+	template<typename FieldType>
+	FieldType* GetHandleProperty(const UObject* Object, const FResolvedPropertyHandle& Handle)
+	{
+		if (Object == nullptr)
+		{
+			return nullptr;
+		}
+
+		FieldType* Property = CastField<FieldType>(Handle.Property.Get());
+		if (Property == nullptr)
+		{
+			return nullptr;
+		}
+
+		const UStruct* OwnerStruct = Property->GetOwnerStruct();
+		return (OwnerStruct && Object->GetClass()->IsChildOf(OwnerStruct)) ? Property : nullptr;
+	}
+
+	template<typename ValueType>
+	void SetStructValueByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const UScriptStruct* ValueStruct, const ValueType& Value)
+	{
+		FStructProperty* StructProp = GetHandleProperty<FStructProperty>(Object, Handle);
+		if (StructProp != nullptr && StructProp->Struct == ValueStruct)
+		{
+			*StructProp->ContainerPtrToValuePtr<ValueType>(Object) = Value;
+		}
+	}
+}
+
+FResolvedPropertyHandle UKismetPropertyHandleLibrary::ResolvePropertyHandle(const UClass* Class, FName PropertyName)
+{
+	FResolvedPropertyHandle Handle;
+	if (Class != nullptr)
+	{
+		Handle.Property = UE::Blueprint::Private::FindPropertyByNameCached(Class, PropertyName);
+	}
+	return Handle;
+}
+
+bool UKismetPropertyHandleLibrary::IsValidPropertyHandle(const FResolvedPropertyHandle& Handle)
+{
+	return Handle.Property.Get() != nullptr;
+}
+
+void UKismetPropertyHandleLibrary::SetIntPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, int32 Value)
+{
+	if (FIntProperty* IntProp = UE::Blueprint::Private::GetHandleProperty<FIntProperty>(Object, Handle))
+	{
+		IntProp->SetPropertyValue_InContainer(Object, Value);
+	}
+}
+
+void UKismetPropertyHandleLibrary::SetInt64PropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, int64 Value)
+{
+	if (FInt64Property* IntProp = UE::Blueprint::Private::GetHandleProperty<FInt64Property>(Object, Handle))
+	{
+		IntProp->SetPropertyValue_InContainer(Object, Value);
+	}
+}
+
+void UKismetPropertyHandleLibrary::SetBytePropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, uint8 Value)
+{
+	if (FByteProperty* ByteProp = UE::Blueprint::Private::GetHandleProperty<FByteProperty>(Object, Handle))
+	{
+		ByteProp->SetPropertyValue_InContainer(Object, Value);
+	}
+	else if (FEnumProperty* EnumProp = UE::Blueprint::Private::GetHandleProperty<FEnumProperty>(Object, Handle))
+	{
+		void* PropAddr = EnumProp->ContainerPtrToValuePtr<void>(Object);
+		EnumProp->GetUnderlyingProperty()->SetIntPropertyValue(PropAddr, (int64)Value);
+	}
+}
+
+void UKismetPropertyHandleLibrary::SetFloatPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, float Value)
+{
+	if (FFloatProperty* FloatProp = UE::Blueprint::Private::GetHandleProperty<FFloatProperty>(Object, Handle))
+	{
+		FloatProp->SetPropertyValue_InContainer(Object, Value);
+	}
+}
+
+void UKismetPropertyHandleLibrary::SetDoublePropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, double Value)
+{
+	if (FDoubleProperty* DoubleProp = UE::Blueprint::Private::GetHandleProperty<FDoubleProperty>(Object, Handle))
+	{
+		DoubleProp->SetPropertyValue_InContainer(Object, Value);
+	}
+	else if (FFloatProperty* FloatProp = UE::Blueprint::Private::GetHandleProperty<FFloatProperty>(Object, Handle))
+	{
+		FloatProp->SetPropertyValue_InContainer(Object, static_cast<float>(Value));
+	}
+}
+
+void UKismetPropertyHandleLibrary::SetBoolPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, bool Value)
+{
+	if (FBoolProperty* BoolProp = UE::Blueprint::Private::GetHandleProperty<FBoolProperty>(Object, Handle))
+	{
+		BoolProp->SetPropertyValue_InContainer(Object, Value);
+	}
+}
+
+void UKismetPropertyHandleLibrary::SetObjectPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, UObject* Value)
+{
+	if (FObjectPropertyBase* ObjectProp = UE::Blueprint::Private::GetHandleProperty<FObjectPropertyBase>(Object, Handle))
+	{
+		if (!Value || Value->IsA(ObjectProp->PropertyClass)) // check it's the right type
+		{
+			ObjectProp->SetObjectPropertyValue_InContainer(Object, Value);
+		}
+	}
+}
+
+void UKismetPropertyHandleLibrary::SetStringPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FString& Value)
+{
+	if (FStrProperty* StringProp = UE::Blueprint::Private::GetHandleProperty<FStrProperty>(Object, Handle))
+	{
+		StringProp->SetPropertyValue_InContainer(Object, Value);
+	}
+}
+
+void UKismetPropertyHandleLibrary::SetNamePropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, FName Value)
+{
+	if (FNameProperty* NameProp = UE::Blueprint::Private::GetHandleProperty<FNameProperty>(Object, Handle))
+	{
+		NameProp->SetPropertyValue_InContainer(Object, Value);
+	}
+}
+
+void UKismetPropertyHandleLibrary::SetTextPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FText& Value)
+{
+	if (FTextProperty* TextProp = UE::Blueprint::Private::GetHandleProperty<FTextProperty>(Object, Handle))
+	{
+		TextProp->SetPropertyValue_InContainer(Object, Value);
+	}
+}
+
+void UKismetPropertyHandleLibrary::SetVectorPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FVector& Value)
+{
+	UE::Blueprint::Private::SetStructValueByHandle(Object, Handle, TBaseStructure<FVector>::Get(), Value);
+}
+
+void UKismetPropertyHandleLibrary::SetRotatorPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FRotator& Value)
+{
+	UE::Blueprint::Private::SetStructValueByHandle(Object, Handle, TBaseStructure<FRotator>::Get(), Value);
+}
+
+void UKismetPropertyHandleLibrary::SetLinearColorPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FLinearColor& Value)
+{
+	UE::Blueprint::Private::SetStructValueByHandle(Object, Handle, TBaseStructure<FLinearColor>::Get(), Value);
+}
+
+void UKismetPropertyHandleLibrary::SetColorPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FColor& Value)
+{
+	UE::Blueprint::Private::SetStructValueByHandle(Object, Handle, TBaseStructure<FColor>::Get(), Value);
+}
+
+void UKismetPropertyHandleLibrary::SetTransformPropertyByHandle(UObject* Object, const FResolvedPropertyHandle& Handle, const FTransform& Value)
+{
+	UE::Blueprint::Private::SetStructValueByHandle(Object, Handle, TBaseStructure<FTransform>::Get(), Value);
+}
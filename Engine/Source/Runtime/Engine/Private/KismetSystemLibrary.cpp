@@ -36,6 +36,7 @@
 #include "Net/OnlineEngineInterface.h"
 #include "UObject/FieldPath.h"
 #include "UserActivityTracking.h"
+#include "KismetPropertyCache.h"
 #include "KismetTraceUtils.h"
 #include "Engine/AssetManager.h"
 #include "RHI.h"
@@ -67,7 +68,7 @@ namespace UE::Blueprint::Private
 	{
 		if (OwnerObject != nullptr)
 		{
-			const FStructProperty* DestStructProperty = FindFProperty<FStructProperty>(OwnerObject->GetClass(), StructPropertyName);
+			const FStructProperty* DestStructProperty = FindFPropertyCached<FStructProperty>(OwnerObject->GetClass(), StructPropertyName);
 
 			// SrcStructAddr and SrcStructProperty can be null in certain scenarios.
 			// For example, retrieving an element reference from an array of user structs in BP can result in a null source.
@@ -1082,7 +1083,7 @@ void UKismetSystemLibrary::SetIntPropertyByName(UObject* Object, FName PropertyN
 {
 	if(Object != NULL)
 	{
-		FIntProperty* IntProp = FindFProperty<FIntProperty>(Object->GetClass(), PropertyName);
+		FIntProperty* IntProp = UE::Blueprint::Private::FindFPropertyCached<FIntProperty>(Object->GetClass(), PropertyName);
 		if(IntProp != NULL)
 		{
 			IntProp->SetPropertyValue_InContainer(Object, Value);
@@ -1094,7 +1095,7 @@ void UKismetSystemLibrary::SetInt64PropertyByName(UObject* Object, FName Propert
 {
 	if (Object != NULL)
 	{
-		FInt64Property* IntProp = FindFProperty<FInt64Property>(Object->GetClass(), PropertyName);
+		FInt64Property* IntProp = UE::Blueprint::Private::FindFPropertyCached<FInt64Property>(Object->GetClass(), PropertyName);
 		if (IntProp != NULL)
 		{
 			IntProp->SetPropertyValue_InContainer(Object, Value);
@@ -1106,11 +1107,11 @@ void UKismetSystemLibrary::SetBytePropertyByName(UObject* Object, FName Property
 {
 	if(Object != NULL)
 	{
-		if(FByteProperty* ByteProp = FindFProperty<FByteProperty>(Object->GetClass(), PropertyName))
+		if(FByteProperty* ByteProp = UE::Blueprint::Private::FindFPropertyCached<FByteProperty>(Object->GetClass(), PropertyName))
 		{
 			ByteProp->SetPropertyValue_InContainer(Object, Value);
 		}
-		else if(FEnumProperty* EnumProp = FindFProperty<FEnumProperty>(Object->GetClass(), PropertyName))
+		else if(FEnumProperty* EnumProp = UE::Blueprint::Private::FindFPropertyCached<FEnumProperty>(Object->GetClass(), PropertyName))
 		{
 			void* PropAddr = EnumProp->ContainerPtrToValuePtr<void>(Object);
 			FNumericProperty* UnderlyingProp = EnumProp->GetUnderlyingProperty();
@@ -1123,7 +1124,7 @@ void UKismetSystemLibrary::SetFloatPropertyByName(UObject* Object, FName Propert
 {
 	if(Object != NULL)
 	{
-		FFloatProperty* FloatProp = FindFProperty<FFloatProperty>(Object->GetClass(), PropertyName);
+		FFloatProperty* FloatProp = UE::Blueprint::Private::FindFPropertyCached<FFloatProperty>(Object->GetClass(), PropertyName);
 		if(FloatProp != NULL)
 		{
 			FloatProp->SetPropertyValue_InContainer(Object, Value);
@@ -1135,13 +1136,13 @@ void UKismetSystemLibrary::SetDoublePropertyByName(UObject* Object, FName Proper
 {
 	if (Object != nullptr)
 	{
-		if (FDoubleProperty* DoubleProp = FindFProperty<FDoubleProperty>(Object->GetClass(), PropertyName))
+		if (FDoubleProperty* DoubleProp = UE::Blueprint::Private::FindFPropertyCached<FDoubleProperty>(Object->GetClass(), PropertyName))
 		{
 			DoubleProp->SetPropertyValue_InContainer(Object, Value);
 		}
 		// It's entirely possible that the property refers to a native float property,
 		// so we need to make that check here.
-		else if (FFloatProperty* FloatProp = FindFProperty<FFloatProperty>(Object->GetClass(), PropertyName))
+		else if (FFloatProperty* FloatProp = UE::Blueprint::Private::FindFPropertyCached<FFloatProperty>(Object->GetClass(), PropertyName))
 		{
 			float floatValue = static_cast<float>(Value);
 			FloatProp->SetPropertyValue_InContainer(Object, floatValue);
@@ -1153,7 +1154,7 @@ void UKismetSystemLibrary::SetBoolPropertyByName(UObject* Object, FName Property
 {
 	if(Object != NULL)
 	{
-		FBoolProperty* BoolProp = FindFProperty<FBoolProperty>(Object->GetClass(), PropertyName);
+		FBoolProperty* BoolProp = UE::Blueprint::Private::FindFPropertyCached<FBoolProperty>(Object->GetClass(), PropertyName);
 		if(BoolProp != NULL)
 		{
 			BoolProp->SetPropertyValue_InContainer(Object, Value );
@@ -1165,7 +1166,7 @@ void UKismetSystemLibrary::SetObjectPropertyByName(UObject* Object, FName Proper
 {
 	if (Object)
 	{
-		if (FObjectPropertyBase* ObjectProp = FindFProperty<FObjectPropertyBase>(Object->GetClass(), PropertyName))
+		if (FObjectPropertyBase* ObjectProp = UE::Blueprint::Private::FindFPropertyCached<FObjectPropertyBase>(Object->GetClass(), PropertyName))
 		{
 			if (!Value || Value->IsA(ObjectProp->PropertyClass)) // check it's the right type
 			{
@@ -1179,7 +1180,7 @@ void UKismetSystemLibrary::SetClassPropertyByName(UObject* Object, FName Propert
 {
 	if (Object)
 	{
-		if (FClassProperty* ClassProp = FindFProperty<FClassProperty>(Object->GetClass(), PropertyName))
+		if (FClassProperty* ClassProp = UE::Blueprint::Private::FindFPropertyCached<FClassProperty>(Object->GetClass(), PropertyName))
 		{
 			if (!*Value || Value->IsChildOf(ClassProp->MetaClass)) // check it's the right type
 			{
@@ -1193,7 +1194,7 @@ void UKismetSystemLibrary::SetInterfacePropertyByName(UObject* Object, FName Pro
 {
 	if (Object)
 	{
-		FInterfaceProperty* InterfaceProp = FindFProperty<FInterfaceProperty>(Object->GetClass(), PropertyName);
+		FInterfaceProperty* InterfaceProp = UE::Blueprint::Private::FindFPropertyCached<FInterfaceProperty>(Object->GetClass(), PropertyName);
 		if (InterfaceProp != NULL && Value.GetObject()->GetClass()->ImplementsInterface(InterfaceProp->InterfaceClass)) // check it's the right type
 		{
 			InterfaceProp->SetPropertyValue_InContainer(Object, Value);
@@ -1205,7 +1206,7 @@ void UKismetSystemLibrary::SetStringPropertyByName(UObject* Object, FName Proper
 {
 	if(Object != NULL)
 	{
-		FStrProperty* StringProp = FindFProperty<FStrProperty>(Object->GetClass(), PropertyName);
+		FStrProperty* StringProp = UE::Blueprint::Private::FindFPropertyCached<FStrProperty>(Object->GetClass(), PropertyName);
 		if(StringProp != NULL)
 		{
 			StringProp->SetPropertyValue_InContainer(Object, Value);
@@ -1217,7 +1218,7 @@ void UKismetSystemLibrary::SetNamePropertyByName(UObject* Object, FName Property
 {
 	if(Object != NULL)
 	{
-		FNameProperty* NameProp = FindFProperty<FNameProperty>(Object->GetClass(), PropertyName);
+		FNameProperty* NameProp = UE::Blueprint::Private::FindFPropertyCached<FNameProperty>(Object->GetClass(), PropertyName);
 		if(NameProp != NULL)
 		{
 			NameProp->SetPropertyValue_InContainer(Object, Value);
@@ -1229,7 +1230,7 @@ void UKismetSystemLibrary::SetSoftObjectPropertyByName(UObject* Object, FName Pr
 {
 	if (Object != NULL)
 	{
-		FSoftObjectProperty* ObjectProp = FindFProperty<FSoftObjectProperty>(Object->GetClass(), PropertyName);
+		FSoftObjectProperty* ObjectProp = UE::Blueprint::Private::FindFPropertyCached<FSoftObjectProperty>(Object->GetClass(), PropertyName);
 		const FSoftObjectPtr* SoftObjectPtr = (const FSoftObjectPtr*)(&Value);
 		ObjectProp->SetPropertyValue_InContainer(Object, *SoftObjectPtr);
 	}
@@ -1239,7 +1240,7 @@ void UKismetSystemLibrary::SetFieldPathPropertyByName(UObject* Object, FName Pro
 {
 	if (Object != NULL)
 	{
-		FFieldPathProperty* FieldProp = FindFProperty<FFieldPathProperty>(Object->GetClass(), PropertyName);
+		FFieldPathProperty* FieldProp = UE::Blueprint::Private::FindFPropertyCached<FFieldPathProperty>(Object->GetClass(), PropertyName);
 		const FFieldPath* FieldPathPtr = (const FFieldPath*)(&Value);
 		FieldProp->SetPropertyValue_InContainer(Object, *FieldPathPtr);
 	}
@@ -1279,7 +1280,7 @@ void UKismetSystemLibrary::SetSoftClassPropertyByName(UObject* Object, FName Pro
 {
 	if (Object != NULL)
 	{
-		FSoftClassProperty* ObjectProp = FindFProperty<FSoftClassProperty>(Object->GetClass(), PropertyName);
+		FSoftClassProperty* ObjectProp = UE::Blueprint::Private::FindFPropertyCached<FSoftClassProperty>(Object->GetClass(), PropertyName);
 		const FSoftObjectPtr* SoftObjectPtr = (const FSoftObjectPtr*)(&Value);
 		ObjectProp->SetPropertyValue_InContainer(Object, *SoftObjectPtr);
 	}
@@ -1504,7 +1505,7 @@ void UKismetSystemLibrary::SetTextPropertyByName(UObject* Object, FName Property
 {
 	if(Object != nullptr)
 	{
-		FTextProperty* TextProp = FindFProperty<FTextProperty>(Object->GetClass(), PropertyName);
+		FTextProperty* TextProp = UE::Blueprint::Private::FindFPropertyCached<FTextProperty>(Object->GetClass(), PropertyName);
 		if(TextProp != nullptr)
 		{
 			TextProp->SetPropertyValue_InContainer(Object, Value);
@@ -1517,7 +1518,7 @@ void UKismetSystemLibrary::SetVectorPropertyByName(UObject* Object, FName Proper
 	if(Object != nullptr)
 	{
 		UScriptStruct* VectorStruct = TBaseStructure<FVector>::Get();
-		FStructProperty* VectorProp = FindFProperty<FStructProperty>(Object->GetClass(), PropertyName);
+		FStructProperty* VectorProp = UE::Blueprint::Private::FindFPropertyCached<FStructProperty>(Object->GetClass(), PropertyName);
 		if(VectorProp != nullptr && VectorProp->Struct == VectorStruct)
 		{
 			*VectorProp->ContainerPtrToValuePtr<FVector>(Object) = Value;
@@ -1530,7 +1531,7 @@ void UKismetSystemLibrary::SetVector3fPropertyByName(UObject* Object, FName Prop
 	if (Object != nullptr)
 	{
 		UScriptStruct* Vector3fStruct = TVariantStructure<FVector3f>::Get();
-		FStructProperty* Vector3fProp = FindFProperty<FStructProperty>(Object->GetClass(), PropertyName);
+		FStructProperty* Vector3fProp = UE::Blueprint::Private::FindFPropertyCached<FStructProperty>(Object->GetClass(), PropertyName);
 		if (Vector3fProp != nullptr && Vector3fProp->Struct == Vector3fStruct)
 		{
 			*Vector3fProp->ContainerPtrToValuePtr<FVector3f>(Object) = Value;
@@ -1543,7 +1544,7 @@ void UKismetSystemLibrary::SetRotatorPropertyByName(UObject* Object, FName Prope
 	if(Object != nullptr)
 	{
 		UScriptStruct* RotatorStruct = TBaseStructure<FRotator>::Get();
-		FStructProperty* RotatorProp = FindFProperty<FStructProperty>(Object->GetClass(), PropertyName);
+		FStructProperty* RotatorProp = UE::Blueprint::Private::FindFPropertyCached<FStructProperty>(Object->GetClass(), PropertyName);
 		if(RotatorProp != nullptr && RotatorProp->Struct == RotatorStruct)
 		{
 			*RotatorProp->ContainerPtrToValuePtr<FRotator>(Object) = Value;
@@ -1556,7 +1557,7 @@ void UKismetSystemLibrary::SetLinearColorPropertyByName(UObject* Object, FName P
 	if(Object != nullptr)
 	{
 		UScriptStruct* LinearColorStruct = TBaseStructure<FLinearColor>::Get();
-		FStructProperty* LinearColorProp = FindFProperty<FStructProperty>(Object->GetClass(), PropertyName);
+		FStructProperty* LinearColorProp = UE::Blueprint::Private::FindFPropertyCached<FStructProperty>(Object->GetClass(), PropertyName);
 		if(LinearColorProp != nullptr && LinearColorProp->Struct == LinearColorStruct)
 		{
 			*LinearColorProp->ContainerPtrToValuePtr<FLinearColor>(Object) = Value;
@@ -1569,7 +1570,7 @@ void UKismetSystemLibrary::SetColorPropertyByName(UObject* Object, FName Propert
 	if (Object != nullptr)
 	{
 		UScriptStruct* ColorStruct = TBaseStructure<FColor>::Get();
-		FStructProperty* ColorProp = FindFProperty<FStructProperty>(Object->GetClass(), PropertyName);
+		FStructProperty* ColorProp = UE::Blueprint::Private::FindFPropertyCached<FStructProperty>(Object->GetClass(), PropertyName);
 		if (ColorProp != nullptr && ColorProp->Struct == ColorStruct)
 		{
 			*ColorProp->ContainerPtrToValuePtr<FColor>(Object) = Value;
@@ -1582,7 +1583,7 @@ void UKismetSystemLibrary::SetTransformPropertyByName(UObject* Object, FName Pro
 	if(Object != nullptr)
 	{
 		UScriptStruct* TransformStruct = TBaseStructure<FTransform>::Get();
-		FStructProperty* TransformProp = FindFProperty<FStructProperty>(Object->GetClass(), PropertyName);
+		FStructProperty* TransformProp = UE::Blueprint::Private::FindFPropertyCached<FStructProperty>(Object->GetClass(), PropertyName);
 		if(TransformProp != nullptr && TransformProp->Struct == TransformStruct)
 		{
 			*TransformProp->ContainerPtrToValuePtr<FTransform>(Object) = Value;
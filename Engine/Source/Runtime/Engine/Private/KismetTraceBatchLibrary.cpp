@@ -0,0 +1,393 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Kismet/KismetTraceBatchLibrary.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "KismetTraceUtils.h"
+#include UE_INLINE_GENERATED_CPP_BY_NAME(KismetTraceBatchLibrary)
+
+namespace UE::Blueprint::Private
+{
+	static bool bTraceBatchParallel = true;
+	FAutoConsoleVariableRef CVarTraceBatchParallel(
+		TEXT("bp.TraceBatch.Parallel"),
+		bTraceBatchParallel,
+		TEXT("Whether the batch trace nodes run their traces on worker threads (default: true)."));
+
+	static int32 TraceBatchMinBatchSize = 32;
+	FAutoConsoleVariableRef CVarTraceBatchMinBatchSize(
+		TEXT("bp.TraceBatch.MinBatchSize"),
+		TraceBatchMinBatchSize,
+		TEXT("Minimum number of traces a worker thread runs at once for the batch trace nodes, smaller batches run on the calling thread (default: 32)."));
+
+	/** Start, end and shape of every trace of a batch. Shape arrays hold one element shared by every trace or one element per trace. */
+	struct FTraceBatchDesc
+	{
+		ECollisionShape::Type ShapeType = ECollisionShape::Line;
+		TConstArrayView<FVector> Starts;
+		TConstArrayView<FVector> Ends;
+		TConstArrayView<float> Radii;
+		TConstArrayView<float> HalfHeights;
+		TConstArrayView<FVector> HalfSizes;
+		TConstArrayView<FRotator> Orientations;
+
+		int32 Num() const
+		{
+			return Starts.Num();
+		}
+
+		FCollisionShape GetShape(int32 Index) const
+		{
+			switch (ShapeType)
+			{
+			case ECollisionShape::Sphere:
+				return FCollisionShape::MakeSphere(GetElement(Radii, Index));
+			case ECollisionShape::Box:
+				return FCollisionShape::MakeBox(GetElement(HalfSizes, Index));
+			case ECollisionShape::Capsule:
+				return FCollisionShape::MakeCapsule(GetElement(Radii, Index), GetElement(HalfHeights, Index));
+			default:
+				return FCollisionShape();
+			}
+		}
+
+		FQuat GetRotation(int32 Index) const
+		{
+			return Orientations.IsEmpty() ? FQuat::Identity : GetElement(Orientations, Index).Quaternion();
+		}
+
+		/** Reports arrays of the wrong size to the Blueprint, returns false if the batch can't be traced. */
+		bool Validate(const TCHAR* FunctionName) const
+		{
+			bool bValid = true;
+			auto ValidateShapeArray = [this, FunctionName, &bValid](int32 ArrayNum, const TCHAR* ArrayName, bool bRequired)
+			{
+				if ((ArrayNum == 0 && bRequired) || (ArrayNum > 1 && ArrayNum != Num()))
+				{
+					FFrame::KismetExecutionMessage(*FString::Printf(TEXT("%s: %s has %d elements, expected 1 or %d"), FunctionName, ArrayName, ArrayNum, Num()), ELogVerbosity::Warning);
+					bValid = false;
+				}
+			};
+
+			if (Starts.Num() != Ends.Num())
+			{
+				FFrame::KismetExecutionMessage(*FString::Printf(TEXT("%s: Starts has %d elements but Ends has %d"), FunctionName, Starts.Num(), Ends.Num()), ELogVerbosity::Warning);
+				bValid = false;
+			}
+			ValidateShapeArray(Radii.Num(), TEXT("Radii"), ShapeType == ECollisionShape::Sphere || ShapeType == ECollisionShape::Capsule);
+			ValidateShapeArray(HalfHeights.Num(), TEXT("HalfHeights"), ShapeType == ECollisionShape::Capsule);
+			ValidateShapeArray(HalfSizes.Num(), TEXT("HalfSizes"), ShapeType == ECollisionShape::Box);
+			ValidateShapeArray(Orientations.Num(), TEXT("Orientations"), false);
+			return bValid;
+		}
+
+	private:
+		template<typename ElementType>
+		static const ElementType& GetElement(TConstArrayView<ElementType> Array, int32 Index)
+		{
+			return Array.Num() == 1 ? Array[0] : Array[Index];
+		}
+	};
+
+	/** Same queries as the per-call trace nodes, line traces go through the line trace path rather than a zero extent sweep. */
+	static void TraceSingle(const UWorld& World, const FTraceBatchDesc& Desc, int32 Index, ECollisionChannel Channel, const FCollisionQueryParams& Params, FHitResult& OutHit)
+	{
+		if (Desc.ShapeType == ECollisionShape::Line)
+		{
+			World.LineTraceSingleByChannel(OutHit, Desc.Starts[Index], Desc.Ends[Index], Channel, Params);
+		}
+		else
+		{
+			World.SweepSingleByChannel(OutHit, Desc.Starts[Index], Desc.Ends[Index], Desc.GetRotation(Index), Channel, Desc.GetShape(Index), Params);
+		}
+	}
+
+	static void TraceMulti(const UWorld& World, const FTraceBatchDesc& Desc, int32 Index, ECollisionChannel Channel, const FCollisionQueryParams& Params, TArray<FHitResult>& OutHits)
+	{
+		if (Desc.ShapeType == ECollisionShape::Line)
+		{
+			World.LineTraceMultiByChannel(OutHits, Desc.Starts[Index], Desc.Ends[Index], Channel, Params);
+		}
+		else
+		{
+			World.SweepMultiByChannel(OutHits, Desc.Starts[Index], Desc.Ends[Index], Desc.GetRotation(Index), Channel, Desc.GetShape(Index), Params);
+		}
+	}
+
+	static EParallelForFlags GetTraceBatchParallelForFlags()
+	{
+		return bTraceBatchParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+	}
+
+	static UWorld* GetTraceBatchWorld(const UObject* WorldContextObject, const FTraceBatchDesc& Desc, const TCHAR* FunctionName)
+	{
+		return Desc.Validate(FunctionName) ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	}
+
+	static int32 TraceSingleBatch(const UObject* WorldContextObject, const FTraceBatchDesc& Desc, FName TraceTag, ETraceTypeQuery TraceChannel, bool bTraceComplex,
+		const TArray<AActor*>& ActorsToIgnore, bool bIgnoreSelf, TArray<FHitResult>& OutHits)
+	{
+		OutHits.Reset();
+
+		const UWorld* World = GetTraceBatchWorld(WorldContextObject, Desc, *TraceTag.ToString());
+		if (!World)
+		{
+			return 0;
+		}
+
+		// Ignored actors are resolved once for the whole batch, every worker shares the same params
+		const FCollisionQueryParams Params = ConfigureCollisionParams(TraceTag, bTraceComplex, ActorsToIgnore, bIgnoreSelf, WorldContextObject);
+		const ECollisionChannel CollisionChannel = UEngineTypes::ConvertToCollisionChannel(TraceChannel);
+
+		OutHits.SetNum(Desc.Num());
+		ParallelFor(TEXT("TraceSingleBatch"), Desc.Num(), TraceBatchMinBatchSize, [World, &Desc, CollisionChannel, &Params, &OutHits](int32 Index)
+		{
+			TraceSingle(*World, Desc, Index, CollisionChannel, Params, OutHits[Index]);
+		}, GetTraceBatchParallelForFlags());
+
+		int32 NumHitTraces = 0;
+		for (const FHitResult& Hit : OutHits)
+		{
+			NumHitTraces += Hit.bBlockingHit ? 1 : 0;
+		}
+		return NumHitTraces;
+	}
+
+	static int32 TraceMultiBatch(const UObject* WorldContextObject, const FTraceBatchDesc& Desc, FName TraceTag, ETraceTypeQuery TraceChannel, bool bTraceComplex,
+		const TArray<AActor*>& ActorsToIgnore, bool bIgnoreSelf, TArray<FHitResult>& OutHits, TArray<int32>& OutNumHits)
+	{
+		OutHits.Reset();
+		OutNumHits.Reset();
+
+		const UWorld* World = GetTraceBatchWorld(WorldContextObject, Desc, *TraceTag.ToString());
+		if (!World)
+		{
+			return 0;
+		}
+
+		const FCollisionQueryParams Params = ConfigureCollisionParams(TraceTag, bTraceComplex, ActorsToIgnore, bIgnoreSelf, WorldContextObject);
+		const ECollisionChannel CollisionChannel = UEngineTypes::ConvertToCollisionChannel(TraceChannel);
+
+		TArray<TArray<FHitResult>> TraceHits;
+		TraceHits.SetNum(Desc.Num());
+		ParallelFor(TEXT("TraceMultiBatch"), Desc.Num(), TraceBatchMinBatchSize, [World, &Desc, CollisionChannel, &Params, &TraceHits](int32 Index)
+		{
+			TraceMulti(*World, Desc, Index, CollisionChannel, Params, TraceHits[Index]);
+		}, GetTraceBatchParallelForFlags());
+
+		int32 NumTotalHits = 0;
+		for (const TArray<FHitResult>& Hits : TraceHits)
+		{
+			NumTotalHits += Hits.Num();
+		}
+
+		int32 NumBlockedTraces = 0;
+		OutHits.Reserve(NumTotalHits);
+		OutNumHits.SetNumUninitialized(TraceHits.Num());
+		for (int32 Index = 0; Index < TraceHits.Num(); ++Index)
+		{
+			// Multi traces end with their blocking hit, if any
+			NumBlockedTraces += (TraceHits[Index].Num() > 0 && TraceHits[Index].Last().bBlockingHit) ? 1 : 0;
+			OutNumHits[Index] = TraceHits[Index].Num();
+			OutHits.Append(MoveTemp(TraceHits[Index]));
+		}
+		return NumBlockedTraces;
+	}
+}
+
+int32 UKismetTraceBatchLibrary::LineTraceSingleBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, bool bIgnoreSelf)
+{
+	using namespace UE::Blueprint::Private;
+
+	static const FName LineTraceSingleBatchName(TEXT("LineTraceSingleBatch"));
+	const FTraceBatchDesc Desc{ ECollisionShape::Line, Starts, Ends };
+	return TraceSingleBatch(WorldContextObject, Desc, LineTraceSingleBatchName, TraceChannel, bTraceComplex, ActorsToIgnore, bIgnoreSelf, OutHits);
+}
+
+int32 UKismetTraceBatchLibrary::LineTraceMultiBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, TArray<int32>& OutNumHits, bool bIgnoreSelf)
+{
+	using namespace UE::Blueprint::Private;
+
+	static const FName LineTraceMultiBatchName(TEXT("LineTraceMultiBatch"));
+	const FTraceBatchDesc Desc{ ECollisionShape::Line, Starts, Ends };
+	return TraceMultiBatch(WorldContextObject, Desc, LineTraceMultiBatchName, TraceChannel, bTraceComplex, ActorsToIgnore, bIgnoreSelf, OutHits, OutNumHits);
+}
+
+int32 UKismetTraceBatchLibrary::SphereTraceSingleBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<float>& Radii, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, bool bIgnoreSelf)
+{
+	using namespace UE::Blueprint::Private;
+
+	static const FName SphereTraceSingleBatchName(TEXT("SphereTraceSingleBatch"));
+	FTraceBatchDesc Desc{ ECollisionShape::Sphere, Starts, Ends };
+	Desc.Radii = Radii;
+	return TraceSingleBatch(WorldContextObject, Desc, SphereTraceSingleBatchName, TraceChannel, bTraceComplex, ActorsToIgnore, bIgnoreSelf, OutHits);
+}
+
+int32 UKismetTraceBatchLibrary::SphereTraceMultiBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<float>& Radii, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, TArray<int32>& OutNumHits, bool bIgnoreSelf)
+{
+	using namespace UE::Blueprint::Private;
+
+	static const FName SphereTraceMultiBatchName(TEXT("SphereTraceMultiBatch"));
+	FTraceBatchDesc Desc{ ECollisionShape::Sphere, Starts, Ends };
+	Desc.Radii = Radii;
+	return TraceMultiBatch(WorldContextObject, Desc, SphereTraceMultiBatchName, TraceChannel, bTraceComplex, ActorsToIgnore, bIgnoreSelf, OutHits, OutNumHits);
+}
+
+int32 UKismetTraceBatchLibrary::BoxTraceSingleBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<FVector>& HalfSizes, const TArray<FRotator>& Orientations, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, bool bIgnoreSelf)
+{
+	using namespace UE::Blueprint::Private;
+
+	static const FName BoxTraceSingleBatchName(TEXT("BoxTraceSingleBatch"));
+	FTraceBatchDesc Desc{ ECollisionShape::Box, Starts, Ends };
+	Desc.HalfSizes = HalfSizes;
+	Desc.Orientations = Orientations;
+	return TraceSingleBatch(WorldContextObject, Desc, BoxTraceSingleBatchName, TraceChannel, bTraceComplex, ActorsToIgnore, bIgnoreSelf, OutHits);
+}
+
+int32 UKismetTraceBatchLibrary::BoxTraceMultiBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<FVector>& HalfSizes, const TArray<FRotator>& Orientations, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, TArray<int32>& OutNumHits, bool bIgnoreSelf)
+{
+	using namespace UE::Blueprint::Private;
+
+	static const FName BoxTraceMultiBatchName(TEXT("BoxTraceMultiBatch"));
+	FTraceBatchDesc Desc{ ECollisionShape::Box, Starts, Ends };
+	Desc.HalfSizes = HalfSizes;
+	Desc.Orientations = Orientations;
+	return TraceMultiBatch(WorldContextObject, Desc, BoxTraceMultiBatchName, TraceChannel, bTraceComplex, ActorsToIgnore, bIgnoreSelf, OutHits, OutNumHits);
+}
+
+int32 UKismetTraceBatchLibrary::CapsuleTraceSingleBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<float>& Radii, const TArray<float>& HalfHeights, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, bool bIgnoreSelf)
+{
+	using namespace UE::Blueprint::Private;
+
+	static const FName CapsuleTraceSingleBatchName(TEXT("CapsuleTraceSingleBatch"));
+	FTraceBatchDesc Desc{ ECollisionShape::Capsule, Starts, Ends };
+	Desc.Radii = Radii;
+	Desc.HalfHeights = HalfHeights;
+	return TraceSingleBatch(WorldContextObject, Desc, CapsuleTraceSingleBatchName, TraceChannel, bTraceComplex, ActorsToIgnore, bIgnoreSelf, OutHits);
+}
+
+int32 UKismetTraceBatchLibrary::CapsuleTraceMultiBatch(const UObject* WorldContextObject, const TArray<FVector>& Starts, const TArray<FVector>& Ends, const TArray<float>& Radii, const TArray<float>& HalfHeights, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, TArray<FHitResult>& OutHits, TArray<int32>& OutNumHits, bool bIgnoreSelf)
+{
+	using namespace UE::Blueprint::Private;
+
+	static const FName CapsuleTraceMultiBatchName(TEXT("CapsuleTraceMultiBatch"));
+	FTraceBatchDesc Desc{ ECollisionShape::Capsule, Starts, Ends };
+	Desc.Radii = Radii;
+	Desc.HalfHeights = HalfHeights;
+	return TraceMultiBatch(WorldContextObject, Desc, CapsuleTraceMultiBatchName, TraceChannel, bTraceComplex, ActorsToIgnore, bIgnoreSelf, OutHits, OutNumHits);
+}
+
+UAsyncTraceBatchAction* UAsyncTraceBatchAction::CreateAction(const UObject* WorldContextObject, FName TraceTag, ECollisionShape::Type InShapeType, const TArray<FVector>& InStarts, const TArray<FVector>& InEnds,
+	ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, bool bInMultiHit, bool bIgnoreSelf)
+{
+	UAsyncTraceBatchAction* Action = NewObject<UAsyncTraceBatchAction>();
+	Action->World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	Action->QueryParams = ConfigureCollisionParams(TraceTag, bTraceComplex, ActorsToIgnore, bIgnoreSelf, WorldContextObject);
+	Action->CollisionChannel = UEngineTypes::ConvertToCollisionChannel(TraceChannel);
+	Action->ShapeType = InShapeType;
+	Action->bMultiHit = bInMultiHit;
+	Action->Starts = InStarts;
+	Action->Ends = InEnds;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+UAsyncTraceBatchAction* UAsyncTraceBatchAction::AsyncLineTraceBatch(const UObject* WorldContextObject, const TArray<FVector>& InStarts, const TArray<FVector>& InEnds, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, bool bInMultiHit, bool bIgnoreSelf)
+{
+	static const FName AsyncLineTraceBatchName(TEXT("AsyncLineTraceBatch"));
+	return CreateAction(WorldContextObject, AsyncLineTraceBatchName, ECollisionShape::Line, InStarts, InEnds, TraceChannel, bTraceComplex, ActorsToIgnore, bInMultiHit, bIgnoreSelf);
+}
+
+UAsyncTraceBatchAction* UAsyncTraceBatchAction::AsyncSphereTraceBatch(const UObject* WorldContextObject, const TArray<FVector>& InStarts, const TArray<FVector>& InEnds, const TArray<float>& InRadii, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, bool bInMultiHit, bool bIgnoreSelf)
+{
+	static const FName AsyncSphereTraceBatchName(TEXT("AsyncSphereTraceBatch"));
+	UAsyncTraceBatchAction* Action = CreateAction(WorldContextObject, AsyncSphereTraceBatchName, ECollisionShape::Sphere, InStarts, InEnds, TraceChannel, bTraceComplex, ActorsToIgnore, bInMultiHit, bIgnoreSelf);
+	Action->Radii = InRadii;
+	return Action;
+}
+
+UAsyncTraceBatchAction* UAsyncTraceBatchAction::AsyncBoxTraceBatch(const UObject* WorldContextObject, const TArray<FVector>& InStarts, const TArray<FVector>& InEnds, const TArray<FVector>& InHalfSizes, const TArray<FRotator>& InOrientations, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, bool bInMultiHit, bool bIgnoreSelf)
+{
+	static const FName AsyncBoxTraceBatchName(TEXT("AsyncBoxTraceBatch"));
+	UAsyncTraceBatchAction* Action = CreateAction(WorldContextObject, AsyncBoxTraceBatchName, ECollisionShape::Box, InStarts, InEnds, TraceChannel, bTraceComplex, ActorsToIgnore, bInMultiHit, bIgnoreSelf);
+	Action->HalfSizes = InHalfSizes;
+	Action->Orientations = InOrientations;
+	return Action;
+}
+
+UAsyncTraceBatchAction* UAsyncTraceBatchAction::AsyncCapsuleTraceBatch(const UObject* WorldContextObject, const TArray<FVector>& InStarts, const TArray<FVector>& InEnds, const TArray<float>& InRadii, const TArray<float>& InHalfHeights, ETraceTypeQuery TraceChannel, bool bTraceComplex, const TArray<AActor*>& ActorsToIgnore, bool bInMultiHit, bool bIgnoreSelf)
+{
+	static const FName AsyncCapsuleTraceBatchName(TEXT("AsyncCapsuleTraceBatch"));
+	UAsyncTraceBatchAction* Action = CreateAction(WorldContextObject, AsyncCapsuleTraceBatchName, ECollisionShape::Capsule, InStarts, InEnds, TraceChannel, bTraceComplex, ActorsToIgnore, bInMultiHit, bIgnoreSelf);
+	Action->Radii = InRadii;
+	Action->HalfHeights = InHalfHeights;
+	return Action;
+}
+
+void UAsyncTraceBatchAction::Activate()
+{
+	using namespace UE::Blueprint::Private;
+
+	FTraceBatchDesc Desc{ ShapeType, Starts, Ends, Radii, HalfHeights, HalfSizes, Orientations };
+	UWorld* TraceWorld = World.Get();
+	if (!TraceWorld || !Desc.Validate(*QueryParams.TraceTag.ToString()) || Desc.Num() == 0)
+	{
+		Complete();
+		return;
+	}
+
+	TraceHits.SetNum(Desc.Num());
+	NumPendingTraces = Desc.Num();
+	TraceDelegate.BindUObject(this, &UAsyncTraceBatchAction::OnTraceCompleted);
+
+	// The trace index travels as user data, results come back in whichever order the async trace tasks finish
+	const EAsyncTraceType TraceType = bMultiHit ? EAsyncTraceType::Multi : EAsyncTraceType::Single;
+	for (int32 Index = 0; Index < Desc.Num(); ++Index)
+	{
+		if (ShapeType == ECollisionShape::Line)
+		{
+			TraceWorld->AsyncLineTraceByChannel(TraceType, Starts[Index], Ends[Index], CollisionChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, (uint32)Index);
+		}
+		else
+		{
+			TraceWorld->AsyncSweepByChannel(TraceType, Starts[Index], Ends[Index], Desc.GetRotation(Index), CollisionChannel, Desc.GetShape(Index), QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, (uint32)Index);
+		}
+	}
+}
+
+void UAsyncTraceBatchAction::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Data)
+{
+	check(TraceHits.IsValidIndex(Data.UserData));
+	TraceHits[Data.UserData] = MoveTemp(Data.OutHits);
+
+	if (--NumPendingTraces == 0)
+	{
+		Complete();
+	}
+}
+
+void UAsyncTraceBatchAction::Complete()
+{
+	int32 NumTotalHits = 0;
+	for (const TArray<FHitResult>& Hits : TraceHits)
+	{
+		NumTotalHits += Hits.Num();
+	}
+
+	TArray<FHitResult> Hits;
+	TArray<int32> NumHits;
+	Hits.Reserve(NumTotalHits);
+	NumHits.SetNumUninitialized(TraceHits.Num());
+	for (int32 Index = 0; Index < TraceHits.Num(); ++Index)
+	{
+		NumHits[Index] = TraceHits[Index].Num();
+		Hits.Append(MoveTemp(TraceHits[Index]));
+	}
+	TraceHits.Empty();
+	TraceDelegate.Unbind();
+
+	OnCompleted.Broadcast(Hits, NumHits);
+	SetReadyToDestroy();
+}
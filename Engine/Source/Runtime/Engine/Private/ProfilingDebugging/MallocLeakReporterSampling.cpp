@@ -0,0 +1,127 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "ProfilingDebugging/MallocLeakReporter.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/MallocLeakSampler.h"
+#include "Misc/OutputDeviceArchiveWrapper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMallocLeakSampling, Log, All);
+
+namespace UE::MallocLeakReporter::Private
+{
+	/** Puts the sampling proxy in front of GMalloc the first time sampling starts, it stays there and costs a flag check when not sampling. */
+	static void InstallSamplingProxy()
+	{
+		check(IsInGameThread());
+		static bool bInstalled = false;
+		if (!bInstalled)
+		{
+			GMalloc = new FMallocLeakSamplingProxy(GMalloc);
+			bInstalled = true;
+		}
+	}
+}
+
+void FMallocLeakReporter::StartSampling(int32 SampleIntervalKB, float ReportOnTime)
+{
+	UE::MallocLeakReporter::Private::InstallSamplingProxy();
+
+	const uint64 SampleInterval = uint64(FMath::Max(1, SampleIntervalKB)) * 1024;
+	FMallocLeakSampler::Get().Start(SampleInterval);
+	UE_LOG(LogMallocLeakSampling, Log, TEXT("Sampling one allocation every %d KB allocated"), FMath::Max(1, SampleIntervalKB));
+
+	FTSTicker::GetCoreTicker().RemoveTicker(SampledReportTicker);
+	SampledReportTicker.Reset();
+	if (ReportOnTime > 0.0f)
+	{
+		SampledReportTicker = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float)
+		{
+			WriteSampledReport(TEXT("Sampled"));
+			return true;
+		}), ReportOnTime);
+	}
+}
+
+void FMallocLeakReporter::StopSampling()
+{
+	FMallocLeakSampler::Get().Stop();
+	FTSTicker::GetCoreTicker().RemoveTicker(SampledReportTicker);
+	SampledReportTicker.Reset();
+}
+
+void FMallocLeakReporter::ClearSamples()
+{
+	FMallocLeakSampler::Get().Clear();
+	SampledReportCount = 0;
+}
+
+bool FMallocLeakReporter::IsSampling() const
+{
+	return FMallocLeakSampler::Get().IsSampling();
+}
+
+int32 FMallocLeakReporter::WriteSampledReport(const TCHAR* ReportName, int32 FilterSizeKB)
+{
+	FMallocLeakSampler& Sampler = FMallocLeakSampler::Get();
+	const uint64 MinEstimatedBytes = uint64(FMath::Max(0, FilterSizeKB)) * 1024;
+
+	const FString ReportPath = FPaths::ProfilingDir() / FString::Printf(TEXT("MemLeaks/%s-%d.txt"), ReportName, SampledReportCount++);
+	TUniquePtr<FArchive> FileArchive(IFileManager::Get().CreateDebugFileWriter(*ReportPath));
+	if (!FileArchive)
+	{
+		UE_LOG(LogMallocLeakSampling, Warning, TEXT("Failed to open %s"), *ReportPath);
+		return 0;
+	}
+
+	FOutputDeviceArchiveWrapper FileWrapper(FileArchive.Get());
+	Sampler.DumpLiveCallstacks(FileWrapper, MinEstimatedBytes);
+	FileWrapper.TearDown();
+
+	const int32 NumCallstacks = Sampler.GetLiveCallstacks(MinEstimatedBytes).Num();
+	UE_LOG(LogMallocLeakSampling, Log, TEXT("Wrote %d sampled callstacks, %.2f MB estimated alive, to %s"),
+		NumCallstacks, Sampler.GetEstimatedLiveBytes() / (1024.0 * 1024.0), *FPaths::ConvertRelativePathToFull(ReportPath));
+	return NumCallstacks;
+}
+
+static FAutoConsoleCommand MallocLeakSampleStartCommand(
+	TEXT("mallocleak.sample.start"),
+	TEXT("Starts sampling allocations for leaks. interval=KB samples one allocation every KB allocated (default 512), report=secs writes a report every secs."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString Params = FString::Join(Args, TEXT(" "));
+		int32 SampleIntervalKB = 512;
+		float ReportOnTime = 0.0f;
+		FParse::Value(*Params, TEXT("interval="), SampleIntervalKB);
+		FParse::Value(*Params, TEXT("report="), ReportOnTime);
+		FMallocLeakReporter::Get().StartSampling(SampleIntervalKB, ReportOnTime);
+	}));
+
+static FAutoConsoleCommand MallocLeakSampleReportCommand(
+	TEXT("mallocleak.sample.report"),
+	TEXT("Writes the sampled allocations still alive with their estimated sizes. filter=KB leaves out callstacks with less estimated KB alive."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString Params = FString::Join(Args, TEXT(" "));
+		int32 FilterSizeKB = 0;
+		FParse::Value(*Params, TEXT("filter="), FilterSizeKB);
+		FMallocLeakReporter::Get().WriteSampledReport(TEXT("Sampled"), FilterSizeKB);
+	}));
+
+static FAutoConsoleCommand MallocLeakSampleStopCommand(
+	TEXT("mallocleak.sample.stop"),
+	TEXT("Stops sampling allocations. The samples are kept for reports and their frees are still tracked until mallocleak.sample.clear."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FMallocLeakReporter::Get().StopSampling();
+	}));
+
+static FAutoConsoleCommand MallocLeakSampleClearCommand(
+	TEXT("mallocleak.sample.clear"),
+	TEXT("Forgets every sampled allocation."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FMallocLeakReporter::Get().ClearSamples();
+	}));
@@ -1,12 +1,23 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 /*=============================================================================
-	ShaderCompilerMemoryLimit.cpp: Wrapper for Windows specific Job Object functionality.
+	ShaderCompilerMemoryLimit.cpp: Wrapper for Windows specific Job Object functionality and Linux cgroups.
 =============================================================================*/
 
 #include "ShaderCompilerMemoryLimit.h"
 #include "HAL/ConsoleManager.h"
 
+#if PLATFORM_LINUX
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 #if PLATFORM_WINDOWS
 
@@ -155,7 +166,7 @@ void FWindowsResourceRestrictedJobObject::CreateAndLinkCompletionPort()
 	}
 }
 
-#else
+#elif !PLATFORM_LINUX
 
 FGenericResourceRestrictedJobObject::FGenericResourceRestrictedJobObject(const FString& JobName, int32 InitialJobMemoryLimitMiB)
 {
@@ -184,5 +195,380 @@ bool FGenericResourceRestrictedJobObject::QueryLimitViolationStatus(FJobObjectLi
 
 #endif // PLATFORM_WINDOWS
 
+#if PLATFORM_LINUX
+
+namespace UE::ShaderCompiler::Private
+{
+	static FString GLinuxCgroupRoot;
+	static FAutoConsoleVariableRef CVarLinuxCgroupRoot(
+		TEXT("r.ShaderCompiler.Linux.CgroupRoot"),
+		GLinuxCgroupRoot,
+		TEXT("cgroup v2 directory below which ShaderCompileWorker groups are created, e.g. /sys/fs/cgroup/user.slice/user-1000.slice/user@1000.service/scw.slice.\n")
+		TEXT("Must be delegated to the current user. When empty, groups are created below the cgroup of this process."),
+		ECVF_ReadOnly);
+
+	static int32 GLinuxMemoryHighPercent = 85;
+	static FAutoConsoleVariableRef CVarLinuxMemoryHighPercent(
+		TEXT("r.ShaderCompiler.Linux.MemoryHighPercent"),
+		GLinuxMemoryHighPercent,
+		TEXT("memory.high of the ShaderCompileWorker cgroup as a percentage of its memory limit. Going over it makes the kernel reclaim memory from the workers and throttles job dispatch (default 85)."),
+		ECVF_Default);
+
+	static int32 GLinuxCpuWeight = 50;
+	static FAutoConsoleVariableRef CVarLinuxCpuWeight(
+		TEXT("r.ShaderCompiler.Linux.CpuWeight"),
+		GLinuxCpuWeight,
+		TEXT("cpu.weight of the ShaderCompileWorker cgroup, 1 to 10000 where 100 is the default for other processes. 0 leaves it unchanged (default 50)."),
+		ECVF_Default);
+
+	static float GLinuxDispatchRecoverySeconds = 10.0f;
+	static FAutoConsoleVariableRef CVarLinuxDispatchRecoverySeconds(
+		TEXT("r.ShaderCompiler.Linux.DispatchRecoverySeconds"),
+		GLinuxDispatchRecoverySeconds,
+		TEXT("After memory pressure halved the number of ShaderCompileWorkers being dispatched to, one more worker is allowed every this many seconds without pressure (default 10)."),
+		ECVF_Default);
+
+	FString ParseUnifiedCgroupPath(const FString& ProcCgroupContents)
+	{
+		TArray<FString> Lines;
+		ProcCgroupContents.ParseIntoArrayLines(Lines);
+		for (const FString& Line : Lines)
+		{
+			// The unified hierarchy is the "0::<path>" entry
+			if (Line.StartsWith(TEXT("0::")))
+			{
+				FString Path = FString(TEXT("/sys/fs/cgroup")) / Line.RightChop(3).TrimEnd();
+				Path.RemoveFromEnd(TEXT("/"));
+				return Path;
+			}
+		}
+		return FString();
+	}
+
+	void ParseMemoryEvents(const FString& Events, uint64& InOutNumHighEvents, uint64& InOutNumMaxEvents)
+	{
+		TArray<FString> Lines;
+		Events.ParseIntoArrayLines(Lines);
+		for (const FString& Line : Lines)
+		{
+			FString Key, Value;
+			if (Line.Split(TEXT(" "), &Key, &Value))
+			{
+				if (Key == TEXT("high"))
+				{
+					InOutNumHighEvents = FCString::Strtoui64(*Value, nullptr, 10);
+				}
+				else if (Key == TEXT("max") || Key == TEXT("oom"))
+				{
+					InOutNumMaxEvents = FMath::Max(InOutNumMaxEvents, FCString::Strtoui64(*Value, nullptr, 10));
+				}
+			}
+		}
+	}
+
+	TArray<TPair<const TCHAR*, int64>, TInlineAllocator<2>> GetMemoryLimitWrites(int64 PreviousMemoryMax, int64 MemoryMax, int32 MemoryHighPercent)
+	{
+		const TPair<const TCHAR*, int64> High(TEXT("memory.high"), MemoryMax / 100 * FMath::Clamp(MemoryHighPercent, 1, 100));
+		const TPair<const TCHAR*, int64> Max(TEXT("memory.max"), MemoryMax);
+
+		TArray<TPair<const TCHAR*, int64>, TInlineAllocator<2>> Writes;
+		if (MemoryMax < PreviousMemoryMax)
+		{
+			// Lowering: bring memory.high under the new memory.max first so reclaim starts before the hard limit moves
+			Writes.Add(High);
+			Writes.Add(Max);
+		}
+		else
+		{
+			// Raising: the new memory.high would be above the old memory.max until memory.max is written
+			Writes.Add(Max);
+			Writes.Add(High);
+		}
+		return Writes;
+	}
+
+	/** Returns the cgroup v2 path of this process from /proc/self/cgroup, e.g. /sys/fs/cgroup/user.slice/... */
+	static FString GetOwnCgroupPath()
+	{
+		FString Contents;
+		if (FFileHelper::LoadFileToString(Contents, TEXT("/proc/self/cgroup")))
+		{
+			return ParseUnifiedCgroupPath(Contents);
+		}
+		return FString();
+	}
+
+	static bool WriteCgroupFile(const FString& Path, const FString& Value)
+	{
+		// cgroup interface files must be written with a single write() call and must not be truncated or created
+		const int Handle = open(TCHAR_TO_UTF8(*Path), O_WRONLY | O_CLOEXEC);
+		if (Handle < 0)
+		{
+			return false;
+		}
+		const FTCHARToUTF8 Utf8Value(*Value);
+		const bool bSuccess = write(Handle, Utf8Value.Get(), Utf8Value.Length()) == Utf8Value.Length();
+		const int WriteErrno = errno;
+		close(Handle);
+		errno = WriteErrno;
+		return bSuccess;
+	}
+
+	static FString GetErrnoMessage()
+	{
+		return FString(UTF8_TO_TCHAR(strerror(errno)));
+	}
+}
+
+FLinuxResourceRestrictedJobObject::FLinuxResourceRestrictedJobObject(const FString& InJobName, int32 InitialJobMemoryLimitMiB) :
+	JobName(InJobName)
+{
+	using namespace UE::ShaderCompiler::Private;
+
+	const FString OwnPath = GetOwnCgroupPath();
+	FString RootPath = GLinuxCgroupRoot.IsEmpty() ? OwnPath : GLinuxCgroupRoot;
+	RootPath.RemoveFromEnd(TEXT("/"));
+	if (RootPath.IsEmpty() || access(TCHAR_TO_UTF8(*(RootPath / TEXT("cgroup.controllers"))), F_OK) != 0)
+	{
+		UE_LOG(LogLinux, Warning, TEXT("cgroup v2 hierarchy not found, ShaderCompileWorker processes will not be resource restricted"));
+		return;
+	}
+
+	// Controllers can only be enabled for the children of a group that has no processes in it (the "no internal processes" rule),
+	// so when the workers go below our own group, move this process into a leaf next to them first
+	const uint32 ProcessId = FPlatformProcess::GetCurrentProcessId();
+	if (RootPath == OwnPath)
+	{
+		const FString LeafPath = RootPath / FString::Printf(TEXT("ShaderCompilerHost-%u"), ProcessId);
+		if ((mkdir(TCHAR_TO_UTF8(*LeafPath), 0755) != 0 && errno != EEXIST) ||
+			!WriteCgroupFile(LeafPath / TEXT("cgroup.procs"), FString::FromInt(ProcessId)))
+		{
+			UE_LOG(LogLinux, Warning, TEXT("Failed to move this process into leaf cgroup \"%s\": %s. Set r.ShaderCompiler.Linux.CgroupRoot to a delegated cgroup without processes in it."),
+				*LeafPath, *GetErrnoMessage());
+			return;
+		}
+	}
 
+	// Child groups only get the memory and cpu interface files if the controllers are enabled for the root's children.
+	// This still fails with EBUSY when other processes are left in the root.
+	if (!WriteCgroupFile(RootPath / TEXT("cgroup.subtree_control"), TEXT("+memory +cpu")))
+	{
+		UE_LOG(LogLinux, Warning, TEXT("Failed to enable memory and cpu controllers in \"%s\": %s. Set r.ShaderCompiler.Linux.CgroupRoot to a delegated cgroup without processes in it."),
+			*RootPath, *GetErrnoMessage());
+		return;
+	}
+
+	// Job names are shared by concurrent cooks on the same host, so make the group unique to this process
+	const FString CandidatePath = RootPath / FString::Printf(TEXT("%s-%u"), *FPaths::MakeValidFileName(JobName, TEXT('_')), ProcessId);
+	if (mkdir(TCHAR_TO_UTF8(*CandidatePath), 0755) != 0 && errno != EEXIST)
+	{
+		UE_LOG(LogLinux, Warning, TEXT("Failed to create cgroup \"%s\": %s"), *CandidatePath, *GetErrnoMessage());
+		return;
+	}
+	GroupPath = CandidatePath;
+
+	if (GLinuxCpuWeight > 0)
+	{
+		WriteGroupFile(TEXT("cpu.weight"), FString::FromInt(FMath::Clamp(GLinuxCpuWeight, 1, 10000)));
+	}
+
+	// memory.events is modified whenever one of its counters changes, which is how the kernel notifies about pressure
+	// Without the watch memory.events is polled instead
+	InotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (InotifyHandle >= 0 && inotify_add_watch(InotifyHandle, TCHAR_TO_UTF8(*(GroupPath / TEXT("memory.events"))), IN_MODIFY) < 0)
+	{
+		close(InotifyHandle);
+		InotifyHandle = -1;
+	}
+	if (InotifyHandle < 0)
+	{
+		UE_LOG(LogLinux, Warning, TEXT("Failed to watch memory events of cgroup \"%s\": %s"), *GroupPath, *GetErrnoMessage());
+	}
+	UpdateMemoryEvents();
+
+	if (InitialJobMemoryLimitMiB > 0)
+	{
+		SetMemoryLimit(InitialJobMemoryLimitMiB);
+	}
+}
+
+FLinuxResourceRestrictedJobObject::~FLinuxResourceRestrictedJobObject()
+{
+	if (InotifyHandle >= 0)
+	{
+		close(InotifyHandle);
+	}
+	if (!GroupPath.IsEmpty())
+	{
+		// Only succeeds once all workers have exited, a leftover empty group is harmless and reused by name.
+		// This process stays in its leaf group, moving it back would break the no internal processes rule while the workers' group exists.
+		rmdir(TCHAR_TO_UTF8(*GroupPath));
+	}
+}
+
+void FLinuxResourceRestrictedJobObject::AssignProcess(const FProcHandle& Process)
+{
+	if (IsValid())
+	{
+		const FProcState* ProcessInfo = Process.GetProcessInfo();
+		if (ProcessInfo == nullptr || !WriteGroupFile(TEXT("cgroup.procs"), FString::FromInt(ProcessInfo->GetProcessId())))
+		{
+			UE_LOG(LogLinux, Warning, TEXT("Failed to assign process to cgroup \"%s\": %s"), *GroupPath, *UE::ShaderCompiler::Private::GetErrnoMessage());
+		}
+	}
+}
+
+void FLinuxResourceRestrictedJobObject::SetMemoryLimit(int32 InJobMemoryLimitMiB)
+{
+	checkf(InJobMemoryLimitMiB >= 1024, TEXT("Cannot launch ShaderCompileWorker processes with memory restriction of less than 1024 MiB (%u MiB was specified)"), InJobMemoryLimitMiB);
+	if (MemoryLimit != InJobMemoryLimitMiB)
+	{
+		if (IsValid())
+		{
+			// A new group reads back "max", i.e. unlimited, so the first limit is always a lowering
+			int64 PreviousMemoryMax = MAX_int64;
+			ReadGroupValue(TEXT("memory.max"), PreviousMemoryMax);
+
+			const int64 MemoryMax = 1024 * 1024 * static_cast<int64>(InJobMemoryLimitMiB);
+			for (const TPair<const TCHAR*, int64>& Write : UE::ShaderCompiler::Private::GetMemoryLimitWrites(PreviousMemoryMax, MemoryMax, UE::ShaderCompiler::Private::GLinuxMemoryHighPercent))
+			{
+				if (!WriteGroupFile(Write.Key, FString::Printf(TEXT("%lld"), Write.Value)))
+				{
+					UE_LOG(LogLinux, Warning, TEXT("Failed to set %s for cgroup \"%s\": %s"), Write.Key, *GroupPath, *UE::ShaderCompiler::Private::GetErrnoMessage());
+					break;
+				}
+			}
+		}
+		MemoryLimit = InJobMemoryLimitMiB;
+	}
+}
+
+bool FLinuxResourceRestrictedJobObject::QueryStatus(FJobObjectLimitationInfo& OutInfo)
+{
+	int64 MemoryMax = 0;
+	int64 MemoryCurrent = 0;
+	if (IsValid() && ReadGroupValue(TEXT("memory.max"), MemoryMax) && ReadGroupValue(TEXT("memory.current"), MemoryCurrent) && MemoryMax > 0)
+	{
+		OutInfo.MemoryLimit = MemoryMax;
+		OutInfo.MemoryUsed = MemoryCurrent;
+		return true;
+	}
+	return false;
+}
+
+bool FLinuxResourceRestrictedJobObject::QueryLimitViolationStatus(FJobObjectLimitationInfo& OutInfo)
+{
+	if (IsValid() && UpdateMemoryEvents())
+	{
+		// Like on Windows, usage might have gone down again by now, so only report it if it's still at the limit
+		FJobObjectLimitationInfo Info;
+		if (QueryStatus(Info) && Info.MemoryUsed >= Info.MemoryLimit)
+		{
+			OutInfo = Info;
+			return true;
+		}
+	}
+	return false;
+}
+
+int32 FLinuxResourceRestrictedJobObject::GetNumDispatchableWorkers(int32 NumWorkers)
+{
+	if (!IsValid() || NumWorkers <= 1)
+	{
+		return NumWorkers;
+	}
+
+	UpdateMemoryEvents();
+
+	// Give back one worker at a time while usage stays under memory.high
+	const double CurrentTime = FPlatformTime::Seconds();
+	if (DispatchScale < 1.0f && CurrentTime - LastThrottleTime >= UE::ShaderCompiler::Private::GLinuxDispatchRecoverySeconds)
+	{
+		int64 MemoryHigh = 0;
+		int64 MemoryCurrent = 0;
+		if (ReadGroupValue(TEXT("memory.high"), MemoryHigh) && ReadGroupValue(TEXT("memory.current"), MemoryCurrent) && MemoryCurrent < MemoryHigh)
+		{
+			DispatchScale = FMath::Min(1.0f, DispatchScale + 1.0f / NumWorkers);
+			LastThrottleTime = CurrentTime;
+		}
+	}
+
+	return FMath::Clamp(FMath::FloorToInt32(NumWorkers * DispatchScale + UE_KINDA_SMALL_NUMBER), 1, NumWorkers);
+}
+
+bool FLinuxResourceRestrictedJobObject::IsValid() const
+{
+	return !GroupPath.IsEmpty();
+}
+
+bool FLinuxResourceRestrictedJobObject::UpdateMemoryEvents()
+{
+	if (InotifyHandle >= 0)
+	{
+		// Drain the watch, memory.events is read either way since notifications can coalesce
+		alignas(struct inotify_event) uint8 Buffer[4096];
+		bool bModified = false;
+		while (read(InotifyHandle, Buffer, sizeof(Buffer)) > 0)
+		{
+			bModified = true;
+		}
+		if (!bModified && LastThrottleTime > 0.0)
+		{
+			return false;
+		}
+	}
+
+	FString Events;
+	if (!ReadGroupFile(TEXT("memory.events"), Events))
+	{
+		return false;
+	}
+
+	uint64 NewNumHighEvents = NumMemoryHighEvents;
+	uint64 NewNumMaxEvents = NumMemoryMaxEvents;
+	UE::ShaderCompiler::Private::ParseMemoryEvents(Events, NewNumHighEvents, NewNumMaxEvents);
+
+	const bool bFirstUpdate = LastThrottleTime == 0.0;
+	const double CurrentTime = FPlatformTime::Seconds();
+	if (!bFirstUpdate && NewNumHighEvents > NumMemoryHighEvents && CurrentTime - LastThrottleTime >= 1.0)
+	{
+		// Reclaim is already slowing the workers down, so stop handing out new jobs before memory.max is hit
+		DispatchScale = FMath::Max(DispatchScale * 0.5f, UE_SMALL_NUMBER);
+		UE_LOG(LogLinux, Display, TEXT("ShaderCompileWorker cgroup \"%s\" is over memory.high, throttling job dispatch to %.0f%% of workers"), *GroupPath, DispatchScale * 100.0f);
+	}
+	if (bFirstUpdate || NewNumHighEvents > NumMemoryHighEvents)
+	{
+		LastThrottleTime = CurrentTime;
+	}
+
+	const bool bHitMax = !bFirstUpdate && NewNumMaxEvents > NumMemoryMaxEvents;
+	NumMemoryHighEvents = NewNumHighEvents;
+	NumMemoryMaxEvents = NewNumMaxEvents;
+	return bHitMax;
+}
+
+bool FLinuxResourceRestrictedJobObject::WriteGroupFile(const TCHAR* FileName, const FString& Value) const
+{
+	return UE::ShaderCompiler::Private::WriteCgroupFile(GroupPath / FileName, Value);
+}
+
+bool FLinuxResourceRestrictedJobObject::ReadGroupFile(const TCHAR* FileName, FString& OutValue) const
+{
+	return FFileHelper::LoadFileToString(OutValue, *(GroupPath / FileName));
+}
+
+bool FLinuxResourceRestrictedJobObject::ReadGroupValue(const TCHAR* FileName, int64& OutValue) const
+{
+	FString Value;
+	if (!ReadGroupFile(FileName, Value))
+	{
+		return false;
+	}
+
+	// Limits read back as "max" when unlimited
+	Value.TrimStartAndEndInline();
+	OutValue = Value == TEXT("max") ? MAX_int64 : FCString::Atoi64(*Value);
+	return true;
+}
 
+#endif // PLATFORM_LINUX
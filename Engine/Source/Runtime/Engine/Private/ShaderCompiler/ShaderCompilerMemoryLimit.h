@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ShaderCompilerMemoryLimit.h: Wrapper for Windows specific Job Object functionality and Linux cgroups.
+=============================================================================*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include "Windows/WindowsHWrapper.h"
+#include "Windows/HideWindowsPlatformTypes.h"
+#endif
+
+struct FJobObjectLimitationInfo
+{
+	int64 MemoryLimit = 0;
+	int64 MemoryUsed = 0;
+};
+
+#if PLATFORM_WINDOWS
+
+class FWindowsResourceRestrictedJobObject
+{
+public:
+	FWindowsResourceRestrictedJobObject(const FString& InJobName, int32 InitialJobMemoryLimitMiB);
+	~FWindowsResourceRestrictedJobObject();
+
+	void AssignProcess(const FProcHandle& Process);
+
+	void SetMemoryLimit(int32 InJobMemoryLimitMiB);
+
+	bool QueryStatus(FJobObjectLimitationInfo& OutInfo);
+
+	bool QueryLimitViolationStatus(FJobObjectLimitationInfo& OutInfo);
+
+	/** Returns how many of NumWorkers should have jobs dispatched to them. Job objects don't report pressure before the limit is hit, so this is always all of them. */
+	int32 GetNumDispatchableWorkers(int32 NumWorkers)
+	{
+		return NumWorkers;
+	}
+
+private:
+	static FString GetErrorMessage();
+
+	bool IsValid() const;
+
+	void CreateAndLinkCompletionPort();
+
+	FString JobName;
+	HANDLE JobObject = nullptr;
+	HANDLE CompletionPort = nullptr;
+	int32 MemoryLimit = 0;
+};
+
+typedef FWindowsResourceRestrictedJobObject FResourceRestrictedJobObject;
+
+#elif PLATFORM_LINUX
+
+#include "ShaderCompilerMemoryLimitLinux.h"
+
+typedef FLinuxResourceRestrictedJobObject FResourceRestrictedJobObject;
+
+#else
+
+class FGenericResourceRestrictedJobObject
+{
+public:
+	FGenericResourceRestrictedJobObject(const FString& JobName, int32 InitialJobMemoryLimitMiB);
+
+	void AssignProcess(const FProcHandle& Process);
+
+	void SetMemoryLimit(int32 InJobMemoryLimitMiB);
+
+	bool QueryStatus(FJobObjectLimitationInfo& OutInfo);
+
+	bool QueryLimitViolationStatus(FJobObjectLimitationInfo& OutInfo);
+
+	int32 GetNumDispatchableWorkers(int32 NumWorkers)
+	{
+		return NumWorkers;
+	}
+};
+
+typedef FGenericResourceRestrictedJobObject FResourceRestrictedJobObject;
+
+#endif // PLATFORM_WINDOWS
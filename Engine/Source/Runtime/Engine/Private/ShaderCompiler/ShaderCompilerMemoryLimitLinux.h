@@ -0,0 +1,89 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ShaderCompilerMemoryLimitLinux.h: cgroup v2 based resource restriction for ShaderCompileWorker processes on Linux.
+=============================================================================*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+
+#if PLATFORM_LINUX
+
+struct FJobObjectLimitationInfo;
+
+namespace UE::ShaderCompiler::Private
+{
+	/** Returns the cgroup v2 directory of the unified hierarchy ("0::<path>") entry of a /proc/<pid>/cgroup file, or an empty string. */
+	FString ParseUnifiedCgroupPath(const FString& ProcCgroupContents);
+
+	/** Parses the "high" and "max"/"oom" counters of a memory.events file, leaving counters that are missing unchanged. */
+	void ParseMemoryEvents(const FString& Events, uint64& InOutNumHighEvents, uint64& InOutNumMaxEvents);
+
+	/**
+	 * Returns the memory.high and memory.max values to write for a new limit, in the order they have to be written.
+	 * memory.high stays at or below memory.max after every write: when lowering the limit memory.high goes first,
+	 * when raising it memory.max goes first.
+	 */
+	TArray<TPair<const TCHAR*, int64>, TInlineAllocator<2>> GetMemoryLimitWrites(int64 PreviousMemoryMax, int64 MemoryMax, int32 MemoryHighPercent);
+}
+
+/**
+ * Linux equivalent of FWindowsResourceRestrictedJobObject. Worker processes are moved into a cgroup v2 group with
+ * memory.max, memory.high and cpu.weight set, created below r.ShaderCompiler.Linux.CgroupRoot (or the cgroup of this
+ * process when empty). The root must be delegated to the current user with the memory and cpu controllers available,
+ * e.g. by running the cook through "systemd-run --user --scope -p Delegate=yes".
+ *
+ * cgroup v2 only allows controllers to be enabled for the children of a group without processes in it, so when the
+ * root is the cgroup of this process, this process is first moved into a leaf group of its own next to the workers.
+ *
+ * Rather than waiting for the kernel OOM killer, the group's memory.events file is watched: every time the group goes
+ * over memory.high the number of workers that should be dispatched is halved, and it recovers one worker at a time once
+ * usage stays below memory.high. QueryLimitViolationStatus only reports the group reaching memory.max.
+ */
+class FLinuxResourceRestrictedJobObject
+{
+public:
+	FLinuxResourceRestrictedJobObject(const FString& InJobName, int32 InitialJobMemoryLimitMiB);
+	~FLinuxResourceRestrictedJobObject();
+
+	FLinuxResourceRestrictedJobObject(const FLinuxResourceRestrictedJobObject&) = delete;
+	FLinuxResourceRestrictedJobObject& operator=(const FLinuxResourceRestrictedJobObject&) = delete;
+
+	void AssignProcess(const FProcHandle& Process);
+
+	void SetMemoryLimit(int32 InJobMemoryLimitMiB);
+
+	bool QueryStatus(FJobObjectLimitationInfo& OutInfo);
+
+	bool QueryLimitViolationStatus(FJobObjectLimitationInfo& OutInfo);
+
+	/** Returns how many of NumWorkers should have jobs dispatched to them given the recent memory pressure of the group. */
+	int32 GetNumDispatchableWorkers(int32 NumWorkers);
+
+	bool IsValid() const;
+
+private:
+	/** Reads memory.events and the inotify watch on it, updating the dispatch throttle. Returns true if memory.max was hit since the last call. */
+	bool UpdateMemoryEvents();
+
+	bool WriteGroupFile(const TCHAR* FileName, const FString& Value) const;
+	bool ReadGroupFile(const TCHAR* FileName, FString& OutValue) const;
+	bool ReadGroupValue(const TCHAR* FileName, int64& OutValue) const;
+
+	FString JobName;
+	FString GroupPath;
+	int32 MemoryLimit = 0;
+	int32 InotifyHandle = -1;
+
+	/** Counters from memory.events, see the cgroup v2 documentation */
+	uint64 NumMemoryHighEvents = 0;
+	uint64 NumMemoryMaxEvents = 0;
+
+	/** Fraction of the workers that should be dispatched to, halved on memory.high events */
+	float DispatchScale = 1.0f;
+	double LastThrottleTime = 0.0;
+};
+
+#endif // PLATFORM_LINUX
@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Components/StaticMeshComponent.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/KismetPropertyHandleLibrary.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "KismetPropertyCache.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace KismetPropertyByNameTest
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+// Properties declared a few classes up the hierarchy of the component, so resolving them by name walks most of its property chain
+const FName IntPropertyName(TEXT("TranslucencySortPriority"));
+const FName FloatPropertyName(TEXT("MinDrawDistance"));
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKismetPropertyByNameCacheTest, "System.Engine.Kismet.PropertyByName.Cache", TestFlags)
+bool FKismetPropertyByNameCacheTest::RunTest(const FString& Parameters)
+{
+	UE::Blueprint::Private::ResetPropertyByNameCache();
+
+	UStaticMeshComponent* Component = NewObject<UStaticMeshComponent>(GetTransientPackage());
+
+	TestTrue(TEXT("Cached lookup finds the same property"),
+		UE::Blueprint::Private::FindPropertyByNameCached(Component->GetClass(), IntPropertyName) == FindFProperty<FProperty>(Component->GetClass(), IntPropertyName));
+	TestTrue(TEXT("Cached lookup finds the same property the second time"),
+		UE::Blueprint::Private::FindPropertyByNameCached(Component->GetClass(), IntPropertyName) == FindFProperty<FProperty>(Component->GetClass(), IntPropertyName));
+	TestNull(TEXT("Missing properties stay missing"), UE::Blueprint::Private::FindPropertyByNameCached(Component->GetClass(), TEXT("NotAPropertyOfStaticMeshComponent")));
+	TestNull(TEXT("Properties of the wrong type are not returned"), UE::Blueprint::Private::FindFPropertyCached<FFloatProperty>(Component->GetClass(), IntPropertyName));
+
+	UKismetSystemLibrary::SetIntPropertyByName(Component, IntPropertyName, 7);
+	UKismetSystemLibrary::SetFloatPropertyByName(Component, FloatPropertyName, 12.5f);
+	TestEqual(TEXT("SetIntPropertyByName"), Component->TranslucencySortPriority, 7);
+	TestEqual(TEXT("SetFloatPropertyByName"), Component->MinDrawDistance, 12.5f);
+
+	const FResolvedPropertyHandle IntHandle = UKismetPropertyHandleLibrary::ResolvePropertyHandle(UStaticMeshComponent::StaticClass(), IntPropertyName);
+	const FResolvedPropertyHandle MissingHandle = UKismetPropertyHandleLibrary::ResolvePropertyHandle(UStaticMeshComponent::StaticClass(), TEXT("NotAPropertyOfStaticMeshComponent"));
+	TestTrue(TEXT("Handle to an existing property is valid"), UKismetPropertyHandleLibrary::IsValidPropertyHandle(IntHandle));
+	TestFalse(TEXT("Handle to a missing property is invalid"), UKismetPropertyHandleLibrary::IsValidPropertyHandle(MissingHandle));
+
+	UKismetPropertyHandleLibrary::SetIntPropertyByHandle(Component, IntHandle, 9);
+	TestEqual(TEXT("SetIntPropertyByHandle"), Component->TranslucencySortPriority, 9);
+
+	// Wrong value type and unrelated object class are both ignored
+	UKismetPropertyHandleLibrary::SetFloatPropertyByHandle(Component, IntHandle, 3.0f);
+	TestEqual(TEXT("SetFloatPropertyByHandle on an int property does nothing"), Component->TranslucencySortPriority, 9);
+	UKismetPropertyHandleLibrary::SetIntPropertyByHandle(GetTransientPackage(), IntHandle, 5);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKismetPropertyByNameBenchmarkTest, "System.Engine.Kismet.PropertyByName.Benchmark", TestFlags | EAutomationTestFlags::PerfFilter)
+bool FKismetPropertyByNameBenchmarkTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumObjects = 1000;
+	constexpr int32 NumSets = 100000;
+
+	TArray<UStaticMeshComponent*> Components;
+	for (int32 Index = 0; Index < NumObjects; ++Index)
+	{
+		Components.Add(NewObject<UStaticMeshComponent>(GetTransientPackage()));
+	}
+
+	// What SetIntPropertyByName did before the cache, one search of the class per set
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumSets; ++Index)
+	{
+		UStaticMeshComponent* Component = Components[Index % NumObjects];
+		if (FIntProperty* IntProp = FindFProperty<FIntProperty>(Component->GetClass(), IntPropertyName))
+		{
+			IntProp->SetPropertyValue_InContainer(Component, Index);
+		}
+	}
+	const double UncachedSeconds = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Index = 0; Index < NumSets; ++Index)
+	{
+		UKismetSystemLibrary::SetIntPropertyByName(Components[Index % NumObjects], IntPropertyName, Index + 1);
+	}
+	const double ByNameSeconds = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	const FResolvedPropertyHandle Handle = UKismetPropertyHandleLibrary::ResolvePropertyHandle(UStaticMeshComponent::StaticClass(), IntPropertyName);
+	for (int32 Index = 0; Index < NumSets; ++Index)
+	{
+		UKismetPropertyHandleLibrary::SetIntPropertyByHandle(Components[Index % NumObjects], Handle, Index + 2);
+	}
+	const double ByHandleSeconds = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumMismatches = 0;
+	for (int32 Index = NumSets - NumObjects; Index < NumSets; ++Index)
+	{
+		NumMismatches += (Components[Index % NumObjects]->TranslucencySortPriority != Index + 2) ? 1 : 0;
+	}
+	TestEqual(TEXT("Every set through the handle landed"), NumMismatches, 0);
+
+	AddInfo(FString::Printf(TEXT("%d sets: %.3f ms with FindFProperty, %.3f ms with SetIntPropertyByName, %.3f ms with SetIntPropertyByHandle"),
+		NumSets, 1000.0 * UncachedSeconds, 1000.0 * ByNameSeconds, 1000.0 * ByHandleSeconds));
+
+	return true;
+}
+
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
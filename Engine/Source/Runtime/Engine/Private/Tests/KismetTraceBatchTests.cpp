@@ -0,0 +1,101 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Kismet/KismetTraceBatchLibrary.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace KismetTraceBatchTest
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter | EAutomationTestFlags::PerfFilter;
+
+// Compares 10K traces through the batch node against the same traces issued one Blueprint call at a time, in a world full of blocking boxes
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKismetTraceBatchPerfTest, "System.Engine.Kismet.TraceBatch.Perf", TestFlags)
+bool FKismetTraceBatchPerfTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumBoxes = 512;
+	constexpr int32 NumTraces = 10000;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("KismetTraceBatchTestWorld"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+
+	FRandomStream RandomStream(17);
+	for (int32 Index = 0; Index < NumBoxes; ++Index)
+	{
+		AActor* Actor = World->SpawnActor<AActor>();
+		UBoxComponent* Box = NewObject<UBoxComponent>(Actor);
+		Box->SetBoxExtent(FVector(RandomStream.FRandRange(20.0f, 200.0f)));
+		Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Actor->SetRootComponent(Box);
+		Box->RegisterComponent();
+		Actor->SetActorLocation(RandomStream.VRand() * RandomStream.FRandRange(0.0f, 5000.0f));
+	}
+
+	// Let the physics scene pick up the new bodies
+	World->Tick(LEVELTICK_All, 0.01f);
+
+	TArray<FVector> Starts;
+	TArray<FVector> Ends;
+	for (int32 Index = 0; Index < NumTraces; ++Index)
+	{
+		Starts.Add(RandomStream.VRand() * 6000.0f);
+		Ends.Add(RandomStream.VRand() * 6000.0f);
+	}
+
+	const ETraceTypeQuery TraceChannel = UEngineTypes::ConvertToTraceType(ECC_Visibility);
+	const TArray<AActor*> ActorsToIgnore;
+
+	double StartTime = FPlatformTime::Seconds();
+	TArray<FHitResult> PerCallHits;
+	PerCallHits.SetNum(NumTraces);
+	for (int32 Index = 0; Index < NumTraces; ++Index)
+	{
+		UKismetSystemLibrary::LineTraceSingle(World, Starts[Index], Ends[Index], TraceChannel, false, ActorsToIgnore, EDrawDebugTrace::None, PerCallHits[Index], true);
+	}
+	const double PerCallSeconds = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	TArray<FHitResult> BatchHits;
+	const int32 NumHitTraces = UKismetTraceBatchLibrary::LineTraceSingleBatch(World, Starts, Ends, TraceChannel, false, ActorsToIgnore, BatchHits);
+	const double BatchSeconds = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumMismatches = 0;
+	int32 NumExpectedHitTraces = 0;
+	if (TestEqual(TEXT("One hit per trace"), BatchHits.Num(), NumTraces))
+	{
+		for (int32 Index = 0; Index < NumTraces; ++Index)
+		{
+			const FHitResult& Expected = PerCallHits[Index];
+			const FHitResult& Actual = BatchHits[Index];
+			NumExpectedHitTraces += Expected.bBlockingHit ? 1 : 0;
+			NumMismatches += (Expected.bBlockingHit != Actual.bBlockingHit || Expected.GetActor() != Actual.GetActor() || Expected.Distance != Actual.Distance) ? 1 : 0;
+		}
+	}
+
+	TestTrue(TEXT("Some traces hit a box"), NumExpectedHitTraces > 0);
+	TestEqual(TEXT("Batch reports the number of traces that hit"), NumHitTraces, NumExpectedHitTraces);
+	TestEqual(TEXT("Batch traces hit the same as per-call traces"), NumMismatches, 0);
+
+	AddInfo(FString::Printf(TEXT("%d line traces against %d boxes, %d hits: %.3f ms one call at a time, %.3f ms as a batch"),
+		NumTraces, NumBoxes, NumHitTraces, 1000.0 * PerCallSeconds, 1000.0 * BatchSeconds));
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	return true;
+}
+
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "ShaderCompiler/ShaderCompilerMemoryLimit.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && PLATFORM_LINUX
+
+namespace ShaderCompilerMemoryLimitTest
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShaderCompilerCgroupParseTest, "System.Engine.ShaderCompiler.MemoryLimit.Linux.Parse", TestFlags)
+bool FShaderCompilerCgroupParseTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::ShaderCompiler::Private;
+
+	// Hybrid hierarchies list the v1 controllers before the unified entry
+	TestEqual(TEXT("Unified entry"), ParseUnifiedCgroupPath(TEXT("0::/user.slice/user-1000.slice/user@1000.service/app.slice/cook.scope\n")),
+		FString(TEXT("/sys/fs/cgroup/user.slice/user-1000.slice/user@1000.service/app.slice/cook.scope")));
+	TestEqual(TEXT("Hybrid hierarchy"), ParseUnifiedCgroupPath(TEXT("12:memory:/user.slice\n1:name=systemd:/user.slice\n0::/user.slice/cook.scope\n")),
+		FString(TEXT("/sys/fs/cgroup/user.slice/cook.scope")));
+	TestEqual(TEXT("Root cgroup"), ParseUnifiedCgroupPath(TEXT("0::/\n")), FString(TEXT("/sys/fs/cgroup")));
+	TestTrue(TEXT("v1 only"), ParseUnifiedCgroupPath(TEXT("12:memory:/user.slice\n")).IsEmpty());
+
+	uint64 NumHighEvents = 3;
+	uint64 NumMaxEvents = 1;
+	ParseMemoryEvents(TEXT("low 0\nhigh 7\nmax 2\noom 4\noom_kill 1\n"), NumHighEvents, NumMaxEvents);
+	TestEqual(TEXT("High events"), NumHighEvents, 7ull);
+	TestEqual(TEXT("Max events take the larger of max and oom"), NumMaxEvents, 4ull);
+
+	ParseMemoryEvents(TEXT("low 0\n"), NumHighEvents, NumMaxEvents);
+	TestEqual(TEXT("Missing high counter is left unchanged"), NumHighEvents, 7ull);
+	TestEqual(TEXT("Missing max counter is left unchanged"), NumMaxEvents, 4ull);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShaderCompilerCgroupWriteOrderTest, "System.Engine.ShaderCompiler.MemoryLimit.Linux.WriteOrder", TestFlags)
+bool FShaderCompilerCgroupWriteOrderTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::ShaderCompiler::Private;
+
+	constexpr int64 GiB = 1024 * 1024 * 1024;
+
+	// memory.high must be at or below memory.max after each write, starting from the previous pair
+	auto TestOrder = [this](const TCHAR* What, int64 PreviousMemoryMax, int64 MemoryMax)
+	{
+		const TArray<TPair<const TCHAR*, int64>, TInlineAllocator<2>> Writes = GetMemoryLimitWrites(PreviousMemoryMax, MemoryMax, 85);
+		if (!TestEqual(What, Writes.Num(), 2))
+		{
+			return;
+		}
+
+		int64 High = PreviousMemoryMax == MAX_int64 ? MAX_int64 : PreviousMemoryMax / 100 * 85;
+		int64 Max = PreviousMemoryMax;
+		for (const TPair<const TCHAR*, int64>& Write : Writes)
+		{
+			(FCString::Strcmp(Write.Key, TEXT("memory.high")) == 0 ? High : Max) = Write.Value;
+			TestTrue(FString::Printf(TEXT("%s: memory.high <= memory.max after writing %s"), What, Write.Key), High <= Max);
+		}
+		TestEqual(FString::Printf(TEXT("%s: final memory.max"), What), Max, MemoryMax);
+		TestEqual(FString::Printf(TEXT("%s: final memory.high"), What), High, MemoryMax / 100 * 85);
+	};
+
+	TestOrder(TEXT("First limit"), MAX_int64, 8 * GiB);
+	TestOrder(TEXT("Lowering"), 8 * GiB, 4 * GiB);
+	TestOrder(TEXT("Raising"), 4 * GiB, 8 * GiB);
+	TestOrder(TEXT("Raising above the old memory.max / percent"), 4 * GiB, 5 * GiB);
+
+	return true;
+}
+
+// Only runs where a delegated cgroup v2 hierarchy is available, e.g. under "systemd-run --user --scope -p Delegate=yes".
+// Creating the job object moves this process into a leaf group when r.ShaderCompiler.Linux.CgroupRoot is empty, as the cook does.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShaderCompilerCgroupJobObjectTest, "System.Engine.ShaderCompiler.MemoryLimit.Linux.JobObject", TestFlags)
+bool FShaderCompilerCgroupJobObjectTest::RunTest(const FString& Parameters)
+{
+	FResourceRestrictedJobObject JobObject(TEXT("ShaderCompilerMemoryLimitTest"), 0);
+	if (!JobObject.IsValid())
+	{
+		AddInfo(TEXT("No delegated cgroup v2 hierarchy with the memory and cpu controllers, skipping"));
+		return true;
+	}
+
+	constexpr int64 MiB = 1024 * 1024;
+	FJobObjectLimitationInfo Info;
+
+	JobObject.SetMemoryLimit(4096);
+	TestTrue(TEXT("QueryStatus after setting the limit"), JobObject.QueryStatus(Info));
+	TestEqual(TEXT("memory.max after the first limit"), Info.MemoryLimit, 4096 * MiB);
+
+	JobObject.SetMemoryLimit(2048);
+	TestTrue(TEXT("QueryStatus after lowering the limit"), JobObject.QueryStatus(Info));
+	TestEqual(TEXT("memory.max after lowering"), Info.MemoryLimit, 2048 * MiB);
+
+	JobObject.SetMemoryLimit(8192);
+	TestTrue(TEXT("QueryStatus after raising the limit"), JobObject.QueryStatus(Info));
+	TestEqual(TEXT("memory.max after raising"), Info.MemoryLimit, 8192 * MiB);
+
+	TestFalse(TEXT("An empty group has not hit memory.max"), JobObject.QueryLimitViolationStatus(Info));
+	TestEqual(TEXT("All workers are dispatchable without memory pressure"), JobObject.GetNumDispatchableWorkers(16), 16);
+
+	return true;
+}
+
+} // namespace ShaderCompilerMemoryLimitTest
+
+#endif // WITH_DEV_AUTOMATION_TESTS && PLATFORM_LINUX
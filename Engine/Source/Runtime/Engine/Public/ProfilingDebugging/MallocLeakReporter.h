@@ -23,12 +23,20 @@
 	"mallocleak report"				- report allocations and leaks
 	"mallocleak stop"				- stop tracking leaks
 
+	For long soak tests the sampling mode records one allocation every N KB allocated on average instead of every allocation,
+	and extrapolates leak sizes from the samples:
+
+	"mallocleak.sample.start interval=512 report=300"	- sample one allocation per 512 KB allocated and report every 300 secs
+	"mallocleak.sample.report"							- report estimated leaks
+	"mallocleak.sample.stop"							- stop sampling
+
 	Example Code usage
 
 	FMallocLeakReporter::Get().Start(0, 300) - start tracking allocs > 0KB and generate a report every 300 secs
 	FMallocLeakReporter::Get().WriteReports() - Writes reports and returns the number of suspected leaks
 	FMallocLeakReporter::Get().WriteReport(TEXT("BigAllocs"), Options); - Write custom report of allocations that matches "Options"
 	FMallocLeakReporter::Get().Stop() - stop tracking allocations
+	FMallocLeakReporter::Get().StartSampling(512, 300) - sample one allocation per 512KB allocated and generate a report every 300 secs
 
 
 	Reports are written to the profiling dir, e,g GameName/Saved/Profiling/SessionName
@@ -89,6 +97,36 @@ public:
 	 */
 	ENGINE_API int32		WriteReport(const TCHAR* ReportName, const FMallocLeakReportOptions& Options);
 
+	/**
+	 * Starts sampling allocations with FMallocLeakSampler, a fraction of the cost of Start() in time and memory.
+	 *
+	 * @param: 	SampleIntervalKB	Sample one allocation every this many KB allocated, on average
+	 * @param: 	ReportOnTime		Write out a sampled report every N seconds
+	 */
+	ENGINE_API void		StartSampling(int32 SampleIntervalKB = 512, float ReportOnTime = 0.0f);
+
+	/**
+	 * Stop sampling allocations, the samples are kept for reports and their frees tracked until ClearSamples()
+	 */
+	ENGINE_API void		StopSampling();
+
+	/**
+	 * Forgets every sampled allocation
+	 */
+	ENGINE_API void		ClearSamples();
+
+	/**
+	 * Returns true while sampling
+	 */
+	ENGINE_API bool		IsSampling() const;
+
+	/**
+	 *	Writes out the sampled allocations still alive with their estimated sizes, returns the number of callstacks reported
+	 *
+	 * @param: 	FilterSizeKB		Only report callstacks with at least this many estimated KB alive
+	 */
+	ENGINE_API int32		WriteSampledReport(const TCHAR* ReportName, int32 FilterSizeKB = 0);
+
 	/**
 	 * Sets default options for what are considered memory leaks
 	 *
@@ -129,6 +167,10 @@ protected:
 	FTSTicker::FDelegateHandle				ReportTicker;
 	FMallocLeakReportDelegate	ReportDelegate;
 
+	// Sampling vars
+	int32						SampledReportCount = 0;
+	FTSTicker::FDelegateHandle				SampledReportTicker;
+
 	// Report vars
 	FMallocLeakReportOptions	DefaultLeakReportOptions;
 	FMallocLeakReportOptions	DefaultAllocReportOptions;
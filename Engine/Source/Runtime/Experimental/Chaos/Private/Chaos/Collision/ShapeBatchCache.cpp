@@ -0,0 +1,279 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Chaos/Collision/ShapeBatchCache.h"
+#include "Chaos/Box.h"
+#include "Chaos/Capsule.h"
+#include "Chaos/ImplicitObject.h"
+#include "Chaos/ShapeInstance.h"
+#include "Chaos/Sphere.h"
+#include "HAL/IConsoleManager.h"
+
+#if INTEL_ISPC
+#include "ShapeBatchCache.ispc.generated.h"
+
+static_assert(sizeof(Chaos::Private::FShapeBatchPair) == 2 * sizeof(int32), "ISPC kernels expect pairs to be packed int32 pairs");
+static_assert(sizeof(Chaos::FVec3f) == 3 * sizeof(float), "ISPC kernels expect normals to be packed float triples");
+
+#if !UE_BUILD_SHIPPING
+bool bChaos_ShapeBatch_ISPC_Enabled = CHAOS_SHAPE_BATCH_ISPC_ENABLED_DEFAULT;
+FAutoConsoleVariableRef CVarChaosShapeBatchISPCEnabled(TEXT("p.Chaos.Collision.ShapeBatch.ISPC"), bChaos_ShapeBatch_ISPC_Enabled, TEXT("Whether to use ISPC optimizations in the batched shape narrow phase"));
+#endif
+#endif
+
+namespace Chaos::Private
+{
+	namespace ShapeBatchCache
+	{
+		// Scalar versions of the kernels in ShapeBatchCache.ispc, used when ISPC is not available
+		inline void SpherePointDistance(const FVec3f& A, const FRealSingle RadiusA, const FVec3f& P, const FRealSingle Radius, FRealSingle& OutPhi, FVec3f& OutNormal)
+		{
+			const FVec3f Delta = A - P;
+			const FRealSingle DistSq = Delta.SizeSquared();
+			const FRealSingle Dist = FMath::Sqrt(DistSq);
+			OutNormal = (DistSq > 1.e-8f) ? Delta / Dist : FVec3f(0, 0, 1);
+			OutPhi = Dist - (RadiusA + Radius);
+		}
+
+		inline FVec3f GetPosition(const TArray<FRealSingle>& X, const TArray<FRealSingle>& Y, const TArray<FRealSingle>& Z, const int32 Index)
+		{
+			return FVec3f(X[Index], Y[Index], Z[Index]);
+		}
+	}
+
+	void FShapeBatchCache::Reset(const FVec3& InOrigin)
+	{
+		Origin = InOrigin;
+
+		Spheres.X.Reset();
+		Spheres.Y.Reset();
+		Spheres.Z.Reset();
+		Spheres.Radius.Reset();
+
+		Boxes.X.Reset();
+		Boxes.Y.Reset();
+		Boxes.Z.Reset();
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			for (int32 Component = 0; Component < 3; ++Component)
+			{
+				Boxes.Axes[Axis][Component].Reset();
+			}
+			Boxes.Extent[Axis].Reset();
+		}
+
+		Capsules.X1.Reset();
+		Capsules.Y1.Reset();
+		Capsules.Z1.Reset();
+		Capsules.X2.Reset();
+		Capsules.Y2.Reset();
+		Capsules.Z2.Reset();
+		Capsules.Radius.Reset();
+
+		for (TArray<const FPerShapeData*>& TypeShapes : Shapes)
+		{
+			TypeShapes.Reset();
+		}
+	}
+
+	FShapeBatchHandle FShapeBatchCache::AddShape(const FPerShapeData* Shape, const FRigidTransform3& LeafWorldTransform)
+	{
+		check(Shape != nullptr);
+		return AddImplicitObject(Shape->GetLeafGeometry(), LeafWorldTransform, Shape);
+	}
+
+	FShapeBatchHandle FShapeBatchCache::AddImplicitObject(const FImplicitObject* Implicit, const FRigidTransform3& WorldTransform, const FPerShapeData* Shape)
+	{
+		FShapeBatchHandle Handle;
+		if (Implicit == nullptr)
+		{
+			return Handle;
+		}
+
+		// Scaled and instanced wrappers have their own types and are not batched
+		switch (Implicit->GetType())
+		{
+		case ImplicitObjectType::Sphere:
+		{
+			const FImplicitSphere3& Sphere = Implicit->GetObjectChecked<FImplicitSphere3>();
+			const FVec3f Center = FVec3f(WorldTransform.TransformPositionNoScale(Sphere.GetCenter()) - Origin);
+			Spheres.X.Add(Center.X);
+			Spheres.Y.Add(Center.Y);
+			Spheres.Z.Add(Center.Z);
+			Spheres.Radius.Add(FRealSingle(Sphere.GetRadius()));
+			Handle.Type = EShapeBatchType::Sphere;
+			break;
+		}
+		case ImplicitObjectType::Box:
+		{
+			const FImplicitBox3& Box = Implicit->GetObjectChecked<FImplicitBox3>();
+			const FVec3f Center = FVec3f(WorldTransform.TransformPositionNoScale(Box.GetCenter()) - Origin);
+			const FVec3f HalfExtents = FVec3f(0.5 * Box.Extents());
+			const FRotation3 Rotation = WorldTransform.GetRotation();
+			const FVec3f Axes[3] = { FVec3f(Rotation.GetAxisX()), FVec3f(Rotation.GetAxisY()), FVec3f(Rotation.GetAxisZ()) };
+			Boxes.X.Add(Center.X);
+			Boxes.Y.Add(Center.Y);
+			Boxes.Z.Add(Center.Z);
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				for (int32 Component = 0; Component < 3; ++Component)
+				{
+					Boxes.Axes[Axis][Component].Add(Axes[Axis][Component]);
+				}
+				Boxes.Extent[Axis].Add(HalfExtents[Axis]);
+			}
+			Handle.Type = EShapeBatchType::Box;
+			break;
+		}
+		case ImplicitObjectType::Capsule:
+		{
+			const FImplicitCapsule3& Capsule = Implicit->GetObjectChecked<FImplicitCapsule3>();
+			const FVec3f X1 = FVec3f(WorldTransform.TransformPositionNoScale(Capsule.GetX1()) - Origin);
+			const FVec3f X2 = FVec3f(WorldTransform.TransformPositionNoScale(Capsule.GetX2()) - Origin);
+			Capsules.X1.Add(X1.X);
+			Capsules.Y1.Add(X1.Y);
+			Capsules.Z1.Add(X1.Z);
+			Capsules.X2.Add(X2.X);
+			Capsules.Y2.Add(X2.Y);
+			Capsules.Z2.Add(X2.Z);
+			Capsules.Radius.Add(FRealSingle(Capsule.GetRadius()));
+			Handle.Type = EShapeBatchType::Capsule;
+			break;
+		}
+		default:
+			return Handle;
+		}
+
+		Handle.Index = Shapes[(int32)Handle.Type].Add(Shape);
+		return Handle;
+	}
+
+	void FShapeBatchCache::ComputeSphereSphereDistances(TArrayView<const FShapeBatchPair> Pairs, TArrayView<FRealSingle> OutPhis, TArrayView<FVec3f> OutNormals) const
+	{
+		check(OutPhis.Num() >= Pairs.Num());
+		check(OutNormals.Num() >= Pairs.Num());
+
+		if (bChaos_ShapeBatch_ISPC_Enabled)
+		{
+#if INTEL_ISPC
+			ispc::ComputeSphereSphereDistances(
+				(const int32*)Pairs.GetData(),
+				Spheres.X.GetData(), Spheres.Y.GetData(), Spheres.Z.GetData(), Spheres.Radius.GetData(),
+				OutPhis.GetData(), (float*)OutNormals.GetData(),
+				Pairs.Num());
+#endif
+			return;
+		}
+
+		for (int32 PairIndex = 0; PairIndex < Pairs.Num(); ++PairIndex)
+		{
+			const int32 IndexA = Pairs[PairIndex].IndexA;
+			const int32 IndexB = Pairs[PairIndex].IndexB;
+			ShapeBatchCache::SpherePointDistance(
+				ShapeBatchCache::GetPosition(Spheres.X, Spheres.Y, Spheres.Z, IndexA), Spheres.Radius[IndexA],
+				ShapeBatchCache::GetPosition(Spheres.X, Spheres.Y, Spheres.Z, IndexB), Spheres.Radius[IndexB],
+				OutPhis[PairIndex], OutNormals[PairIndex]);
+		}
+	}
+
+	void FShapeBatchCache::ComputeSphereBoxDistances(TArrayView<const FShapeBatchPair> Pairs, TArrayView<FRealSingle> OutPhis, TArrayView<FVec3f> OutNormals) const
+	{
+		check(OutPhis.Num() >= Pairs.Num());
+		check(OutNormals.Num() >= Pairs.Num());
+
+		if (bChaos_ShapeBatch_ISPC_Enabled)
+		{
+#if INTEL_ISPC
+			ispc::ComputeSphereBoxDistances(
+				(const int32*)Pairs.GetData(),
+				Spheres.X.GetData(), Spheres.Y.GetData(), Spheres.Z.GetData(), Spheres.Radius.GetData(),
+				Boxes.X.GetData(), Boxes.Y.GetData(), Boxes.Z.GetData(),
+				Boxes.Axes[0][0].GetData(), Boxes.Axes[0][1].GetData(), Boxes.Axes[0][2].GetData(),
+				Boxes.Axes[1][0].GetData(), Boxes.Axes[1][1].GetData(), Boxes.Axes[1][2].GetData(),
+				Boxes.Axes[2][0].GetData(), Boxes.Axes[2][1].GetData(), Boxes.Axes[2][2].GetData(),
+				Boxes.Extent[0].GetData(), Boxes.Extent[1].GetData(), Boxes.Extent[2].GetData(),
+				OutPhis.GetData(), (float*)OutNormals.GetData(),
+				Pairs.Num());
+#endif
+			return;
+		}
+
+		for (int32 PairIndex = 0; PairIndex < Pairs.Num(); ++PairIndex)
+		{
+			const int32 IndexA = Pairs[PairIndex].IndexA;
+			const int32 IndexB = Pairs[PairIndex].IndexB;
+
+			const FVec3f Delta = ShapeBatchCache::GetPosition(Spheres.X, Spheres.Y, Spheres.Z, IndexA) - ShapeBatchCache::GetPosition(Boxes.X, Boxes.Y, Boxes.Z, IndexB);
+			FVec3f Axes[3];
+			FVec3f Local;
+			FVec3f Outside;
+			FVec3f Depth;
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				Axes[Axis] = ShapeBatchCache::GetPosition(Boxes.Axes[Axis][0], Boxes.Axes[Axis][1], Boxes.Axes[Axis][2], IndexB);
+				const FRealSingle Extent = Boxes.Extent[Axis][IndexB];
+				Local[Axis] = FVec3f::DotProduct(Delta, Axes[Axis]);
+				Outside[Axis] = Local[Axis] - FMath::Clamp(Local[Axis], -Extent, Extent);
+				Depth[Axis] = Extent - FMath::Abs(Local[Axis]);
+			}
+
+			FVec3f LocalNormal;
+			FRealSingle Phi;
+			const FRealSingle OutsideDistSq = Outside.SizeSquared();
+			if (OutsideDistSq > 1.e-8f)
+			{
+				// Outside: distance to the closest point on the box
+				const FRealSingle OutsideDist = FMath::Sqrt(OutsideDistSq);
+				LocalNormal = Outside / OutsideDist;
+				Phi = OutsideDist;
+			}
+			else
+			{
+				// Inside: push out through the face with the least penetration
+				const int32 Axis = (Depth[0] <= Depth[1] && Depth[0] <= Depth[2]) ? 0 : ((Depth[1] <= Depth[2]) ? 1 : 2);
+				LocalNormal = FVec3f(0);
+				LocalNormal[Axis] = (Local[Axis] < 0.0f) ? -1.0f : 1.0f;
+				Phi = -Depth[Axis];
+			}
+
+			OutPhis[PairIndex] = Phi - Spheres.Radius[IndexA];
+			OutNormals[PairIndex] = LocalNormal[0] * Axes[0] + LocalNormal[1] * Axes[1] + LocalNormal[2] * Axes[2];
+		}
+	}
+
+	void FShapeBatchCache::ComputeSphereCapsuleDistances(TArrayView<const FShapeBatchPair> Pairs, TArrayView<FRealSingle> OutPhis, TArrayView<FVec3f> OutNormals) const
+	{
+		check(OutPhis.Num() >= Pairs.Num());
+		check(OutNormals.Num() >= Pairs.Num());
+
+		if (bChaos_ShapeBatch_ISPC_Enabled)
+		{
+#if INTEL_ISPC
+			ispc::ComputeSphereCapsuleDistances(
+				(const int32*)Pairs.GetData(),
+				Spheres.X.GetData(), Spheres.Y.GetData(), Spheres.Z.GetData(), Spheres.Radius.GetData(),
+				Capsules.X1.GetData(), Capsules.Y1.GetData(), Capsules.Z1.GetData(),
+				Capsules.X2.GetData(), Capsules.Y2.GetData(), Capsules.Z2.GetData(),
+				Capsules.Radius.GetData(),
+				OutPhis.GetData(), (float*)OutNormals.GetData(),
+				Pairs.Num());
+#endif
+			return;
+		}
+
+		for (int32 PairIndex = 0; PairIndex < Pairs.Num(); ++PairIndex)
+		{
+			const int32 IndexA = Pairs[PairIndex].IndexA;
+			const int32 IndexB = Pairs[PairIndex].IndexB;
+
+			const FVec3f A = ShapeBatchCache::GetPosition(Spheres.X, Spheres.Y, Spheres.Z, IndexA);
+			const FVec3f X1 = ShapeBatchCache::GetPosition(Capsules.X1, Capsules.Y1, Capsules.Z1, IndexB);
+			const FVec3f Segment = ShapeBatchCache::GetPosition(Capsules.X2, Capsules.Y2, Capsules.Z2, IndexB) - X1;
+
+			// Closest point on the capsule segment
+			const FRealSingle SegmentLenSq = Segment.SizeSquared();
+			const FRealSingle T = (SegmentLenSq > 1.e-8f) ? FMath::Clamp(FVec3f::DotProduct(A - X1, Segment) / SegmentLenSq, 0.0f, 1.0f) : 0.0f;
+
+			ShapeBatchCache::SpherePointDistance(A, Spheres.Radius[IndexA], X1 + T * Segment, Capsules.Radius[IndexB], OutPhis[PairIndex], OutNormals[PairIndex]);
+		}
+	}
+}
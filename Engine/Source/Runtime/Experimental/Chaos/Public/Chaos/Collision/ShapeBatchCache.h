@@ -0,0 +1,134 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "Chaos/Core.h"
+#include "Chaos/ShapeInstanceFwd.h"
+
+#if !defined(CHAOS_SHAPE_BATCH_ISPC_ENABLED_DEFAULT)
+#define CHAOS_SHAPE_BATCH_ISPC_ENABLED_DEFAULT 1
+#endif
+
+// Support run-time toggling on supported platforms in non-shipping configurations
+#if !INTEL_ISPC || UE_BUILD_SHIPPING
+static constexpr bool bChaos_ShapeBatch_ISPC_Enabled = INTEL_ISPC && CHAOS_SHAPE_BATCH_ISPC_ENABLED_DEFAULT;
+#else
+extern CHAOS_API bool bChaos_ShapeBatch_ISPC_Enabled;
+#endif
+
+namespace Chaos::Private
+{
+	/**
+	 * The primitive types that FShapeBatchCache stores in structure-of-arrays form.
+	 */
+	enum class EShapeBatchType : uint8
+	{
+		Sphere,
+		Box,
+		Capsule,
+		Num,
+		None = Num,
+	};
+
+	/**
+	 * A shape's location in FShapeBatchCache.
+	 */
+	struct FShapeBatchHandle
+	{
+		EShapeBatchType Type = EShapeBatchType::None;
+		int32 Index = INDEX_NONE;
+
+		bool IsValid() const
+		{
+			return Type != EShapeBatchType::None;
+		}
+	};
+
+	/**
+	 * A pair of shapes to run through one of the FShapeBatchCache narrow phase kernels, as indices into the batches of
+	 * the kernel's shape types.
+	 */
+	struct FShapeBatchPair
+	{
+		int32 IndexA;
+		int32 IndexB;
+	};
+
+	/**
+	 * An opt-in cache of world-space sphere, box and capsule shapes grouped by type, with each batch stored as
+	 * structure-of-arrays floats relative to a cache origin.
+	 *
+	 * The cache is built once per tick from the shapes that the broad phase will produce pairs for. Pairs of cached
+	 * shapes can then be processed by the ComputeXXXDistances kernels several pairs at a time (4 or 8 wide, depending
+	 * on the ISPC target) instead of one GJK query per pair through the shape's implicit object.
+	 *
+	 * Only unscaled, non-instanced spheres, boxes and capsules are cached. AddShape returns an invalid handle for
+	 * everything else, and those pairs should go through the regular narrow phase.
+	 *
+	 * All kernels output Phi, the separation distance (negative when overlapping), and the contact normal pointing from
+	 * shape B towards shape A, in the same convention as the GJK/EPA based collision functions.
+	 */
+	class FShapeBatchCache
+	{
+	public:
+		/** Empty the cache. Cached positions are stored relative to Origin, which should be near the shapes for precision. */
+		CHAOS_API void Reset(const FVec3& InOrigin);
+
+		/** Add a shape with the world transform of its leaf geometry. Returns an invalid handle if the shape type is not batched. */
+		CHAOS_API FShapeBatchHandle AddShape(const FPerShapeData* Shape, const FRigidTransform3& LeafWorldTransform);
+
+		/** Add a sphere, box or capsule implicit object with its world transform. Returns an invalid handle for other types. */
+		CHAOS_API FShapeBatchHandle AddImplicitObject(const FImplicitObject* Implicit, const FRigidTransform3& WorldTransform, const FPerShapeData* Shape = nullptr);
+
+		int32 Num(const EShapeBatchType Type) const
+		{
+			return Shapes[(int32)Type].Num();
+		}
+
+		const FPerShapeData* GetShape(const FShapeBatchHandle Handle) const
+		{
+			return Shapes[(int32)Handle.Type][Handle.Index];
+		}
+
+		const FVec3& GetOrigin() const
+		{
+			return Origin;
+		}
+
+		/** Sphere (A) vs sphere (B) */
+		CHAOS_API void ComputeSphereSphereDistances(TArrayView<const FShapeBatchPair> Pairs, TArrayView<FRealSingle> OutPhis, TArrayView<FVec3f> OutNormals) const;
+
+		/** Sphere (A) vs box (B) */
+		CHAOS_API void ComputeSphereBoxDistances(TArrayView<const FShapeBatchPair> Pairs, TArrayView<FRealSingle> OutPhis, TArrayView<FVec3f> OutNormals) const;
+
+		/** Sphere (A) vs capsule (B) */
+		CHAOS_API void ComputeSphereCapsuleDistances(TArrayView<const FShapeBatchPair> Pairs, TArrayView<FRealSingle> OutPhis, TArrayView<FVec3f> OutNormals) const;
+
+	private:
+		struct FSphereBatch
+		{
+			TArray<FRealSingle> X, Y, Z;
+			TArray<FRealSingle> Radius;
+		};
+
+		// Oriented boxes: center, world space box axes indexed by [Axis][Component] and half extents including the margin
+		struct FBoxBatch
+		{
+			TArray<FRealSingle> X, Y, Z;
+			TArray<FRealSingle> Axes[3][3];
+			TArray<FRealSingle> Extent[3];
+		};
+
+		struct FCapsuleBatch
+		{
+			TArray<FRealSingle> X1, Y1, Z1;
+			TArray<FRealSingle> X2, Y2, Z2;
+			TArray<FRealSingle> Radius;
+		};
+
+		FVec3 Origin = FVec3(0);
+		FSphereBatch Spheres;
+		FBoxBatch Boxes;
+		FCapsuleBatch Capsules;
+		TArray<const FPerShapeData*> Shapes[(int32)EShapeBatchType::Num];
+	};
+}
@@ -0,0 +1,214 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Iris/ReplicationSystem/Prioritization/SpatialGridSphereWithOwnerBoostNetObjectPrioritizer.h"
+#include "Iris/Core/IrisProfiler.h"
+#include "Iris/ReplicationSystem/ReplicationView.h"
+
+void USpatialGridSphereWithOwnerBoostNetObjectPrioritizer::Init(FNetObjectPrioritizerInitParams& Params)
+{
+	Super::Init(Params);
+
+	const USpatialGridSphereWithOwnerBoostNetObjectPrioritizerConfig* GridConfig = CastChecked<USpatialGridSphereWithOwnerBoostNetObjectPrioritizerConfig>(Params.Config);
+	OuterRadius = GridConfig->OuterRadius;
+	OutsidePriority = GridConfig->OutsidePriority;
+	OwnerPriorityBoost = GridConfig->OwnerPriorityBoost;
+	MinObjectCountForCulling = GridConfig->MinObjectCountForCulling;
+	CellSize = GridConfig->CellSize > 0.0f ? GridConfig->CellSize : FMath::Max(OuterRadius, 1.0f);
+	InvCellSize = 1.0f/CellSize;
+}
+
+void USpatialGridSphereWithOwnerBoostNetObjectPrioritizer::Deinit()
+{
+	Super::Deinit();
+
+	CellObjects.Empty();
+	ObjectCells.Empty();
+	ObjectCellSlots.Empty();
+	NearObjectStamps.Empty();
+	NearObjectIndices.Empty();
+}
+
+bool USpatialGridSphereWithOwnerBoostNetObjectPrioritizer::AddObject(uint32 ObjectIndex, FNetObjectPrioritizerAddObjectParams& Params)
+{
+	if (!Super::AddObject(ObjectIndex, Params))
+	{
+		return false;
+	}
+
+	if (ObjectIndex >= static_cast<uint32>(ObjectCells.Num()))
+	{
+		const int32 PrevObjectCount = ObjectCells.Num();
+		const int32 NewObjectCount = FMath::Max(static_cast<int32>(ObjectIndex) + 1, PrevObjectCount*2);
+		ObjectCells.SetNumZeroed(NewObjectCount);
+		NearObjectStamps.SetNumZeroed(NewObjectCount);
+		ObjectCellSlots.SetNumUninitialized(NewObjectCount);
+		for (int32 SlotIt = PrevObjectCount; SlotIt < NewObjectCount; ++SlotIt)
+		{
+			ObjectCellSlots[SlotIt] = InvalidCellSlot;
+		}
+	}
+
+	AddToCell(ObjectIndex, GetCell(static_cast<const FObjectLocationInfo&>(Params.OutInfo)));
+
+	return true;
+}
+
+void USpatialGridSphereWithOwnerBoostNetObjectPrioritizer::RemoveObject(uint32 ObjectIndex, const FNetObjectPrioritizationInfo& Info)
+{
+	RemoveFromCell(ObjectIndex);
+
+	Super::RemoveObject(ObjectIndex, Info);
+}
+
+void USpatialGridSphereWithOwnerBoostNetObjectPrioritizer::UpdateObjects(FNetObjectPrioritizerUpdateParams& Params)
+{
+	Super::UpdateObjects(Params);
+
+	IRIS_PROFILER_SCOPE(USpatialGridSphereWithOwnerBoostNetObjectPrioritizer_UpdateGrid);
+
+	// Only objects that moved to another cell touch the grid.
+	for (const uint32 ObjectIndex : MakeArrayView(Params.ObjectIndices, Params.ObjectCount))
+	{
+		const FObjectLocationInfo& ObjectInfo = static_cast<const FObjectLocationInfo&>(Params.PrioritizationInfos[ObjectIndex]);
+		const FIntPoint Cell = GetCell(ObjectInfo);
+		if (Cell != ObjectCells[ObjectIndex])
+		{
+			RemoveFromCell(ObjectIndex);
+			AddToCell(ObjectIndex, Cell);
+		}
+	}
+}
+
+void USpatialGridSphereWithOwnerBoostNetObjectPrioritizer::Prioritize(FNetObjectPrioritizationParams& PrioritizationParams)
+{
+	IRIS_PROFILER_SCOPE(USpatialGridSphereWithOwnerBoostNetObjectPrioritizer_Prioritize);
+
+	if (PrioritizationParams.ObjectCount < MinObjectCountForCulling)
+	{
+		Super::Prioritize(PrioritizationParams);
+		return;
+	}
+
+	// A new stamp invalidates the near marks of the previous call without clearing them.
+	if (++NearObjectStamp == 0U)
+	{
+		FMemory::Memzero(NearObjectStamps.GetData(), NearObjectStamps.Num()*sizeof(uint32));
+		NearObjectStamp = 1U;
+	}
+
+	MarkObjectsNearViews(PrioritizationParams.View);
+
+	// Objects outside of every queried cell are further away than the outer radius from all views.
+	// Assign what the sphere prioritization would and only keep the near objects for it, in their original order.
+	// The owning connection is the copy cached in UpdateObjects, which is also what the sphere prioritization compares against.
+	const uint32 ConnectionId = PrioritizationParams.ConnectionId;
+	float* Priorities = PrioritizationParams.Priorities;
+
+	NearObjectIndices.Reset();
+	for (const uint32 ObjectIndex : MakeArrayView(PrioritizationParams.ObjectIndices, PrioritizationParams.ObjectCount))
+	{
+		if (NearObjectStamps[ObjectIndex] == NearObjectStamp)
+		{
+			NearObjectIndices.Add(ObjectIndex);
+			continue;
+		}
+
+		float Priority = FMath::Max(Priorities[ObjectIndex], OutsidePriority);
+		if (GetOwningConnection(static_cast<const FObjectLocationInfo&>(PrioritizationParams.PrioritizationInfos[ObjectIndex])) == ConnectionId)
+		{
+			Priority += OwnerPriorityBoost;
+		}
+		Priorities[ObjectIndex] = Priority;
+	}
+
+	if (NearObjectIndices.Num() > 0)
+	{
+		FNetObjectPrioritizationParams NearPrioritizationParams(PrioritizationParams);
+		NearPrioritizationParams.ObjectIndices = NearObjectIndices.GetData();
+		NearPrioritizationParams.ObjectCount = static_cast<uint32>(NearObjectIndices.Num());
+		Super::Prioritize(NearPrioritizationParams);
+	}
+}
+
+FIntPoint USpatialGridSphereWithOwnerBoostNetObjectPrioritizer::GetCell(const FObjectLocationInfo& Info) const
+{
+	const VectorRegister Location = GetLocation(Info);
+	const double X = VectorGetComponent(Location, 0);
+	const double Y = VectorGetComponent(Location, 1);
+	return FIntPoint(FMath::FloorToInt32(X*InvCellSize), FMath::FloorToInt32(Y*InvCellSize));
+}
+
+void USpatialGridSphereWithOwnerBoostNetObjectPrioritizer::AddToCell(uint32 ObjectIndex, FIntPoint Cell)
+{
+	TArray<uint32>& Objects = CellObjects.FindOrAdd(Cell);
+	ObjectCells[ObjectIndex] = Cell;
+	ObjectCellSlots[ObjectIndex] = Objects.Add(ObjectIndex);
+}
+
+void USpatialGridSphereWithOwnerBoostNetObjectPrioritizer::RemoveFromCell(uint32 ObjectIndex)
+{
+	const int32 Slot = ObjectCellSlots[ObjectIndex];
+	if (Slot == InvalidCellSlot)
+	{
+		return;
+	}
+
+	const FIntPoint Cell = ObjectCells[ObjectIndex];
+	TArray<uint32>& Objects = CellObjects.FindChecked(Cell);
+
+	// Move the last object of the cell into the freed slot.
+	const uint32 LastObjectIndex = Objects.Last();
+	Objects[Slot] = LastObjectIndex;
+	ObjectCellSlots[LastObjectIndex] = Slot;
+	Objects.Pop(EAllowShrinking::No);
+
+	if (Objects.Num() == 0)
+	{
+		CellObjects.Remove(Cell);
+	}
+
+	ObjectCellSlots[ObjectIndex] = InvalidCellSlot;
+}
+
+void USpatialGridSphereWithOwnerBoostNetObjectPrioritizer::MarkObjectsNearViews(const UE::Net::FReplicationView& View)
+{
+	IRIS_PROFILER_SCOPE(USpatialGridSphereWithOwnerBoostNetObjectPrioritizer_MarkObjectsNearViews);
+
+	for (const UE::Net::FReplicationView::FView& ViewInfo : View.Views)
+	{
+		const FIntPoint MinCell(FMath::FloorToInt32((ViewInfo.Pos.X - OuterRadius)*InvCellSize), FMath::FloorToInt32((ViewInfo.Pos.Y - OuterRadius)*InvCellSize));
+		const FIntPoint MaxCell(FMath::FloorToInt32((ViewInfo.Pos.X + OuterRadius)*InvCellSize), FMath::FloorToInt32((ViewInfo.Pos.Y + OuterRadius)*InvCellSize));
+
+		// With small cells or few objects it is cheaper to visit the occupied cells than every cell in the view box.
+		const int64 BoxCellCount = int64(MaxCell.X - MinCell.X + 1)*int64(MaxCell.Y - MinCell.Y + 1);
+		if (BoxCellCount > CellObjects.Num())
+		{
+			for (const TPair<FIntPoint, TArray<uint32>>& CellAndObjects : CellObjects)
+			{
+				const FIntPoint& Cell = CellAndObjects.Key;
+				if (Cell.X >= MinCell.X && Cell.X <= MaxCell.X && Cell.Y >= MinCell.Y && Cell.Y <= MaxCell.Y)
+				{
+					for (const uint32 ObjectIndex : CellAndObjects.Value)
+					{
+						NearObjectStamps[ObjectIndex] = NearObjectStamp;
+					}
+				}
+			}
+			continue;
+		}
+
+		for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+		{
+			for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+			{
+				if (const TArray<uint32>* Objects = CellObjects.Find(FIntPoint(CellX, CellY)))
+				{
+					for (const uint32 ObjectIndex : *Objects)
+					{
+						NearObjectStamps[ObjectIndex] = NearObjectStamp;
+					}
+				}
+			}
+		}
+	}
+}
@@ -5,9 +5,27 @@
 #include "Iris/ReplicationSystem/Filtering/ReplicationFiltering.h"
 #include "Iris/ReplicationSystem/ReplicationSystem.h"
 #include "Iris/ReplicationSystem/ReplicationSystemInternal.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
 #include "Misc/MemStack.h"
 #include <limits>
 
+namespace UE::Net::Private
+{
+
+// Trade-off memory/performance
+static constexpr uint32 SphereWithOwnerBoostMaxBatchObjectCount = 1024U;
+
+// Prioritize is called once per connection, so going wide costs a ParallelFor per connection per frame. Whether that pays off depends on
+// the connection count and the hardware, measure with the PrioritizationTimeVersusConnectionAndObjectCount test before enabling it.
+static int32 GSphereWithOwnerBoostParallelObjectCount = 0;
+static FAutoConsoleVariableRef CVarSphereWithOwnerBoostParallelObjectCount(
+	TEXT("net.Iris.SphereWithOwnerBoostPrioritizer.ParallelObjectCount"),
+	GSphereWithOwnerBoostParallelObjectCount,
+	TEXT("When a connection has at least this many objects to prioritize its batches are prioritized in parallel on task workers. 0 disables parallel prioritization (default)."));
+
+}
+
 void USphereWithOwnerBoostNetObjectPrioritizer::Init(FNetObjectPrioritizerInitParams& Params)
 {
 	// Make sure our ConnectionId type is sufficient.
@@ -77,26 +95,46 @@ void USphereWithOwnerBoostNetObjectPrioritizer::Prioritize(FNetObjectPrioritizat
 {
 	IRIS_PROFILER_SCOPE(USphereWithOwnerBoostNetObjectPrioritizer_Prioritize);
 
-	FMemStack& Mem = FMemStack::Get();
-	FMemMark MemMark(Mem);
+	using namespace UE::Net::Private;
 
-	// Trade-off memory/performance
-	constexpr uint32 MaxBatchObjectCount = 1024U;
+	const uint32 ObjectCount = PrioritizationParams.ObjectCount;
+	const uint32 BatchCount = FMath::DivideAndRoundUp(ObjectCount, SphereWithOwnerBoostMaxBatchObjectCount);
 
-	FOwnerBoostBatchParams BatchParams;
-	const uint32 BatchObjectCount = FMath::Min((PrioritizationParams.ObjectCount + 3U) & ~3U, MaxBatchObjectCount);
-	SetupBatchParams(BatchParams, PrioritizationParams, BatchObjectCount, Mem);
-
-	for (uint32 ObjectIt = 0, ObjectEndIt = PrioritizationParams.ObjectCount; ObjectIt < ObjectEndIt; )
+	// Batches only read shared state and write the priorities of their own objects, so the result is the same regardless of which thread runs which batch.
+	auto PrioritizeBatches = [this, &PrioritizationParams, ObjectCount](uint32 BatchBeginIt, uint32 BatchEndIt)
 	{
-		const uint32 CurrentBatchObjectCount = FMath::Min(ObjectEndIt - ObjectIt, MaxBatchObjectCount);
+		// FMemStack is per thread so every worker uses its own scratch memory.
+		FMemStack& Mem = FMemStack::Get();
+		FMemMark MemMark(Mem);
+
+		FOwnerBoostBatchParams BatchParams;
+		const uint32 BatchObjectCount = FMath::Min((ObjectCount + 3U) & ~3U, SphereWithOwnerBoostMaxBatchObjectCount);
+		SetupBatchParams(BatchParams, PrioritizationParams, BatchObjectCount, Mem);
 
-		BatchParams.ObjectCount = CurrentBatchObjectCount;
-		PrepareBatch(BatchParams, PrioritizationParams, ObjectIt);
-		PrioritizeBatch(BatchParams);
-		FinishBatch(BatchParams, PrioritizationParams, ObjectIt);
+		for (uint32 ObjectIt = BatchBeginIt*SphereWithOwnerBoostMaxBatchObjectCount, ObjectEndIt = FMath::Min(BatchEndIt*SphereWithOwnerBoostMaxBatchObjectCount, ObjectCount); ObjectIt < ObjectEndIt; )
+		{
+			const uint32 CurrentBatchObjectCount = FMath::Min(ObjectEndIt - ObjectIt, SphereWithOwnerBoostMaxBatchObjectCount);
+
+			BatchParams.ObjectCount = CurrentBatchObjectCount;
+			PrepareBatch(BatchParams, PrioritizationParams, ObjectIt);
+			PrioritizeBatch(BatchParams);
+			FinishBatch(BatchParams, PrioritizationParams, ObjectIt);
+
+			ObjectIt += CurrentBatchObjectCount;
+		}
+	};
 
-		ObjectIt += CurrentBatchObjectCount;
+	const bool bPrioritizeInParallel = BatchCount > 1U && GSphereWithOwnerBoostParallelObjectCount > 0 && ObjectCount >= static_cast<uint32>(GSphereWithOwnerBoostParallelObjectCount);
+	if (bPrioritizeInParallel)
+	{
+		ParallelFor(TEXT("USphereWithOwnerBoostNetObjectPrioritizer::Prioritize"), static_cast<int32>(BatchCount), 1, [&PrioritizeBatches](int32 BatchIndex)
+		{
+			PrioritizeBatches(static_cast<uint32>(BatchIndex), static_cast<uint32>(BatchIndex) + 1U);
+		});
+	}
+	else
+	{
+		PrioritizeBatches(0U, BatchCount);
 	}
 }
 
@@ -1,11 +1,281 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Iris/Serialization/EnumNetSerializers.h"
+#include "Iris/Serialization/EnumNetSerializerBatch.h"
 #include "Iris/Serialization/IntRangeNetSerializerUtils.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+#include "Containers/Map.h"
+#include "Misc/ScopeRWLock.h"
+#include "Templates/SharedPointer.h"
+#include "UObject/Class.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/WeakObjectPtrTemplates.h"
 
 namespace UE::Net::Private
 {
 
+/**
+ * The values of a UEnum in a form that is quick to query. Enums spanning at most MaxBitCount values
+ * use one bit per value between the smallest and largest value, others fall back to a sorted array.
+ */
+class FEnumValidValues
+{
+public:
+	explicit FEnumValidValues(const UEnum* InEnum)
+	: Enum(InEnum)
+	, NumEnums(InEnum->NumEnums())
+	{
+		TArray<int64> Values;
+		Values.Reserve(NumEnums);
+		for (int32 EnumIndex = 0; EnumIndex < NumEnums; ++EnumIndex)
+		{
+			Values.Add(InEnum->GetValueByIndex(EnumIndex));
+		}
+		Algo::Sort(Values);
+
+		if (Values.Num() == 0)
+		{
+			return;
+		}
+
+		MinValue = Values[0];
+		const uint64 Span = static_cast<uint64>(Values.Last() - MinValue) + 1U;
+		if (Span <= MaxBitCount)
+		{
+			BitCount = static_cast<uint32>(Span);
+			ValidBits.SetNumZeroed(FMath::DivideAndRoundUp(BitCount, 64U));
+			for (const int64 Value : Values)
+			{
+				const uint64 Offset = static_cast<uint64>(Value - MinValue);
+				ValidBits[Offset >> 6U] |= 1ULL << (Offset & 63U);
+			}
+			bIsContiguous = (Span == static_cast<uint64>(Algo::Unique(Values)));
+		}
+		else
+		{
+			SortedValues = MoveTemp(Values);
+		}
+	}
+
+	/**
+	 * Whether the table still describes the enum. Enums can be garbage collected or reloaded with a different number of values.
+	 * Edits that keep the number of values are handled by FEnumValidValuesCache dropping the table when it is notified of them.
+	 */
+	bool IsUpToDate(const UEnum* InEnum) const
+	{
+		return Enum.Get() == InEnum && InEnum->NumEnums() == NumEnums;
+	}
+
+	bool IsStale() const
+	{
+		return !Enum.IsValid();
+	}
+
+	/** True if every value between the smallest and largest enum value is valid, in which case the range check is enough */
+	bool IsContiguous() const
+	{
+		return bIsContiguous;
+	}
+
+	bool IsValidValue(const int64 Value) const
+	{
+		const uint64 Offset = static_cast<uint64>(Value - MinValue);
+		if (Offset < BitCount)
+		{
+			return (ValidBits[Offset >> 6U] & (1ULL << (Offset & 63U))) != 0U;
+		}
+		return SortedValues.Num() > 0 && Algo::BinarySearch(SortedValues, Value) != INDEX_NONE;
+	}
+
+private:
+	static constexpr uint64 MaxBitCount = 64U*1024U;
+
+	TWeakObjectPtr<const UEnum> Enum;
+	TArray<uint64> ValidBits;
+	TArray<int64> SortedValues;
+	int64 MinValue = 0;
+	uint32 BitCount = 0;
+	int32 NumEnums = 0;
+	bool bIsContiguous = false;
+};
+
+/**
+ * FEnumValidValues per UEnum, shared by all serializer configs using the enum. Callers hold a reference to the table they use,
+ * so replaced tables are freed as soon as the last caller is done with them.
+ */
+class FEnumValidValuesCache
+{
+public:
+	using FTableRef = TSharedRef<const FEnumValidValues, ESPMode::ThreadSafe>;
+
+	static FEnumValidValuesCache& Get()
+	{
+		static FEnumValidValuesCache Cache;
+		return Cache;
+	}
+
+#if WITH_EDITOR
+	FEnumValidValuesCache()
+	{
+		// User defined enums are edited, and undone, in place. Both end in PostEditChange, so drop the table then rather than
+		// checking the values on every lookup. Reloads can replace values of native enums.
+		ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FEnumValidValuesCache::OnObjectPropertyChanged);
+		ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddRaw(this, &FEnumValidValuesCache::OnReloadComplete);
+	}
+
+	~FEnumValidValuesCache()
+	{
+		FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+		FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+	}
+#endif
+
+	FTableRef FindOrAdd(const UEnum* Enum)
+	{
+		{
+			FReadScopeLock ReadLock(Lock);
+			if (const FTableRef* ValidValues = Tables.Find(Enum))
+			{
+				if ((*ValidValues)->IsUpToDate(Enum))
+				{
+					return *ValidValues;
+				}
+			}
+		}
+
+		FWriteScopeLock WriteLock(Lock);
+		if (const FTableRef* ValidValues = Tables.Find(Enum))
+		{
+			if ((*ValidValues)->IsUpToDate(Enum))
+			{
+				return *ValidValues;
+			}
+		}
+
+		// Rare, also forget the tables of enums that were collected since
+		for (TMap<const UEnum*, FTableRef>::TIterator It = Tables.CreateIterator(); It; ++It)
+		{
+			if (It.Value()->IsStale())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		FTableRef NewValidValues = MakeShared<const FEnumValidValues, ESPMode::ThreadSafe>(Enum);
+		Tables.Add(Enum, NewValidValues);
+		return NewValidValues;
+	}
+
+private:
+#if WITH_EDITOR
+	void OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+	{
+		if (const UEnum* Enum = Cast<UEnum>(Object))
+		{
+			FWriteScopeLock WriteLock(Lock);
+			Tables.Remove(Enum);
+		}
+	}
+
+	void OnReloadComplete(EReloadCompleteReason Reason)
+	{
+		FWriteScopeLock WriteLock(Lock);
+		Tables.Reset();
+	}
+
+	FDelegateHandle ObjectPropertyChangedHandle;
+	FDelegateHandle ReloadCompleteHandle;
+#endif
+
+	FRWLock Lock;
+	TMap<const UEnum*, FTableRef> Tables;
+};
+
+/** Scalar validation scans enums with at most this many values, which is cheaper than the locked table lookup. */
+static constexpr int32 EnumValidValuesTableMinNumEnums = 32;
+
+/** Values are processed in blocks of this size using branch free compares that the compiler turns into SIMD compares. */
+static constexpr uint32 EnumBatchBlockSize = 16U;
+
+template<typename SourceType>
+static bool AreValuesInRange(const SourceType* Values, uint32 Count, const SourceType LowerBound, const SourceType UpperBound)
+{
+	uint32 ValueIt = 0;
+	for (; ValueIt + EnumBatchBlockSize <= Count; ValueIt += EnumBatchBlockSize)
+	{
+		const SourceType* Block = Values + ValueIt;
+		uint32 OutOfRange = 0;
+		for (uint32 BlockIt = 0; BlockIt < EnumBatchBlockSize; ++BlockIt)
+		{
+			OutOfRange |= static_cast<uint32>(Block[BlockIt] < LowerBound) | static_cast<uint32>(Block[BlockIt] > UpperBound);
+		}
+
+		if (OutOfRange)
+		{
+			return false;
+		}
+	}
+
+	for (; ValueIt < Count; ++ValueIt)
+	{
+		if (Values[ValueIt] < LowerBound || Values[ValueIt] > UpperBound)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename SourceType, typename ConfigType>
+static bool ValidateEnumValuesImpl(const ConfigType& Config, const SourceType* Values, uint32 Count)
+{
+	// Detect invalid bit count
+	if (Config.BitCount > sizeof(SourceType)*8U)
+	{
+		return false;
+	}
+
+	// Detect values outside of the valid range. This check needs to be performed before the enum check due to the generated _MAX value.
+	if (!AreValuesInRange(Values, Count, Config.LowerBound, Config.UpperBound))
+	{
+		return false;
+	}
+
+	if (const UEnum* Enum = Config.Enum)
+	{
+		const FEnumValidValuesCache::FTableRef ValidValues = FEnumValidValuesCache::Get().FindOrAdd(Enum);
+		if (!ValidValues->IsContiguous())
+		{
+			for (uint32 ValueIt = 0; ValueIt < Count; ++ValueIt)
+			{
+				if (!ValidValues->IsValidValue(static_cast<int64>(Values[ValueIt])))
+				{
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+template<typename SourceType, typename QuantizedType, typename ConfigType>
+static void QuantizeEnumValuesImpl(const ConfigType& Config, const SourceType* Values, QuantizedType* OutQuantized, uint32 Count)
+{
+	const SourceType LowerBound = Config.LowerBound;
+	const SourceType UpperBound = Config.UpperBound;
+	for (uint32 ValueIt = 0; ValueIt < Count; ++ValueIt)
+	{
+		// Clamp and rebase on the lower bound like FIntRangeNetSerializerBase::Quantize, written without branches so that it vectorizes
+		const SourceType Value = Values[ValueIt];
+		const SourceType ClampedValue = Value < LowerBound ? LowerBound : (Value > UpperBound ? UpperBound : Value);
+		OutQuantized[ValueIt] = static_cast<QuantizedType>(static_cast<QuantizedType>(ClampedValue) - static_cast<QuantizedType>(LowerBound));
+	}
+}
+
 template<typename InSourceType, typename EnumNetSerializerConfig>
 struct FEnumNetSerializerBase : public FIntRangeNetSerializerBase<InSourceType, EnumNetSerializerConfig>
 {
@@ -29,10 +299,15 @@ struct FEnumNetSerializerBase : public FIntRangeNetSerializerBase<InSourceType,
 			return false;
 		}
 
-		// This is slow as it will go through all values in the enum.
+		// Large enums are checked against a table rather than walking all values in the enum.
 		if (const UEnum* Enum = Config->Enum)
 		{
-			return Enum->IsValidEnumValue(Value);
+			if (Enum->NumEnums() < EnumValidValuesTableMinNumEnums)
+			{
+				return Enum->IsValidEnumValue(Value);
+			}
+			const FEnumValidValuesCache::FTableRef ValidValues = FEnumValidValuesCache::Get().FindOrAdd(Enum);
+			return ValidValues->IsContiguous() || ValidValues->IsValidValue(static_cast<int64>(Value));
 		}
 
 		return true;
@@ -84,4 +359,84 @@ struct FEnumUint64NetSerializer : public Private::FEnumNetSerializerBase<uint64,
 };
 UE_NET_IMPLEMENT_SERIALIZER(FEnumUint64NetSerializer);
 
+bool ValidateEnumValues(const FEnumInt8NetSerializerConfig& Config, const int8* Values, uint32 Count)
+{
+	return Private::ValidateEnumValuesImpl(Config, Values, Count);
+}
+
+bool ValidateEnumValues(const FEnumInt16NetSerializerConfig& Config, const int16* Values, uint32 Count)
+{
+	return Private::ValidateEnumValuesImpl(Config, Values, Count);
+}
+
+bool ValidateEnumValues(const FEnumInt32NetSerializerConfig& Config, const int32* Values, uint32 Count)
+{
+	return Private::ValidateEnumValuesImpl(Config, Values, Count);
+}
+
+bool ValidateEnumValues(const FEnumInt64NetSerializerConfig& Config, const int64* Values, uint32 Count)
+{
+	return Private::ValidateEnumValuesImpl(Config, Values, Count);
+}
+
+bool ValidateEnumValues(const FEnumUint8NetSerializerConfig& Config, const uint8* Values, uint32 Count)
+{
+	return Private::ValidateEnumValuesImpl(Config, Values, Count);
+}
+
+bool ValidateEnumValues(const FEnumUint16NetSerializerConfig& Config, const uint16* Values, uint32 Count)
+{
+	return Private::ValidateEnumValuesImpl(Config, Values, Count);
+}
+
+bool ValidateEnumValues(const FEnumUint32NetSerializerConfig& Config, const uint32* Values, uint32 Count)
+{
+	return Private::ValidateEnumValuesImpl(Config, Values, Count);
+}
+
+bool ValidateEnumValues(const FEnumUint64NetSerializerConfig& Config, const uint64* Values, uint32 Count)
+{
+	return Private::ValidateEnumValuesImpl(Config, Values, Count);
+}
+
+void QuantizeEnumValues(const FEnumInt8NetSerializerConfig& Config, const int8* Values, uint8* OutQuantized, uint32 Count)
+{
+	Private::QuantizeEnumValuesImpl(Config, Values, OutQuantized, Count);
+}
+
+void QuantizeEnumValues(const FEnumInt16NetSerializerConfig& Config, const int16* Values, uint16* OutQuantized, uint32 Count)
+{
+	Private::QuantizeEnumValuesImpl(Config, Values, OutQuantized, Count);
+}
+
+void QuantizeEnumValues(const FEnumInt32NetSerializerConfig& Config, const int32* Values, uint32* OutQuantized, uint32 Count)
+{
+	Private::QuantizeEnumValuesImpl(Config, Values, OutQuantized, Count);
+}
+
+void QuantizeEnumValues(const FEnumInt64NetSerializerConfig& Config, const int64* Values, uint64* OutQuantized, uint32 Count)
+{
+	Private::QuantizeEnumValuesImpl(Config, Values, OutQuantized, Count);
+}
+
+void QuantizeEnumValues(const FEnumUint8NetSerializerConfig& Config, const uint8* Values, uint8* OutQuantized, uint32 Count)
+{
+	Private::QuantizeEnumValuesImpl(Config, Values, OutQuantized, Count);
+}
+
+void QuantizeEnumValues(const FEnumUint16NetSerializerConfig& Config, const uint16* Values, uint16* OutQuantized, uint32 Count)
+{
+	Private::QuantizeEnumValuesImpl(Config, Values, OutQuantized, Count);
+}
+
+void QuantizeEnumValues(const FEnumUint32NetSerializerConfig& Config, const uint32* Values, uint32* OutQuantized, uint32 Count)
+{
+	Private::QuantizeEnumValuesImpl(Config, Values, OutQuantized, Count);
+}
+
+void QuantizeEnumValues(const FEnumUint64NetSerializerConfig& Config, const uint64* Values, uint64* OutQuantized, uint32 Count)
+{
+	Private::QuantizeEnumValuesImpl(Config, Values, OutQuantized, Count);
+}
+
 }
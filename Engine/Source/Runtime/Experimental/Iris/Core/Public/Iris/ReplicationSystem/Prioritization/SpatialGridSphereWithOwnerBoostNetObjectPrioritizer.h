@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Iris/ReplicationSystem/Prioritization/SphereWithOwnerBoostNetObjectPrioritizer.h"
+#include "Containers/Map.h"
+#include "Math/IntPoint.h"
+#include "SpatialGridSphereWithOwnerBoostNetObjectPrioritizer.generated.h"
+
+namespace UE::Net
+{
+	class FReplicationView;
+}
+
+UCLASS(transient, config=Engine, MinimalAPI)
+class USpatialGridSphereWithOwnerBoostNetObjectPrioritizerConfig : public USphereWithOwnerBoostNetObjectPrioritizerConfig
+{
+	GENERATED_BODY()
+
+public:
+	/** Size of a grid cell in the XY plane. Zero or less uses the outer radius. */
+	UPROPERTY(Config)
+	float CellSize = 0.0f;
+
+	/** Connections with fewer objects to prioritize than this skip the grid and prioritize every object. */
+	UPROPERTY(Config)
+	uint32 MinObjectCountForCulling = 1024;
+};
+
+/**
+ * USphereWithOwnerBoostNetObjectPrioritizer that keeps object locations in a uniform grid in the XY plane, updated as objects move.
+ * When prioritizing for a connection only objects in the cells within the outer radius of a view go through the sphere prioritization.
+ * All other objects are known to be outside of the sphere and get the outside priority, plus the owner boost for objects owned by the connection,
+ * which is the same result the sphere prioritization would give them.
+ */
+UCLASS(MinimalAPI)
+class USpatialGridSphereWithOwnerBoostNetObjectPrioritizer : public USphereWithOwnerBoostNetObjectPrioritizer
+{
+	GENERATED_BODY()
+
+protected:
+	// UNetObjectPrioritizer interface
+	IRISCORE_API virtual void Init(FNetObjectPrioritizerInitParams& Params) override;
+	IRISCORE_API virtual void Deinit() override;
+	IRISCORE_API virtual bool AddObject(uint32 ObjectIndex, FNetObjectPrioritizerAddObjectParams& Params) override;
+	IRISCORE_API virtual void RemoveObject(uint32 ObjectIndex, const FNetObjectPrioritizationInfo& Info) override;
+	IRISCORE_API virtual void UpdateObjects(FNetObjectPrioritizerUpdateParams& Params) override;
+	IRISCORE_API virtual void Prioritize(FNetObjectPrioritizationParams& PrioritizationParams) override;
+
+private:
+	static constexpr int32 InvalidCellSlot = -1;
+
+	FIntPoint GetCell(const FObjectLocationInfo& Info) const;
+	void AddToCell(uint32 ObjectIndex, FIntPoint Cell);
+	void RemoveFromCell(uint32 ObjectIndex);
+	void MarkObjectsNearViews(const UE::Net::FReplicationView& View);
+
+	float CellSize = 0.0f;
+	float InvCellSize = 0.0f;
+	float OuterRadius = 0.0f;
+	float OutsidePriority = 0.0f;
+	float OwnerPriorityBoost = 0.0f;
+	uint32 MinObjectCountForCulling = 0;
+
+	/** Object indices per grid cell, unordered. */
+	TMap<FIntPoint, TArray<uint32>> CellObjects;
+	/** Per object index, the cell the object is in and its slot in the cell's array. */
+	TArray<FIntPoint> ObjectCells;
+	TArray<int32> ObjectCellSlots;
+
+	/** Per object index, the stamp of the last Prioritize call that found the object near a view. */
+	TArray<uint32> NearObjectStamps;
+	TArray<uint32> NearObjectIndices;
+	uint32 NearObjectStamp = 0;
+};
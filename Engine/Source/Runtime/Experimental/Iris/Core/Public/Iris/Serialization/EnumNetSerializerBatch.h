@@ -0,0 +1,36 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Iris/Serialization/EnumNetSerializers.h"
+
+namespace UE::Net
+{
+
+/**
+ * Batched versions of FEnum*NetSerializer Validate and Quantize for arrays of values sharing one config.
+ * Values are processed in blocks of 16 with branch free range compares, and enums with gaps between their values
+ * are checked against a validity table built once per UEnum instead of walking the enum for every value.
+ */
+
+/** Returns true if FEnum*NetSerializer::Validate would accept each of the Count values. */
+IRISCORE_API bool ValidateEnumValues(const FEnumInt8NetSerializerConfig& Config, const int8* Values, uint32 Count);
+IRISCORE_API bool ValidateEnumValues(const FEnumInt16NetSerializerConfig& Config, const int16* Values, uint32 Count);
+IRISCORE_API bool ValidateEnumValues(const FEnumInt32NetSerializerConfig& Config, const int32* Values, uint32 Count);
+IRISCORE_API bool ValidateEnumValues(const FEnumInt64NetSerializerConfig& Config, const int64* Values, uint32 Count);
+IRISCORE_API bool ValidateEnumValues(const FEnumUint8NetSerializerConfig& Config, const uint8* Values, uint32 Count);
+IRISCORE_API bool ValidateEnumValues(const FEnumUint16NetSerializerConfig& Config, const uint16* Values, uint32 Count);
+IRISCORE_API bool ValidateEnumValues(const FEnumUint32NetSerializerConfig& Config, const uint32* Values, uint32 Count);
+IRISCORE_API bool ValidateEnumValues(const FEnumUint64NetSerializerConfig& Config, const uint64* Values, uint32 Count);
+
+/** Writes the quantized state FEnum*NetSerializer::Quantize would produce for each of the Count values. */
+IRISCORE_API void QuantizeEnumValues(const FEnumInt8NetSerializerConfig& Config, const int8* Values, uint8* OutQuantized, uint32 Count);
+IRISCORE_API void QuantizeEnumValues(const FEnumInt16NetSerializerConfig& Config, const int16* Values, uint16* OutQuantized, uint32 Count);
+IRISCORE_API void QuantizeEnumValues(const FEnumInt32NetSerializerConfig& Config, const int32* Values, uint32* OutQuantized, uint32 Count);
+IRISCORE_API void QuantizeEnumValues(const FEnumInt64NetSerializerConfig& Config, const int64* Values, uint64* OutQuantized, uint32 Count);
+IRISCORE_API void QuantizeEnumValues(const FEnumUint8NetSerializerConfig& Config, const uint8* Values, uint8* OutQuantized, uint32 Count);
+IRISCORE_API void QuantizeEnumValues(const FEnumUint16NetSerializerConfig& Config, const uint16* Values, uint16* OutQuantized, uint32 Count);
+IRISCORE_API void QuantizeEnumValues(const FEnumUint32NetSerializerConfig& Config, const uint32* Values, uint32* OutQuantized, uint32 Count);
+IRISCORE_API void QuantizeEnumValues(const FEnumUint64NetSerializerConfig& Config, const uint64* Values, uint64* OutQuantized, uint32 Count);
+
+}
@@ -0,0 +1,413 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Net/Core/Serialization/QuantizedVectorDeltaSerialization.h"
+#include "Net/Core/Serialization/QuantizedVectorSerialization.h"
+#include "Containers/Array.h"
+#include "HAL/UnrealMemory.h"
+#include "Math/UnrealMathUtility.h"
+#include "Math/Vector.h"
+#include "Misc/ByteSwap.h"
+
+namespace UE::Net::Private
+{
+
+/* Elements sharing one set of component bit widths. Also the width of the per block full precision mask. */
+static constexpr uint32 QuantizedVectorDeltaBlockSize = 16;
+static constexpr uint32 QuantizedVectorDeltaWidthBits = 6;
+
+/*
+ * Scaled components are kept well inside int64 so that the difference of two of them always fits in the 6 bit width field.
+ * Anything larger is sent at full precision anyway.
+ */
+static constexpr int64 MaxScaledComponent = int64(1) << 40;
+
+template<typename T> struct TQuantizedVectorDeltaTraits;
+
+template<> struct TQuantizedVectorDeltaTraits<FVector3d>
+{
+	using RealType = double;
+	using BitsType = uint64;
+};
+
+template<> struct TQuantizedVectorDeltaTraits<FVector3f>
+{
+	using RealType = float;
+	using BitsType = uint32;
+};
+
+/* Scaled integer used both as the exact representation of a component and as the predictor for later elements. */
+template<typename RealType>
+static int64 ToScaledComponent(const int32 Scale, const RealType Value)
+{
+	const double Scaled = double(Value)*double(Scale);
+	if (!(Scaled > double(-MaxScaledComponent) && Scaled < double(MaxScaledComponent)))
+	{
+		// Also catches NaN
+		return Scaled >= double(MaxScaledComponent) ? MaxScaledComponent : (Scaled <= double(-MaxScaledComponent) ? -MaxScaledComponent : 0);
+	}
+	return FMath::RoundToInt64(Scaled);
+}
+
+template<typename RealType>
+static RealType FromScaledComponent(const int32 Scale, const int64 Value)
+{
+	return RealType(double(Value)/double(Scale));
+}
+
+template<typename RealType>
+static bool IsBitwiseEqual(const RealType A, const RealType B)
+{
+	return FMemory::Memcmp(&A, &B, sizeof(RealType)) == 0;
+}
+
+static uint64 ZigZagEncode(const int64 Value)
+{
+	return (uint64(Value) << 1U) ^ uint64(Value >> 63);
+}
+
+static int64 ZigZagDecode(const uint64 Value)
+{
+	return int64(Value >> 1U) ^ -int64(Value & 1U);
+}
+
+class FQuantizedVectorDeltaBitWriter
+{
+public:
+	void WriteBits(const uint64 Value, const uint32 NumBits)
+	{
+		if (NumBits == 0)
+		{
+			return;
+		}
+
+		const uint64 Masked = NumBits == 64 ? Value : (Value & ((uint64(1) << NumBits) - 1U));
+		const uint32 BitOffset = uint32(BitCount & 63U);
+		if (BitOffset == 0)
+		{
+			Words.Add(Masked);
+		}
+		else
+		{
+			Words.Last() |= Masked << BitOffset;
+			if (BitOffset + NumBits > 64U)
+			{
+				Words.Add(Masked >> (64U - BitOffset));
+			}
+		}
+		BitCount += NumBits;
+	}
+
+	void Flush(FArchive& Ar)
+	{
+		uint32 NumBits = uint32(BitCount);
+		Ar.SerializeIntPacked(NumBits);
+		for (uint64& Word : Words)
+		{
+			Word = INTEL_ORDER64(Word);
+		}
+		Ar.SerializeBits(Words.GetData(), BitCount);
+	}
+
+	void Reserve(const uint64 NumBits)
+	{
+		Words.Reserve(int32((NumBits + 63U)/64U));
+	}
+
+private:
+	TArray<uint64> Words;
+	uint64 BitCount = 0;
+};
+
+class FQuantizedVectorDeltaBitReader
+{
+public:
+	bool Load(FArchive& Ar, const uint64 MaxBits)
+	{
+		uint32 NumBits = 0;
+		Ar.SerializeIntPacked(NumBits);
+		if (Ar.IsError() || NumBits > MaxBits)
+		{
+			return false;
+		}
+
+		Words.SetNumZeroed(int32((uint64(NumBits) + 63U)/64U));
+		Ar.SerializeBits(Words.GetData(), NumBits);
+		for (uint64& Word : Words)
+		{
+			Word = INTEL_ORDER64(Word);
+		}
+		BitCount = NumBits;
+		return !Ar.IsError();
+	}
+
+	uint64 ReadBits(const uint32 NumBits)
+	{
+		if (NumBits == 0)
+		{
+			return 0;
+		}
+		if (BitPos + NumBits > BitCount)
+		{
+			bOverflow = true;
+			BitPos = BitCount;
+			return 0;
+		}
+
+		const uint32 WordIndex = uint32(BitPos >> 6U);
+		const uint32 BitOffset = uint32(BitPos & 63U);
+		uint64 Value = Words[WordIndex] >> BitOffset;
+		if (BitOffset + NumBits > 64U)
+		{
+			Value |= Words[WordIndex + 1] << (64U - BitOffset);
+		}
+		BitPos += NumBits;
+		return NumBits == 64 ? Value : (Value & ((uint64(1) << NumBits) - 1U));
+	}
+
+	bool IsOverflown() const
+	{
+		return bOverflow;
+	}
+
+private:
+	TArray<uint64> Words;
+	uint64 BitCount = 0;
+	uint64 BitPos = 0;
+	bool bOverflow = false;
+};
+
+/* Upper bound of the stream size for Count elements, used to reserve when writing and to reject bogus sizes when reading. */
+template<typename VectorType>
+static uint64 GetMaxQuantizedVectorDeltaBits(const uint32 Count)
+{
+	using BitsType = typename TQuantizedVectorDeltaTraits<VectorType>::BitsType;
+	const uint64 NumBlocks = (uint64(Count) + QuantizedVectorDeltaBlockSize - 1U)/QuantizedVectorDeltaBlockSize;
+	return NumBlocks*(1U + QuantizedVectorDeltaBlockSize + 3U*QuantizedVectorDeltaWidthBits) + uint64(Count)*3U*sizeof(BitsType)*8U;
+}
+
+template<typename VectorType>
+static bool WriteQuantizedVectorDeltas(const int32 Scale, TConstArrayView<VectorType> Values, TConstArrayView<VectorType> Baseline, FArchive& Ar)
+{
+	using RealType = typename TQuantizedVectorDeltaTraits<VectorType>::RealType;
+	using BitsType = typename TQuantizedVectorDeltaTraits<VectorType>::BitsType;
+	constexpr uint32 BlockSize = QuantizedVectorDeltaBlockSize;
+
+	if (Baseline.Num() != 0 && Baseline.Num() != Values.Num())
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	uint32 Count = uint32(Values.Num());
+	Ar.SerializeIntPacked(Count);
+
+	FQuantizedVectorDeltaBitWriter Writer;
+	Writer.Reserve(GetMaxQuantizedVectorDeltaBits<VectorType>(Count)/4U);
+
+	const bool bHasBaseline = Baseline.Num() != 0;
+	int64 Previous[3] = {};
+	for (uint32 BlockStart = 0; BlockStart < Count; BlockStart += BlockSize)
+	{
+		const uint32 BlockCount = FMath::Min(BlockSize, Count - BlockStart);
+
+		// Quantize the whole block up front into one array per component, so the prediction and width passes below walk contiguous values.
+		// Quantizing and scaling are scalar and clamp out of range values. Only the delta and width loop is branch free.
+		RealType Quantized[3][BlockSize];
+		int64 Scaled[3][BlockSize];
+		int64 Predicted[3][BlockSize];
+		uint64 Deltas[3][BlockSize];
+		uint32 FullPrecisionMask = 0;
+		for (uint32 It = 0; It < BlockCount; ++It)
+		{
+			const VectorType Value = QuantizeVector(Scale, Values[BlockStart + It]);
+			bool bIsExact = true;
+			for (uint32 Component = 0; Component < 3; ++Component)
+			{
+				const RealType ComponentValue = Value[Component];
+				const int64 ScaledValue = ToScaledComponent(Scale, ComponentValue);
+				Quantized[Component][It] = ComponentValue;
+				Scaled[Component][It] = ScaledValue;
+				bIsExact &= IsBitwiseEqual(FromScaledComponent<RealType>(Scale, ScaledValue), ComponentValue);
+			}
+			FullPrecisionMask |= (bIsExact ? 0U : 1U) << It;
+		}
+
+		for (uint32 Component = 0; Component < 3; ++Component)
+		{
+			if (bHasBaseline)
+			{
+				for (uint32 It = 0; It < BlockCount; ++It)
+				{
+					Predicted[Component][It] = ToScaledComponent(Scale, RealType(Baseline[BlockStart + It][Component]));
+				}
+			}
+			else
+			{
+				Predicted[Component][0] = Previous[Component];
+				for (uint32 It = 1; It < BlockCount; ++It)
+				{
+					Predicted[Component][It] = Scaled[Component][It - 1];
+				}
+				Previous[Component] = Scaled[Component][BlockCount - 1];
+			}
+		}
+
+		uint32 Widths[3];
+		for (uint32 Component = 0; Component < 3; ++Component)
+		{
+			uint64 WidthMask = 0;
+			for (uint32 It = 0; It < BlockCount; ++It)
+			{
+				const uint64 Delta = ZigZagEncode(Scaled[Component][It] - Predicted[Component][It]);
+				Deltas[Component][It] = Delta;
+				// Full precision elements don't contribute to the width
+				WidthMask |= Delta & (uint64(0) - uint64(((FullPrecisionMask >> It) & 1U) ^ 1U));
+			}
+			Widths[Component] = 64U - uint32(FMath::CountLeadingZeros64(WidthMask));
+		}
+
+		Writer.WriteBits(FullPrecisionMask != 0 ? 1U : 0U, 1U);
+		if (FullPrecisionMask != 0)
+		{
+			Writer.WriteBits(FullPrecisionMask, BlockCount);
+		}
+		for (uint32 Component = 0; Component < 3; ++Component)
+		{
+			Writer.WriteBits(Widths[Component], QuantizedVectorDeltaWidthBits);
+		}
+
+		for (uint32 It = 0; It < BlockCount; ++It)
+		{
+			if (FullPrecisionMask & (1U << It))
+			{
+				for (uint32 Component = 0; Component < 3; ++Component)
+				{
+					BitsType Bits;
+					FMemory::Memcpy(&Bits, &Quantized[Component][It], sizeof(Bits));
+					Writer.WriteBits(Bits, sizeof(Bits)*8U);
+				}
+			}
+			else
+			{
+				for (uint32 Component = 0; Component < 3; ++Component)
+				{
+					Writer.WriteBits(Deltas[Component][It], Widths[Component]);
+				}
+			}
+		}
+	}
+
+	Writer.Flush(Ar);
+	return !Ar.IsError();
+}
+
+template<typename VectorType>
+static bool ReadQuantizedVectorDeltas(const int32 Scale, TArrayView<VectorType> OutValues, TConstArrayView<VectorType> Baseline, FArchive& Ar)
+{
+	using RealType = typename TQuantizedVectorDeltaTraits<VectorType>::RealType;
+	using BitsType = typename TQuantizedVectorDeltaTraits<VectorType>::BitsType;
+	constexpr uint32 BlockSize = QuantizedVectorDeltaBlockSize;
+
+	uint32 Count = 0;
+	Ar.SerializeIntPacked(Count);
+	if (Ar.IsError() || Count != uint32(OutValues.Num()) || (Baseline.Num() != 0 && Baseline.Num() != OutValues.Num()))
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	FQuantizedVectorDeltaBitReader Reader;
+	if (!Reader.Load(Ar, GetMaxQuantizedVectorDeltaBits<VectorType>(Count)))
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	const bool bHasBaseline = Baseline.Num() != 0;
+	int64 Previous[3] = {};
+	for (uint32 BlockStart = 0; BlockStart < Count; BlockStart += BlockSize)
+	{
+		const uint32 BlockCount = FMath::Min(BlockSize, Count - BlockStart);
+
+		const uint32 FullPrecisionMask = Reader.ReadBits(1U) ? uint32(Reader.ReadBits(BlockCount)) : 0U;
+		uint32 Widths[3];
+		for (uint32 Component = 0; Component < 3; ++Component)
+		{
+			Widths[Component] = uint32(Reader.ReadBits(QuantizedVectorDeltaWidthBits));
+		}
+
+		for (uint32 It = 0; It < BlockCount; ++It)
+		{
+			const uint32 Index = BlockStart + It;
+			VectorType& Value = OutValues[Index];
+			const bool bIsFullPrecision = (FullPrecisionMask & (1U << It)) != 0;
+			for (uint32 Component = 0; Component < 3; ++Component)
+			{
+				int64 Scaled;
+				if (bIsFullPrecision)
+				{
+					const BitsType Bits = BitsType(Reader.ReadBits(sizeof(BitsType)*8U));
+					RealType ComponentValue;
+					FMemory::Memcpy(&ComponentValue, &Bits, sizeof(Bits));
+					Value[Component] = ComponentValue;
+					Scaled = ToScaledComponent(Scale, ComponentValue);
+				}
+				else
+				{
+					const int64 Prediction = bHasBaseline ? ToScaledComponent(Scale, RealType(Baseline[Index][Component])) : Previous[Component];
+					// Unsigned add so that malformed deltas wrap instead of overflowing
+					Scaled = int64(uint64(Prediction) + uint64(ZigZagDecode(Reader.ReadBits(Widths[Component]))));
+					Value[Component] = FromScaledComponent<RealType>(Scale, Scaled);
+				}
+				Previous[Component] = Scaled;
+			}
+		}
+	}
+
+	if (Reader.IsOverflown())
+	{
+		Ar.SetError();
+		return false;
+	}
+
+	return true;
+}
+
+}
+
+namespace UE::Net
+{
+
+FQuantizedVectorDeltaWriter::FQuantizedVectorDeltaWriter(int32 InScale)
+: Scale(InScale)
+{
+	check(Scale > 0);
+}
+
+bool FQuantizedVectorDeltaWriter::Write(TConstArrayView<FVector3d> Values, TConstArrayView<FVector3d> Baseline, FArchive& Ar)
+{
+	return Private::WriteQuantizedVectorDeltas(Scale, Values, Baseline, Ar);
+}
+
+bool FQuantizedVectorDeltaWriter::Write(TConstArrayView<FVector3f> Values, TConstArrayView<FVector3f> Baseline, FArchive& Ar)
+{
+	return Private::WriteQuantizedVectorDeltas(Scale, Values, Baseline, Ar);
+}
+
+FQuantizedVectorDeltaReader::FQuantizedVectorDeltaReader(int32 InScale)
+: Scale(InScale)
+{
+	check(Scale > 0);
+}
+
+bool FQuantizedVectorDeltaReader::Read(TArrayView<FVector3d> OutValues, TConstArrayView<FVector3d> Baseline, FArchive& Ar)
+{
+	return Private::ReadQuantizedVectorDeltas(Scale, OutValues, Baseline, Ar);
+}
+
+bool FQuantizedVectorDeltaReader::Read(TArrayView<FVector3f> OutValues, TConstArrayView<FVector3f> Baseline, FArchive& Ar)
+{
+	return Private::ReadQuantizedVectorDeltas(Scale, OutValues, Baseline, Ar);
+}
+
+}
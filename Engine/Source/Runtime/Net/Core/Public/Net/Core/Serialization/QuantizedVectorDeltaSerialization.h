@@ -0,0 +1,50 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreTypes.h"
+#include "Containers/ArrayView.h"
+#include "Math/MathFwd.h"
+#include "Serialization/Archive.h"
+
+namespace UE::Net
+{
+
+/*
+ * Writes arrays of vectors quantized with QuantizeVector(Scale, Value), for dense streams such as crowd or projectile positions.
+ * Each element is predicted from the element before it, or from the same element in a baseline such as the previously sent frame,
+ * and only the difference of the quantized integer components is written. Bit widths adapt per block of 16 elements.
+ * Elements that cannot be represented as scaled integers exactly are written at full precision, so the values read back are always
+ * bitwise identical to QuantizeVector(Scale, Value).
+ */
+class FQuantizedVectorDeltaWriter
+{
+public:
+	NETCORE_API explicit FQuantizedVectorDeltaWriter(int32 InScale);
+
+	/*
+	 * Writes Values. Baseline is either empty or has as many elements as Values and must be known to the reader,
+	 * typically the values it read for the previous frame.
+	 */
+	NETCORE_API bool Write(TConstArrayView<FVector3d> Values, TConstArrayView<FVector3d> Baseline, FArchive& Ar);
+	NETCORE_API bool Write(TConstArrayView<FVector3f> Values, TConstArrayView<FVector3f> Baseline, FArchive& Ar);
+
+private:
+	int32 Scale;
+};
+
+/* Reads arrays of vectors written by FQuantizedVectorDeltaWriter with the same scale and baseline. */
+class FQuantizedVectorDeltaReader
+{
+public:
+	NETCORE_API explicit FQuantizedVectorDeltaReader(int32 InScale);
+
+	/* Reads OutValues, which must have as many elements as were written. Returns false and sets an archive error on malformed data. */
+	NETCORE_API bool Read(TArrayView<FVector3d> OutValues, TConstArrayView<FVector3d> Baseline, FArchive& Ar);
+	NETCORE_API bool Read(TArrayView<FVector3f> OutValues, TConstArrayView<FVector3f> Baseline, FArchive& Ar);
+
+private:
+	int32 Scale;
+};
+
+}
@@ -0,0 +1,180 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#if WITH_TESTS
+
+#include "Net/Core/Serialization/QuantizedVectorDeltaSerialization.h"
+#include "Net/Core/Serialization/QuantizedVectorSerialization.h"
+#include "Containers/Array.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Math/Vector.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+#include "Tests/TestHarnessAdapter.h"
+
+namespace UE::Net::QuantizedVectorDeltaTest
+{
+	/* Positions of a crowd moving a short distance each frame, sprinkled with values that need full precision. */
+	template<typename VectorType>
+	static TArray<VectorType> MakeCrowd(int32 Num, int32 Seed, bool bWithSpecialValues)
+	{
+		FRandomStream Stream(Seed);
+		TArray<VectorType> Result;
+		Result.SetNumUninitialized(Num);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			Result[Index] = VectorType(Stream.FRandRange(-50000.0f, 50000.0f), Stream.FRandRange(-50000.0f, 50000.0f), Stream.FRandRange(0.0f, 2000.0f));
+			if (bWithSpecialValues && (Index % 37) == 5)
+			{
+				Result[Index].Y = 1.0e20f;
+			}
+			if (bWithSpecialValues && (Index % 41) == 3)
+			{
+				Result[Index].Z = -0.0f;
+			}
+		}
+		return Result;
+	}
+
+	template<typename VectorType>
+	static void MoveCrowd(TArray<VectorType>& Values, int32 Seed)
+	{
+		FRandomStream Stream(Seed);
+		for (VectorType& Value : Values)
+		{
+			Value += VectorType(Stream.FRandRange(-8.0f, 8.0f), Stream.FRandRange(-8.0f, 8.0f), Stream.FRandRange(-1.0f, 1.0f));
+		}
+	}
+
+	template<typename VectorType>
+	static void TestRoundTrip(const int32 Scale, const TArray<VectorType>& Values, TConstArrayView<VectorType> Baseline)
+	{
+		FBitWriter Writer(0, true);
+		CHECK(FQuantizedVectorDeltaWriter(Scale).Write(Values, Baseline, Writer));
+
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		TArray<VectorType> ReadValues;
+		ReadValues.SetNumZeroed(Values.Num());
+		CHECK(FQuantizedVectorDeltaReader(Scale).Read(ReadValues, Baseline, Reader));
+		CHECK(Reader.GetBitsLeft() == 0);
+
+		for (int32 Index = 0; Index < Values.Num(); ++Index)
+		{
+			const VectorType Expected = QuantizeVector(Scale, Values[Index]);
+			CHECK(FMemory::Memcmp(&Expected, &ReadValues[Index], sizeof(VectorType)) == 0);
+		}
+	}
+
+	template<typename VectorType>
+	static void TestRoundTrips(const int32 Scale)
+	{
+		for (const int32 Num : {0, 1, 15, 16, 17, 1000})
+		{
+			TArray<VectorType> Values = MakeCrowd<VectorType>(Num, Num + Scale, true);
+			TestRoundTrip(Scale, Values, TConstArrayView<VectorType>());
+
+			TArray<VectorType> Baseline;
+			for (const VectorType& Value : Values)
+			{
+				Baseline.Add(QuantizeVector(Scale, Value));
+			}
+			MoveCrowd(Values, Num);
+			TestRoundTrip(Scale, Values, Baseline);
+		}
+	}
+}
+
+TEST_CASE_NAMED(FQuantizedVectorDeltaTestRoundTrip, "System::Net::Core::QuantizedVectorDelta::Matches QuantizeVector", "[Net][Core][SmokeFilter]")
+{
+	using namespace UE::Net::QuantizedVectorDeltaTest;
+
+	for (const int32 Scale : {1, 10, 100})
+	{
+		TestRoundTrips<FVector3d>(Scale);
+		TestRoundTrips<FVector3f>(Scale);
+	}
+}
+
+TEST_CASE_NAMED(FQuantizedVectorDeltaTestMalformed, "System::Net::Core::QuantizedVectorDelta::Malformed", "[Net][Core][SmokeFilter]")
+{
+	using namespace UE::Net;
+	using namespace UE::Net::QuantizedVectorDeltaTest;
+
+	const TArray<FVector3d> Values = MakeCrowd<FVector3d>(100, 1, false);
+	FBitWriter Writer(0, true);
+	FQuantizedVectorDeltaWriter(10).Write(Values, TConstArrayView<FVector3d>(), Writer);
+
+	// Element count mismatch
+	{
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+		TArray<FVector3d> ReadValues;
+		ReadValues.SetNumZeroed(99);
+		CHECK_FALSE(FQuantizedVectorDeltaReader(10).Read(ReadValues, TConstArrayView<FVector3d>(), Reader));
+		CHECK(Reader.IsError());
+	}
+
+	// Truncated stream
+	{
+		FBitReader Reader(Writer.GetData(), Writer.GetNumBits()/2);
+		TArray<FVector3d> ReadValues;
+		ReadValues.SetNumZeroed(Values.Num());
+		CHECK_FALSE(FQuantizedVectorDeltaReader(10).Read(ReadValues, TConstArrayView<FVector3d>(), Reader));
+		CHECK(Reader.IsError());
+	}
+}
+
+TEST_CASE_NAMED(FQuantizedVectorDeltaTestPerf, "System::Net::Core::QuantizedVectorDelta::Perf", "[.][Net][Core][Perf]")
+{
+	using namespace UE::Net;
+	using namespace UE::Net::QuantizedVectorDeltaTest;
+
+	constexpr int32 Scale = 10;
+	constexpr int32 NumVectors = 1 << 16;
+	constexpr int32 NumFrames = 32;
+
+	TArray<FVector3d> Values = MakeCrowd<FVector3d>(NumVectors, 0x9e3779b9, false);
+	TArray<FVector3d> Baseline;
+
+	uint64 PerElementBits = 0;
+	uint64 PerElementCycles = 0;
+	uint64 DeltaBits = 0;
+	uint64 DeltaCycles = 0;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		{
+			FBitWriter Writer(0, true);
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			for (const FVector3d& Value : Values)
+			{
+				WriteQuantizedVector(Scale, Value, Writer);
+			}
+			PerElementCycles += FPlatformTime::Cycles64() - StartCycles;
+			PerElementBits += Writer.GetNumBits();
+		}
+
+		{
+			FBitWriter Writer(0, true);
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			FQuantizedVectorDeltaWriter(Scale).Write(Values, Baseline, Writer);
+			DeltaCycles += FPlatformTime::Cycles64() - StartCycles;
+			DeltaBits += Writer.GetNumBits();
+
+			// The receiver's view of this frame becomes the baseline for the next one
+			FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+			TArray<FVector3d> ReadValues;
+			ReadValues.SetNumUninitialized(NumVectors);
+			CHECK(FQuantizedVectorDeltaReader(Scale).Read(ReadValues, Baseline, Reader));
+			Baseline = MoveTemp(ReadValues);
+		}
+
+		MoveCrowd(Values, Frame);
+	}
+
+	const double NumWritten = double(NumVectors)*NumFrames;
+	UE_LOG(LogCore, Display, TEXT("WriteQuantizedVector: %.2f bytes/vector, %.2f M vectors/s"),
+		PerElementBits/8.0/NumWritten, NumWritten/FPlatformTime::ToSeconds64(PerElementCycles)/1e6);
+	UE_LOG(LogCore, Display, TEXT("FQuantizedVectorDeltaWriter: %.2f bytes/vector, %.2f M vectors/s"),
+		DeltaBits/8.0/NumWritten, NumWritten/FPlatformTime::ToSeconds64(DeltaCycles)/1e6);
+}
+
+#endif // WITH_TESTS
@@ -395,7 +395,7 @@ namespace Audio
 		if (InNumChannels != NumChannels)
 		{
 			Smoother.SetNumChannels(InNumChannels);
-			MeanSquaredProcessor.SetNumChannels(NumChannels);
+			MeanSquaredProcessor.SetNumChannels(InNumChannels);
 			NumChannels = InNumChannels;
 		}
 	}
@@ -0,0 +1,277 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DSP/InterleavedEnvelopeFollower.h"
+#include "Math/VectorRegister.h"
+
+namespace Audio
+{
+	namespace InterleavedEnvelopeFollowerPrivate
+	{
+		// Channels left over after the groups of four, processed together so their dependency chains overlap
+		static constexpr int32 MaxScalarChannels = 3;
+	}
+
+	FInterleavedEnvelopeFollower::FInterleavedEnvelopeFollower()
+	: FInterleavedEnvelopeFollower(FEnvelopeFollowerInitParams{})
+	{
+	}
+
+	FInterleavedEnvelopeFollower::FInterleavedEnvelopeFollower(const FEnvelopeFollowerInitParams& InParams)
+	: AttackRelease(InParams.SampleRate, InParams.AttackTimeMsec, InParams.ReleaseTimeMsec, InParams.bIsAnalog)
+	{
+		Init(InParams);
+	}
+
+	void FInterleavedEnvelopeFollower::Init(const FEnvelopeFollowerInitParams& InParams)
+	{
+		AttackRelease = FAttackRelease(InParams.SampleRate, InParams.AttackTimeMsec, InParams.ReleaseTimeMsec, InParams.bIsAnalog);
+		EnvMode = InParams.Mode;
+		NumChannels = 0;
+		SetNumChannels(InParams.NumChannels);
+		SetAnalysisWindow(InParams.AnalysisWindowMsec);
+	}
+
+	int32 FInterleavedEnvelopeFollower::GetNumChannels() const
+	{
+		return NumChannels;
+	}
+
+	float FInterleavedEnvelopeFollower::GetSampleRate() const
+	{
+		return AttackRelease.GetSampleRate();
+	}
+
+	EPeakMode::Type FInterleavedEnvelopeFollower::GetMode() const
+	{
+		return EnvMode;
+	}
+
+	void FInterleavedEnvelopeFollower::SetNumChannels(int32 InNumChannels)
+	{
+		if (InNumChannels != NumChannels)
+		{
+			MeanSquaredValues.Reset(InNumChannels);
+			EnvelopeValues.Reset(InNumChannels);
+			if (ensure(InNumChannels > 0))
+			{
+				MeanSquaredValues.AddZeroed(InNumChannels);
+				EnvelopeValues.AddZeroed(InNumChannels);
+			}
+			NumChannels = MeanSquaredValues.Num();
+		}
+	}
+
+	void FInterleavedEnvelopeFollower::SetAnalog(bool bInIsAnalog)
+	{
+		AttackRelease.SetAnalog(bInIsAnalog);
+	}
+
+	void FInterleavedEnvelopeFollower::SetAttackTime(float InAttackTimeMsec)
+	{
+		AttackRelease.SetAttackTime(InAttackTimeMsec);
+	}
+
+	void FInterleavedEnvelopeFollower::SetReleaseTime(float InReleaseTimeMsec)
+	{
+		AttackRelease.SetReleaseTime(InReleaseTimeMsec);
+	}
+
+	void FInterleavedEnvelopeFollower::SetAnalysisWindow(float InAnalysisWindowMsec)
+	{
+		// Same coefficients as FMeanSquaredIIR, exponential decay set so window is 1/e at end of window
+		if (ensure(InAnalysisWindowMsec > 0.f))
+		{
+			AnalysisWindowMsec = InAnalysisWindowMsec;
+			Alpha = FMath::Exp(-1000.f / (AttackRelease.GetSampleRate() * AnalysisWindowMsec));
+			Beta = 1.f - Alpha;
+		}
+
+		Reset();
+	}
+
+	void FInterleavedEnvelopeFollower::SetMode(EPeakMode::Type InMode)
+	{
+		EnvMode = InMode;
+	}
+
+	void FInterleavedEnvelopeFollower::Reset()
+	{
+		if (NumChannels > 0)
+		{
+			FMemory::Memzero(MeanSquaredValues.GetData(), sizeof(float) * NumChannels);
+			FMemory::Memzero(EnvelopeValues.GetData(), sizeof(float) * NumChannels);
+		}
+	}
+
+	void FInterleavedEnvelopeFollower::ProcessAudio(const float* InBuffer, int32 InNumFrames, float* OutBuffer)
+	{
+		if (InNumFrames > 0 && NumChannels > 0)
+		{
+			switch (EnvMode)
+			{
+			case EPeakMode::MeanSquared:
+				ProcessAudioInternal<EPeakMode::MeanSquared, true>(InBuffer, InNumFrames, OutBuffer);
+				break;
+
+			case EPeakMode::RootMeanSquared:
+				ProcessAudioInternal<EPeakMode::RootMeanSquared, true>(InBuffer, InNumFrames, OutBuffer);
+				break;
+
+			case EPeakMode::Peak:
+				ProcessAudioInternal<EPeakMode::Peak, true>(InBuffer, InNumFrames, OutBuffer);
+				break;
+
+			default:
+				checkNoEntry();
+				break;
+			}
+		}
+	}
+
+	void FInterleavedEnvelopeFollower::ProcessAudio(const float* InBuffer, int32 InNumFrames)
+	{
+		if (InNumFrames > 0 && NumChannels > 0)
+		{
+			switch (EnvMode)
+			{
+			case EPeakMode::MeanSquared:
+				ProcessAudioInternal<EPeakMode::MeanSquared, false>(InBuffer, InNumFrames, nullptr);
+				break;
+
+			case EPeakMode::RootMeanSquared:
+				ProcessAudioInternal<EPeakMode::RootMeanSquared, false>(InBuffer, InNumFrames, nullptr);
+				break;
+
+			case EPeakMode::Peak:
+				ProcessAudioInternal<EPeakMode::Peak, false>(InBuffer, InNumFrames, nullptr);
+				break;
+
+			default:
+				checkNoEntry();
+				break;
+			}
+		}
+	}
+
+	template<EPeakMode::Type Mode, bool bWriteOutput>
+	void FInterleavedEnvelopeFollower::ProcessAudioInternal(const float* InBuffer, int32 InNumFrames, float* OutBuffer)
+	{
+		using namespace InterleavedEnvelopeFollowerPrivate;
+
+		const float AttackSamples = AttackRelease.GetAttackTimeSamples();
+		const float ReleaseSamples = AttackRelease.GetReleaseTimeSamples();
+		float* MeanSquaredData = MeanSquaredValues.GetData();
+		float* EnvelopeData = EnvelopeValues.GetData();
+
+		// Groups of four channels are processed in SIMD lanes, a frame of a group being one contiguous load from the interleaved buffer.
+		// Frames depend on the previous frame through both filters, so they can't be spread across lanes.
+		const int32 NumVectorChannels = NumChannels & ~3;
+		if (NumVectorChannels > 0)
+		{
+			const VectorRegister4Float VAlpha = VectorSetFloat1(Alpha);
+			const VectorRegister4Float VBeta = VectorSetFloat1(Beta);
+			const VectorRegister4Float VAttack = VectorSetFloat1(AttackSamples);
+			const VectorRegister4Float VRelease = VectorSetFloat1(ReleaseSamples);
+
+			for (int32 Channel = 0; Channel < NumVectorChannels; Channel += 4)
+			{
+				VectorRegister4Float VMeanSquared = VectorLoad(MeanSquaredData + Channel);
+				VectorRegister4Float VEnvelope = VectorLoad(EnvelopeData + Channel);
+
+				const float* InFrame = InBuffer + Channel;
+				float* OutFrame = bWriteOutput ? OutBuffer + Channel : nullptr;
+
+				for (int32 Frame = 0; Frame < InNumFrames; Frame++)
+				{
+					const VectorRegister4Float VSample = VectorLoad(InFrame);
+					InFrame += NumChannels;
+
+					VectorRegister4Float VDetector;
+					if constexpr (Mode == EPeakMode::Peak)
+					{
+						VDetector = VectorAbs(VSample);
+					}
+					else
+					{
+						// MS[n] = Beta * x^2[n] + Alpha * MS[n - 1]
+						VMeanSquared = VectorMultiplyAdd(VBeta, VectorMultiply(VSample, VSample), VectorMultiply(VAlpha, VMeanSquared));
+						VDetector = (Mode == EPeakMode::RootMeanSquared) ? VectorSqrt(VMeanSquared) : VMeanSquared;
+					}
+
+					// Attack when rising, release when falling
+					const VectorRegister4Float VDiff = VectorSubtract(VEnvelope, VDetector);
+					const VectorRegister4Float VCoefficient = VectorSelect(VectorCompareLE(VDiff, VectorZeroFloat()), VAttack, VRelease);
+					VEnvelope = VectorMultiplyAdd(VCoefficient, VDiff, VDetector);
+
+					if constexpr (bWriteOutput)
+					{
+						VectorStore(VEnvelope, OutFrame);
+						OutFrame += NumChannels;
+					}
+				}
+
+				VectorStore(VMeanSquared, MeanSquaredData + Channel);
+				VectorStore(VEnvelope, EnvelopeData + Channel);
+			}
+		}
+
+		const int32 NumScalarChannels = NumChannels - NumVectorChannels;
+		if (NumScalarChannels > 0)
+		{
+			float MeanSquared[MaxScalarChannels];
+			float Envelope[MaxScalarChannels];
+			for (int32 Index = 0; Index < NumScalarChannels; Index++)
+			{
+				MeanSquared[Index] = MeanSquaredData[NumVectorChannels + Index];
+				Envelope[Index] = EnvelopeData[NumVectorChannels + Index];
+			}
+
+			const float* InFrame = InBuffer + NumVectorChannels;
+			float* OutFrame = bWriteOutput ? OutBuffer + NumVectorChannels : nullptr;
+
+			for (int32 Frame = 0; Frame < InNumFrames; Frame++)
+			{
+				for (int32 Index = 0; Index < NumScalarChannels; Index++)
+				{
+					const float Sample = InFrame[Index];
+
+					float Detector;
+					if constexpr (Mode == EPeakMode::Peak)
+					{
+						Detector = FMath::Abs(Sample);
+					}
+					else
+					{
+						MeanSquared[Index] = Beta * (Sample * Sample) + Alpha * MeanSquared[Index];
+						Detector = (Mode == EPeakMode::RootMeanSquared) ? FMath::Sqrt(MeanSquared[Index]) : MeanSquared[Index];
+					}
+
+					const float Diff = Envelope[Index] - Detector;
+					Envelope[Index] = ((Diff <= 0.f) ? AttackSamples : ReleaseSamples) * Diff + Detector;
+
+					if constexpr (bWriteOutput)
+					{
+						OutFrame[Index] = Envelope[Index];
+					}
+				}
+
+				InFrame += NumChannels;
+				if constexpr (bWriteOutput)
+				{
+					OutFrame += NumChannels;
+				}
+			}
+
+			for (int32 Index = 0; Index < NumScalarChannels; Index++)
+			{
+				MeanSquaredData[NumVectorChannels + Index] = MeanSquared[Index];
+				EnvelopeData[NumVectorChannels + Index] = Envelope[Index];
+			}
+		}
+	}
+
+	const TArray<float>& FInterleavedEnvelopeFollower::GetEnvelopeValues() const
+	{
+		return EnvelopeValues;
+	}
+}
@@ -0,0 +1,155 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DSP/EnvelopeFollower.h"
+#include "DSP/InterleavedEnvelopeFollower.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace Audio::InterleavedEnvelopeFollowerTest
+{
+	constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+	static const EPeakMode::Type Modes[] = { EPeakMode::MeanSquared, EPeakMode::RootMeanSquared, EPeakMode::Peak };
+
+	// Noise bursts with silent gaps, so both attack and release are exercised
+	static void MakeInput(int32 NumChannels, int32 NumFrames, int32 Seed, TArray<float>& OutBuffer)
+	{
+		FRandomStream RandomStream(Seed);
+		OutBuffer.SetNumUninitialized(NumChannels * NumFrames);
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			const float Gain = ((Frame / 1024) % 2) ? 0.f : 0.25f + 0.1f * float((Frame / 1024) % 7);
+			for (int32 Channel = 0; Channel < NumChannels; Channel++)
+			{
+				OutBuffer[Frame * NumChannels + Channel] = Gain * RandomStream.FRandRange(-1.f, 1.f) * float(Channel + 1) / float(NumChannels);
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInterleavedEnvelopeFollowerMatchesEnvelopeFollowerTest, "System.Audio.DSP.InterleavedEnvelopeFollower.MatchesEnvelopeFollower", Audio::InterleavedEnvelopeFollowerTest::TestFlags)
+bool FInterleavedEnvelopeFollowerMatchesEnvelopeFollowerTest::RunTest(const FString& Parameters)
+{
+	using namespace Audio;
+	using namespace Audio::InterleavedEnvelopeFollowerTest;
+
+	constexpr int32 NumFrames = 8192;
+	constexpr float Tolerance = 1e-5f;
+
+	for (EPeakMode::Type Mode : Modes)
+	{
+		for (int32 NumChannels : { 1, 2, 3, 4, 6, 8 })
+		{
+			FEnvelopeFollowerInitParams Params;
+			Params.SampleRate = 48000.f;
+			Params.NumChannels = NumChannels;
+			Params.Mode = Mode;
+			Params.AttackTimeMsec = 5.f;
+			Params.ReleaseTimeMsec = 50.f;
+			Params.AnalysisWindowMsec = 10.f;
+
+			FEnvelopeFollower Reference(Params);
+			FInterleavedEnvelopeFollower Fused(Params);
+
+			TArray<float> Input;
+			MakeInput(NumChannels, NumFrames, NumChannels, Input);
+
+			TArray<float> ReferenceOutput;
+			TArray<float> FusedOutput;
+			ReferenceOutput.SetNumZeroed(Input.Num());
+			FusedOutput.SetNumZeroed(Input.Num());
+
+			// Odd block sizes so state carries over between calls at different points
+			for (int32 Frame = 0, BlockSize = 1; Frame < NumFrames; Frame += BlockSize, BlockSize = (BlockSize * 3 + 1) % 509 + 1)
+			{
+				const int32 NumBlockFrames = FMath::Min(BlockSize, NumFrames - Frame);
+				Reference.ProcessAudio(Input.GetData() + Frame * NumChannels, NumBlockFrames, ReferenceOutput.GetData() + Frame * NumChannels);
+				Fused.ProcessAudio(Input.GetData() + Frame * NumChannels, NumBlockFrames, FusedOutput.GetData() + Frame * NumChannels);
+			}
+
+			float MaxError = 0.f;
+			for (int32 Index = 0; Index < Input.Num(); Index++)
+			{
+				MaxError = FMath::Max(MaxError, FMath::Abs(ReferenceOutput[Index] - FusedOutput[Index]) / FMath::Max(1.f, FMath::Abs(ReferenceOutput[Index])));
+			}
+			TestTrue(FString::Printf(TEXT("Mode %d with %d channels matches FEnvelopeFollower (max error %g)"), (int32)Mode, NumChannels, MaxError), MaxError <= Tolerance);
+
+			for (int32 Channel = 0; Channel < NumChannels; Channel++)
+			{
+				TestTrue(TEXT("Envelope values match"), FMath::IsNearlyEqual(Reference.GetEnvelopeValues()[Channel], Fused.GetEnvelopeValues()[Channel], Tolerance));
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInterleavedEnvelopeFollowerBenchmarkTest, "System.Audio.DSP.InterleavedEnvelopeFollower.Benchmark", Audio::InterleavedEnvelopeFollowerTest::TestFlags | EAutomationTestFlags::PerfFilter)
+bool FInterleavedEnvelopeFollowerBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace Audio;
+	using namespace Audio::InterleavedEnvelopeFollowerTest;
+
+	// One second of audio per voice in typical callback sized blocks, on a single thread
+	constexpr float SampleRate = 48000.f;
+	constexpr int32 NumBlockFrames = 256;
+	constexpr int32 NumBlocks = 48000 / NumBlockFrames;
+	constexpr int32 NumVoices = 64;
+
+	for (EPeakMode::Type Mode : Modes)
+	{
+		for (int32 NumChannels : { 1, 2, 8 })
+		{
+			FEnvelopeFollowerInitParams Params;
+			Params.SampleRate = SampleRate;
+			Params.NumChannels = NumChannels;
+			Params.Mode = Mode;
+
+			TArray<FEnvelopeFollower> ReferenceVoices;
+			TArray<FInterleavedEnvelopeFollower> FusedVoices;
+			for (int32 Voice = 0; Voice < NumVoices; Voice++)
+			{
+				ReferenceVoices.Emplace(Params);
+				FusedVoices.Emplace(Params);
+			}
+
+			TArray<float> Input;
+			TArray<float> Output;
+			MakeInput(NumChannels, NumBlockFrames * NumBlocks, 0, Input);
+			Output.SetNumUninitialized(NumBlockFrames * NumChannels);
+
+			double ReferenceSeconds = 0.0;
+			double FusedSeconds = 0.0;
+			for (int32 Block = 0; Block < NumBlocks; Block++)
+			{
+				const float* BlockInput = Input.GetData() + Block * NumBlockFrames * NumChannels;
+
+				double StartTime = FPlatformTime::Seconds();
+				for (FEnvelopeFollower& Voice : ReferenceVoices)
+				{
+					Voice.ProcessAudio(BlockInput, NumBlockFrames, Output.GetData());
+				}
+				ReferenceSeconds += FPlatformTime::Seconds() - StartTime;
+
+				StartTime = FPlatformTime::Seconds();
+				for (FInterleavedEnvelopeFollower& Voice : FusedVoices)
+				{
+					Voice.ProcessAudio(BlockInput, NumBlockFrames, Output.GetData());
+				}
+				FusedSeconds += FPlatformTime::Seconds() - StartTime;
+			}
+
+			// Each voice processed NumBlocks * NumBlockFrames / SampleRate seconds of audio
+			const double AudioSeconds = NumVoices * NumBlocks * NumBlockFrames / double(SampleRate);
+			AddInfo(FString::Printf(TEXT("Mode %d, %d channels: FEnvelopeFollower %.0f voices per core, FInterleavedEnvelopeFollower %.0f voices per core"),
+				(int32)Mode, NumChannels, AudioSeconds / FMath::Max(ReferenceSeconds, UE_SMALL_NUMBER), AudioSeconds / FMath::Max(FusedSeconds, UE_SMALL_NUMBER)));
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
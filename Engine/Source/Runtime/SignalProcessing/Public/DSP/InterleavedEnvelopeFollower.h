@@ -0,0 +1,65 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DSP/EnvelopeFollower.h"
+
+namespace Audio
+{
+	/**
+	 * Envelope follower producing the same envelope as FEnvelopeFollower, with the mean squared filter, square root and
+	 * attack/release smoothing fused into a single pass over the input. Channels are processed four at a time in SIMD lanes,
+	 * straight from the interleaved buffer, and no memory is allocated while processing.
+	 *
+	 * Results match FEnvelopeFollower up to floating point rounding differences of the vectorized math.
+	 */
+	class SIGNALPROCESSING_API FInterleavedEnvelopeFollower
+	{
+	public:
+		FInterleavedEnvelopeFollower();
+		FInterleavedEnvelopeFollower(const FEnvelopeFollowerInitParams& InParams);
+
+		void Init(const FEnvelopeFollowerInitParams& InParams);
+
+		int32 GetNumChannels() const;
+		float GetSampleRate() const;
+		EPeakMode::Type GetMode() const;
+
+		void SetNumChannels(int32 InNumChannels);
+		void SetAnalog(bool bInIsAnalog);
+		void SetAttackTime(float InAttackTimeMsec);
+		void SetReleaseTime(float InReleaseTimeMsec);
+		void SetAnalysisWindow(float InAnalysisWindowMsec);
+		void SetMode(EPeakMode::Type InMode);
+
+		/** Resets the state of the envelope follower */
+		void Reset();
+
+		/** Processes InNumFrames of interleaved audio, writing the interleaved envelope to OutBuffer */
+		void ProcessAudio(const float* InBuffer, int32 InNumFrames, float* OutBuffer);
+
+		/** Processes InNumFrames of interleaved audio, only updating the envelope values */
+		void ProcessAudio(const float* InBuffer, int32 InNumFrames);
+
+		/** Last envelope value of each channel */
+		const TArray<float>& GetEnvelopeValues() const;
+
+	private:
+		template<EPeakMode::Type Mode, bool bWriteOutput>
+		void ProcessAudioInternal(const float* InBuffer, int32 InNumFrames, float* OutBuffer);
+
+		FAttackRelease AttackRelease;
+
+		// Mean squared IIR coefficients, MS[n] = Beta * x^2[n] + Alpha * MS[n - 1]
+		float AnalysisWindowMsec = 10.f;
+		float Alpha = 0.f;
+		float Beta = 1.f;
+
+		int32 NumChannels = 0;
+		EPeakMode::Type EnvMode = EPeakMode::Peak;
+
+		TArray<float> MeanSquaredValues;
+		TArray<float> EnvelopeValues;
+	};
+}
@@ -0,0 +1,347 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Textures/SlateSkylineAtlasPacker.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SlateSkylineAtlasPackerTest
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+// Fills every live slot with its id and checks the slots are inside the atlas and don't overlap
+static bool CheckSlots(FAutomationTestBase& Test, const FSlateSkylineAtlasPacker& Packer, const TArray<int32>& SlotIds, TArray<int32>& OutOwners)
+{
+	const uint32 Width = Packer.GetAtlasWidth();
+	OutOwners.Init(INDEX_NONE, Width * Packer.GetAtlasHeight());
+	for (int32 SlotId : SlotIds)
+	{
+		const FSlateSkylineAtlasRect& Rect = Packer.GetSlot(SlotId);
+		if (!Test.TestTrue(TEXT("Slot is inside the atlas"), Rect.X + Rect.Width <= Width && Rect.Y + Rect.Height <= Packer.GetAtlasHeight()))
+		{
+			return false;
+		}
+		for (uint32 Y = Rect.Y; Y < Rect.Y + Rect.Height; ++Y)
+		{
+			for (uint32 X = Rect.X; X < Rect.X + Rect.Width; ++X)
+			{
+				if (!Test.TestEqual(TEXT("Slots don't overlap"), OutOwners[Y * Width + X], INDEX_NONE))
+				{
+					return false;
+				}
+				OutOwners[Y * Width + X] = SlotId;
+			}
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSlateSkylineAtlasPackerTest, "System.Slate.SkylineAtlasPacker", TestFlags)
+bool FSlateSkylineAtlasPackerTest::RunTest(const FString& Parameters)
+{
+	constexpr uint32 AtlasSize = 256;
+	FSlateSkylineAtlasPacker Packer(AtlasSize, AtlasSize);
+	FRandomStream Stream(0x5c71);
+
+	// fill the atlas, free half of it, then fill the holes again
+	TArray<int32> SlotIds;
+	for (int32 SlotId = Packer.Allocate(Stream.RandRange(4, 24), Stream.RandRange(4, 24)); SlotId != INDEX_NONE; SlotId = Packer.Allocate(Stream.RandRange(4, 24), Stream.RandRange(4, 24)))
+	{
+		SlotIds.Add(SlotId);
+	}
+	TestTrue(TEXT("Full atlas is mostly used"), Packer.GetFillRate() > 0.7f);
+
+	for (int32 Index = SlotIds.Num() - 1; Index >= 0; Index -= 2)
+	{
+		Packer.Free(SlotIds[Index]);
+		SlotIds.RemoveAtSwap(Index);
+	}
+	const int32 NumAfterFree = SlotIds.Num();
+	for (int32 SlotId = Packer.Allocate(8, 8); SlotId != INDEX_NONE; SlotId = Packer.Allocate(8, 8))
+	{
+		SlotIds.Add(SlotId);
+	}
+	TestTrue(TEXT("Freed space is reused"), SlotIds.Num() > NumAfterFree);
+	TestEqual(TEXT("Slot count"), Packer.GetNumSlots(), SlotIds.Num());
+
+	TArray<int32> Owners;
+	if (!CheckSlots(*this, Packer, SlotIds, Owners))
+	{
+		return false;
+	}
+
+	// free some more and compact, the pixels of every slot must follow it
+	for (int32 Index = SlotIds.Num() - 1; Index >= 0; Index -= 3)
+	{
+		Packer.Free(SlotIds[Index]);
+		SlotIds.RemoveAtSwap(Index);
+	}
+	TArray<uint8> AtlasData;
+	AtlasData.SetNumZeroed(AtlasSize * AtlasSize * 4);
+	for (int32 SlotId : SlotIds)
+	{
+		const FSlateSkylineAtlasRect& Rect = Packer.GetSlot(SlotId);
+		for (uint32 Y = Rect.Y; Y < Rect.Y + Rect.Height; ++Y)
+		{
+			for (uint32 X = Rect.X; X < Rect.X + Rect.Width; ++X)
+			{
+				FMemory::Memcpy(&AtlasData[(Y * AtlasSize + X) * 4], &SlotId, 4);
+			}
+		}
+	}
+
+	TArray<FSlateSkylineAtlasPacker::FSlotMove> Moves;
+	TestTrue(TEXT("Compact"), Packer.Compact(Moves));
+	FSlateSkylineAtlasPacker::RelocateSlots(AtlasData, AtlasSize, 4, Moves);
+	if (!CheckSlots(*this, Packer, SlotIds, Owners))
+	{
+		return false;
+	}
+
+	int32 NumWrongPixels = 0;
+	for (int32 SlotId : SlotIds)
+	{
+		const FSlateSkylineAtlasRect& Rect = Packer.GetSlot(SlotId);
+		for (uint32 Y = Rect.Y; Y < Rect.Y + Rect.Height; ++Y)
+		{
+			for (uint32 X = Rect.X; X < Rect.X + Rect.Width; ++X)
+			{
+				int32 PixelOwner;
+				FMemory::Memcpy(&PixelOwner, &AtlasData[(Y * AtlasSize + X) * 4], 4);
+				NumWrongPixels += PixelOwner != SlotId ? 1 : 0;
+			}
+		}
+	}
+	TestEqual(TEXT("Relocated pixels follow their slots"), NumWrongPixels, 0);
+
+	return true;
+}
+
+// Writes the id of a slot into every pixel of it
+static void FillSlot(TArray<uint8>& AtlasData, uint32 AtlasWidth, const FSlateSkylineAtlasRect& Rect, int32 SlotId)
+{
+	for (uint32 Y = Rect.Y; Y < Rect.Y + Rect.Height; ++Y)
+	{
+		for (uint32 X = Rect.X; X < Rect.X + Rect.Width; ++X)
+		{
+			FMemory::Memcpy(&AtlasData[(Y * AtlasWidth + X) * 4], &SlotId, 4);
+		}
+	}
+}
+
+// Counts the pixels of live slots that don't hold their slot id
+static int32 CountWrongPixels(const FSlateSkylineAtlasPacker& Packer, const TArray<int32>& SlotIds, const TArray<uint8>& AtlasData)
+{
+	const uint32 AtlasWidth = Packer.GetAtlasWidth();
+	int32 NumWrongPixels = 0;
+	for (int32 SlotId : SlotIds)
+	{
+		const FSlateSkylineAtlasRect& Rect = Packer.GetSlot(SlotId);
+		for (uint32 Y = Rect.Y; Y < Rect.Y + Rect.Height; ++Y)
+		{
+			for (uint32 X = Rect.X; X < Rect.X + Rect.Width; ++X)
+			{
+				int32 PixelOwner;
+				FMemory::Memcpy(&PixelOwner, &AtlasData[(Y * AtlasWidth + X) * 4], 4);
+				NumWrongPixels += PixelOwner != SlotId ? 1 : 0;
+			}
+		}
+	}
+	return NumWrongPixels;
+}
+
+// Compacts a few slots at a time while allocating and freeing slots in between, as a font cache spreading compaction over frames would
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSlateSkylineAtlasPackerIncrementalTest, "System.Slate.SkylineAtlasPacker.Incremental", TestFlags)
+bool FSlateSkylineAtlasPackerIncrementalTest::RunTest(const FString& Parameters)
+{
+	constexpr uint32 AtlasSize = 256;
+	FSlateSkylineAtlasPacker Packer(AtlasSize, AtlasSize);
+	FRandomStream Stream(0x1c0f);
+	TArray<uint8> AtlasData;
+	AtlasData.SetNumZeroed(AtlasSize * AtlasSize * 4);
+
+	TArray<int32> SlotIds;
+	for (int32 SlotId = Packer.Allocate(Stream.RandRange(3, 24), Stream.RandRange(3, 24)); SlotId != INDEX_NONE; SlotId = Packer.Allocate(Stream.RandRange(3, 24), Stream.RandRange(3, 24)))
+	{
+		SlotIds.Add(SlotId);
+		FillSlot(AtlasData, AtlasSize, Packer.GetSlot(SlotId), SlotId);
+	}
+	for (int32 Index = SlotIds.Num() - 1; Index >= 0; Index -= 2)
+	{
+		Packer.Free(SlotIds[Index]);
+		SlotIds.RemoveAtSwap(Index);
+	}
+
+	if (!TestTrue(TEXT("BeginCompaction"), Packer.BeginCompaction()) || !TestTrue(TEXT("Slots have to move"), Packer.IsCompacting()))
+	{
+		return false;
+	}
+
+	TArray<int32> Owners;
+	TArray<FSlateSkylineAtlasPacker::FSlotMove> Moves;
+	int32 NumSteps = 0;
+	int32 NumAllocatedWhileCompacting = 0;
+	for (bool bDone = false; !bDone; ++NumSteps)
+	{
+		bDone = Packer.CompactStep(4, Moves);
+		FSlateSkylineAtlasPacker::RelocateSlots(AtlasData, AtlasSize, 4, Moves);
+
+		// free a slot, waiting to move or not, and allocate one in the free space of the new packing
+		if (SlotIds.Num() > 0 && Stream.FRand() < 0.3f)
+		{
+			const int32 Index = Stream.RandHelper(SlotIds.Num());
+			Packer.Free(SlotIds[Index]);
+			SlotIds.RemoveAtSwap(Index);
+		}
+		const int32 NewSlotId = Packer.Allocate(Stream.RandRange(3, 12), Stream.RandRange(3, 12));
+		if (NewSlotId != INDEX_NONE)
+		{
+			++NumAllocatedWhileCompacting;
+			SlotIds.Add(NewSlotId);
+			FillSlot(AtlasData, AtlasSize, Packer.GetSlot(NewSlotId), NewSlotId);
+		}
+
+		if (!CheckSlots(*this, Packer, SlotIds, Owners)
+			|| !TestEqual(FString::Printf(TEXT("Pixels follow their slots after step %d"), NumSteps), CountWrongPixels(Packer, SlotIds, AtlasData), 0))
+		{
+			return false;
+		}
+	}
+
+	TestFalse(TEXT("Compaction is done"), Packer.IsCompacting());
+	TestTrue(TEXT("Compaction took several steps"), NumSteps > 1);
+	TestTrue(TEXT("Slots were allocated while compacting"), NumAllocatedWhileCompacting > 0);
+	TestEqual(TEXT("Slot count"), Packer.GetNumSlots(), SlotIds.Num());
+
+	return true;
+}
+
+struct FGlyphTraceResult
+{
+	int32 NumRasterizations = 0;
+	int32 NumFlushes = 0;
+	int32 NumCompactions = 0;
+	double AverageFillRate = 0.0;
+	double Seconds = 0.0;
+};
+
+/**
+ * Replays the glyphs drawn by a CJK heavy UI on a 1bpp 1024x1024 atlas page: 150 glyphs a frame out of 12K, three font sizes,
+ * the popular glyphs changing with the screen every 200 frames. A glyph missing from the atlas is rasterized (counted) and added.
+ *
+ * When the atlas is full, bCompact evicts the glyphs not drawn this frame and compacts the rest, which only needs a flush when the glyphs of
+ * the frame alone don't fit. Otherwise the atlas is flushed like FSlateFlushableAtlasCache does, and every glyph rasterized again.
+ */
+static FGlyphTraceResult ReplayGlyphTrace(bool bCompact)
+{
+	constexpr uint32 AtlasSize = 1024;
+	constexpr int32 NumFrames = 2000;
+	constexpr int32 GlyphsPerFrame = 150;
+	constexpr int32 NumGlyphs = 12000;
+	constexpr int32 FramesPerScreen = 200;
+	constexpr uint32 Padding = 2;
+
+	struct FCachedGlyph
+	{
+		int32 SlotId = INDEX_NONE;
+		int32 LastUsedFrame = 0;
+	};
+
+	FSlateSkylineAtlasPacker Packer(AtlasSize, AtlasSize);
+	TArray<uint8> AtlasData;
+	AtlasData.SetNumZeroed(AtlasSize * AtlasSize);
+	TMap<uint32, FCachedGlyph> Cache;
+	TArray<FSlateSkylineAtlasPacker::FSlotMove> Moves;
+	TArray<uint32> Evicted;
+	FRandomStream Stream(0xc1c);
+	FGlyphTraceResult Result;
+
+	const double StartTime = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const int32 ScreenOffset = (Frame / FramesPerScreen) * 997;
+		for (int32 Draw = 0; Draw < GlyphsPerFrame; ++Draw)
+		{
+			// skewed towards the first ranks, like character frequencies
+			const int32 Rank = FMath::Min(int32(NumGlyphs * FMath::Pow(Stream.GetFraction(), 3.0f)), NumGlyphs - 1);
+			const uint32 Glyph = uint32((Rank + ScreenOffset) % NumGlyphs);
+
+			FCachedGlyph& Cached = Cache.FindOrAdd(Glyph);
+			Cached.LastUsedFrame = Frame;
+			if (Cached.SlotId != INDEX_NONE)
+			{
+				continue;
+			}
+
+			const uint32 FontSize = 16 + 8 * (Glyph % 3);
+			const uint32 Width = FontSize - (Glyph / 3) % 4 + Padding;
+			const uint32 Height = FontSize + Padding;
+
+			++Result.NumRasterizations;
+			int32 SlotId = Packer.Allocate(Width, Height);
+			if (SlotId == INDEX_NONE && bCompact)
+			{
+				Evicted.Reset();
+				for (const TPair<uint32, FCachedGlyph>& Pair : Cache)
+				{
+					if (Pair.Value.LastUsedFrame < Frame && Pair.Value.SlotId != INDEX_NONE)
+					{
+						Packer.Free(Pair.Value.SlotId);
+						Evicted.Add(Pair.Key);
+					}
+				}
+				for (uint32 EvictedGlyph : Evicted)
+				{
+					Cache.Remove(EvictedGlyph);
+				}
+
+				++Result.NumCompactions;
+				if (Packer.Compact(Moves))
+				{
+					FSlateSkylineAtlasPacker::RelocateSlots(AtlasData, AtlasSize, 1, Moves);
+				}
+				SlotId = Packer.Allocate(Width, Height);
+			}
+			if (SlotId == INDEX_NONE)
+			{
+				++Result.NumFlushes;
+				Packer.Reset();
+				Cache.Reset();
+				SlotId = Packer.Allocate(Width, Height);
+			}
+
+			// the glyph may have been evicted or flushed above
+			FCachedGlyph& NewCached = Cache.FindOrAdd(Glyph);
+			NewCached.SlotId = SlotId;
+			NewCached.LastUsedFrame = Frame;
+		}
+		Result.AverageFillRate += Packer.GetFillRate();
+	}
+	Result.Seconds = FPlatformTime::Seconds() - StartTime;
+	Result.AverageFillRate /= NumFrames;
+
+	return Result;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSlateSkylineAtlasPackerBenchmarkTest, "System.Slate.SkylineAtlasPacker.Benchmark", TestFlags | EAutomationTestFlags::PerfFilter)
+bool FSlateSkylineAtlasPackerBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const FGlyphTraceResult FlushResult = ReplayGlyphTrace(false);
+	const FGlyphTraceResult CompactResult = ReplayGlyphTrace(true);
+
+	TestTrue(TEXT("Compaction rasterizes fewer glyphs than flushing"), CompactResult.NumRasterizations <= FlushResult.NumRasterizations);
+
+	AddInfo(FString::Printf(TEXT("Flush when full: %d rasterizations, %d flushes, %.1f%% average fill, %.3f ms"),
+		FlushResult.NumRasterizations, FlushResult.NumFlushes, 100.0 * FlushResult.AverageFillRate, 1000.0 * FlushResult.Seconds));
+	AddInfo(FString::Printf(TEXT("Compact when full: %d rasterizations, %d flushes, %d compactions, %.1f%% average fill, %.3f ms"),
+		CompactResult.NumRasterizations, CompactResult.NumFlushes, CompactResult.NumCompactions, 100.0 * CompactResult.AverageFillRate, 1000.0 * CompactResult.Seconds));
+
+	return true;
+}
+
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
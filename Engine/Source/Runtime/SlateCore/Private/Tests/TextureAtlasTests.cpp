@@ -0,0 +1,130 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+#include "Textures/TextureAtlas.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace SlateTextureAtlasTest
+{
+
+constexpr const EAutomationTestFlags TestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+// CPU only atlas, the pixels are checked straight from the atlas data
+class FTestTextureAtlas : public FSlateTextureAtlas
+{
+public:
+	FTestTextureAtlas(uint32 InWidth, uint32 InHeight, uint32 InBytesPerPixel, ESlateTextureAtlasPaddingStyle InPaddingStyle)
+		: FSlateTextureAtlas(InWidth, InHeight, InBytesPerPixel, InPaddingStyle, false)
+	{
+	}
+
+	virtual void ReleaseResources() override {}
+	virtual void ConditionalUpdateTexture() override {}
+
+	TArray<uint8>& GetAtlasData()
+	{
+		return AtlasData;
+	}
+};
+
+static constexpr uint8 Untouched = 0xcd;
+
+static uint8 GetSourceByte(int32 TextureIndex, uint32 X, uint32 Y, uint32 Byte)
+{
+	return uint8(1 + TextureIndex * 29 + X * 7 + Y * 13 + Byte * 3);
+}
+
+static bool TestCopyDataIntoSlot(FAutomationTestBase& Test, ESlateTextureAtlasPaddingStyle PaddingStyle, uint32 BytesPerPixel)
+{
+	constexpr uint32 AtlasSize = 64;
+	FTestTextureAtlas Atlas(AtlasSize, AtlasSize, BytesPerPixel, PaddingStyle);
+	const uint32 Padding = PaddingStyle == ESlateTextureAtlasPaddingStyle::NoPadding ? 0 : 1;
+
+	// anything the copy doesn't write must keep this value
+	TArray<uint8>& AtlasData = Atlas.GetAtlasData();
+	FMemory::Memset(AtlasData.GetData(), Untouched, AtlasData.Num());
+
+	// the first texture is as wide as the atlas, which is copied in one go when there is no padding
+	const FIntPoint TextureSizes[] = { { int32(AtlasSize - 2 * Padding), 3 }, { 1, 1 }, { 1, 4 }, { 5, 1 }, { 7, 5 }, { 13, 9 } };
+
+	TArray<const FAtlasedTextureSlot*> Slots;
+	for (int32 TextureIndex = 0; TextureIndex < UE_ARRAY_COUNT(TextureSizes); ++TextureIndex)
+	{
+		const FIntPoint Size = TextureSizes[TextureIndex];
+		TArray<uint8> Data;
+		Data.SetNumUninitialized(Size.X * Size.Y * BytesPerPixel);
+		for (uint32 Y = 0; Y < uint32(Size.Y); ++Y)
+		{
+			for (uint32 X = 0; X < uint32(Size.X); ++X)
+			{
+				for (uint32 Byte = 0; Byte < BytesPerPixel; ++Byte)
+				{
+					Data[(Y * Size.X + X) * BytesPerPixel + Byte] = GetSourceByte(TextureIndex, X, Y, Byte);
+				}
+			}
+		}
+
+		const FAtlasedTextureSlot* Slot = Atlas.AddTexture(Size.X, Size.Y, Data);
+		if (!Test.TestNotNull(TEXT("Texture fits in the atlas"), Slot))
+		{
+			return false;
+		}
+		Slots.Add(Slot);
+	}
+
+	// every pixel of a slot is the source pixel, clamped to the texture for dilated borders and zero for zero padding
+	TArray<uint8> Expected;
+	Expected.Init(Untouched, AtlasData.Num());
+	for (int32 TextureIndex = 0; TextureIndex < Slots.Num(); ++TextureIndex)
+	{
+		const FAtlasedTextureSlot& Slot = *Slots[TextureIndex];
+		const FIntPoint Size = TextureSizes[TextureIndex];
+		Test.TestEqual(TEXT("Slot width"), Slot.Width, Size.X + 2 * Padding);
+		Test.TestEqual(TEXT("Slot height"), Slot.Height, Size.Y + 2 * Padding);
+		for (uint32 Y = 0; Y < Slot.Height; ++Y)
+		{
+			for (uint32 X = 0; X < Slot.Width; ++X)
+			{
+				const bool bPadding = X < Padding || Y < Padding || X >= Slot.Width - Padding || Y >= Slot.Height - Padding;
+				const uint32 SourceX = uint32(FMath::Clamp(int32(X) - int32(Padding), 0, Size.X - 1));
+				const uint32 SourceY = uint32(FMath::Clamp(int32(Y) - int32(Padding), 0, Size.Y - 1));
+				for (uint32 Byte = 0; Byte < BytesPerPixel; ++Byte)
+				{
+					const bool bZero = bPadding && PaddingStyle == ESlateTextureAtlasPaddingStyle::PadWithZero;
+					Expected[((Slot.Y + Y) * AtlasSize + Slot.X + X) * BytesPerPixel + Byte] = bZero ? 0 : GetSourceByte(TextureIndex, SourceX, SourceY, Byte);
+				}
+			}
+		}
+	}
+
+	for (int32 Index = 0; Index < AtlasData.Num(); ++Index)
+	{
+		if (AtlasData[Index] != Expected[Index])
+		{
+			const uint32 Pixel = Index / BytesPerPixel;
+			Test.AddError(FString::Printf(TEXT("Padding style %d, %u bytes per pixel: pixel (%u, %u) byte %u is %u, expected %u"),
+				int32(PaddingStyle), BytesPerPixel, Pixel % AtlasSize, Pixel / AtlasSize, Index % BytesPerPixel, AtlasData[Index], Expected[Index]));
+			return false;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSlateTextureAtlasCopyDataTest, "System.Slate.TextureAtlas.CopyDataIntoSlot", TestFlags)
+bool FSlateTextureAtlasCopyDataTest::RunTest(const FString& Parameters)
+{
+	const ESlateTextureAtlasPaddingStyle PaddingStyles[] = { ESlateTextureAtlasPaddingStyle::NoPadding, ESlateTextureAtlasPaddingStyle::DilateBorder, ESlateTextureAtlasPaddingStyle::PadWithZero };
+	for (const ESlateTextureAtlasPaddingStyle PaddingStyle : PaddingStyles)
+	{
+		for (const uint32 BytesPerPixel : { 1u, 4u })
+		{
+			TestCopyDataIntoSlot(*this, PaddingStyle, BytesPerPixel);
+		}
+	}
+	return true;
+}
+
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,574 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Textures/SlateSkylineAtlasPacker.h"
+#include "Algo/BinarySearch.h"
+
+namespace UE::Slate::Private
+{
+	// Free rects must have a minimum width/height, to avoid keeping slivers no glyph fits in (same as FSlateTextureAtlas)
+	static constexpr uint32 SkylineMinFreeRectDim = 2;
+
+	// Size of the cells tracking where slots waiting to move during a compaction are, a little less than the smallest glyphs
+	static constexpr uint32 PendingCellSize = 8;
+}
+
+FSlateSkylineAtlasPacker::FSlateSkylineAtlasPacker(uint32 InAtlasWidth, uint32 InAtlasHeight)
+	: AtlasWidth(InAtlasWidth)
+	, AtlasHeight(InAtlasHeight)
+	, LeafCount(FMath::RoundUpToPowerOfTwo(InAtlasHeight + 1))
+{
+	check(AtlasWidth > 0 && AtlasHeight > 0);
+	ResetFreeSpace();
+}
+
+void FSlateSkylineAtlasPacker::Reset()
+{
+	ResetFreeSpace();
+	Slots.Reset();
+	LiveSlots.Reset();
+	FreeSlotIds.Reset();
+	NumLiveSlots = 0;
+	UsedArea = 0;
+	PendingMoves.Reset();
+	PendingCells.Reset();
+}
+
+void FSlateSkylineAtlasPacker::ResetFreeSpace()
+{
+	FreeSpace.Skyline.Reset();
+	FreeSpace.Skyline.Add({ 0, 0, AtlasWidth });
+	FreeSpace.FreeRectsByHeight.SetNum(AtlasHeight + 1);
+	for (TArray<FSlateSkylineAtlasRect>& FreeRects : FreeSpace.FreeRectsByHeight)
+	{
+		FreeRects.Reset();
+	}
+	FreeSpace.MaxWidthTree.Init(0, 2 * LeafCount);
+}
+
+int32 FSlateSkylineAtlasPacker::Allocate(uint32 InWidth, uint32 InHeight)
+{
+	FSlateSkylineAtlasRect Rect;
+	if (InWidth == 0 || InHeight == 0)
+	{
+		// zero sized slots (spaces) don't take any room
+		Rect.Width = InWidth;
+		Rect.Height = InHeight;
+	}
+	else if (!PlaceRect(InWidth, InHeight, Rect))
+	{
+		return INDEX_NONE;
+	}
+
+	int32 SlotId;
+	if (FreeSlotIds.Num() > 0)
+	{
+		SlotId = FreeSlotIds.Pop(EAllowShrinking::No);
+		Slots[SlotId] = Rect;
+		LiveSlots[SlotId] = true;
+	}
+	else
+	{
+		SlotId = Slots.Add(Rect);
+		LiveSlots.Add(true);
+	}
+
+	++NumLiveSlots;
+	UsedArea += Rect.GetArea();
+	return SlotId;
+}
+
+void FSlateSkylineAtlasPacker::Free(int32 SlotId)
+{
+	check(IsSlotAllocated(SlotId));
+
+	const FSlateSkylineAtlasRect& Rect = Slots[SlotId];
+
+	// a slot waiting to move already has its room in the new packing, its current rect isn't part of the free space.
+	// Linear, but only while compacting.
+	const int32 PendingIndex = IsCompacting() ? PendingMoves.IndexOfByPredicate([SlotId](const FPendingMove& Pending) { return Pending.SlotId == SlotId; }) : INDEX_NONE;
+	if (PendingIndex != INDEX_NONE)
+	{
+		const FSlateSkylineAtlasRect To = PendingMoves[PendingIndex].To;
+		UpdatePendingCells(Rect, -1);
+		PendingMoves.RemoveAt(PendingIndex, 1, EAllowShrinking::No);
+		if (PendingMoves.Num() == 0)
+		{
+			PendingCells.Empty();
+		}
+		AddFreeRect(To.X, To.Y, To.Width, To.Height);
+	}
+	else
+	{
+		AddFreeRect(Rect.X, Rect.Y, Rect.Width, Rect.Height);
+	}
+
+	--NumLiveSlots;
+	UsedArea -= Rect.GetArea();
+	LiveSlots[SlotId] = false;
+	FreeSlotIds.Add(SlotId);
+}
+
+bool FSlateSkylineAtlasPacker::PlaceRect(uint32 InWidth, uint32 InHeight, FSlateSkylineAtlasRect& OutRect)
+{
+	int32 FreeRectHeight;
+	int32 SegmentIndex;
+	if (!FindRect(InWidth, InHeight, OutRect, FreeRectHeight, SegmentIndex))
+	{
+		return false;
+	}
+
+	// while compacting, the room found in the new packing can still hold the pixels of slots waiting to move
+	if (IsCompacting() && OverlapsPendingSlots(OutRect))
+	{
+		return false;
+	}
+
+	CommitRect(OutRect, FreeRectHeight, SegmentIndex);
+	return true;
+}
+
+bool FSlateSkylineAtlasPacker::FindRect(uint32 InWidth, uint32 InHeight, FSlateSkylineAtlasRect& OutRect, int32& OutFreeRectHeight, int32& OutSegmentIndex) const
+{
+	OutRect.Width = InWidth;
+	OutRect.Height = InHeight;
+
+	OutFreeRectHeight = FindFreeRectHeight(InWidth, InHeight);
+	if (OutFreeRectHeight != INDEX_NONE)
+	{
+		// the narrowest rect of the bucket that is wide enough
+		const TArray<FSlateSkylineAtlasRect>& FreeRects = FreeSpace.FreeRectsByHeight[OutFreeRectHeight];
+		const FSlateSkylineAtlasRect& FreeRect = FreeRects[Algo::LowerBoundBy(FreeRects, InWidth, &FSlateSkylineAtlasRect::Width)];
+		OutRect.X = FreeRect.X;
+		OutRect.Y = FreeRect.Y;
+		OutSegmentIndex = INDEX_NONE;
+		return true;
+	}
+
+	uint32 Y;
+	if (FindSkylinePosition(InWidth, InHeight, OutSegmentIndex, Y))
+	{
+		OutRect.X = FreeSpace.Skyline[OutSegmentIndex].X;
+		OutRect.Y = Y;
+		return true;
+	}
+
+	return false;
+}
+
+void FSlateSkylineAtlasPacker::CommitRect(const FSlateSkylineAtlasRect& Rect, int32 FreeRectHeight, int32 SegmentIndex)
+{
+	if (FreeRectHeight != INDEX_NONE)
+	{
+		FSlateSkylineAtlasRect TakenRect;
+		TakeFreeRect(FreeRectHeight, Rect.Width, Rect.Height, TakenRect);
+		check(TakenRect.X == Rect.X && TakenRect.Y == Rect.Y);
+	}
+	else
+	{
+		PlaceOnSkyline(SegmentIndex, Rect.Width, Rect.Height, Rect.Y);
+	}
+}
+
+bool FSlateSkylineAtlasPacker::FindSkylinePosition(uint32 InWidth, uint32 InHeight, int32& OutSegmentIndex, uint32& OutY) const
+{
+	const TArray<FSkylineSegment>& Skyline = FreeSpace.Skyline;
+	uint32 BestTop = MAX_uint32;
+	uint32 BestSegmentWidth = MAX_uint32;
+	OutSegmentIndex = INDEX_NONE;
+
+	for (int32 SegmentIndex = 0; SegmentIndex < Skyline.Num(); ++SegmentIndex)
+	{
+		const uint32 X = Skyline[SegmentIndex].X;
+		if (X + InWidth > AtlasWidth)
+		{
+			// segments are sorted by X, the following ones are further right
+			break;
+		}
+
+		// the slot rests on the highest segment under it
+		uint32 Y = 0;
+		for (int32 CoveredIndex = SegmentIndex; CoveredIndex < Skyline.Num() && Skyline[CoveredIndex].X < X + InWidth; ++CoveredIndex)
+		{
+			Y = FMath::Max(Y, Skyline[CoveredIndex].Y);
+		}
+
+		const uint32 Top = Y + InHeight;
+		if (Top <= AtlasHeight && (Top < BestTop || (Top == BestTop && Skyline[SegmentIndex].Width < BestSegmentWidth)))
+		{
+			BestTop = Top;
+			BestSegmentWidth = Skyline[SegmentIndex].Width;
+			OutSegmentIndex = SegmentIndex;
+			OutY = Y;
+		}
+	}
+
+	return OutSegmentIndex != INDEX_NONE;
+}
+
+void FSlateSkylineAtlasPacker::PlaceOnSkyline(int32 SegmentIndex, uint32 InWidth, uint32 InHeight, uint32 InY)
+{
+	TArray<FSkylineSegment>& Skyline = FreeSpace.Skyline;
+	const uint32 X = Skyline[SegmentIndex].X;
+	const uint32 Right = X + InWidth;
+
+	// the space between the lower segments and the bottom of the slot is stepped over by the skyline, keep it as free rects
+	int32 EndIndex = SegmentIndex;
+	while (EndIndex < Skyline.Num() && Skyline[EndIndex].X < Right)
+	{
+		FSkylineSegment& Segment = Skyline[EndIndex];
+		const uint32 SegmentRight = Segment.X + Segment.Width;
+		if (Segment.Y < InY)
+		{
+			AddFreeRect(Segment.X, Segment.Y, FMath::Min(SegmentRight, Right) - Segment.X, InY - Segment.Y);
+		}
+
+		if (SegmentRight > Right)
+		{
+			// partly covered, keep the part right of the slot
+			Segment.Width = SegmentRight - Right;
+			Segment.X = Right;
+			break;
+		}
+		++EndIndex;
+	}
+
+	Skyline.RemoveAt(SegmentIndex, EndIndex - SegmentIndex, EAllowShrinking::No);
+	Skyline.Insert({ X, InY + InHeight, InWidth }, SegmentIndex);
+
+	// merge with the neighbors at the same height
+	if (SegmentIndex + 1 < Skyline.Num() && Skyline[SegmentIndex + 1].Y == Skyline[SegmentIndex].Y)
+	{
+		Skyline[SegmentIndex].Width += Skyline[SegmentIndex + 1].Width;
+		Skyline.RemoveAt(SegmentIndex + 1, 1, EAllowShrinking::No);
+	}
+	if (SegmentIndex > 0 && Skyline[SegmentIndex - 1].Y == Skyline[SegmentIndex].Y)
+	{
+		Skyline[SegmentIndex - 1].Width += Skyline[SegmentIndex].Width;
+		Skyline.RemoveAt(SegmentIndex, 1, EAllowShrinking::No);
+	}
+}
+
+int32 FSlateSkylineAtlasPacker::FindFreeRectHeight(uint32 InWidth, uint32 InHeight) const
+{
+	if (InHeight > AtlasHeight)
+	{
+		return INDEX_NONE;
+	}
+
+	// The least tall bucket at least InHeight tall with a rect at least InWidth wide. Climb from the leaf of InHeight to the first
+	// range right of the path whose widest rect is wide enough, then go down to its leftmost leaf that is.
+	const TArray<uint32>& MaxWidthTree = FreeSpace.MaxWidthTree;
+	uint32 Node = LeafCount + InHeight;
+	while (MaxWidthTree[Node] < InWidth)
+	{
+		// ranges of right children are followed by the range right of their parent
+		while (Node & 1U)
+		{
+			Node >>= 1U;
+		}
+		if (Node == 0)
+		{
+			return INDEX_NONE;
+		}
+		++Node;
+	}
+	while (Node < LeafCount)
+	{
+		Node = MaxWidthTree[2 * Node] >= InWidth ? 2 * Node : 2 * Node + 1;
+	}
+	return int32(Node - LeafCount);
+}
+
+void FSlateSkylineAtlasPacker::TakeFreeRect(uint32 FreeRectHeight, uint32 InWidth, uint32 InHeight, FSlateSkylineAtlasRect& OutRect)
+{
+	TArray<FSlateSkylineAtlasRect>& FreeRects = FreeSpace.FreeRectsByHeight[FreeRectHeight];
+	const int32 RectIndex = Algo::LowerBoundBy(FreeRects, InWidth, &FSlateSkylineAtlasRect::Width);
+	const FSlateSkylineAtlasRect FreeRect = FreeRects[RectIndex];
+	FreeRects.RemoveAt(RectIndex, 1, EAllowShrinking::No);
+	UpdateMaxWidth(FreeRectHeight);
+
+	OutRect.X = FreeRect.X;
+	OutRect.Y = FreeRect.Y;
+	OutRect.Width = InWidth;
+	OutRect.Height = InHeight;
+
+	// Split the remaining area around the slot into two rects, along the shorter remaining side like FSlateTextureAtlas
+	const uint32 RemainingWidth = FreeRect.Width - InWidth;
+	const uint32 RemainingHeight = FreeRect.Height - InHeight;
+	if (RemainingHeight <= RemainingWidth)
+	{
+		AddFreeRect(FreeRect.X + InWidth, FreeRect.Y, RemainingWidth, FreeRect.Height);
+		AddFreeRect(FreeRect.X, FreeRect.Y + InHeight, InWidth, RemainingHeight);
+	}
+	else
+	{
+		AddFreeRect(FreeRect.X, FreeRect.Y + InHeight, FreeRect.Width, RemainingHeight);
+		AddFreeRect(FreeRect.X + InWidth, FreeRect.Y, RemainingWidth, InHeight);
+	}
+}
+
+void FSlateSkylineAtlasPacker::AddFreeRect(uint32 InX, uint32 InY, uint32 InWidth, uint32 InHeight)
+{
+	using namespace UE::Slate::Private;
+
+	if (InWidth < SkylineMinFreeRectDim || InHeight < SkylineMinFreeRectDim)
+	{
+		return;
+	}
+
+	FSlateSkylineAtlasRect Rect;
+	Rect.X = InX;
+	Rect.Y = InY;
+	Rect.Width = InWidth;
+	Rect.Height = InHeight;
+
+	// after the rects of the same width, which are taken first
+	TArray<FSlateSkylineAtlasRect>& FreeRects = FreeSpace.FreeRectsByHeight[InHeight];
+	FreeRects.Insert(Rect, Algo::UpperBoundBy(FreeRects, InWidth, &FSlateSkylineAtlasRect::Width));
+	UpdateMaxWidth(InHeight);
+}
+
+void FSlateSkylineAtlasPacker::UpdateMaxWidth(uint32 Height)
+{
+	TArray<uint32>& MaxWidthTree = FreeSpace.MaxWidthTree;
+	const TArray<FSlateSkylineAtlasRect>& FreeRects = FreeSpace.FreeRectsByHeight[Height];
+
+	uint32 Node = LeafCount + Height;
+	MaxWidthTree[Node] = FreeRects.Num() > 0 ? FreeRects.Last().Width : 0;
+	for (Node >>= 1U; Node > 0; Node >>= 1U)
+	{
+		MaxWidthTree[Node] = FMath::Max(MaxWidthTree[2 * Node], MaxWidthTree[2 * Node + 1]);
+	}
+}
+
+bool FSlateSkylineAtlasPacker::BeginCompaction()
+{
+	using namespace UE::Slate::Private;
+
+	check(!IsCompacting());
+
+	TArray<int32> SlotIds;
+	SlotIds.Reserve(NumLiveSlots);
+	for (TConstSetBitIterator<> It(LiveSlots); It; ++It)
+	{
+		if (Slots[It.GetIndex()].GetArea() > 0)
+		{
+			SlotIds.Add(It.GetIndex());
+		}
+	}
+
+	// tallest first keeps the skyline flat, the usual order for offline skyline packing
+	SlotIds.Sort([this](int32 A, int32 B)
+	{
+		const FSlateSkylineAtlasRect& RectA = Slots[A];
+		const FSlateSkylineAtlasRect& RectB = Slots[B];
+		return RectA.Height != RectB.Height ? RectA.Height > RectB.Height : RectA.Width > RectB.Width;
+	});
+
+	FFreeSpace PreviousFreeSpace = MoveTemp(FreeSpace);
+	ResetFreeSpace();
+
+	TArray<FSlateSkylineAtlasRect> NewRects;
+	NewRects.SetNumUninitialized(SlotIds.Num());
+	for (int32 Index = 0; Index < SlotIds.Num(); ++Index)
+	{
+		const FSlateSkylineAtlasRect& Slot = Slots[SlotIds[Index]];
+		if (!PlaceRect(Slot.Width, Slot.Height, NewRects[Index]))
+		{
+			FreeSpace = MoveTemp(PreviousFreeSpace);
+			return false;
+		}
+	}
+
+	PendingCellsPerRow = FMath::DivideAndRoundUp(AtlasWidth, PendingCellSize);
+	PendingCells.SetNumZeroed(PendingCellsPerRow * FMath::DivideAndRoundUp(AtlasHeight, PendingCellSize));
+	for (int32 Index = 0; Index < SlotIds.Num(); ++Index)
+	{
+		const FSlateSkylineAtlasRect& Slot = Slots[SlotIds[Index]];
+		if (Slot.X != NewRects[Index].X || Slot.Y != NewRects[Index].Y)
+		{
+			PendingMoves.Add({ SlotIds[Index], NewRects[Index] });
+			UpdatePendingCells(Slot, 1);
+		}
+	}
+	if (PendingMoves.Num() == 0)
+	{
+		PendingCells.Empty();
+	}
+
+	return true;
+}
+
+bool FSlateSkylineAtlasPacker::CompactStep(int32 MaxMoves, TArray<FSlotMove>& OutMoves)
+{
+	check(MaxMoves > 0);
+	OutMoves.Reset();
+
+	// keep the moves that can't go yet in order
+	int32 NumKept = 0;
+	for (int32 Index = 0; Index < PendingMoves.Num(); ++Index)
+	{
+		const FPendingMove Pending = PendingMoves[Index];
+		FSlateSkylineAtlasRect& Slot = Slots[Pending.SlotId];
+		if (OutMoves.Num() < MaxMoves && !OverlapsPendingSlots(Pending.To, &Slot))
+		{
+			UpdatePendingCells(Slot, -1);
+			OutMoves.Add({ Pending.SlotId, Slot, Pending.To });
+			Slot = Pending.To;
+		}
+		else
+		{
+			PendingMoves[NumKept++] = Pending;
+		}
+	}
+	PendingMoves.SetNum(NumKept, EAllowShrinking::No);
+
+	// The remaining moves block each other. Move the first one along with every move blocking it, transitively, which
+	// RelocateSlots can do at once since it reads all of them before writing any.
+	if (OutMoves.Num() == 0)
+	{
+		auto Intersects = [](const FSlateSkylineAtlasRect& A, const FSlateSkylineAtlasRect& B)
+		{
+			return A.X < B.X + B.Width && B.X < A.X + A.Width && A.Y < B.Y + B.Height && B.Y < A.Y + A.Height;
+		};
+
+		TBitArray<> InGroup(false, PendingMoves.Num());
+		TArray<int32> Group;
+		Group.Add(0);
+		InGroup[0] = true;
+		for (int32 GroupIndex = 0; GroupIndex < Group.Num(); ++GroupIndex)
+		{
+			const FSlateSkylineAtlasRect To = PendingMoves[Group[GroupIndex]].To;
+			for (int32 Index = 0; Index < PendingMoves.Num(); ++Index)
+			{
+				if (!InGroup[Index] && Intersects(To, Slots[PendingMoves[Index].SlotId]))
+				{
+					Group.Add(Index);
+					InGroup[Index] = true;
+				}
+			}
+		}
+
+		for (const int32 Index : Group)
+		{
+			const FPendingMove& Pending = PendingMoves[Index];
+			FSlateSkylineAtlasRect& Slot = Slots[Pending.SlotId];
+			UpdatePendingCells(Slot, -1);
+			OutMoves.Add({ Pending.SlotId, Slot, Pending.To });
+			Slot = Pending.To;
+		}
+
+		NumKept = 0;
+		for (int32 Index = 0; Index < PendingMoves.Num(); ++Index)
+		{
+			if (!InGroup[Index])
+			{
+				PendingMoves[NumKept++] = PendingMoves[Index];
+			}
+		}
+		PendingMoves.SetNum(NumKept, EAllowShrinking::No);
+	}
+
+	if (PendingMoves.Num() == 0)
+	{
+		PendingCells.Empty();
+		return true;
+	}
+	return false;
+}
+
+bool FSlateSkylineAtlasPacker::Compact(TArray<FSlotMove>& OutMoves)
+{
+	OutMoves.Reset();
+	if (!BeginCompaction())
+	{
+		return false;
+	}
+
+	// moves of later steps read slots earlier steps didn't write to, so they can all be relocated at once
+	TArray<FSlotMove> StepMoves;
+	bool bDone = !IsCompacting();
+	while (!bDone)
+	{
+		bDone = CompactStep(MAX_int32, StepMoves);
+		OutMoves.Append(StepMoves);
+	}
+	return true;
+}
+
+void FSlateSkylineAtlasPacker::UpdatePendingCells(const FSlateSkylineAtlasRect& Rect, int32 Delta)
+{
+	using namespace UE::Slate::Private;
+
+	for (uint32 CellY = Rect.Y / PendingCellSize; CellY <= (Rect.Y + Rect.Height - 1) / PendingCellSize; ++CellY)
+	{
+		for (uint32 CellX = Rect.X / PendingCellSize; CellX <= (Rect.X + Rect.Width - 1) / PendingCellSize; ++CellX)
+		{
+			uint16& Count = PendingCells[CellY * PendingCellsPerRow + CellX];
+			Count = uint16(int32(Count) + Delta);
+		}
+	}
+}
+
+bool FSlateSkylineAtlasPacker::OverlapsPendingSlots(const FSlateSkylineAtlasRect& Rect, const FSlateSkylineAtlasRect* IgnoredRect) const
+{
+	using namespace UE::Slate::Private;
+
+	auto TouchesCell = [](const FSlateSkylineAtlasRect& CellRect, uint32 CellX, uint32 CellY)
+	{
+		return CellX >= CellRect.X / PendingCellSize && CellX <= (CellRect.X + CellRect.Width - 1) / PendingCellSize
+			&& CellY >= CellRect.Y / PendingCellSize && CellY <= (CellRect.Y + CellRect.Height - 1) / PendingCellSize;
+	};
+
+	for (uint32 CellY = Rect.Y / PendingCellSize; CellY <= (Rect.Y + Rect.Height - 1) / PendingCellSize; ++CellY)
+	{
+		for (uint32 CellX = Rect.X / PendingCellSize; CellX <= (Rect.X + Rect.Width - 1) / PendingCellSize; ++CellX)
+		{
+			const uint32 Count = PendingCells[CellY * PendingCellsPerRow + CellX];
+			const uint32 IgnoredCount = IgnoredRect && TouchesCell(*IgnoredRect, CellX, CellY) ? 1 : 0;
+			if (Count > IgnoredCount)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void FSlateSkylineAtlasPacker::RelocateSlots(TArrayView<uint8> AtlasData, uint32 AtlasWidth, uint32 BytesPerPixel, TConstArrayView<FSlotMove> Moves)
+{
+	const SIZE_T Stride = SIZE_T(AtlasWidth) * BytesPerPixel;
+	check(Moves.IsEmpty() || SIZE_T(AtlasData.Num()) >= Stride);
+
+	uint64 ScratchSize = 0;
+	for (const FSlotMove& Move : Moves)
+	{
+		check(Move.From.Width == Move.To.Width && Move.From.Height == Move.To.Height);
+		ScratchSize += Move.From.GetArea() * BytesPerPixel;
+	}
+
+	TArray<uint8> Scratch;
+	Scratch.SetNumUninitialized(IntCastChecked<int32>(ScratchSize));
+
+	uint8* ScratchData = Scratch.GetData();
+	for (const FSlotMove& Move : Moves)
+	{
+		const SIZE_T RowSize = SIZE_T(Move.From.Width) * BytesPerPixel;
+		const uint8* Source = AtlasData.GetData() + Move.From.Y * Stride + SIZE_T(Move.From.X) * BytesPerPixel;
+		for (uint32 Row = 0; Row < Move.From.Height; ++Row, Source += Stride, ScratchData += RowSize)
+		{
+			FMemory::Memcpy(ScratchData, Source, RowSize);
+		}
+	}
+
+	ScratchData = Scratch.GetData();
+	for (const FSlotMove& Move : Moves)
+	{
+		const SIZE_T RowSize = SIZE_T(Move.To.Width) * BytesPerPixel;
+		uint8* Dest = AtlasData.GetData() + Move.To.Y * Stride + SIZE_T(Move.To.X) * BytesPerPixel;
+		for (uint32 Row = 0; Row < Move.To.Height; ++Row, Dest += Stride, ScratchData += RowSize)
+		{
+			FMemory::Memcpy(Dest, ScratchData, RowSize);
+		}
+	}
+}
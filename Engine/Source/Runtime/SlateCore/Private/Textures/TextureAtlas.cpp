@@ -248,13 +248,45 @@ void FSlateTextureAtlas::CopyDataIntoSlot( const FAtlasedTextureSlot* SlotToCopy
 		}
 	}
 
-	// Copy each row of the texture
-	for (uint32 Row = Padding; Row < SlotToCopyTo->Height-Padding; ++Row)
+	// Copy each row of the texture.
+	// Walks the rows with pointers and one memcpy per row, the padding pixels are the only per row work left
+	const SIZE_T SourceRowSize = SIZE_T(SourceWidth) * BytesPerPixel;
+	const SIZE_T DestStride = SIZE_T(AtlasWidth) * BytesPerPixel;
+	const uint8* SourceRowAddr = Data.GetData();
+	uint8* DestRowAddr = Start + Padding * DestStride;
+	if (Padding == 0)
 	{
-		CopyRowData.SrcRow = Row-Padding;
-		CopyRowData.DestRow = Row;
-
-		CopyRow(CopyRowData);
+		if (SourceWidth == AtlasWidth)
+		{
+			// rows are contiguous in both
+			FMemory::Memcpy(DestRowAddr, SourceRowAddr, SourceRowSize * SourceHeight);
+		}
+		else
+		{
+			for (uint32 Row = 0; Row < SourceHeight; ++Row, SourceRowAddr += SourceRowSize, DestRowAddr += DestStride)
+			{
+				FMemory::Memcpy(DestRowAddr, SourceRowAddr, SourceRowSize);
+			}
+		}
+	}
+	else
+	{
+		const SIZE_T RightPaddingOffset = SIZE_T(SlotToCopyTo->Width - 1) * BytesPerPixel;
+		const bool bDilateBorder = PaddingStyle == ESlateTextureAtlasPaddingStyle::DilateBorder;
+		for (uint32 Row = 0; Row < SourceHeight; ++Row, SourceRowAddr += SourceRowSize, DestRowAddr += DestStride)
+		{
+			FMemory::Memcpy(DestRowAddr + Padding * BytesPerPixel, SourceRowAddr, SourceRowSize);
+			if (bDilateBorder)
+			{
+				FMemory::Memcpy(DestRowAddr, SourceRowAddr, BytesPerPixel);
+				FMemory::Memcpy(DestRowAddr + RightPaddingOffset, SourceRowAddr + SourceRowSize - BytesPerPixel, BytesPerPixel);
+			}
+			else
+			{
+				FMemory::Memzero(DestRowAddr, BytesPerPixel);
+				FMemory::Memzero(DestRowAddr + RightPaddingOffset, BytesPerPixel);
+			}
+		}
 	}
 
 	if (Padding > 0)
@@ -0,0 +1,177 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Rectangle of an atlas, padding included. */
+struct FSlateSkylineAtlasRect
+{
+	uint32 X = 0;
+	uint32 Y = 0;
+	uint32 Width = 0;
+	uint32 Height = 0;
+
+	uint64 GetArea() const
+	{
+		return uint64(Width) * uint64(Height);
+	}
+};
+
+/**
+ * Skyline packer for texture and font atlases that supports freeing slots and compacting the live ones, so a full atlas can make room
+ * by relocating the slots still in use instead of being flushed and having all its glyphs rasterized again.
+ *
+ * New slots go on the skyline, the top edge of the packed area, at the position that keeps it lowest. The space the skyline steps over
+ * and the space of freed slots is kept as free rects and reused first (guillotine split, as in FSlateTextureAtlas), taking the narrowest
+ * of the least tall free rects the slot fits in. Free rects are bucketed by height, each bucket sorted by width, with a tree of the widest
+ * rect per height range on top: finding the bucket is O(log AtlasHeight) whatever the number of free rects, and the rect in it a binary search.
+ *
+ * Compaction can be spread over several frames: BeginCompaction plans the new positions of every live slot, and each CompactStep returns
+ * a batch of moves whose destination no longer holds pixels of slots still waiting to move. Slot ids stay valid across compaction, which
+ * only changes their positions, and GetSlot always returns where the pixels of a slot currently are.
+ */
+class FSlateSkylineAtlasPacker
+{
+public:
+	struct FSlotMove
+	{
+		int32 SlotId = INDEX_NONE;
+		FSlateSkylineAtlasRect From;
+		FSlateSkylineAtlasRect To;
+	};
+
+	SLATECORE_API FSlateSkylineAtlasPacker(uint32 InAtlasWidth, uint32 InAtlasHeight);
+
+	/** Frees every slot. */
+	SLATECORE_API void Reset();
+
+	/**
+	 * Finds room for a slot of the given size, padding included.
+	 * @return The id of the new slot, INDEX_NONE when the atlas is full.
+	 */
+	SLATECORE_API int32 Allocate(uint32 InWidth, uint32 InHeight);
+
+	SLATECORE_API void Free(int32 SlotId);
+
+	/**
+	 * Plans packing the live slots again from scratch, tallest first, which gathers most of the free space above the skyline.
+	 * Does nothing and returns false if the new packing doesn't fit them all. Slots only move with CompactStep.
+	 *
+	 * While compacting, new slots go in the free space of the new packing. Allocate fails when the room it finds still holds slots waiting
+	 * to move, in which case more steps make room.
+	 */
+	SLATECORE_API bool BeginCompaction();
+
+	/**
+	 * Moves up to MaxMoves slots to their planned position. Moves whose destination still holds slots waiting to move are held back.
+	 * When all of them are, the first one goes along with the moves blocking it, transitively, which can be more than MaxMoves
+	 * (RelocateSlots handles the overlaps).
+	 *
+	 * @param OutMoves	The slots that changed position, to relocate their pixels with RelocateSlots before writing any new slot.
+	 * @return True once every slot has moved, which ends the compaction.
+	 */
+	SLATECORE_API bool CompactStep(int32 MaxMoves, TArray<FSlotMove>& OutMoves);
+
+	bool IsCompacting() const
+	{
+		return PendingMoves.Num() > 0;
+	}
+
+	/**
+	 * BeginCompaction and every CompactStep at once, not while a compaction is in progress. Runs synchronously, like a flush it costs a hitch on the frame that calls it,
+	 * to be paid instead of rasterizing every glyph again.
+	 *
+	 * @param OutMoves	The slots that changed position, to relocate their pixels with RelocateSlots.
+	 */
+	SLATECORE_API bool Compact(TArray<FSlotMove>& OutMoves);
+
+	/** Moves the pixels of the slots Compact moved. Sources and destinations can overlap, everything moved is read before anything is written. */
+	static SLATECORE_API void RelocateSlots(TArrayView<uint8> AtlasData, uint32 AtlasWidth, uint32 BytesPerPixel, TConstArrayView<FSlotMove> Moves);
+
+	const FSlateSkylineAtlasRect& GetSlot(int32 SlotId) const
+	{
+		check(IsSlotAllocated(SlotId));
+		return Slots[SlotId];
+	}
+
+	bool IsSlotAllocated(int32 SlotId) const
+	{
+		return LiveSlots.IsValidIndex(SlotId) && LiveSlots[SlotId];
+	}
+
+	int32 GetNumSlots() const
+	{
+		return NumLiveSlots;
+	}
+
+	/** Fraction of the atlas covered by live slots. */
+	float GetFillRate() const
+	{
+		return float(double(UsedArea) / (double(AtlasWidth) * double(AtlasHeight)));
+	}
+
+	uint32 GetAtlasWidth() const { return AtlasWidth; }
+	uint32 GetAtlasHeight() const { return AtlasHeight; }
+
+private:
+	/** Horizontal run of the top edge of the packed area, segments cover the width of the atlas in increasing X order. */
+	struct FSkylineSegment
+	{
+		uint32 X;
+		uint32 Y;
+		uint32 Width;
+	};
+
+	/** Free space of the atlas, moved out and back as a whole when a compaction doesn't fit. */
+	struct FFreeSpace
+	{
+		TArray<FSkylineSegment> Skyline;
+		/** Free rects indexed by height, each sorted by width. */
+		TArray<TArray<FSlateSkylineAtlasRect>> FreeRectsByHeight;
+		/** Implicit binary tree over heights, leaves at LeafCount + Height, holding the width of the widest free rect in their range. */
+		TArray<uint32> MaxWidthTree;
+	};
+
+	/** Planned position of a slot waiting to move during a compaction. */
+	struct FPendingMove
+	{
+		int32 SlotId = INDEX_NONE;
+		FSlateSkylineAtlasRect To;
+	};
+
+	bool FindSkylinePosition(uint32 InWidth, uint32 InHeight, int32& OutSegmentIndex, uint32& OutY) const;
+	void PlaceOnSkyline(int32 SegmentIndex, uint32 InWidth, uint32 InHeight, uint32 InY);
+	int32 FindFreeRectHeight(uint32 InWidth, uint32 InHeight) const;
+	void TakeFreeRect(uint32 FreeRectHeight, uint32 InWidth, uint32 InHeight, FSlateSkylineAtlasRect& OutRect);
+	void AddFreeRect(uint32 InX, uint32 InY, uint32 InWidth, uint32 InHeight);
+	void UpdateMaxWidth(uint32 Height);
+	/** Finds where PlaceRect would put a rect, from a free rect (OutFreeRectHeight) or on the skyline (OutSegmentIndex), without taking the room. */
+	bool FindRect(uint32 InWidth, uint32 InHeight, FSlateSkylineAtlasRect& OutRect, int32& OutFreeRectHeight, int32& OutSegmentIndex) const;
+	void CommitRect(const FSlateSkylineAtlasRect& Rect, int32 FreeRectHeight, int32 SegmentIndex);
+	bool PlaceRect(uint32 InWidth, uint32 InHeight, FSlateSkylineAtlasRect& OutRect);
+	void ResetFreeSpace();
+
+	/** Adds Delta to the pending cells a rect touches. */
+	void UpdatePendingCells(const FSlateSkylineAtlasRect& Rect, int32 Delta);
+	/** Whether a rect touches a cell holding pixels of a pending slot, other than those of IgnoredRect. Conservative, cells are PendingCellSize wide. */
+	bool OverlapsPendingSlots(const FSlateSkylineAtlasRect& Rect, const FSlateSkylineAtlasRect* IgnoredRect = nullptr) const;
+
+	uint32 AtlasWidth;
+	uint32 AtlasHeight;
+	uint32 LeafCount;
+
+	FFreeSpace FreeSpace;
+
+	/** Slots waiting to move, in the order they were planned. */
+	TArray<FPendingMove> PendingMoves;
+	/** Number of pending slots touching each cell of the atlas, only while compacting. */
+	TArray<uint16> PendingCells;
+	uint32 PendingCellsPerRow = 0;
+
+	TArray<FSlateSkylineAtlasRect> Slots;
+	TBitArray<> LiveSlots;
+	TArray<int32> FreeSlotIds;
+	int32 NumLiveSlots = 0;
+	uint64 UsedArea = 0;
+};